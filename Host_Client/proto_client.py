@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Host client for the binary protocol mode of STM32_FreeRTOS_General_Application
+(main menu option 9). See proto.h for the packet layout.
+
+Packets are COBS encoded between two 0x00 delimiters. The CRC-32 is the one of
+the STM32 CRC unit: polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no
+reflection, no final XOR, over the packet read as little-endian 32-bit words
+with the last word padded with zeros.
+
+Usage examples:
+    proto_client.py /dev/ttyACM0 --enter ping
+    proto_client.py /dev/ttyACM0 get-datetime
+    proto_client.py /dev/ttyACM0 set-datetime 26 10 16 5 13 45 00
+    proto_client.py /dev/ttyACM0 calc 1234 -56 '*'
+    proto_client.py /dev/ttyACM0 temp-stats
+    proto_client.py /dev/ttyACM0 exit
+
+Requires pyserial.
+"""
+
+import argparse
+import struct
+import sys
+
+PING, GET_DATETIME, SET_DATETIME, SET_ALARM = 0x01, 0x10, 0x11, 0x12
+CALC, TEMP_START, TEMP_STOP, TEMP_STATS = 0x20, 0x30, 0x31, 0x32
+LED, SLEEP, EXIT = 0x40, 0x50, 0x7F
+RESPONSE_FLAG = 0x80
+
+STATUS_TEXT = {0: "OK", 1: "unknown request", 2: "wrong length", 3: "value out of range", 4: "wrong state"}
+
+
+def crc32_stm32(data):
+    crc = 0xFFFFFFFF
+    data = bytes(data) + bytes(-len(data) % 4)
+    for (word,) in struct.iter_unpack("<I", data):
+        crc ^= word
+        for _ in range(32):
+            crc = ((crc << 1) ^ 0x04C11DB7) if crc & 0x80000000 else (crc << 1)
+            crc &= 0xFFFFFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code = 0
+    run = 1
+    for byte in data:
+        if byte != 0:
+            out.append(byte)
+            run += 1
+        if byte == 0 or run == 0xFF:
+            out[code] = run
+            code = len(out)
+            out.append(0)
+            run = 1
+    out[code] = run
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("bad COBS encoding")
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class ProtoClient:
+    def __init__(self, port, baud, timeout):
+        import serial
+        self.serial = serial.Serial(port, baud, timeout=timeout)
+        self.seq = 0
+
+    def enter(self):
+        # Select option 9 from the main menu, then drop the menu text
+        self.serial.write(b"9\r")
+        self.serial.read_until(b"Binary protocol mode\r\n")
+
+    def request(self, req_type, payload=b""):
+        self.seq = (self.seq + 1) & 0xFF
+        packet = bytes([req_type, self.seq]) + payload
+        packet += struct.pack("<I", crc32_stm32(packet))
+        self.serial.write(b"\x00" + cobs_encode(packet) + b"\x00")
+
+        while True:
+            encoded = self.serial.read_until(b"\x00")
+            if not encoded.endswith(b"\x00"):
+                raise TimeoutError("no response")
+            encoded = encoded[:-1]
+            if not encoded:
+                continue
+            try:
+                response = cobs_decode(encoded)
+            except ValueError:
+                continue
+            if len(response) < 7 or crc32_stm32(response[:-4]) != struct.unpack("<I", response[-4:])[0]:
+                continue
+            if response[0] != (req_type | RESPONSE_FLAG) or response[1] != self.seq:
+                continue
+            if response[2] != 0:
+                raise RuntimeError(STATUS_TEXT.get(response[2], "status %d" % response[2]))
+            return response[3:-4]
+
+
+def temp_stat(data):
+    centi, year, month, date, hours, minutes, seconds = struct.unpack("<h6B", data)
+    return "%02d-%02d-%02d %02d:%02d:%02d %.2f C" % (date, month, year, hours, minutes, seconds, centi / 100.0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=2.0)
+    parser.add_argument("--enter", action="store_true", help="select option 9 from the main menu first")
+    parser.add_argument("command", choices=["ping", "get-datetime", "set-datetime", "set-alarm", "calc",
+                                            "temp-start", "temp-stop", "temp-stats", "led", "sleep", "exit"])
+    parser.add_argument("args", nargs="*")
+    args = parser.parse_args()
+
+    client = ProtoClient(args.port, args.baud, args.timeout)
+    if args.enter:
+        client.enter()
+
+    cmd = args.command
+    if cmd == "ping":
+        print("protocol version %d" % client.request(PING)[0])
+    elif cmd == "get-datetime":
+        year, month, date, weekday, hours, minutes, seconds = client.request(GET_DATETIME)
+        print("%02d-%02d-%02d (weekday %d) %02d:%02d:%02d" % (date, month, year, weekday, hours, minutes, seconds))
+    elif cmd == "set-datetime":
+        client.request(SET_DATETIME, bytes(int(a) for a in args.args))
+    elif cmd == "set-alarm":
+        client.request(SET_ALARM, bytes(int(a) for a in args.args))
+    elif cmd == "calc":
+        first, second, operator = args.args
+        result = client.request(CALC, struct.pack("<ii", int(first), int(second)) + operator.encode())
+        print(struct.unpack("<i", result)[0])
+    elif cmd == "temp-start":
+        client.request(TEMP_START)
+    elif cmd == "temp-stop":
+        client.request(TEMP_STOP)
+    elif cmd == "temp-stats":
+        data = client.request(TEMP_STATS)
+        print("running" if data[0] else "stopped")
+        for name, offset in (("current", 1), ("highest", 9), ("lowest", 17)):
+            print("%-8s %s" % (name, temp_stat(data[offset:offset + 8])))
+    elif cmd == "led":
+        client.request(LED, bytes([1 if args.args and args.args[0] in ("1", "on") else 0]))
+    elif cmd == "sleep":
+        client.request(SLEEP)
+    elif cmd == "exit":
+        client.request(EXIT)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
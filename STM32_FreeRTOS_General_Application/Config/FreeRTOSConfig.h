@@ -50,13 +50,15 @@
 extern uint32_t SystemCoreClock;
 
 #define configUSE_PREEMPTION			1 // Set to 0 for co-operative scheduler, 1 for pre-emptive scheduler
-#define configUSE_IDLE_HOOK				1
+#define configUSE_IDLE_HOOK				0
 #define configUSE_TICK_HOOK				0
+#define configUSE_TICKLESS_IDLE			1		// STOP mode while the application sleeps, sleep mode otherwise (lowpower.c)
 #define configCPU_CLOCK_HZ				( SystemCoreClock )
 #define configTICK_RATE_HZ				( ( TickType_t ) 1000 )	// 1000 ticks per second
 #define configMAX_PRIORITIES			( 5 )
 #define configMINIMAL_STACK_SIZE		( ( unsigned short ) 130 )
-#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 75 * 1024 ) )
+#define configSUPPORT_STATIC_ALLOCATION	1
+#define configSUPPORT_DYNAMIC_ALLOCATION	0
 #define configMAX_TASK_NAME_LEN			( 10 )
 #define configUSE_TRACE_FACILITY		1
 #define configUSE_16_BIT_TICKS			0
@@ -68,7 +70,20 @@ extern uint32_t SystemCoreClock;
 #define configUSE_MALLOC_FAILED_HOOK	0
 #define configUSE_APPLICATION_TASK_TAG	0
 #define configUSE_COUNTING_SEMAPHORES	1
-#define configGENERATE_RUN_TIME_STATS	0
+#define configGENERATE_RUN_TIME_STATS	1
+
+/* Run time statistics are counted in microseconds by TIM2 (see main.c). The
+counter wraps after about 71 minutes, which skews the figures once. */
+extern void vRunTimeCounterSetup( void );
+extern unsigned long ulRunTimeCounterGet( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	vRunTimeCounterSetup()
+#define portGET_RUN_TIME_COUNTER_VALUE()			ulRunTimeCounterGet()
+
+/* The idle task stops the tick and enters STOP mode, woken by the RTC wakeup
+timer or the USART2 RX pin (see lowpower.c). TIM2 stops in STOP mode, so the
+time slept is not counted in the run time statistics. */
+extern void vLowPowerSuppressTicksAndSleep( uint32_t xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )	vLowPowerSuppressTicksAndSleep( xExpectedIdleTime )
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 		0
@@ -89,6 +104,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			1
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_xTimerPendFunctionCall	1		// Needed by xEventGroupClearBitsFromISR()
 
 //For SEGGER SystemView
 #define INCLUDE_xTaskGetIdleTaskHandle	1
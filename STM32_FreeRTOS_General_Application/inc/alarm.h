@@ -0,0 +1,79 @@
+/**
+  ******************************************************************************
+  * @file    alarm.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Alarm scheduler. Any number of one-shot and recurring alarms, up
+  * 		 to ALARM_MAX_ALARMS, share RTC Alarm A. The alarms are kept in a
+  * 		 min-heap ordered by their next fire time and only the earliest
+  * 		 one is programmed into the RTC. Adding, removing and firing an
+  * 		 alarm cost O(log n).
+  *
+  * 		 Times are counted in 32-bit Unix time (see calendar.h). The
+  * 		 application programs the RTC through vAlarmPortProgram() and
+  * 		 vAlarmPortDisable(), and calls vAlarmFireFromISR() from the RTC
+  * 		 Alarm interrupt.
+  ******************************************************************************
+*/
+
+#ifndef ALARM_H
+#define ALARM_H
+
+// INCLUDES
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+// CONSTANTS
+
+// Maximum number of alarms set at once
+#ifndef ALARM_MAX_ALARMS
+#define ALARM_MAX_ALARMS			32
+#endif
+
+// ID returned when no alarm could be added
+#define ALARM_NONE					( -1 )
+
+// Period of a daily alarm, in seconds
+#define ALARM_PERIOD_DAILY			86400UL
+
+// TYPES
+
+// ID of an alarm. It is reused once the alarm is removed or has fired for the last time
+typedef int32_t AlarmId_t;
+
+// Called from the RTC Alarm interrupt each time an alarm fires. It may only use
+// the FromISR APIs, and sets *pxHigherPriorityTaskWoken if it wakes a task
+typedef void (*AlarmCallback_t)(AlarmId_t xId, void* pvArg, BaseType_t* pxHigherPriorityTaskWoken);
+
+// FUNCTION PROTOTYPES
+
+// To empty the scheduler, before the scheduler is started
+void vAlarmInit(void);
+
+// To add an alarm firing at ulTime, then every ulPeriod seconds if ulPeriod is not 0
+AlarmId_t xAlarmAdd(uint32_t ulTime, uint32_t ulPeriod, AlarmCallback_t pxCallback, void* pvArg);
+
+// To remove an alarm
+BaseType_t xAlarmRemove(AlarmId_t xId);
+
+// To read the next fire time and the period of an alarm
+BaseType_t xAlarmGet(AlarmId_t xId, uint32_t* pulTime, uint32_t* pulPeriod);
+
+// To get the number of alarms set
+uint32_t ulAlarmCount(void);
+
+// To program the RTC again once its date or time was set
+void vAlarmRtcChanged(void);
+
+// To fire the alarms due at ulNow and program the next one, from the RTC Alarm interrupt
+void vAlarmFireFromISR(uint32_t ulNow, BaseType_t* pxHigherPriorityTaskWoken);
+
+// To program RTC Alarm A to fire at ulTime, implemented by the application
+void vAlarmPortProgram(uint32_t ulTime);
+
+// To turn RTC Alarm A off when no alarm is set, implemented by the application
+void vAlarmPortDisable(void);
+
+#endif /* ALARM_H */
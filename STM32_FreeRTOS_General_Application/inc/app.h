@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    app.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Run-to-completion executor for the sub-applications. Each
+  * 		 sub-application is a state machine whose states are functions
+  * 		 taking an event: entering the state, a line of input, or the
+  * 		 timeout of the state expiring. All of them run in the App task
+  * 		 and share its stack, one event at a time. Tasks of the other
+  * 		 console sessions take the App lock to run commands in between
+  * 		 the events.
+  ******************************************************************************
+*/
+
+#ifndef APP_H
+#define APP_H
+
+// INCLUDES
+
+#include <stddef.h>
+#include "FreeRTOS.h"
+
+// CONSTANTS
+
+// Priority of the App task
+#define APP_TASK_PRIORITY			1
+
+// Stack of the App task in words, shared by all the sub-applications
+#define APP_TASK_STACK_SIZE			500
+
+// TYPES
+
+// Types of event
+typedef enum
+{
+	eAppEnter = 0,			// The state has just been entered
+	eAppLine,				// A line, or a chunk of bytes in raw mode, was received
+	eAppTimeout				// Nothing was received within the timeout of the state
+} AppEventType_t;
+
+// An event
+typedef struct
+{
+	AppEventType_t eType;	// Type of event
+	char* pcLine;			// eAppLine: the NUL terminated line, which may be changed
+	size_t xLen;			// eAppLine: the number of bytes received
+} AppEvent_t;
+
+// A state. It handles an event and returns without waiting
+typedef void (*AppState_t)(const AppEvent_t* pxEvent);
+
+// FUNCTION PROTOTYPES
+
+// To create the App lock
+BaseType_t xAppInit(void);
+
+// Task handler of the App task
+void vAppTaskFunction(void *pvParam);
+
+// To move to a state once the current event is handled
+void vAppSetState(AppState_t pxState);
+
+// To set the time the current state waits for input before getting eAppTimeout
+void vAppSetTimeout(TickType_t xTimeout);
+
+// To get the state being run
+AppState_t pxAppGetState(void);
+
+// To wait till no event is being handled by the App task and keep it waiting
+void vAppLock(void);
+
+// To let the App task handle events again
+void vAppUnlock(void);
+
+#endif /* APP_H */
@@ -0,0 +1,35 @@
+/**
+  ******************************************************************************
+  * @file    calc.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Arithmetic of the calculator, shared by the calculator menu and
+  * 		 the binary protocol. It has no state and no hardware access.
+  ******************************************************************************
+*/
+
+#ifndef CALC_H
+#define CALC_H
+
+// INCLUDES
+
+#include <stdint.h>
+
+// TYPES
+
+// Outcome of a calculation
+typedef enum
+{
+	eCalcOk = 0,			// The result is valid
+	eCalcDivByZero,			// Division by zero
+	eCalcBadOperator,		// The operator is not one of + - * /
+	eCalcOutOfRange			// The result does not fit in an int32
+} CalcStatus_t;
+
+// FUNCTION PROTOTYPES
+
+// To apply an operator to two integers
+CalcStatus_t xCalcApply(int32_t lFirstNum, char cOperator, int32_t lSecondNum, int32_t* plResult);
+
+#endif /* CALC_H */
@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    calendar.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Calendar of the Gregorian dates. Dates and times are counted as
+  * 		 32-bit Unix time, the seconds since 1970-01-01 00:00:00, which
+  * 		 holds every date up to 2106 and so every date of the RTC (2000 to
+  * 		 2099). The conversions to and from the RTC fields take the same
+  * 		 time whatever the date: they have no loops and no table lookups,
+  * 		 only a few divisions by constants.
+  ******************************************************************************
+*/
+
+#ifndef CALENDAR_H
+#define CALENDAR_H
+
+// INCLUDES
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "stm32f4xx.h"
+
+// CONSTANTS
+
+// Seconds in a day
+#define CALENDAR_SECONDS_PER_DAY	86400UL
+
+// First and last years the RTC can hold, as 00 to 99
+#define CALENDAR_RTC_FIRST_YEAR		2000
+#define CALENDAR_RTC_LAST_YEAR		2099
+
+// To convert a packed BCD field of an RTC register to binary
+#define CALENDAR_BCD_TO_BIN(x)		( ( ( (x) >> 4 ) * 10 ) + ( (x) & 0x0F ) )
+
+// TYPES
+
+// A duration split into days, hours, minutes and seconds
+typedef struct
+{
+	uint32_t ulDays;
+	uint32_t ulHours;
+	uint32_t ulMinutes;
+	uint32_t ulSeconds;
+} CalendarDuration_t;
+
+// FUNCTION PROTOTYPES
+
+// To check whether a year is a leap year
+BaseType_t xCalendarIsLeapYear(uint32_t ulYear);
+
+// To get the number of days of a month
+uint32_t ulCalendarDaysInMonth(uint32_t ulYear, uint32_t ulMonth);
+
+// To check whether a date exists and can be held by the RTC
+BaseType_t xCalendarIsValidDate(uint32_t ulYear, uint32_t ulMonth, uint32_t ulDay);
+
+// To convert a date to days since 1970-01-01
+uint32_t ulCalendarDaysFromDate(uint32_t ulYear, uint32_t ulMonth, uint32_t ulDay);
+
+// To convert days since 1970-01-01 to a date
+void vCalendarDateFromDays(uint32_t ulDays, uint32_t* pulYear, uint32_t* pulMonth, uint32_t* pulDay);
+
+// To get the day of the week of a date, as held by the RTC (Monday 1 to Sunday 7)
+uint8_t ucCalendarWeekDay(uint32_t ulYear, uint32_t ulMonth, uint32_t ulDay);
+
+// To get the day of the year of a date, 1 to 366
+uint32_t ulCalendarDayOfYear(uint32_t ulYear, uint32_t ulMonth, uint32_t ulDay);
+
+// To convert an RTC date and time to Unix time
+uint32_t ulCalendarFromRtc(const RTC_DateTypeDef* pxDate, const RTC_TimeTypeDef* pxTime);
+
+// To convert Unix time to an RTC date and time, the day of the week included
+void vCalendarToRtc(uint32_t ulTime, RTC_DateTypeDef* pxDate, RTC_TimeTypeDef* pxTime);
+
+// To split a duration in seconds into days, hours, minutes and seconds
+void vCalendarSplitDuration(uint32_t ulSeconds, CalendarDuration_t* pxDuration);
+
+#endif /* CALENDAR_H */
@@ -0,0 +1,104 @@
+/**
+  ******************************************************************************
+  * @file    cmd.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Menu command dispatch. The commands are declared in commands.def
+  * 		 and built into a constant table. A line typed by the user is
+  * 		 split into a command and an optional argument, the command is
+  * 		 looked up with a perfect hash and its handler is called. The menu
+  * 		 text is generated from the same declarations. A script of several
+  * 		 commands separated by ';' can be run in one go with one status
+  * 		 line per command instead of prompts.
+  ******************************************************************************
+*/
+
+#ifndef CMD_H
+#define CMD_H
+
+// INCLUDES
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+// TYPES
+
+// Menus
+#define MENU( id, title, prompt )	eCmdMenu##id,
+#define CMD( menu, key, name, aliases, arg, handler, text )
+typedef enum
+{
+#include "commands.def"
+	eCmdNumMenus
+} CmdMenu_t;
+#undef MENU
+#undef CMD
+
+// Types of the optional argument of a command
+typedef enum
+{
+	eCmdArgNone = 0,		// No argument given, or none accepted
+	eCmdArgInt,				// A decimal integer
+	eCmdArgWord				// Any text
+} CmdArgType_t;
+
+// Argument passed to a handler
+typedef struct
+{
+	CmdArgType_t eType;		// eCmdArgNone if the user gave no argument
+	int32_t lInt;			// Value of an eCmdArgInt argument
+	const char* pcWord;		// Text of an eCmdArgWord argument
+} CmdArg_t;
+
+// Results of running a command
+typedef enum
+{
+	eCmdOk = 0,				// The handler succeeded
+	eCmdUnknown,			// No command of the menu has that key, name or alias
+	eCmdBadNumber,			// The command takes a number and something else was given
+	eCmdNoArgument,			// An argument was given to a command taking none
+	eCmdFailed				// The handler rejected the argument or failed
+} CmdStatus_t;
+
+// Handler of a command. It may set *pxQuit to leave the current sub-application.
+// It returns pdPASS, or pdFAIL if the argument is rejected or the action failed
+typedef BaseType_t (*CmdHandler_t)(const CmdArg_t* pxArg, BaseType_t* pxQuit);
+
+// A command
+typedef struct
+{
+	uint8_t ucMenu;				// Menu the command belongs to (CmdMenu_t)
+	uint8_t ucArgType;			// Type of argument accepted (CmdArgType_t)
+	const char* pcKey;			// Key shown in the menu
+	const char* pcName;			// Name
+	const char* pcAliases;		// Other names, space separated
+	CmdHandler_t pxHandler;		// Handler
+} Cmd_t;
+
+// FUNCTION PROTOTYPES
+
+// Handlers, implemented by the application
+#define MENU( id, title, prompt )
+#define CMD( menu, key, name, aliases, arg, handler, text )	BaseType_t handler(const CmdArg_t* pxArg, BaseType_t* pxQuit);
+#include "commands.def"
+#undef MENU
+#undef CMD
+
+// To post the text of a menu to the console
+void vCmdPostMenu(CmdMenu_t eMenu);
+
+// To find a command of a menu by its key, name or alias
+const Cmd_t* pxCmdFind(CmdMenu_t eMenu, const char* pcToken, size_t xLen);
+
+// To run a command without posting anything
+CmdStatus_t xCmdExecute(CmdMenu_t eMenu, char* pcLine, const Cmd_t** ppxCmd, BaseType_t* pxQuit);
+
+// To run the command typed by the user
+BaseType_t xCmdDispatch(CmdMenu_t eMenu, char* pcLine, BaseType_t* pxQuit);
+
+// To run the commands of a script, separated by ';', and post a status line for each
+BaseType_t xCmdRunScript(CmdMenu_t eMenu, char* pcScript, BaseType_t* pxQuit);
+
+#endif /* CMD_H */
@@ -0,0 +1,220 @@
+/**
+  ******************************************************************************
+  * @file    commands_gen.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Generated by Tools/gen_commands.py from commands.def. Do not edit.
+  * 		 Holds the perfect hash table of the command tokens and the text of
+  * 		 each menu. Included by cmd.c only.
+  ******************************************************************************
+*/
+
+#ifndef COMMANDS_GEN_H
+#define COMMANDS_GEN_H
+
+// CONSTANTS
+
+#define CMD_NUM_COMMANDS			29
+#define CMD_HASH_SEED				0x0000024BUL
+#define CMD_HASH_BITS				9
+
+// GLOBALS
+
+// Command tokens
+static const CmdKey_t xCmdKeys[66] =
+{
+	{ eCmdMenuMain, 0, 1, "1" },
+	{ eCmdMenuMain, 0, 5, "clock" },
+	{ eCmdMenuMain, 0, 4, "time" },
+	{ eCmdMenuMain, 0, 5, "alarm" },
+	{ eCmdMenuMain, 1, 1, "2" },
+	{ eCmdMenuMain, 1, 4, "game" },
+	{ eCmdMenuMain, 1, 5, "guess" },
+	{ eCmdMenuMain, 2, 1, "3" },
+	{ eCmdMenuMain, 2, 4, "calc" },
+	{ eCmdMenuMain, 2, 10, "calculator" },
+	{ eCmdMenuMain, 3, 1, "4" },
+	{ eCmdMenuMain, 3, 4, "temp" },
+	{ eCmdMenuMain, 3, 11, "temperature" },
+	{ eCmdMenuMain, 4, 1, "5" },
+	{ eCmdMenuMain, 4, 3, "led" },
+	{ eCmdMenuMain, 5, 1, "6" },
+	{ eCmdMenuMain, 5, 5, "sleep" },
+	{ eCmdMenuMain, 6, 1, "7" },
+	{ eCmdMenuMain, 6, 4, "baud" },
+	{ eCmdMenuMain, 7, 1, "8" },
+	{ eCmdMenuMain, 7, 5, "stats" },
+	{ eCmdMenuMain, 8, 1, "9" },
+	{ eCmdMenuMain, 8, 5, "proto" },
+	{ eCmdMenuMain, 8, 6, "binary" },
+	{ eCmdMenuMain, 9, 2, "10" },
+	{ eCmdMenuMain, 9, 6, "script" },
+	{ eCmdMenuMain, 9, 5, "batch" },
+	{ eCmdMenuClock, 10, 1, "1" },
+	{ eCmdMenuClock, 10, 4, "show" },
+	{ eCmdMenuClock, 10, 7, "display" },
+	{ eCmdMenuClock, 11, 1, "2" },
+	{ eCmdMenuClock, 11, 3, "set" },
+	{ eCmdMenuClock, 12, 1, "3" },
+	{ eCmdMenuClock, 12, 5, "alarm" },
+	{ eCmdMenuClock, 13, 1, "4" },
+	{ eCmdMenuClock, 13, 4, "quit" },
+	{ eCmdMenuClock, 13, 4, "exit" },
+	{ eCmdMenuTemp, 14, 1, "1" },
+	{ eCmdMenuTemp, 14, 5, "start" },
+	{ eCmdMenuTemp, 15, 1, "2" },
+	{ eCmdMenuTemp, 15, 4, "show" },
+	{ eCmdMenuTemp, 15, 5, "stats" },
+	{ eCmdMenuTemp, 16, 1, "3" },
+	{ eCmdMenuTemp, 16, 4, "stop" },
+	{ eCmdMenuLed, 17, 1, "y" },
+	{ eCmdMenuLed, 17, 2, "on" },
+	{ eCmdMenuLed, 17, 5, "start" },
+	{ eCmdMenuLed, 18, 1, "n" },
+	{ eCmdMenuLed, 18, 3, "off" },
+	{ eCmdMenuLed, 18, 4, "stop" },
+	{ eCmdMenuScript, 19, 4, "date" },
+	{ eCmdMenuScript, 20, 4, "time" },
+	{ eCmdMenuScript, 21, 5, "alarm" },
+	{ eCmdMenuScript, 22, 6, "alarms" },
+	{ eCmdMenuScript, 23, 4, "temp" },
+	{ eCmdMenuScript, 23, 11, "temperature" },
+	{ eCmdMenuScript, 24, 3, "led" },
+	{ eCmdMenuScript, 25, 4, "show" },
+	{ eCmdMenuScript, 25, 7, "display" },
+	{ eCmdMenuScript, 26, 5, "stats" },
+	{ eCmdMenuScript, 27, 4, "help" },
+	{ eCmdMenuScript, 27, 1, "?" },
+	{ eCmdMenuScript, 28, 3, "end" },
+	{ eCmdMenuScript, 28, 4, "quit" },
+	{ eCmdMenuScript, 28, 4, "exit" },
+	{ eCmdMenuScript, 28, 1, "q" },
+};
+
+// Index of the token in xCmdKeys plus one, by slot. 0 if the slot is empty
+static const uint8_t ucCmdHashSlots[1 << CMD_HASH_BITS] =
+{
+	[11] = 7,
+	[24] = 61,
+	[25] = 3,
+	[39] = 59,
+	[50] = 51,
+	[59] = 26,
+	[72] = 49,
+	[109] = 1,
+	[113] = 8,
+	[115] = 5,
+	[117] = 14,
+	[119] = 11,
+	[120] = 15,
+	[121] = 18,
+	[122] = 10,
+	[123] = 16,
+	[125] = 22,
+	[127] = 20,
+	[133] = 65,
+	[136] = 19,
+	[146] = 56,
+	[168] = 52,
+	[201] = 55,
+	[202] = 25,
+	[207] = 54,
+	[211] = 27,
+	[213] = 37,
+	[220] = 4,
+	[221] = 64,
+	[224] = 34,
+	[247] = 30,
+	[253] = 45,
+	[256] = 2,
+	[284] = 32,
+	[285] = 66,
+	[287] = 36,
+	[291] = 13,
+	[295] = 48,
+	[302] = 63,
+	[305] = 24,
+	[313] = 57,
+	[317] = 23,
+	[342] = 17,
+	[344] = 12,
+	[371] = 58,
+	[376] = 44,
+	[384] = 9,
+	[385] = 29,
+	[393] = 62,
+	[394] = 60,
+	[401] = 43,
+	[403] = 40,
+	[405] = 38,
+	[411] = 35,
+	[415] = 31,
+	[417] = 33,
+	[421] = 28,
+	[429] = 50,
+	[433] = 42,
+	[447] = 39,
+	[448] = 21,
+	[457] = 6,
+	[464] = 41,
+	[482] = 53,
+	[502] = 47,
+	[507] = 46,
+};
+
+// Menu text
+static const char* const pcCmdMenuText[eCmdNumMenus] =
+{
+	[eCmdMenuMain] =
+		"\r\n==============================================="
+		"\r\nThis is a general FreeRTOS Application"
+		"\r\nPress the letter Q (or q) and the return key"
+		"\r\nto return to the main menu below any time"
+		"\r\n=================MAIN MENU====================="
+		"\r\nSelect one of the sub-applications below to run"
+		"\r\nTime and Alarms [clock]                     ----> 1"
+		"\r\nGuess-A-Number Game [game]                  ----> 2"
+		"\r\nCalculator [calc]                           ----> 3"
+		"\r\nMonitor temperature [temp]                  ----> 4"
+		"\r\nToggle LED (on/off) [led]                   ----> 5"
+		"\r\nSleep in STOP mode till a key [sleep]       ----> 6"
+		"\r\nConsole baud rate (rate) [baud]             ----> 7"
+		"\r\nConsole, CPU and sleep statistics [stats]   ----> 8"
+		"\r\nBinary protocol mode (host scripts) [proto] ----> 9"
+		"\r\nScript mode (batch commands) [script]       ----> 10"
+		"\r\nType your option: ",
+	[eCmdMenuClock] =
+		"\r\n\nThis is a clock sub-application"
+		"\r\nDisplay date and time [show]                ----> 1"
+		"\r\nSet date and time [set]                     ----> 2"
+		"\r\nAdd a daily alarm [alarm]                   ----> 3"
+		"\r\nQuit application [quit]                     ----> 4"
+		"\r\nEnter your option here: ",
+	[eCmdMenuTemp] =
+		"\r\n\nThis is a temperature monitoring sub-application"
+		"\r\nStart temperature monitoring [start]        ----> 1"
+		"\r\nDisplay temperature statistics [show]       ----> 2"
+		"\r\nStop temperature monitoring [stop]          ----> 3"
+		"\r\nEnter your option here: ",
+	[eCmdMenuLed] =
+		"\r\nToggle the LED?"
+		"\r\nTo start toggling the LED press [on]        ----> y"
+		"\r\nTo stop toggling the LED press [off]        ----> n"
+		"\r\n",
+	[eCmdMenuScript] =
+		"\r\n\nScript commands, separated by ';'"
+		"\r\nSet the date (YYYY-MM-DD)                   ----> date"
+		"\r\nSet the time (HH:MM[:SS])                   ----> time"
+		"\r\nAdd a daily alarm (HH:MM[:SS]), in N s, or del ID----> alarm"
+		"\r\nList the alarms                             ----> alarms"
+		"\r\nTemperature monitor (start/stop/show)       ----> temp"
+		"\r\nToggle LED (on/off)                         ----> led"
+		"\r\nDisplay date and time                       ----> show"
+		"\r\nConsole, CPU and sleep statistics           ----> stats"
+		"\r\nList the script commands                    ----> help"
+		"\r\nLeave script mode                           ----> end"
+		"\r\n",
+};
+
+#endif /* COMMANDS_GEN_H */
@@ -0,0 +1,131 @@
+/**
+  ******************************************************************************
+  * @file    console.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Console output service. Tasks post messages which are copied into
+  * 		 a fixed-size output arena. The UART Write task transmits them in
+  * 		 order straight out of the arena and then releases the space.
+  * 		 Interrupt handlers post constant messages through a lock-free
+  * 		 ring which the UART Write task drains at task level. RTT channel
+  * 		 1, read through the debug probe, is a second link of the console
+  * 		 carrying its own session: the output of a task bound to it is
+  * 		 written there instead of UART2.
+  ******************************************************************************
+*/
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+// INCLUDES
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// CONSTANTS
+
+// Size in bytes of the output arena holding the messages waiting to be sent
+#define CONSOLE_ARENA_SIZE			2048
+
+// Maximum number of messages waiting to be sent
+#define CONSOLE_QUEUE_LENGTH		16
+
+// Set to 1 for the UART Write task to drain every queued message and send
+// adjacent ones with a single transfer, or 0 to send one message at a time
+#define CONSOLE_BATCH_WRITES		1
+
+// Number of messages interrupt handlers can have pending (must be a power of 2)
+#define CONSOLE_ISR_RING_SIZE		8
+
+// Size in bytes of the status line (see eConsoleStatus)
+#define CONSOLE_STATUS_SIZE			128
+
+// Number of producer tasks whose statistics are recorded
+#define CONSOLE_MAX_PRODUCERS		8
+
+// Number of tasks that can be bound to a link other than UART2
+#define CONSOLE_MAX_BINDINGS		4
+
+// RTT channel of the second console link. SystemView uses another channel
+#define CONSOLE_RTT_CHANNEL			1
+
+// Sizes in bytes of the RTT buffers of the console, to the host (up) and from it (down)
+#define CONSOLE_RTT_UP_SIZE			1024
+#define CONSOLE_RTT_DOWN_SIZE		64
+
+// Priority and stack in words of the UART Write task
+#define CONSOLE_TASK_PRIORITY		2
+#define CONSOLE_TASK_STACK_SIZE		500
+
+// TYPES
+
+// Links the console can be reached over
+typedef enum
+{
+	eConsoleLinkUart = 0,		// USART2, through the ST-LINK virtual COM port
+	eConsoleLinkRtt,			// RTT channel CONSOLE_RTT_CHANNEL, through the debug probe
+	eConsoleNumLinks
+} ConsoleLink_t;
+
+// What to do with a message when the console cannot take it right away
+typedef enum
+{
+	eConsoleBlock = 0,			// Wait till the UART Write task has freed enough space
+	eConsoleDropNewest,			// Drop the message being posted
+	eConsoleDropOldest,			// Drop the oldest queued messages to make room, or this one if that is not enough
+	eConsoleStatus				// Replace the status line if it has not been sent yet. Never waits
+} ConsolePolicy_t;
+
+// GLOBALS
+
+// Number of messages posted from interrupt handlers that were dropped
+extern volatile uint32_t ulIsrMsgsDropped;
+
+// FUNCTION PROTOTYPES
+
+// To create the output arena and the UART write queue
+BaseType_t xConsoleInit(void);
+
+// To send the output of a task to another link than UART2
+BaseType_t xConsoleBindLink(TaskHandle_t xTask, ConsoleLink_t eLink);
+
+// To get the link the output of the calling task is sent to
+ConsoleLink_t xConsoleGetLink(void);
+
+// Task handler of the UART Write task
+void vUartWriteTaskFunction(void *pvParam);
+
+// To copy a message into the output arena and queue it for transmission
+void vPostMsgToUartQueue(const char* pcUartMsg);
+
+// To post a message with the given policy
+void vConsolePost(const char* pcMsg, ConsolePolicy_t ePolicy);
+
+// To post a message of a given length, which may hold any byte, with the given policy
+void vConsoleWrite(const char* pcData, size_t xLen, ConsolePolicy_t ePolicy);
+
+// To post a message to a given link, e.g. on behalf of another task
+void vConsoleWriteToLink(ConsoleLink_t eLink, const char* pcData, size_t xLen, ConsolePolicy_t ePolicy);
+
+// To count a message the calling task dropped before it reached the console
+void vConsoleNoteDrop(void);
+
+// To print the console statistics
+void vConsoleReportStats(void);
+
+// To write straight to the RTT link without going through UART2, e.g. bulk dumps
+void vConsoleRttWrite(const char* pcData, size_t xLen);
+
+// To wait till every queued message has been transmitted
+void vConsoleFlush(void);
+
+// To switch UART2 to a new baud rate once the messages posted so far are transmitted
+BaseType_t xConsoleSetBaudRate(uint32_t ulBaudRate);
+
+// To queue a constant message for transmission from an interrupt handler
+void vPostMsgToUartQueueFromISR(const char* pcConstMsg, BaseType_t* pxHigherPriorityTaskWoken);
+
+#endif /* CONSOLE_H */
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    console_in.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Console input service. The Console Input task is the only task
+  * 		 reading UART2 and the RTT link. Each link carries a session with
+  * 		 its own focus. The received bytes of each link are assembled into
+  * 		 lines and each line is delivered to the queue of the client task
+  * 		 holding the focus of that link. A line starting with "@<name> "
+  * 		 is delivered to the client of that name instead, so background
+  * 		 tasks can take commands at any time from any session.
+  ******************************************************************************
+*/
+
+#ifndef CONSOLE_IN_H
+#define CONSOLE_IN_H
+
+// INCLUDES
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+#include "console.h"
+
+// CONSTANTS
+
+// Largest number of characters in a line, enough for a script of a few
+// commands. Longer lines are cut
+#define CONSOLE_IN_LINE_SIZE		96
+
+// Number of lines a client can have waiting to be read
+#define CONSOLE_IN_QUEUE_LENGTH		4
+
+// Largest number of clients. The line queue of each one is allocated statically
+#define CONSOLE_IN_MAX_CLIENTS		4
+
+// Priority of the Console Input task. It must be above the clients so each
+// byte is taken as soon as it is received
+#define CONSOLE_IN_TASK_PRIORITY	2
+
+// Stack of the Console Input task in words
+#define CONSOLE_IN_TASK_STACK_SIZE	250
+
+// Period the RTT link is polled at while a debugger is attached. The debug
+// probe writes the RTT down buffer without raising any interrupt
+#define CONSOLE_IN_RTT_POLL_MS		20
+
+// GLOBALS
+
+// Number of lines dropped because the client queue was full or no client had the focus
+extern volatile uint32_t ulConsoleInLinesDropped;
+
+// FUNCTION PROTOTYPES
+
+// Task handler of the Console Input task
+void vConsoleInTaskFunction(void *pvParam);
+
+// To register a task as a client of the console input
+BaseType_t xConsoleInRegister(TaskHandle_t xTask, const char* pcName);
+
+// To set bits of an event group whenever a line is queued for a client
+void vConsoleInSetEvent(TaskHandle_t xTask, EventGroupHandle_t xEvents, EventBits_t uxBits);
+
+// To give the focus of a link to a client
+void vConsoleInSetFocus(ConsoleLink_t eLink, TaskHandle_t xTask);
+
+// To receive the next line sent to the calling task, and the link it was typed on
+BaseType_t xConsoleInRead(char* pcLine, size_t xSize, size_t* pxLen, ConsoleLink_t* pxLink, TickType_t xTimeout);
+
+// To receive the bytes as they arrive instead of lines (pdTRUE) or go back to lines (pdFALSE)
+void vConsoleInSetRaw(BaseType_t xRaw);
+
+// To discard the lines waiting for the calling task and any partly typed line
+void vConsoleInDiscard(void);
+
+// To start polling the RTT link once a debugger is attached, from a periodic ISR
+void vConsoleInCheckDebuggerFromISR(BaseType_t* pxHigherPriorityTaskWoken);
+
+#endif /* CONSOLE_IN_H */
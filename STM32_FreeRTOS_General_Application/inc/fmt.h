@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file    fmt.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Small reentrant text formatter replacing newlib sprintf. It covers
+  * 		 the conversions this application prints: zero padded fields such
+  * 		 as %02d, 32 and 64-bit integers, hexadecimal, characters, strings
+  * 		 and fixed-point decimals. It uses no heap and only a few dozen
+  * 		 bytes of stack.
+  ******************************************************************************
+*/
+
+#ifndef FMT_H
+#define FMT_H
+
+// INCLUDES
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// FUNCTION PROTOTYPES
+
+// To format text into a buffer. Same calling convention as snprintf, and the
+// format string is checked by the compiler against the arguments
+size_t xFmtSnprintf(char* pcOut, size_t xSize, const char* pcFmt, ...) __attribute__((format(printf, 3, 4)));
+
+// To format text into a buffer using a variable argument list
+size_t xFmtVsnprintf(char* pcOut, size_t xSize, const char* pcFmt, va_list xArgs);
+
+// To format a fixed-point decimal (e.g. 2345 with 2 decimals gives "23.45")
+size_t xFmtFixed(char* pcOut, size_t xSize, int32_t lScaled, uint8_t ucDecimals);
+
+#endif /* FMT_H */
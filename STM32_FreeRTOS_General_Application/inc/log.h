@@ -0,0 +1,91 @@
+/**
+  ******************************************************************************
+  * @file    log.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Deferred binary logging. Tasks post a format ID and the raw values
+  * 		 to print as a compact record. The Log task renders the text from a
+  * 		 constant format table and posts it to the console, so producers do
+  * 		 not format anything themselves.
+  ******************************************************************************
+*/
+
+#ifndef LOG_H
+#define LOG_H
+
+// INCLUDES
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "console.h"
+
+// CONSTANTS
+
+// Maximum number of values carried by one record
+#define LOG_MAX_ARGS				8
+
+// Maximum number of records waiting to be rendered
+#define LOG_QUEUE_LENGTH			16
+
+// Priority of the Log task. It must be above the priority of the tasks posting
+// records so their rendered text is queued before anything they post next
+#define LOG_TASK_PRIORITY			2
+
+// Stack of the Log task in words
+#define LOG_TASK_STACK_SIZE			500
+
+// Initializers for the values of a record
+#define LOG_INT(x)					{ .lInt = (int32_t)(x) }
+#define LOG_FLOAT(x)				{ .fFloat = (float)(x) }
+
+// TYPES
+
+// IDs of the formats known to the Log task
+typedef enum
+{
+	eLogTempCurrent = 0,		// Date, time and current temperature
+	eLogTempHighest,			// Date, time and highest temperature
+	eLogTempLowest,				// Date, time and lowest temperature
+	eLogDateTime,				// Current time and date
+	eLogCalcResult,				// Calculator result
+	eLogGameWon,				// Number of guesses it took to win the game
+	eLogBaudRate,				// Current and highest console baud rates
+	eLogNumFormats
+} LogId_t;
+
+// One value of a record. Its type is given by the matching conversion in the format
+typedef union
+{
+	int32_t lInt;
+	float fFloat;
+} LogArg_t;
+
+// Record posted to the Log task
+typedef struct
+{
+	uint8_t ucId;						// Format ID (LogId_t)
+	uint8_t ucNumArgs;					// Number of values used in xArgs
+	uint8_t ucPolicy;					// Console policy of the rendered text (ConsolePolicy_t)
+	uint8_t ucLink;						// Console link of the posting task (ConsoleLink_t)
+	LogArg_t xArgs[LOG_MAX_ARGS];		// Raw values to print
+} LogRecord_t;
+
+// FUNCTION PROTOTYPES
+
+// To create the log queue
+BaseType_t xLogInit(void);
+
+// Task handler of the Log task
+void vLogTaskFunction(void *pvParam);
+
+// To post a record to the Log task
+void vLogPost(LogId_t eId, const LogArg_t* pxArgs, uint8_t ucNumArgs);
+
+// To post a record to the Log task with the given console policy
+void vLogPostWithPolicy(LogId_t eId, const LogArg_t* pxArgs, uint8_t ucNumArgs, ConsolePolicy_t ePolicy);
+
+// To post a record to the Log task, to be printed on the given console link
+void vLogPostToLink(LogId_t eId, const LogArg_t* pxArgs, uint8_t ucNumArgs, ConsolePolicy_t ePolicy, ConsoleLink_t eLink);
+
+#endif /* LOG_H */
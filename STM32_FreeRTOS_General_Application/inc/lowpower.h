@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    lowpower.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Tickless idle. While the application sleeps, the idle task stops
+  * 		 the tick and puts the MCU in STOP mode till the next task is due.
+  * 		 The RTC wakeup timer wakes it up in time, and a falling edge on
+  * 		 the USART2 RX pin (PA3) wakes it up on input. The time slept is
+  * 		 measured with the RTC and added to the tick count. Otherwise the
+  * 		 idle task waits in sleep mode, with SysTick counting the idle
+  * 		 time instead of interrupting every tick.
+  ******************************************************************************
+*/
+
+#ifndef LOWPOWER_H
+#define LOWPOWER_H
+
+// INCLUDES
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+// TYPES
+
+// Statistics of the tickless idle
+typedef struct
+{
+	uint32_t ulStops;				// Times STOP mode was entered
+	uint32_t ulRxWakes;				// Times input on the USART2 RX pin ended STOP mode
+	uint32_t ulTicksSlept;			// Ticks added to the tick count after STOP mode
+	uint32_t ulLongestTicks;		// Most ticks added after a single STOP period
+	uint32_t ulPendingUs;			// Time slept not added to the tick count yet, in microseconds
+	int32_t lTickDriftUs;			// Tick count minus the time counted by the RTC since start, in microseconds
+} LowPowerStats_t;
+
+// FUNCTION PROTOTYPES
+
+// To set up the wakeup on the USART2 RX pin, once UART2 and the RTC are set up
+void vLowPowerInit(void);
+
+// To sleep in STOP or sleep mode without the tick, called through portSUPPRESS_TICKS_AND_SLEEP()
+void vLowPowerSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+
+// To get the statistics of the tickless idle
+void vLowPowerGetStats(LowPowerStats_t* pxStats);
+
+// To check whether STOP mode is allowed, implemented by the application
+BaseType_t xLowPowerPortAllowed(void);
+
+// To handle input on the USART2 RX pin during STOP mode, implemented by the application
+void vLowPowerPortRxWakeFromISR(void);
+
+#endif /* LOWPOWER_H */
@@ -0,0 +1,97 @@
+/**
+  ******************************************************************************
+  * @file    proto.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Binary request/response protocol over the USART2 console, meant
+  * 		 for host scripts. Each packet is COBS encoded and sent between
+  * 		 two 0x00 delimiters, so the text output of the application can
+  * 		 never be taken for a packet.
+  *
+  * 		 Decoded request:  type, seq, payload..., CRC-32 (4 bytes)
+  * 		 Decoded response: type | 0x80, seq, status, payload..., CRC-32
+  *
+  * 		 Multi-byte fields are little-endian. The CRC is computed by the
+  * 		 STM32 CRC unit (polynomial 0x04C11DB7, initial value 0xFFFFFFFF,
+  * 		 no reflection, no final XOR) over the packet bytes read as
+  * 		 little-endian 32-bit words, the last word padded with zeros.
+  ******************************************************************************
+*/
+
+#ifndef PROTO_H
+#define PROTO_H
+
+// INCLUDES
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+// CONSTANTS
+
+// Protocol version returned by PROTO_PING
+#define PROTO_VERSION				1
+
+// Largest payload of a request or a response
+#define PROTO_MAX_PAYLOAD			64
+
+// The protocol mode is left if nothing is received for this long
+#define PROTO_IDLE_TIMEOUT_MS		60000
+
+// Request types. The response to a request has the same type with bit 7 set
+#define PROTO_RESPONSE_FLAG			0x80
+#define PROTO_PING					0x01	// -> version
+#define PROTO_GET_DATETIME			0x10	// -> year, month, date, weekday, hours, minutes, seconds
+#define PROTO_SET_DATETIME			0x11	// year, month, date, weekday (not used), hours, minutes, seconds ->
+#define PROTO_SET_ALARM				0x12	// hours, minutes, seconds ->
+#define PROTO_CALC					0x20	// int32 first, int32 second, operator (+ - * /) -> int32 result
+#define PROTO_TEMP_START			0x30	// ->
+#define PROTO_TEMP_STOP				0x31	// ->
+#define PROTO_TEMP_STATS			0x32	// -> running, then current, highest and lowest as
+											//    int16 centi-degrees, year, month, date, hours, minutes, seconds
+#define PROTO_LED					0x40	// 1 to start toggling the LED, 0 to stop ->
+#define PROTO_SLEEP					0x50	// -> (sent before going to sleep, wake up with any byte)
+#define PROTO_EXIT					0x7F	// -> (then back to the main menu)
+
+// Response status codes
+#define PROTO_OK					0
+#define PROTO_ERR_UNKNOWN			1		// Unknown request type
+#define PROTO_ERR_LENGTH			2		// Wrong payload length
+#define PROTO_ERR_VALUE				3		// Value out of range
+#define PROTO_ERR_STATE				4		// Not possible in the current state
+
+// TYPES
+
+// Decoded request
+typedef struct
+{
+	uint8_t ucType;							// Request type
+	uint8_t ucSeq;							// Sequence number, echoed in the response
+	uint8_t ucLen;							// Payload length
+	uint8_t ucPayload[PROTO_MAX_PAYLOAD];	// Payload
+} ProtoFrame_t;
+
+// Handler of the requests. It must answer each request with vProtoReply()
+typedef void (*ProtoHandler_t)(const ProtoFrame_t* pxReq);
+
+// GLOBALS
+
+// Number of packets dropped because of a bad encoding, length or CRC
+extern volatile uint32_t ulProtoFramesDropped;
+
+// FUNCTION PROTOTYPES
+
+// To enter the protocol mode
+void vProtoBegin(void);
+
+// To decode the bytes received and pass the requests to the handler, till PROTO_EXIT
+BaseType_t xProtoFeed(const char* pcChunk, size_t xLen, ProtoHandler_t pxHandler);
+
+// To leave the protocol mode
+void vProtoEnd(void);
+
+// To send the response to a request
+void vProtoReply(const ProtoFrame_t* pxReq, uint8_t ucStatus, const uint8_t* pucPayload, size_t xLen);
+
+#endif /* PROTO_H */
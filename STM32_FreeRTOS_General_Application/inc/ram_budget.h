@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+  * @file    ram_budget.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   RAM budget of the application. Every task, queue, semaphore and
+  * 		 timer is allocated statically (there is no FreeRTOS heap), so the
+  * 		 RAM used is known once the application is linked. Each module
+  * 		 checks at build time that its objects fit the budget below, and
+  * 		 the budgets are checked against the RAM of the STM32F446RE.
+  * 		 Tools/ram_map.py lists the RAM used by each object of the linked
+  * 		 application and compares it with these budgets.
+  ******************************************************************************
+*/
+
+#ifndef RAM_BUDGET_H
+#define RAM_BUDGET_H
+
+// CONSTANTS
+
+// RAM of the STM32F446RE (see LinkerScript.ld)
+#define RAM_SIZE					( 128 * 1024 )
+
+// RAM kept for the main stack, used by main() and the interrupt handlers (_Min_Stack_Size)
+#define RAM_MAIN_STACK				0x400
+
+// RAM kept for the objects not listed below, e.g. SEGGER SystemView and the drivers
+#define RAM_OTHERS					( 16 * 1024 )
+
+// Budgets of the objects allocated by each module, in bytes
+#define RAM_BUDGET_KERNEL			2048		// Idle and Timer Service tasks (main.c)
+#define RAM_BUDGET_TASKS			12288		// Application tasks and the LED timer (main.c)
+#define RAM_BUDGET_CONTROL			256			// Control event group and temperature mailbox (main.c)
+#define RAM_BUDGET_CONSOLE			4096		// UART write queue, arena locks, output arena and RTT buffers (console.c)
+#define RAM_BUDGET_CONSOLE_IN		2048		// Line queues of the input clients (console_in.c)
+#define RAM_BUDGET_LOG				1024		// Log queue (log.c)
+#define RAM_BUDGET_APP				128			// App lock (app.c)
+#define RAM_BUDGET_ALARM			1024		// Alarm table and heap (alarm.c)
+#define RAM_BUDGET_UART				640			// Receive semaphore and buffers (uart_driver.c)
+
+// Sum of the budgets
+#define RAM_BUDGET_TOTAL			( RAM_BUDGET_KERNEL + RAM_BUDGET_TASKS + RAM_BUDGET_CONTROL + RAM_BUDGET_CONSOLE + \
+									  RAM_BUDGET_CONSOLE_IN + RAM_BUDGET_LOG + RAM_BUDGET_APP + \
+									  RAM_BUDGET_ALARM + RAM_BUDGET_UART )
+
+// To check at build time that the objects of a module fit its budget
+#define RAM_BUDGET_CHECK( xBytes, xBudget ) \
+	_Static_assert( (xBytes) <= (xBudget), "The objects exceed " #xBudget )
+
+RAM_BUDGET_CHECK( RAM_BUDGET_TOTAL + RAM_MAIN_STACK + RAM_OTHERS, RAM_SIZE );
+
+#endif /* RAM_BUDGET_H */
@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file    timebase.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Monotonic time base. A timestamp is a 64-bit number of nanoseconds
+  * 		 since the time base was started, read from the DWT cycle counter
+  * 		 extended past its 32-bit wraparound. No RTC register is read to
+  * 		 take a timestamp. Once a second, at the RTC wakeup interrupt, the
+  * 		 count is disciplined to the RTC, so it runs at the rate of the LSE crystal
+  * 		 instead of the core clock, and a timestamp can be converted to the
+  * 		 wall clock time of the RTC.
+  ******************************************************************************
+*/
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+// INCLUDES
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+// CONSTANTS
+
+// Nanoseconds in a second
+#define TIMEBASE_NS_PER_SECOND		1000000000ULL
+
+// Difference from the RTC above which the time base is stepped instead of slewed
+#define TIMEBASE_STEP_NS			( 20 * 1000000LL )
+
+// FUNCTION PROTOTYPES
+
+// To start the time base once the RTC runs, before the scheduler is started
+void vTimebaseInit(uint64_t ullRtcNs);
+
+// To take a timestamp, from a task or an interrupt
+uint64_t ullTimebaseNow(void);
+
+// To convert a timestamp to nanoseconds of Unix time on the RTC
+uint64_t ullTimebaseToWall(uint64_t ullStamp);
+
+// To synchronize the time base with the RTC, called from the RTC wakeup interrupt
+void vTimebaseSyncFromISR(uint64_t ullRtcNs);
+
+// To synchronize the time base with the RTC on leaving STOP mode
+void vTimebaseResume(uint64_t ullRtcNs);
+
+// To make the synchronizations follow the RTC as it is, before its date or time is set
+void vTimebaseResyncBegin(void);
+
+// To make the next synchronization follow the new RTC date or time at once
+void vTimebaseResyncEnd(void);
+
+#endif /* TIMEBASE_H */
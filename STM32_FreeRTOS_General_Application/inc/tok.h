@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    tok.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Tokenizer for the lines typed by the user. A whole line is split
+  * 		 into numbers, words and symbols in one scan. Numbers may be signed
+  * 		 decimal, hexadecimal (0x1F), binary (0b101) or fixed-point decimal
+  * 		 (-12.75), and are held in 64 bits. A number which is malformed or
+  * 		 does not fit is reported on its token instead of being cut short.
+  ******************************************************************************
+*/
+
+#ifndef TOK_H
+#define TOK_H
+
+// INCLUDES
+
+#include <stddef.h>
+#include <stdint.h>
+
+// TYPES
+
+// Types of token
+typedef enum
+{
+	eTokNumber = 0,			// An integer, e.g. 42, -7, 0x1F or 0b101
+	eTokFixed,				// A decimal with a fraction, e.g. 23.45
+	eTokWord,				// Letters, digits and '_' starting with a letter or '_'
+	eTokSymbol				// Any other single character, e.g. + - * / : ;
+} TokType_t;
+
+// Errors found in a token or when reading its value
+typedef enum
+{
+	eTokOk = 0,				// No error
+	eTokOverflow,			// The number does not fit in 64 bits
+	eTokMalformed,			// E.g. "0x" without digits, "12ab" or "1.2.3"
+	eTokNotInteger,			// An integer was expected
+	eTokRange				// The number does not fit in the type asked for
+} TokError_t;
+
+// A token
+typedef struct
+{
+	int64_t llValue;		// Value of an integer, of a fixed-point decimal times 10^ucDecimals,
+							// or the character of a symbol
+	const char* pcText;		// Start of the token in the line
+	uint8_t ucLen;			// Number of characters of the token
+	uint8_t ucType;			// TokType_t
+	uint8_t ucError;		// TokError_t, eTokOk or the error found in a number
+	uint8_t ucDecimals;		// Number of digits after the point of a fixed-point decimal
+} Token_t;
+
+// FUNCTION PROTOTYPES
+
+// To split a line into tokens
+size_t xTokScan(const char* pcLine, Token_t* pxTokens, size_t xMaxTokens);
+
+// To read an integer token as an int32
+TokError_t xTokGetInt32(const Token_t* pxToken, int32_t* plValue);
+
+// To read a line holding a single integer as an int32
+TokError_t xTokLineToInt32(const char* pcLine, int32_t* plValue);
+
+// To describe an error for the user
+const char* pcTokErrorText(TokError_t xError);
+
+#endif /* TOK_H */
@@ -0,0 +1,101 @@
+/**
+  ******************************************************************************
+  * @file    uart_driver.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   USART2 console driver. Provides the hardware setup for USART2 and
+  * 		 the transmit path used by the UART Write task. Messages are sent
+  * 		 either using DMA1 Stream6/Channel4 or by the USART2 TXE interrupt
+  * 		 from a software ring (see UART_TX_BACKEND). In both cases the
+  * 		 calling task blocks on a task notification while bytes are sent.
+  * 		 Received bytes are moved by DMA1 Stream5/Channel4 into a circular
+  * 		 buffer, and readers block till the idle line or DMA interrupts
+  * 		 signal new bytes. The baud rate can be changed at runtime and kept
+  * 		 across resets.
+  ******************************************************************************
+*/
+
+#ifndef UART_DRIVER_H
+#define UART_DRIVER_H
+
+// INCLUDES
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+// CONSTANTS
+
+// Transmit backends
+#define UART_TX_BACKEND_DMA			0	// DMA1 Stream6 moves each message to UART2
+#define UART_TX_BACKEND_IRQ			1	// USART2 TXE interrupt feeds UART2 from a ring
+
+// Transmit backend used by vUartWrite(). Select UART_TX_BACKEND_IRQ if DMA1
+// Stream6 is needed elsewhere
+#ifndef UART_TX_BACKEND
+#define UART_TX_BACKEND				UART_TX_BACKEND_DMA
+#endif
+
+// Size in bytes of the transmit ring of the interrupt backend (must be a power of 2)
+#define UART_TX_RING_SIZE			256
+
+// Size in bytes of the circular receive buffer. Input older than this is
+// overwritten if it is not read in time
+#define UART_RX_BUF_SIZE			128
+
+// GLOBALS
+
+// CPU cycles (DWT CYCCNT) spent by the calling task inside vUartWrite()
+// and by the transmit interrupts, and the number of bytes transmitted.
+// Dividing the former by the latter gives the CPU cost per transmitted
+// byte of the selected backend. Inspect with the debugger.
+extern volatile uint32_t ulUartTxCpuCycles;
+extern volatile uint32_t ulUartTxBytes;
+
+// FUNCTION PROTOTYPES
+
+// To setup UART communication and the selected transmit backend
+void vUartSetup(void);
+
+// To transmit a message and block the calling task till it is sent
+void vUartWrite(const char* pcMsg, size_t xLen);
+
+// To receive one byte, waiting no longer than the given number of ticks
+BaseType_t xUartReadByte(uint8_t* pucByte, TickType_t xTimeout);
+
+// To discard any received byte not read yet
+void vUartFlushRx(void);
+
+// To make the task waiting in xUartReadByte() return without a byte, from an ISR
+void vUartReadAbortFromISR(BaseType_t* pxHigherPriorityTaskWoken);
+
+// To check whether a message is still being transmitted
+BaseType_t xUartTxBusy(void);
+
+// Called from the USART2 idle line and DMA1 Stream5 interrupt handlers
+// whenever new bytes have been received. Implemented by the application
+void vUartRxCallbackFromISR(BaseType_t* pxHigherPriorityTaskWoken);
+
+// To check whether UART2 can produce a baud rate with the current clock
+BaseType_t xUartBaudRateSupported(uint32_t ulBaudRate);
+
+// To change the console baud rate
+BaseType_t xUartSetBaudRate(uint32_t ulBaudRate);
+
+// To get the current console baud rate
+uint32_t ulUartGetBaudRate(void);
+
+// To get the highest baud rate the current APB1 clock allows
+uint32_t ulUartGetMaxBaudRate(void);
+
+// To store the current baud rate in the RTC backup registers
+void vUartSaveBaudRate(void);
+
+// To apply the baud rate stored in the RTC backup registers, if any
+void vUartRestoreBaudRate(void);
+
+// To send UART messages to a terminal by polling (no scheduler or ISR context)
+void vSendUartMsg(const char* pcMsg);
+
+#endif /* UART_DRIVER_H */
@@ -0,0 +1,48 @@
+/**
+  ******************************************************************************
+  * @file    wallclock.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Cached wall clock. The RTC periodic wakeup interrupt reads the RTC
+  * 		 once a second and publishes the date and time in a snapshot
+  * 		 guarded by a sequence counter (seqlock). Readers copy the
+  * 		 snapshot without any lock or peripheral access, and copy it again
+  * 		 in the rare case it was being updated meanwhile.
+  ******************************************************************************
+*/
+
+#ifndef WALLCLOCK_H
+#define WALLCLOCK_H
+
+// INCLUDES
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+// TYPES
+
+// Date and time of the RTC
+typedef struct
+{
+	RTC_DateTypeDef xDate;			// Date, with the day of the week
+	RTC_TimeTypeDef xTime;			// Time, 24-hour format
+	uint32_t ulSeconds;				// Unix time, seconds since 1970-01-01 00:00:00
+	uint32_t ulNanoseconds;			// Nanoseconds into the second, in steps of the RTC sub-second counter
+} WallClock_t;
+
+// FUNCTION PROTOTYPES
+
+// To read the RTC registers once, consistently
+void vWallClockReadRtc(WallClock_t* pxClock);
+
+// To publish the RTC date and time, from the RTC wakeup interrupt
+void vWallClockUpdateFromISR(WallClock_t* pxClock);
+
+// To publish the RTC date and time at once, from a task, after the RTC was set
+void vWallClockRefresh(void);
+
+// To get the date and time last published
+void vWallClockGet(WallClock_t* pxClock);
+
+#endif /* WALLCLOCK_H */
@@ -0,0 +1,468 @@
+/**
+  ******************************************************************************
+  * @file    alarm.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Alarm scheduler multiplexed onto RTC Alarm A. The alarms live in
+  * 		 a static table and the heap holds their indexes, earliest first.
+  * 		 Each alarm remembers its position in the heap, so it can be
+  * 		 removed without a search. The RTC is programmed again only when
+  * 		 the earliest fire time changes.
+  *
+  * 		 The tables are shared with the RTC Alarm interrupt, so the task
+  * 		 side works in critical sections. The interrupt priority must not
+  * 		 be above configMAX_SYSCALL_INTERRUPT_PRIORITY.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "alarm.h"
+#include "ram_budget.h"
+
+// CONSTANTS
+
+// Heap position of an alarm which is not set
+#define ALARM_UNUSED				0xFFFF
+
+// TYPES
+
+// An alarm
+typedef struct
+{
+	uint32_t ulTime;				// Next fire time, in Unix time
+	uint32_t ulPeriod;				// Seconds between two fire times, 0 for a one-shot alarm
+	AlarmCallback_t pxCallback;		// Called when the alarm fires
+	void* pvArg;					// Passed to the callback
+	uint16_t usPos;					// Position in the heap, ALARM_UNUSED if the alarm is not set
+} Alarm_t;
+
+// ALARM GLOBALS
+
+// Alarms, indexed by their ID
+static Alarm_t xAlarms[ALARM_MAX_ALARMS];
+
+// Min-heap of the IDs of the alarms set, ordered by fire time
+static uint16_t usAlarmHeap[ALARM_MAX_ALARMS];
+static uint32_t ulAlarmNum = 0;
+
+// Stack of the IDs not in use
+static uint16_t usAlarmFree[ALARM_MAX_ALARMS];
+static uint32_t ulAlarmNumFree = 0;
+
+// Fire time programmed into the RTC, valid if xAlarmArmed is pdTRUE
+static uint32_t ulAlarmArmedTime = 0;
+static BaseType_t xAlarmArmed = pdFALSE;
+
+RAM_BUDGET_CHECK( sizeof(xAlarms) + sizeof(usAlarmHeap) + sizeof(usAlarmFree), RAM_BUDGET_ALARM );
+
+// FUNCTION PROTOTYPES
+
+// To move the alarm at a heap position up to its place
+static void vAlarmSiftUp(uint32_t ulPos);
+
+// To move the alarm at a heap position down to its place
+static void vAlarmSiftDown(uint32_t ulPos);
+
+// To take the alarm at a heap position out of the heap and free its ID
+static void vAlarmDelete(uint32_t ulPos);
+
+// To program the RTC with the earliest fire time if it changed
+static void vAlarmArm(void);
+/*******************************************************************************
+*   Procedure: vAlarmInit
+*
+*   Description: This function removes every alarm and turns RTC Alarm A off
+*
+*   Notes: Must be called before the scheduler is started, once the RTC is
+*   	   set up.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAlarmInit(void)
+{
+	for( uint32_t i = 0; i < ALARM_MAX_ALARMS; i++ )
+	{
+		xAlarms[i].usPos = ALARM_UNUSED;
+
+		// The lowest IDs are taken first
+		usAlarmFree[i] = (uint16_t)( ALARM_MAX_ALARMS - 1 - i );
+	}
+
+	ulAlarmNum = 0;
+	ulAlarmNumFree = ALARM_MAX_ALARMS;
+	xAlarmArmed = pdFALSE;
+
+	vAlarmPortDisable();
+}
+/*******************************************************************************
+*   Procedure: xAlarmAdd
+*
+*   Description: This function adds an alarm firing at the given time. A
+*   			 recurring alarm fires again every period after that, till it
+*   			 is removed. A one-shot alarm is removed once it fires.
+*
+*   Notes: An alarm whose time has already passed fires at once. The callback
+*   	   must not call the functions of this module.
+*
+*   Parameters: ulTime - The fire time, in Unix time
+*   			ulPeriod - The seconds between two fire times, 0 for a one-shot alarm
+*   			pxCallback - The function called from the interrupt when the alarm fires
+*   			pvArg - A pointer passed to the callback
+*
+*   Return: AlarmId_t - The ID of the alarm, or ALARM_NONE if ALARM_MAX_ALARMS
+*   		alarms are already set
+*
+*******************************************************************************/
+AlarmId_t xAlarmAdd(uint32_t ulTime, uint32_t ulPeriod, AlarmCallback_t pxCallback, void* pvArg)
+{
+	AlarmId_t xId = ALARM_NONE;		// ID of the alarm added
+
+	if( pxCallback == NULL )
+	{
+		return(ALARM_NONE);
+	}
+
+	taskENTER_CRITICAL();
+
+	if( ulAlarmNumFree > 0 )
+	{
+		xId = usAlarmFree[--ulAlarmNumFree];
+
+		xAlarms[xId].ulTime = ulTime;
+		xAlarms[xId].ulPeriod = ulPeriod;
+		xAlarms[xId].pxCallback = pxCallback;
+		xAlarms[xId].pvArg = pvArg;
+		xAlarms[xId].usPos = (uint16_t)ulAlarmNum;
+		usAlarmHeap[ulAlarmNum++] = (uint16_t)xId;
+
+		vAlarmSiftUp( xAlarms[xId].usPos );
+		vAlarmArm();
+	}
+
+	taskEXIT_CRITICAL();
+
+	return(xId);
+}
+/*******************************************************************************
+*   Procedure: xAlarmRemove
+*
+*   Description: This function removes an alarm before it fires
+*
+*   Notes: None
+*
+*   Parameters: xId - The ID of the alarm
+*
+*   Return: BaseType_t - pdPASS if the alarm was removed, or pdFAIL if it is not
+*   		set
+*
+*******************************************************************************/
+BaseType_t xAlarmRemove(AlarmId_t xId)
+{
+	BaseType_t xResult = pdFAIL;	// pdPASS once the alarm is removed
+
+	if( xId < 0 || xId >= ALARM_MAX_ALARMS )
+	{
+		return(pdFAIL);
+	}
+
+	taskENTER_CRITICAL();
+
+	if( xAlarms[xId].usPos != ALARM_UNUSED )
+	{
+		vAlarmDelete( xAlarms[xId].usPos );
+		vAlarmArm();
+		xResult = pdPASS;
+	}
+
+	taskEXIT_CRITICAL();
+
+	return(xResult);
+}
+/*******************************************************************************
+*   Procedure: xAlarmGet
+*
+*   Description: This function reads the next fire time and the period of an
+*   			 alarm
+*
+*   Notes: Used to list the alarms, by trying each ID up to ALARM_MAX_ALARMS.
+*
+*   Parameters: xId - The ID of the alarm
+*   			pulTime - A pointer to the location receiving the fire time
+*   			pulPeriod - A pointer to the location receiving the period
+*
+*   Return: BaseType_t - pdPASS, or pdFAIL if the alarm is not set
+*
+*******************************************************************************/
+BaseType_t xAlarmGet(AlarmId_t xId, uint32_t* pulTime, uint32_t* pulPeriod)
+{
+	BaseType_t xResult = pdFAIL;	// pdPASS if the alarm is set
+
+	if( xId < 0 || xId >= ALARM_MAX_ALARMS )
+	{
+		return(pdFAIL);
+	}
+
+	taskENTER_CRITICAL();
+
+	if( xAlarms[xId].usPos != ALARM_UNUSED )
+	{
+		*pulTime = xAlarms[xId].ulTime;
+		*pulPeriod = xAlarms[xId].ulPeriod;
+		xResult = pdPASS;
+	}
+
+	taskEXIT_CRITICAL();
+
+	return(xResult);
+}
+/*******************************************************************************
+*   Procedure: ulAlarmCount
+*
+*   Description: This function returns the number of alarms set
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: uint32_t - The number of alarms
+*
+*******************************************************************************/
+uint32_t ulAlarmCount(void)
+{
+	return(ulAlarmNum);
+}
+/*******************************************************************************
+*   Procedure: vAlarmFireFromISR
+*
+*   Description: This function fires every alarm due at the given time, the
+*   			 earliest first, then programs the RTC for the next one. A
+*   			 recurring alarm is moved to its next fire time after the
+*   			 given time, so periods missed while the RTC was set forward
+*   			 fire once only.
+*
+*   Notes: Called from the RTC Alarm interrupt. The RTC may fire early, e.g.
+*   	   for an alarm more than a month away, in which case nothing is due
+*   	   and the RTC is programmed again.
+*
+*   Parameters: ulNow - The current time, in Unix time
+*   			pxHigherPriorityTaskWoken - A pointer passed to the callbacks
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAlarmFireFromISR(uint32_t ulNow, BaseType_t* pxHigherPriorityTaskWoken)
+{
+	Alarm_t* pxAlarm;					// Earliest alarm
+	AlarmId_t xId;						// ID of the earliest alarm
+	AlarmCallback_t pxCallback;			// Callback of the alarm firing
+	void* pvArg;						// Argument of the callback
+
+	// Alarm A stays enabled once it fired, so it is left armed. It is
+	// programmed again below if the earliest fire time changed, and turned
+	// off if the last alarm fired, otherwise it would match again next month
+	while( ulAlarmNum > 0 && xAlarms[usAlarmHeap[0]].ulTime <= ulNow )
+	{
+		xId = usAlarmHeap[0];
+		pxAlarm = &xAlarms[xId];
+		pxCallback = pxAlarm->pxCallback;
+		pvArg = pxAlarm->pvArg;
+
+		if( pxAlarm->ulPeriod != 0 )
+		{
+			pxAlarm->ulTime += ( ( ulNow - pxAlarm->ulTime ) / pxAlarm->ulPeriod + 1 ) * pxAlarm->ulPeriod;
+			vAlarmSiftDown( 0 );
+		}
+		else
+		{
+			vAlarmDelete( 0 );
+		}
+
+		pxCallback( xId, pvArg, pxHigherPriorityTaskWoken );
+	}
+
+	vAlarmArm();
+}
+/*******************************************************************************
+*   Procedure: vAlarmRtcChanged
+*
+*   Description: This function programs the RTC again with the earliest fire
+*   			 time, once the RTC date or time was set
+*
+*   Notes: The RTC only fires on a match of the date of the month and the
+*   	   time, so after the RTC is set forward past the time programmed it
+*   	   would not fire till the next month. The application programs an
+*   	   alarm already due so that it fires at once.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAlarmRtcChanged(void)
+{
+	taskENTER_CRITICAL();
+
+	// Program the RTC even though the earliest fire time did not change
+	xAlarmArmed = pdFALSE;
+	vAlarmArm();
+
+	taskEXIT_CRITICAL();
+}
+/*******************************************************************************
+*   Procedure: vAlarmSiftUp
+*
+*   Description: This function moves the alarm at a heap position towards the
+*   			 root till its parent fires no later than it
+*
+*   Notes: Called with the tables protected.
+*
+*   Parameters: ulPos - The heap position
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vAlarmSiftUp(uint32_t ulPos)
+{
+	uint16_t usId = usAlarmHeap[ulPos];		// Alarm moved
+	uint32_t ulTime = xAlarms[usId].ulTime;	// Its fire time
+	uint32_t ulParent;						// Position of the parent
+
+	while( ulPos > 0 )
+	{
+		ulParent = ( ulPos - 1 ) / 2;
+
+		if( xAlarms[usAlarmHeap[ulParent]].ulTime <= ulTime )
+		{
+			break;
+		}
+
+		usAlarmHeap[ulPos] = usAlarmHeap[ulParent];
+		xAlarms[usAlarmHeap[ulPos]].usPos = (uint16_t)ulPos;
+		ulPos = ulParent;
+	}
+
+	usAlarmHeap[ulPos] = usId;
+	xAlarms[usId].usPos = (uint16_t)ulPos;
+}
+/*******************************************************************************
+*   Procedure: vAlarmSiftDown
+*
+*   Description: This function moves the alarm at a heap position towards the
+*   			 leaves till both its children fire no earlier than it
+*
+*   Notes: Called with the tables protected.
+*
+*   Parameters: ulPos - The heap position
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vAlarmSiftDown(uint32_t ulPos)
+{
+	uint16_t usId = usAlarmHeap[ulPos];		// Alarm moved
+	uint32_t ulTime = xAlarms[usId].ulTime;	// Its fire time
+	uint32_t ulChild;						// Position of the earlier child
+
+	while( ( ulChild = 2 * ulPos + 1 ) < ulAlarmNum )
+	{
+		if( ulChild + 1 < ulAlarmNum &&
+			xAlarms[usAlarmHeap[ulChild + 1]].ulTime < xAlarms[usAlarmHeap[ulChild]].ulTime )
+		{
+			ulChild++;
+		}
+
+		if( ulTime <= xAlarms[usAlarmHeap[ulChild]].ulTime )
+		{
+			break;
+		}
+
+		usAlarmHeap[ulPos] = usAlarmHeap[ulChild];
+		xAlarms[usAlarmHeap[ulPos]].usPos = (uint16_t)ulPos;
+		ulPos = ulChild;
+	}
+
+	usAlarmHeap[ulPos] = usId;
+	xAlarms[usId].usPos = (uint16_t)ulPos;
+}
+/*******************************************************************************
+*   Procedure: vAlarmDelete
+*
+*   Description: This function takes the alarm at a heap position out of the
+*   			 heap. The last alarm of the heap takes its place and is moved
+*   			 up or down to where it belongs.
+*
+*   Notes: Called with the tables protected.
+*
+*   Parameters: ulPos - The heap position
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vAlarmDelete(uint32_t ulPos)
+{
+	uint16_t usId = usAlarmHeap[ulPos];		// Alarm deleted
+
+	xAlarms[usId].usPos = ALARM_UNUSED;
+	usAlarmFree[ulAlarmNumFree++] = usId;
+
+	if( ulPos == --ulAlarmNum )
+	{
+		return;
+	}
+
+	usAlarmHeap[ulPos] = usAlarmHeap[ulAlarmNum];
+	xAlarms[usAlarmHeap[ulPos]].usPos = (uint16_t)ulPos;
+
+	if( ulPos > 0 && xAlarms[usAlarmHeap[ulPos]].ulTime < xAlarms[usAlarmHeap[( ulPos - 1 ) / 2]].ulTime )
+	{
+		vAlarmSiftUp( ulPos );
+	}
+	else
+	{
+		vAlarmSiftDown( ulPos );
+	}
+}
+/*******************************************************************************
+*   Procedure: vAlarmArm
+*
+*   Description: This function programs RTC Alarm A with the fire time of the
+*   			 earliest alarm, or turns it off if no alarm is set. The RTC is
+*   			 left alone if it already holds that time.
+*
+*   Notes: Called with the tables protected.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vAlarmArm(void)
+{
+	uint32_t ulTime;	// Earliest fire time
+
+	if( ulAlarmNum == 0 )
+	{
+		if( xAlarmArmed == pdTRUE )
+		{
+			xAlarmArmed = pdFALSE;
+			vAlarmPortDisable();
+		}
+		return;
+	}
+
+	ulTime = xAlarms[usAlarmHeap[0]].ulTime;
+
+	if( xAlarmArmed == pdFALSE || ulTime != ulAlarmArmedTime )
+	{
+		ulAlarmArmedTime = ulTime;
+		xAlarmArmed = pdTRUE;
+		vAlarmPortProgram( ulTime );
+	}
+}
@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file    app.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Run-to-completion executor for the sub-applications. The App task
+  * 		 is a console input client. It waits for the next line sent to it,
+  * 		 for no longer than the timeout of the current state, and passes
+  * 		 the line or the timeout to the state. A state moves to another
+  * 		 one with vAppSetState(), which is entered as soon as the event is
+  * 		 handled. Moving between sub-applications is a function call, not
+  * 		 a hand-off between tasks.
+  *
+  * 		 The App task holds the App lock while it handles an event. A task
+  * 		 running commands for another console session takes the lock too,
+  * 		 so commands and events share the RTC, the LED timer and the
+  * 		 temperature monitor one at a time. The lock is never held while
+  * 		 waiting for input.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "console_in.h"
+#include "app.h"
+#include "ram_budget.h"
+
+// APP GLOBALS
+
+// State being run
+static AppState_t pxAppState = NULL;
+
+// State to enter once the current event is handled, NULL if none
+static AppState_t pxAppNextState = NULL;
+
+// Time the current state waits for input
+static TickType_t xAppTimeout = portMAX_DELAY;
+
+// Held while an event or a command of another session is handled
+static SemaphoreHandle_t xAppLock = NULL;
+static StaticSemaphore_t xAppLockBuffer;
+
+RAM_BUDGET_CHECK( sizeof(xAppLockBuffer), RAM_BUDGET_APP );
+/*******************************************************************************
+*   Procedure: xAppInit
+*
+*   Description: This function creates the App lock in statically allocated
+*   			 storage
+*
+*   Notes: Must be called before the scheduler is started.
+*
+*   Parameters: None
+*
+*   Return: BaseType_t - pdPASS if the lock was created, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xAppInit(void)
+{
+	xAppLock = xSemaphoreCreateMutexStatic( &xAppLockBuffer );
+
+	return( ( xAppLock != NULL ) ? pdPASS : pdFAIL );
+}
+/*******************************************************************************
+*   Procedure: vAppLock
+*
+*   Description: This function waits in blocked state till the App task is not
+*   			 handling an event, then keeps it from handling the next one
+*   			 till vAppUnlock() is called
+*
+*   Notes: Called by the tasks of the other console sessions around the
+*   	   commands they run. The App task runs the states with the lock held,
+*   	   so they must not call it.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAppLock(void)
+{
+	xSemaphoreTake( xAppLock, portMAX_DELAY );
+}
+/*******************************************************************************
+*   Procedure: vAppUnlock
+*
+*   Description: This function lets the App task handle events again
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAppUnlock(void)
+{
+	xSemaphoreGive( xAppLock );
+}
+/*******************************************************************************
+*   Procedure: vAppSetState
+*
+*   Description: This function selects the state to move to once the current
+*   			 event is handled. The state gets eAppEnter first. A state may
+*   			 select itself to be entered again.
+*
+*   Notes: Called from the states, or before the scheduler is started to select
+*   	   the first state.
+*
+*   Parameters: pxState - The state
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAppSetState(AppState_t pxState)
+{
+	pxAppNextState = pxState;
+}
+/*******************************************************************************
+*   Procedure: vAppSetTimeout
+*
+*   Description: This function sets the time the current state waits for input
+*   			 before it gets eAppTimeout. Each state starts with no timeout.
+*
+*   Notes: The time is counted again after each event.
+*
+*   Parameters: xTimeout - The number of ticks, portMAX_DELAY for no timeout
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAppSetTimeout(TickType_t xTimeout)
+{
+	xAppTimeout = xTimeout;
+}
+/*******************************************************************************
+*   Procedure: pxAppGetState
+*
+*   Description: This function returns the state being run
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: AppState_t - The state
+*
+*******************************************************************************/
+AppState_t pxAppGetState(void)
+{
+	return(pxAppState);
+}
+/*******************************************************************************
+*   Procedure: vAppTaskFunction
+*
+*   Description: This is the task function for the App task. It enters the
+*   			 states selected by the last event, then waits in blocked state
+*   			 for the next line or for the timeout of the state, and passes
+*   			 it on to the state.
+*
+*   Notes: None
+*
+*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
+*   			in this task function
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAppTaskFunction(void *pvParam)
+{
+	char cLine[CONSOLE_IN_LINE_SIZE + 1];	// Line received
+	AppEvent_t xEvent;						// Event passed to the state
+
+	while(1)
+	{
+		vAppLock();
+
+		// Enter the states selected one after another till one waits for input
+		while( pxAppNextState != NULL )
+		{
+			pxAppState = pxAppNextState;
+			pxAppNextState = NULL;
+			xAppTimeout = portMAX_DELAY;
+
+			xEvent.eType = eAppEnter;
+			xEvent.pcLine = NULL;
+			xEvent.xLen = 0;
+			pxAppState( &xEvent );
+		}
+
+		vAppUnlock();
+
+		if( pxAppState == NULL )
+		{
+			// No state selected, nothing to run
+			vTaskSuspend( NULL );
+			continue;
+		}
+
+		// The task will block till a line is received or the state times out
+		if( xConsoleInRead( cLine, sizeof(cLine), &xEvent.xLen, NULL, xAppTimeout ) == pdPASS )
+		{
+			xEvent.eType = eAppLine;
+			xEvent.pcLine = cLine;
+		}
+		else if( xAppTimeout != portMAX_DELAY )
+		{
+			xEvent.eType = eAppTimeout;
+			xEvent.pcLine = NULL;
+			xEvent.xLen = 0;
+		}
+		else
+		{
+			continue;
+		}
+
+		vAppLock();
+		pxAppState( &xEvent );
+		vAppUnlock();
+	}
+}
@@ -0,0 +1,65 @@
+/**
+  ******************************************************************************
+  * @file    calc.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Arithmetic of the calculator. The operands are widened to 64 bits,
+  * 		 which holds any sum, difference, product or quotient of two
+  * 		 int32 values, so the range is checked once on the result.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include "calc.h"
+/*******************************************************************************
+*   Procedure: xCalcApply
+*
+*   Description: This function applies an operator to two integers
+*
+*   Notes: The quotient is rounded toward zero. INT32_MIN / -1 is out of
+*   	   range.
+*
+*   Parameters: lFirstNum - The first operand
+*   			cOperator - The operator: '+', '-', '*' or '/'
+*   			lSecondNum - The second operand
+*   			plResult - A pointer to a location that will hold the result,
+*   			only written if the calculation succeeds
+*
+*   Return: CalcStatus_t - eCalcOk, or the reason there is no result
+*
+*******************************************************************************/
+CalcStatus_t xCalcApply(int32_t lFirstNum, char cOperator, int32_t lSecondNum, int32_t* plResult)
+{
+	int64_t llCalcNum;		// To hold the result of the calculation
+
+	switch( cOperator )
+	{
+		case '+':	llCalcNum = (int64_t)lFirstNum + lSecondNum;	break;
+		case '-':	llCalcNum = (int64_t)lFirstNum - lSecondNum;	break;
+		case '*':	llCalcNum = (int64_t)lFirstNum * lSecondNum;	break;
+		case '/':
+
+			if( lSecondNum == 0 )
+			{
+				return(eCalcDivByZero);
+			}
+
+			llCalcNum = (int64_t)lFirstNum / lSecondNum;
+			break;
+
+		default:
+
+			return(eCalcBadOperator);
+	}
+
+	if( llCalcNum < INT32_MIN || llCalcNum > INT32_MAX )
+	{
+		return(eCalcOutOfRange);
+	}
+
+	*plResult = (int32_t)llCalcNum;
+
+	return(eCalcOk);
+}
@@ -0,0 +1,271 @@
+/**
+  ******************************************************************************
+  * @file    calendar.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Calendar of the Gregorian dates. The conversions between dates and
+  * 		 days count the years from March, so that the leap day is the last
+  * 		 day of a year and the months before it do not depend on the year.
+  * 		 The days before a month are then a linear formula instead of a
+  * 		 table, and 400 years are always 146097 days.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include "calendar.h"
+
+// CONSTANTS
+
+// Days in 400 years, a full cycle of the leap years
+#define CALENDAR_DAYS_PER_400_YEARS	146097UL
+
+// Days from 0000-03-01 to 1970-01-01
+#define CALENDAR_DAYS_TO_1970		719468UL
+
+// Days since 1970-01-01 of a Monday (1970-01-05)
+#define CALENDAR_FIRST_MONDAY		4UL
+/*******************************************************************************
+*   Procedure: xCalendarIsLeapYear
+*
+*   Description: This function checks whether a year is a leap year
+*
+*   Notes: Every fourth year is a leap year, except the centuries which are
+*   	   not a multiple of 400.
+*
+*   Parameters: ulYear - The year, e.g. 2026
+*
+*   Return: BaseType_t - pdTRUE if the year is a leap year, otherwise pdFALSE
+*
+*******************************************************************************/
+BaseType_t xCalendarIsLeapYear(uint32_t ulYear)
+{
+	return( (BaseType_t)( ( ( ulYear % 4 ) == 0 && ( ulYear % 100 ) != 0 ) || ( ulYear % 400 ) == 0 ) );
+}
+/*******************************************************************************
+*   Procedure: ulCalendarDaysInMonth
+*
+*   Description: This function gets the number of days of a month
+*
+*   Notes: The months have 31 and 30 days in turn, the turn starting again
+*   	   in August, which bit 3 of the month number tells. February then
+*   	   loses 2 days, or 1 in a leap year.
+*
+*   Parameters: ulYear - The year, e.g. 2026
+*   			ulMonth - The month, 1 to 12
+*
+*   Return: uint32_t - The number of days, 28 to 31
+*
+*******************************************************************************/
+uint32_t ulCalendarDaysInMonth(uint32_t ulYear, uint32_t ulMonth)
+{
+	uint32_t ulDays = 30 + ( ( ulMonth ^ ( ulMonth >> 3 ) ) & 1 );
+
+	return( ulDays - ( ulMonth == 2 ) * ( 2 - (uint32_t)xCalendarIsLeapYear( ulYear ) ) );
+}
+/*******************************************************************************
+*   Procedure: xCalendarIsValidDate
+*
+*   Description: This function checks whether a date exists and can be held by
+*   			 the RTC
+*
+*   Notes: None
+*
+*   Parameters: ulYear - The year, e.g. 2026
+*   			ulMonth - The month
+*   			ulDay - The day of the month
+*
+*   Return: BaseType_t - pdTRUE if the date is valid, otherwise pdFALSE
+*
+*******************************************************************************/
+BaseType_t xCalendarIsValidDate(uint32_t ulYear, uint32_t ulMonth, uint32_t ulDay)
+{
+	return( (BaseType_t)( ulYear >= CALENDAR_RTC_FIRST_YEAR && ulYear <= CALENDAR_RTC_LAST_YEAR &&
+						  ulMonth >= 1 && ulMonth <= 12 &&
+						  ulDay >= 1 && ulDay <= ulCalendarDaysInMonth( ulYear, ulMonth ) ) );
+}
+/*******************************************************************************
+*   Procedure: ulCalendarDaysFromDate
+*
+*   Description: This function converts a date to the number of days since
+*   			 1970-01-01
+*
+*   Notes: January and February count as the last months of the year before.
+*   	   The days before a month, counted from March, are (153 * m + 2) / 5
+*   	   with m from 0 for March to 11 for February.
+*
+*   Parameters: ulYear - The year, 1970 or later
+*   			ulMonth - The month, 1 to 12
+*   			ulDay - The day of the month
+*
+*   Return: uint32_t - The number of days
+*
+*******************************************************************************/
+uint32_t ulCalendarDaysFromDate(uint32_t ulYear, uint32_t ulMonth, uint32_t ulDay)
+{
+	uint32_t ulEra;				// Cycles of 400 years since year 0
+	uint32_t ulYearOfEra;		// Years into the cycle, 0 to 399
+	uint32_t ulDayOfYear;		// Days since the 1st of March, 0 to 365
+	uint32_t ulDayOfEra;		// Days into the cycle, 0 to 146096
+
+	ulYear -= ( ulMonth <= 2 );
+	ulEra = ulYear / 400;
+	ulYearOfEra = ulYear - ulEra * 400;
+	ulDayOfYear = ( 153 * ( ( ulMonth + 9 ) % 12 ) + 2 ) / 5 + ulDay - 1;
+	ulDayOfEra = ulYearOfEra * 365 + ulYearOfEra / 4 - ulYearOfEra / 100 + ulDayOfYear;
+
+	return( ulEra * CALENDAR_DAYS_PER_400_YEARS + ulDayOfEra - CALENDAR_DAYS_TO_1970 );
+}
+/*******************************************************************************
+*   Procedure: vCalendarDateFromDays
+*
+*   Description: This function converts a number of days since 1970-01-01 to a
+*   			 date
+*
+*   Notes: The reverse of ulCalendarDaysFromDate(). The year into the cycle
+*   	   is found by taking the leap days out of the days into the cycle,
+*   	   the month by inverting (153 * m + 2) / 5.
+*
+*   Parameters: ulDays - The number of days
+*   			pulYear - A pointer to the year to fill in
+*   			pulMonth - A pointer to the month to fill in, 1 to 12
+*   			pulDay - A pointer to the day of the month to fill in
+*
+*   Return: None
+*
+*******************************************************************************/
+void vCalendarDateFromDays(uint32_t ulDays, uint32_t* pulYear, uint32_t* pulMonth, uint32_t* pulDay)
+{
+	uint32_t ulEra;				// Cycles of 400 years since year 0
+	uint32_t ulDayOfEra;		// Days into the cycle, 0 to 146096
+	uint32_t ulYearOfEra;		// Years into the cycle, 0 to 399
+	uint32_t ulDayOfYear;		// Days since the 1st of March, 0 to 365
+	uint32_t ulMonthFromMarch;	// Months since March, 0 to 11
+
+	ulDays += CALENDAR_DAYS_TO_1970;
+	ulEra = ulDays / CALENDAR_DAYS_PER_400_YEARS;
+	ulDayOfEra = ulDays - ulEra * CALENDAR_DAYS_PER_400_YEARS;
+	ulYearOfEra = ( ulDayOfEra - ulDayOfEra / 1460 + ulDayOfEra / 36524 - ulDayOfEra / 146096 ) / 365;
+	ulDayOfYear = ulDayOfEra - ( ulYearOfEra * 365 + ulYearOfEra / 4 - ulYearOfEra / 100 );
+	ulMonthFromMarch = ( 5 * ulDayOfYear + 2 ) / 153;
+
+	*pulDay = ulDayOfYear - ( 153 * ulMonthFromMarch + 2 ) / 5 + 1;
+	*pulMonth = ( ulMonthFromMarch + 2 ) % 12 + 1;
+	*pulYear = ulEra * 400 + ulYearOfEra + ( *pulMonth <= 2 );
+}
+/*******************************************************************************
+*   Procedure: ucCalendarWeekDay
+*
+*   Description: This function gets the day of the week of a date
+*
+*   Notes: 1970-01-01 was a Thursday.
+*
+*   Parameters: ulYear - The year, 1970 or later
+*   			ulMonth - The month, 1 to 12
+*   			ulDay - The day of the month
+*
+*   Return: uint8_t - The day of the week as held by the RTC, from
+*   		RTC_Weekday_Monday (1) to RTC_Weekday_Sunday (7)
+*
+*******************************************************************************/
+uint8_t ucCalendarWeekDay(uint32_t ulYear, uint32_t ulMonth, uint32_t ulDay)
+{
+	uint32_t ulDays = ulCalendarDaysFromDate( ulYear, ulMonth, ulDay );
+
+	return( (uint8_t)( ( ulDays + 7 - CALENDAR_FIRST_MONDAY ) % 7 + RTC_Weekday_Monday ) );
+}
+/*******************************************************************************
+*   Procedure: ulCalendarDayOfYear
+*
+*   Description: This function gets the day of the year of a date
+*
+*   Notes: None
+*
+*   Parameters: ulYear - The year, 1970 or later
+*   			ulMonth - The month, 1 to 12
+*   			ulDay - The day of the month
+*
+*   Return: uint32_t - The day of the year, 1 for the 1st of January
+*
+*******************************************************************************/
+uint32_t ulCalendarDayOfYear(uint32_t ulYear, uint32_t ulMonth, uint32_t ulDay)
+{
+	return( ulCalendarDaysFromDate( ulYear, ulMonth, ulDay ) - ulCalendarDaysFromDate( ulYear, 1, 1 ) + 1 );
+}
+/*******************************************************************************
+*   Procedure: ulCalendarFromRtc
+*
+*   Description: This function converts an RTC date and time to Unix time
+*
+*   Notes: The day of the week is not used.
+*
+*   Parameters: pxDate - A pointer to the date, in binary format
+*   			pxTime - A pointer to the time, in binary 24-hour format
+*
+*   Return: uint32_t - The seconds since 1970-01-01 00:00:00
+*
+*******************************************************************************/
+uint32_t ulCalendarFromRtc(const RTC_DateTypeDef* pxDate, const RTC_TimeTypeDef* pxTime)
+{
+	uint32_t ulDays = ulCalendarDaysFromDate( CALENDAR_RTC_FIRST_YEAR + pxDate->RTC_Year, pxDate->RTC_Month, pxDate->RTC_Date );
+
+	return( ulDays * CALENDAR_SECONDS_PER_DAY + pxTime->RTC_Hours * 3600UL + pxTime->RTC_Minutes * 60UL + pxTime->RTC_Seconds );
+}
+/*******************************************************************************
+*   Procedure: vCalendarToRtc
+*
+*   Description: This function converts Unix time to an RTC date and time, the
+*   			 day of the week included
+*
+*   Notes: The time must fall in the years the RTC can hold, 2000 to 2099.
+*
+*   Parameters: ulTime - The seconds since 1970-01-01 00:00:00
+*   			pxDate - A pointer to the date to fill in, in binary format
+*   			pxTime - A pointer to the time to fill in, in binary 24-hour
+*   			format
+*
+*   Return: None
+*
+*******************************************************************************/
+void vCalendarToRtc(uint32_t ulTime, RTC_DateTypeDef* pxDate, RTC_TimeTypeDef* pxTime)
+{
+	uint32_t ulDays = ulTime / CALENDAR_SECONDS_PER_DAY;	// Days since 1970-01-01
+	uint32_t ulSeconds = ulTime % CALENDAR_SECONDS_PER_DAY;	// Seconds into the day
+	uint32_t ulYear;
+	uint32_t ulMonth;
+	uint32_t ulDay;
+
+	vCalendarDateFromDays( ulDays, &ulYear, &ulMonth, &ulDay );
+
+	pxDate->RTC_Year = ulYear - CALENDAR_RTC_FIRST_YEAR;
+	pxDate->RTC_Month = ulMonth;
+	pxDate->RTC_Date = ulDay;
+	pxDate->RTC_WeekDay = ( ulDays + 7 - CALENDAR_FIRST_MONDAY ) % 7 + RTC_Weekday_Monday;
+
+	pxTime->RTC_Hours = ulSeconds / 3600;
+	pxTime->RTC_Minutes = ( ulSeconds / 60 ) % 60;
+	pxTime->RTC_Seconds = ulSeconds % 60;
+	pxTime->RTC_H12 = RTC_H12_AM;
+}
+/*******************************************************************************
+*   Procedure: vCalendarSplitDuration
+*
+*   Description: This function splits a duration in seconds into days, hours,
+*   			 minutes and seconds
+*
+*   Notes: None
+*
+*   Parameters: ulSeconds - The duration in seconds
+*   			pxDuration - A pointer to the split duration to fill in
+*
+*   Return: None
+*
+*******************************************************************************/
+void vCalendarSplitDuration(uint32_t ulSeconds, CalendarDuration_t* pxDuration)
+{
+	pxDuration->ulDays = ulSeconds / CALENDAR_SECONDS_PER_DAY;
+	pxDuration->ulHours = ( ulSeconds % CALENDAR_SECONDS_PER_DAY ) / 3600;
+	pxDuration->ulMinutes = ( ulSeconds / 60 ) % 60;
+	pxDuration->ulSeconds = ulSeconds % 60;
+}
@@ -0,0 +1,378 @@
+/**
+  ******************************************************************************
+  * @file    cmd.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Menu command dispatch. The command table is built from
+  * 		 commands.def by the preprocessor and lives in flash. Every key,
+  * 		 name and alias of every menu is mapped to its command by a
+  * 		 perfect hash: an FNV-1a hash of the menu ID and the lower case
+  * 		 token, with a seed chosen by Tools/gen_commands.py so that no two
+  * 		 tokens share a slot. A lookup is one hash, one slot read and one
+  * 		 string compare, whatever the number of commands.
+  *
+  * 		 Scripts let a host provision the board in one burst, e.g.
+  * 		 "date 2026-10-16; time 08:00:00; alarm 07:30:00; temp start",
+  * 		 without the prompt and reply round trip of each value.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "console.h"
+#include "fmt.h"
+#include "tok.h"
+#include "cmd.h"
+
+// CONSTANTS
+
+// FNV-1a prime
+#define CMD_FNV_PRIME				16777619UL
+
+// Size of the status line of a script command
+#define CMD_STATUS_SIZE				64
+
+// TYPES
+
+// A token selecting a command
+typedef struct
+{
+	uint8_t ucMenu;			// Menu of the command (CmdMenu_t)
+	uint8_t ucCmd;			// Index of the command in xCmds
+	uint8_t ucLen;			// Length of the token
+	const char* pcToken;	// Key, name or alias, lower case
+} CmdKey_t;
+
+// CMD GLOBALS
+
+// Command table
+static const Cmd_t xCmds[] =
+{
+#define MENU( id, title, prompt )
+#define CMD( menu, key, name, aliases, arg, handler, text )	\
+	{ eCmdMenu##menu, eCmdArg##arg, key, name, aliases, handler },
+#include "commands.def"
+#undef MENU
+#undef CMD
+};
+
+// Reason given in the status line of a script command, indexed by CmdStatus_t
+static const char* const pcCmdStatusText[] =
+{
+	"ok",
+	"unknown command",
+	"number expected",
+	"no argument accepted",
+	"rejected"
+};
+
+// Hash table and menu text generated from commands.def, before each build
+#include "commands_gen.h"
+
+// Catches a header left stale by a build without the pre-build step
+_Static_assert( sizeof(xCmds) / sizeof(xCmds[0]) == CMD_NUM_COMMANDS,
+				"commands.def was changed, run Tools/gen_commands.py" );
+
+// FUNCTION PROTOTYPES
+
+// To convert an upper case letter to lower case
+static char cCmdLower(char c);
+/*******************************************************************************
+*   Procedure: vCmdPostMenu
+*
+*   Description: This function posts the text of a menu to the console: its
+*   			 title, one line per command with its name and key, and the
+*   			 prompt.
+*
+*   Notes: None
+*
+*   Parameters: eMenu - The menu
+*
+*   Return: None
+*
+*******************************************************************************/
+void vCmdPostMenu(CmdMenu_t eMenu)
+{
+	if( eMenu < eCmdNumMenus )
+	{
+		vPostMsgToUartQueue( pcCmdMenuText[eMenu] );
+	}
+}
+/*******************************************************************************
+*   Procedure: pxCmdFind
+*
+*   Description: This function finds the command of a menu selected by a token,
+*   			 which may be its key, its name or one of its aliases. Letters
+*   			 are matched in any case.
+*
+*   Notes: None
+*
+*   Parameters: eMenu - The menu
+*   			pcToken - A pointer to the token, not necessarily NUL terminated
+*   			xLen - The length of the token
+*
+*   Return: const Cmd_t* - The command, or NULL if there is none
+*
+*******************************************************************************/
+const Cmd_t* pxCmdFind(CmdMenu_t eMenu, const char* pcToken, size_t xLen)
+{
+	uint32_t ulHash = CMD_HASH_SEED;	// Hash of the menu ID and the token
+	uint8_t ucSlot;						// Slot of the token in the hash table
+	const CmdKey_t* pxKey;				// Only token which can be in that slot
+
+	ulHash = ( ulHash ^ (uint8_t)eMenu ) * CMD_FNV_PRIME;
+	for( size_t i = 0; i < xLen; i++ )
+	{
+		ulHash = ( ulHash ^ (uint8_t)cCmdLower( pcToken[i] ) ) * CMD_FNV_PRIME;
+	}
+
+	ucSlot = ucCmdHashSlots[ ulHash >> ( 32 - CMD_HASH_BITS ) ];
+	if( ucSlot == 0 )
+	{
+		return(NULL);
+	}
+
+	// The slot holds the index of the key plus one. Check the key is the one typed
+	pxKey = &xCmdKeys[ucSlot - 1];
+	if( pxKey->ucMenu != (uint8_t)eMenu || pxKey->ucLen != xLen )
+	{
+		return(NULL);
+	}
+
+	for( size_t i = 0; i < xLen; i++ )
+	{
+		if( cCmdLower( pcToken[i] ) != pxKey->pcToken[i] )
+		{
+			return(NULL);
+		}
+	}
+
+	return( &xCmds[pxKey->ucCmd] );
+}
+/*******************************************************************************
+*   Procedure: xCmdExecute
+*
+*   Description: This function runs a command of a menu. The line is split into
+*   			 the command token and an optional argument after the first
+*   			 space. The argument is checked against the type the command
+*   			 accepts before the handler is called. Nothing is posted to the
+*   			 console by this function.
+*
+*   Notes: Leading and trailing spaces are removed from the line.
+*
+*   Parameters: eMenu - The menu the command is looked up in
+*   			pcLine - A pointer to the NUL terminated line
+*   			ppxCmd - A pointer to a location that will hold the command
+*   			found, or NULL if there is none. May be NULL
+*   			pxQuit - A pointer passed on to the handler
+*
+*   Return: CmdStatus_t - eCmdOk if the handler was called and succeeded
+*
+*******************************************************************************/
+CmdStatus_t xCmdExecute(CmdMenu_t eMenu, char* pcLine, const Cmd_t** ppxCmd, BaseType_t* pxQuit)
+{
+	CmdArg_t xArg = { eCmdArgNone, 0, NULL };	// Argument passed to the handler
+	const Cmd_t* pxCmd;							// Command selected
+	size_t xLen = strlen(pcLine);				// Length of the line, then of the token
+	char* pcArg;								// Start of the argument
+
+	while( xLen > 0 && pcLine[xLen - 1] == ' ' )
+	{
+		pcLine[--xLen] = '\0';
+	}
+
+	while( *pcLine == ' ' )
+	{
+		pcLine++;
+	}
+
+	xLen = 0;
+	while( pcLine[xLen] != '\0' && pcLine[xLen] != ' ' )
+	{
+		xLen++;
+	}
+
+	pcArg = &pcLine[xLen];
+	while( *pcArg == ' ' )
+	{
+		pcArg++;
+	}
+
+	pxCmd = pxCmdFind( eMenu, pcLine, xLen );
+	if( ppxCmd != NULL )
+	{
+		*ppxCmd = pxCmd;
+	}
+
+	if( pxCmd == NULL )
+	{
+		return(eCmdUnknown);
+	}
+
+	if( *pcArg != '\0' )
+	{
+		switch( pxCmd->ucArgType )
+		{
+			case eCmdArgInt:
+
+				// A single integer which fits in an int32
+				if( xTokLineToInt32( pcArg, &xArg.lInt ) != eTokOk )
+				{
+					return(eCmdBadNumber);
+				}
+
+				xArg.eType = eCmdArgInt;
+				break;
+
+			case eCmdArgWord:
+
+				xArg.eType = eCmdArgWord;
+				xArg.pcWord = pcArg;
+				break;
+
+			default:
+
+				return(eCmdNoArgument);
+		}
+	}
+
+	return( ( pxCmd->pxHandler( &xArg, pxQuit ) == pdPASS ) ? eCmdOk : eCmdFailed );
+}
+/*******************************************************************************
+*   Procedure: xCmdDispatch
+*
+*   Description: This function runs the command typed by the user with
+*   			 xCmdExecute(). An error is posted to the console if the
+*   			 command is unknown or the argument is not accepted. A handler
+*   			 failing posts its own messages.
+*
+*   Notes: None
+*
+*   Parameters: eMenu - The menu the command is looked up in
+*   			pcLine - A pointer to the NUL terminated line
+*   			pxQuit - A pointer passed on to the handler
+*
+*   Return: BaseType_t - pdPASS if the handler was called, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xCmdDispatch(CmdMenu_t eMenu, char* pcLine, BaseType_t* pxQuit)
+{
+	switch( xCmdExecute( eMenu, pcLine, NULL, pxQuit ) )
+	{
+		case eCmdUnknown:
+
+			vPostMsgToUartQueue("\r\nError: Unrecognized option selected\r\n");
+			return(pdFAIL);
+
+		case eCmdBadNumber:
+
+			vPostMsgToUartQueue("\r\nError: A number is expected after the option\r\n");
+			return(pdFAIL);
+
+		case eCmdNoArgument:
+
+			vPostMsgToUartQueue("\r\nError: The option takes no argument\r\n");
+			return(pdFAIL);
+
+		default:
+
+			return(pdPASS);
+	}
+}
+/*******************************************************************************
+*   Procedure: xCmdRunScript
+*
+*   Description: This function runs the commands of a script back to back. The
+*   			 commands are separated by ';' and empty ones are skipped.
+*   			 Instead of prompts, one status line is posted per command:
+*   			 "OK <n> <name>" or "ERR <n> <token>: <reason>", where n counts
+*   			 the commands of the script from 1. The script stops early if a
+*   			 handler sets *pxQuit.
+*
+*   Notes: The script is split in place.
+*
+*   Parameters: eMenu - The menu the commands are looked up in
+*   			pcScript - A pointer to the NUL terminated script
+*   			pxQuit - A pointer passed on to the handlers
+*
+*   Return: BaseType_t - pdPASS if every command succeeded, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xCmdRunScript(CmdMenu_t eMenu, char* pcScript, BaseType_t* pxQuit)
+{
+	char cStatus[CMD_STATUS_SIZE];		// Status line of a command
+	char* pcNext;						// Start of the next command
+	char* pcEnd;						// End of the token, to name an unknown command
+	const Cmd_t* pxCmd;					// Command found
+	CmdStatus_t xStatus;				// Result of the command
+	uint32_t ulCount = 0;				// Number of commands run
+	BaseType_t xResult = pdPASS;		// pdFAIL once a command fails
+
+	while( *pcScript != '\0' && *pxQuit == pdFALSE )
+	{
+		pcNext = strchr( pcScript, ';' );
+		if( pcNext != NULL )
+		{
+			*pcNext++ = '\0';
+		}
+		else
+		{
+			pcNext = &pcScript[strlen(pcScript)];
+		}
+
+		while( *pcScript == ' ' )
+		{
+			pcScript++;
+		}
+
+		if( *pcScript != '\0' )
+		{
+			ulCount++;
+			xStatus = xCmdExecute( eMenu, pcScript, &pxCmd, pxQuit );
+
+			if( xStatus == eCmdOk )
+			{
+				xFmtSnprintf( cStatus, sizeof(cStatus), "\r\nOK %lu %s", (unsigned long)ulCount, pxCmd->pcName );
+			}
+			else
+			{
+				// Name the command, or the token typed if the command is unknown
+				pcEnd = strchr( pcScript, ' ' );
+				if( pcEnd != NULL )
+				{
+					*pcEnd = '\0';
+				}
+
+				xFmtSnprintf( cStatus, sizeof(cStatus), "\r\nERR %lu %s: %s", (unsigned long)ulCount,
+							  ( pxCmd != NULL ) ? pxCmd->pcName : pcScript, pcCmdStatusText[xStatus] );
+				xResult = pdFAIL;
+			}
+
+			vPostMsgToUartQueue( cStatus );
+		}
+
+		pcScript = pcNext;
+	}
+
+	return(xResult);
+}
+/*******************************************************************************
+*   Procedure: cCmdLower
+*
+*   Description: This function converts an upper case ASCII letter to lower
+*   			 case. Any other character is returned as is.
+*
+*   Notes: None
+*
+*   Parameters: c - The character
+*
+*   Return: char - The converted character
+*
+*******************************************************************************/
+static char cCmdLower(char c)
+{
+	return( ( c >= 'A' && c <= 'Z' ) ? (char)( c - 'A' + 'a' ) : c );
+}
@@ -0,0 +1,1139 @@
+/**
+  ******************************************************************************
+  * @file    console.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Console output service. Messages posted by the tasks are copied
+  * 		 into a ring shaped output arena. Each message occupies one
+  * 		 contiguous block of the arena. A small descriptor (address, length
+  * 		 and the number of arena bytes used) is then pushed into the UART
+  * 		 write queue. The UART Write task transmits each message straight
+  * 		 out of the arena and releases its block afterwards. Since messages
+  * 		 are sent in the order they were posted, blocks are always released
+  * 		 in the order they were reserved, which keeps the arena a simple ring.
+  *
+  * 		 Producers keep no reference to their message once it is posted,
+  * 		 so stack buffers and buffers that are reused right away are safe.
+  *
+  * 		 Interrupt handlers cannot take the arena mutex. They store a pointer
+  * 		 to a constant message in a single-producer/single-consumer ring and
+  * 		 leave formatting and transmission to the UART Write task. If the
+  * 		 task is idle it is woken by a single empty "doorbell" descriptor,
+  * 		 for which one slot of the UART write queue is kept free.
+  *
+  * 		 Each message is posted with a policy which says what to do if the
+  * 		 arena or the queue is full: wait, drop the new message, drop the
+  * 		 oldest queued messages, or replace the single status line. Tasks
+  * 		 that must never wait on UART2 (e.g. the temperature monitor) use
+  * 		 one of the dropping policies. Drops, blocked time and high-water
+  * 		 marks are recorded per producer task and reported on request.
+  *
+  * 		 RTT channel CONSOLE_RTT_CHANNEL is the second link of the console,
+  * 		 carrying its own session. The output of the tasks bound to it
+  * 		 with xConsoleBindLink() is written straight into the RTT up buffer
+  * 		 instead of the arena. An RTT write is a copy into RAM which never
+  * 		 waits: bytes that do not fit because no host is reading are
+  * 		 dropped. Bulk data can be written to the RTT link by any task with
+  * 		 vConsoleRttWrite().
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <string.h>
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "console.h"
+#include "fmt.h"
+#include "uart_driver.h"
+#include "SEGGER_RTT.h"
+#include "ram_budget.h"
+
+// TYPES
+
+// Descriptor of a message held in the output arena
+typedef struct
+{
+	const char* pcData;		// Start of the message in the arena
+	uint16_t usLen;			// Number of bytes to transmit
+	uint16_t usCost;		// Number of arena bytes to release once sent (includes wrap padding)
+} ConsoleMsg_t;
+
+// Statistics of a task posting messages
+typedef struct
+{
+	TaskHandle_t xTask;			// Producer task, NULL if the entry is free
+	uint32_t ulPosted;			// Number of messages queued
+	uint32_t ulDropped;			// Number of messages dropped by its posts (its own or older ones it replaced)
+	uint32_t ulBlockedTicks;	// Ticks spent waiting for the console
+} ConsoleProducer_t;
+
+// CONSOLE GLOBALS
+
+// Queue of message descriptors waiting to be transmitted
+static QueueHandle_t xUartWriteQueue = NULL;
+
+// Mutex serializing producers while they reserve arena space and queue a descriptor
+static SemaphoreHandle_t xArenaMutex = NULL;
+
+// Given by the UART Write task each time it releases arena space
+static SemaphoreHandle_t xArenaSpaceFreed = NULL;
+
+// Storage of the queue and of the semaphores, allocated statically
+static StaticQueue_t xUartWriteQueueBuffer;
+static uint8_t ucUartWriteQueueStorage[( CONSOLE_QUEUE_LENGTH + 1 ) * sizeof(ConsoleMsg_t)];
+static StaticSemaphore_t xArenaMutexBuffer;
+static StaticSemaphore_t xArenaSpaceFreedBuffer;
+
+// Output arena
+static char cConsoleArena[CONSOLE_ARENA_SIZE];
+
+// Offset of the next free byte in the arena
+static size_t xArenaHead = 0;
+
+// Number of arena bytes in use. Written by producers and the UART Write task
+static volatile size_t xArenaUsed = 0;
+
+// Ring of constant messages posted from interrupt handlers
+// The head is only written by the ISR and the tail only by the UART Write task
+static const char* volatile pcIsrRing[CONSOLE_ISR_RING_SIZE];
+static volatile uint32_t ulIsrRingHead = 0;
+static volatile uint32_t ulIsrRingTail = 0;
+
+// Number of ISR messages dropped because the ring was full
+volatile uint32_t ulIsrMsgsDropped = 0;
+
+// Set while a doorbell descriptor is sitting in the UART write queue
+static volatile BaseType_t xDoorbellPending = pdFALSE;
+
+// Arena bytes of queued messages dropped by producers. They are released by the
+// UART Write task together with the next message it receives, which keeps the
+// blocks released in the order they were reserved
+static volatile size_t xArenaDropped = 0;
+
+// Status line waiting to be sent (eConsoleStatus) and the copy being sent
+static char cStatusLine[CONSOLE_STATUS_SIZE];
+static volatile size_t xStatusLen = 0;
+static char cStatusTx[CONSOLE_STATUS_SIZE];
+static volatile BaseType_t xStatusSending = pdFALSE;
+
+// Baud rate the UART Write task is to switch UART2 to, 0 if none
+static volatile uint32_t ulBaudRateRequest = 0;
+
+// Statistics. Only updated with xArenaMutex held
+static ConsoleProducer_t xProducers[CONSOLE_MAX_PRODUCERS];
+static uint32_t ulQueueHighWater = 0;
+static size_t xArenaHighWater = 0;
+static uint32_t ulDroppedNewest = 0;
+static uint32_t ulDroppedOldest = 0;
+static uint32_t ulStatusReplaced = 0;
+
+// Buffers of the RTT link, read and written by the debug probe
+static char cRttUpBuffer[CONSOLE_RTT_UP_SIZE];
+static char cRttDownBuffer[CONSOLE_RTT_DOWN_SIZE];
+
+// Tasks whose output goes to another link than UART2. Only written before the
+// scheduler is started
+static struct
+{
+	TaskHandle_t xTask;			// Bound task, NULL if the entry is free
+	ConsoleLink_t eLink;		// Link of its output
+} xBindings[CONSOLE_MAX_BINDINGS];
+
+RAM_BUDGET_CHECK( sizeof(xUartWriteQueueBuffer) + sizeof(ucUartWriteQueueStorage) + sizeof(xArenaMutexBuffer) +
+				  sizeof(xArenaSpaceFreedBuffer) + sizeof(cConsoleArena) + sizeof(cStatusLine) + sizeof(cStatusTx) +
+				  sizeof(cRttUpBuffer) + sizeof(cRttDownBuffer) + sizeof(xBindings), RAM_BUDGET_CONSOLE );
+
+// FUNCTION PROTOTYPES
+
+// To reserve a contiguous block of the output arena
+static char* pcArenaReserve(size_t xLen, uint16_t* pusCost);
+
+// To release the oldest reserved blocks of the output arena
+static void vArenaRelease(size_t xCost);
+
+// To transmit the messages posted by interrupt handlers
+static void vDrainIsrRing(void);
+
+// To transmit a span of the arena and release it
+static void vSendSpan(const char* pcSpan, size_t xLen, size_t xCost);
+
+// To transmit the status line
+static void vSendStatusLine(void);
+
+// To drop queued messages, oldest first, till a block of the arena can be reserved
+static char* pcArenaMakeRoom(size_t xLen, uint16_t* pusCost, ConsoleProducer_t* pxProducer);
+
+// To replace the status line and wake up the UART Write task
+static void vPostStatusLine(const char* pcMsg, size_t xLen);
+
+// To find the statistics entry of the calling task
+static ConsoleProducer_t* pxGetProducer(void);
+/*******************************************************************************
+*   Procedure: xConsoleInit
+*
+*   Description: This function creates the UART write queue and the objects
+*   			 protecting the output arena, in statically allocated storage,
+*   			 and sets up the RTT buffers of the second link. It must be
+*   			 called before the scheduler is started.
+*
+*   Notes: Called after SEGGER_SYSVIEW_Conf(), which sets up the RTT control
+*   	   block.
+*
+*   Parameters: None
+*
+*   Return: BaseType_t - pdPASS if all objects were created, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xConsoleInit(void)
+{
+	// One extra slot is kept free for the doorbell posted from interrupt handlers
+	xUartWriteQueue = xQueueCreateStatic(CONSOLE_QUEUE_LENGTH + 1, sizeof(ConsoleMsg_t), ucUartWriteQueueStorage,
+										 &xUartWriteQueueBuffer);
+	xArenaMutex = xSemaphoreCreateMutexStatic(&xArenaMutexBuffer);
+	xArenaSpaceFreed = xSemaphoreCreateBinaryStatic(&xArenaSpaceFreedBuffer);
+
+	if( xUartWriteQueue == NULL || xArenaMutex == NULL || xArenaSpaceFreed == NULL )
+	{
+		return(pdFAIL);
+	}
+
+	// Output is trimmed rather than waiting when the host is not reading
+	if( SEGGER_RTT_ConfigUpBuffer( CONSOLE_RTT_CHANNEL, "Console", cRttUpBuffer, sizeof(cRttUpBuffer),
+								   SEGGER_RTT_MODE_NO_BLOCK_TRIM ) < 0 ||
+		SEGGER_RTT_ConfigDownBuffer( CONSOLE_RTT_CHANNEL, "Console", cRttDownBuffer, sizeof(cRttDownBuffer),
+									 SEGGER_RTT_MODE_NO_BLOCK_TRIM ) < 0 )
+	{
+		return(pdFAIL);
+	}
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: vUartWriteTaskFunction
+*
+*   Description: This is the task function for the UART Write Task. It supports other
+*   			 tasks by serializing message transmission to UART2. This helps avoid
+*   			 race condition to use UART2. A message will first be copied into the
+*   			 output arena and its descriptor posted to the xUartWriteQueue. The UART
+*   			 Write Task will then be moved from blocked state to ready state and
+*   			 eventually it will run. Afterwards, this task function will run and the
+*   			 posted message will be de-queued and transmitted via UART2 straight
+*   			 out of the arena. The transmission is done by DMA and this task stays
+*   			 in blocked state till the DMA transfer is complete, leaving the CPU to
+*   			 other tasks. The arena space of the message is released afterwards.
+*
+*   			 With CONSOLE_BATCH_WRITES set, every message already queued is drained
+*   			 without blocking once the first one is received. Messages sitting next
+*   			 to each other in the arena are merged into one span and sent with a
+*   			 single DMA transfer. A burst such as the three temperature statistics
+*   			 lines then costs one wake up and one transfer instead of three.
+*
+*   			 Messages posted by interrupt handlers are sent after the queued ones,
+*   			 followed by the status line. A baud rate change requested with
+*   			 xConsoleSetBaudRate() is applied once the queue is empty, when no
+*   			 transfer is in progress.
+*
+*   Notes: None
+*
+*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
+*   			in this task function
+*
+*   Return: None
+*
+*******************************************************************************/
+void vUartWriteTaskFunction(void *pvParam)
+{
+	ConsoleMsg_t xMsg;			// To hold the descriptor of the message received
+	const char* pcSpan = NULL;	// Start of the span of adjacent messages to send
+	size_t xSpanLen;			// Number of bytes in the span
+	size_t xSpanCost;			// Number of arena bytes to release once the span is sent
+	BaseType_t xReceived;		// Flag to indicate if a descriptor was received
+
+	// Task handler should always be executing
+	while(1)
+	{
+		xSpanLen = 0;
+		xSpanCost = 0;
+
+		// Receive an item from the UART write queue
+		// The task will block waiting indefinitely till an item becomes available on the queue to receive
+		xReceived = xQueueReceive( xUartWriteQueue, &xMsg, portMAX_DELAY );
+
+		while( xReceived == pdPASS )
+		{
+			if( xMsg.pcData == NULL )
+			{
+				// A doorbell from an interrupt handler or for the status line. Clear the flag
+				// before draining the ring so a message posted meanwhile rings again
+				xDoorbellPending = pdFALSE;
+			}
+			else
+			{
+				// Messages dropped from the queue so far sit between the span and this
+				// message, so release their space together with this message
+				taskENTER_CRITICAL();
+				xMsg.usCost += (uint16_t)xArenaDropped;
+				xArenaDropped = 0;
+				taskEXIT_CRITICAL();
+
+				if( xSpanCost > 0 && xMsg.pcData == pcSpan + xSpanLen )
+				{
+					// The message follows the span in the arena so extend the span
+					xSpanLen += xMsg.usLen;
+					xSpanCost += xMsg.usCost;
+				}
+				else
+				{
+					// The arena wrapped around or messages were dropped in between
+					// Send the span so far and start a new one
+					vSendSpan(pcSpan, xSpanLen, xSpanCost);
+
+					pcSpan = xMsg.pcData;
+					xSpanLen = xMsg.usLen;
+					xSpanCost = xMsg.usCost;
+				}
+			}
+
+#if CONSOLE_BATCH_WRITES == 1
+			// Drain whatever else is queued without blocking
+			xReceived = xQueueReceive( xUartWriteQueue, &xMsg, 0 );
+#else
+			xReceived = pdFAIL;
+#endif
+		}
+
+		// Print the message(s) on terminal window using UART
+		// The task will block while DMA transmits the span
+		vSendSpan(pcSpan, xSpanLen, xSpanCost);
+
+		// Send whatever interrupt handlers have posted in the meantime, then the status line
+		vDrainIsrRing();
+		vSendStatusLine();
+
+		// Nothing is being sent, so UART2 can be reprogrammed. Wait till the queue is
+		// empty so that every message posted before the request is sent at the old rate
+		if( ulBaudRateRequest != 0 && uxQueueMessagesWaiting( xUartWriteQueue ) == 0 )
+		{
+			(void)xUartSetBaudRate( ulBaudRateRequest );
+			ulBaudRateRequest = 0;
+		}
+	}
+}
+/*******************************************************************************
+*   Procedure: vSendSpan
+*
+*   Description: This function transmits a span of adjacent messages straight
+*   			 out of the arena and then releases the arena bytes they took.
+*
+*   Notes: Only called by the UART Write task. A span may hold no byte to send
+*   	   but still have arena bytes to release, left by dropped messages.
+*
+*   Parameters: pcSpan - A pointer to the first byte of the span
+*   			xLen - The number of bytes to send
+*   			xCost - The number of arena bytes to release
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vSendSpan(const char* pcSpan, size_t xLen, size_t xCost)
+{
+	if( xLen > 0 )
+	{
+		vUartWrite(pcSpan, xLen);
+	}
+
+	if( xCost > 0 )
+	{
+		// The span is sent so its arena space can be reused
+		vArenaRelease(xCost);
+	}
+}
+/*******************************************************************************
+*   Procedure: xConsoleBindLink
+*
+*   Description: This function sends the output of a task to another link than
+*   			 UART2, making the task part of the session on that link. The
+*   			 tasks not bound to a link write to UART2.
+*
+*   Notes: Must be called before the scheduler is started.
+*
+*   Parameters: xTask - The task
+*   			eLink - The link of its output
+*
+*   Return: BaseType_t - pdPASS if the task is bound, pdFAIL if the table is full
+*
+*******************************************************************************/
+BaseType_t xConsoleBindLink(TaskHandle_t xTask, ConsoleLink_t eLink)
+{
+	for( uint32_t i = 0; i < CONSOLE_MAX_BINDINGS; i++ )
+	{
+		if( xBindings[i].xTask == NULL || xBindings[i].xTask == xTask )
+		{
+			xBindings[i].eLink = eLink;
+			xBindings[i].xTask = xTask;
+			return(pdPASS);
+		}
+	}
+
+	return(pdFAIL);
+}
+/*******************************************************************************
+*   Procedure: xConsoleGetLink
+*
+*   Description: This function returns the link the output of the calling task
+*   			 is sent to
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: ConsoleLink_t - The link, eConsoleLinkUart if the task is not bound
+*
+*******************************************************************************/
+ConsoleLink_t xConsoleGetLink(void)
+{
+	TaskHandle_t xTask = xTaskGetCurrentTaskHandle();	// Calling task
+
+	for( uint32_t i = 0; i < CONSOLE_MAX_BINDINGS && xBindings[i].xTask != NULL; i++ )
+	{
+		if( xBindings[i].xTask == xTask )
+		{
+			return(xBindings[i].eLink);
+		}
+	}
+
+	return(eConsoleLinkUart);
+}
+/*******************************************************************************
+*   Procedure: vConsoleRttWrite
+*
+*   Description: This function copies bytes into the RTT up buffer of the
+*   			 console, from where the debug probe reads them. It never
+*   			 waits, the bytes that do not fit are dropped. Bulk data such
+*   			 as dumps and traces written here cost a copy into RAM and do
+*   			 not hold up UART2.
+*
+*   Notes: May be called from any task. SEGGER_RTT_Write() masks the
+*   	   interrupts up to SEGGER_RTT_MAX_INTERRUPT_PRIORITY meanwhile.
+*
+*   Parameters: pcData - A pointer to the bytes
+*   			xLen - The number of bytes
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleRttWrite(const char* pcData, size_t xLen)
+{
+	SEGGER_RTT_Write( CONSOLE_RTT_CHANNEL, pcData, xLen );
+}
+/*******************************************************************************
+*   Procedure: vPostMsgToUartQueue
+*
+*   Description: This function copies a message into the output arena and posts
+*   			 its descriptor to the UART write queue so it can be printed on
+*   			 the UART window for the user to see, or writes it to the link
+*   			 the calling task is bound to. The caller may reuse or discard
+*   			 its buffer as soon as this function returns.
+*
+*   Notes: The calling task blocks if the arena or the queue is full, till the
+*   	   UART Write task has released enough space (eConsoleBlock). Must not
+*   	   be called from an ISR.
+*
+*   Parameters: pcUartMsg - A pointer to a null terminated message
+*
+*   Return: None
+*
+*******************************************************************************/
+void vPostMsgToUartQueue(const char* pcUartMsg)
+{
+	vConsolePost( pcUartMsg, eConsoleBlock );
+}
+/*******************************************************************************
+*   Procedure: vConsolePost
+*
+*   Description: This function posts a null terminated message to the console
+*   			 with the given policy. See vConsoleWrite().
+*
+*   Notes: Must not be called from an ISR.
+*
+*   Parameters: pcMsg - A pointer to a null terminated message
+*   			ePolicy - What to do if the console cannot take the message
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsolePost(const char* pcMsg, ConsolePolicy_t ePolicy)
+{
+	vConsoleWrite( pcMsg, strlen(pcMsg), ePolicy );
+}
+/*******************************************************************************
+*   Procedure: vConsoleWrite
+*
+*   Description: This function posts a message to the link the output of the
+*   			 calling task is sent to. See vConsoleWriteToLink().
+*
+*   Notes: Must not be called from an ISR.
+*
+*   Parameters: pcData - A pointer to the message
+*   			xLen - The number of bytes of the message
+*   			ePolicy - What to do if the console cannot take the message
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleWrite(const char* pcData, size_t xLen, ConsolePolicy_t ePolicy)
+{
+	vConsoleWriteToLink( xConsoleGetLink(), pcData, xLen, ePolicy );
+}
+/*******************************************************************************
+*   Procedure: vConsoleWriteToLink
+*
+*   Description: This function posts a message to a link. A message for the RTT
+*   			 link is written straight into its up buffer, see
+*   			 vConsoleRttWrite(). A message for UART2 is copied into the
+*   			 output arena and its descriptor posted to the UART write
+*   			 queue. If there is no room the
+*   			 policy decides whether the calling task waits, drops the message,
+*   			 or drops the oldest queued messages. Status messages go to the
+*   			 status line instead of the arena. The message may hold any byte,
+*   			 including 0, so it can be used for binary frames.
+*
+*   Notes: Only eConsoleBlock may block on UART2 speed. The other policies only
+*   	   wait for other producers to finish copying. Messages longer than the
+*   	   arena are truncated. Must not be called from an ISR.
+*
+*   Parameters: eLink - The link to send the message over
+*   			pcData - A pointer to the message
+*   			xLen - The number of bytes of the message
+*   			ePolicy - What to do if the console cannot take the message
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleWriteToLink(ConsoleLink_t eLink, const char* pcData, size_t xLen, ConsolePolicy_t ePolicy)
+{
+	char* pcSlot = NULL;			  // Arena block reserved for the message
+	uint16_t usCost = 0;			  // Arena bytes taken by the block
+	ConsoleMsg_t xMsg;				  // Descriptor to post
+	ConsoleProducer_t* pxProducer;	  // Statistics of the calling task
+	TickType_t xStart;				  // Tick count at the time the calling task started waiting
+	uint32_t ulWaiting;				  // Number of messages waiting in the queue
+
+	if( xLen == 0 )
+	{
+		return;
+	}
+
+	if( eLink == eConsoleLinkRtt )
+	{
+		// Never waits, whatever the policy
+		vConsoleRttWrite( pcData, xLen );
+		return;
+	}
+
+	if( xLen > CONSOLE_ARENA_SIZE )
+	{
+		xLen = CONSOLE_ARENA_SIZE;
+	}
+
+	if( ePolicy == eConsoleStatus )
+	{
+		vPostStatusLine( pcData, xLen );
+		return;
+	}
+
+	xStart = xTaskGetTickCount();
+
+	while(1)
+	{
+		// Reserving the block and queuing its descriptor must not be interleaved
+		// with another producer, otherwise blocks would not be released in order
+		xSemaphoreTake( xArenaMutex, portMAX_DELAY );
+
+		pxProducer = pxGetProducer();
+		pcSlot = NULL;
+
+		// Only reserve a block if its descriptor can be queued right away
+		// The last free slot of the queue is kept for the interrupt doorbell
+		if( uxQueueSpacesAvailable( xUartWriteQueue ) > 1 )
+		{
+			pcSlot = pcArenaReserve( xLen, &usCost );
+		}
+
+		if( pcSlot == NULL && ePolicy == eConsoleDropOldest )
+		{
+			pcSlot = pcArenaMakeRoom( xLen, &usCost, pxProducer );
+		}
+
+		if( pcSlot != NULL )
+		{
+			memcpy( pcSlot, pcData, xLen );
+
+			xMsg.pcData = pcSlot;
+			xMsg.usLen = (uint16_t)xLen;
+			xMsg.usCost = usCost;
+
+			// Space is guaranteed since only producers holding the mutex add messages to the queue
+			xQueueSend( xUartWriteQueue, &xMsg, 0 );
+
+			ulWaiting = uxQueueMessagesWaiting( xUartWriteQueue );
+			if( ulWaiting > ulQueueHighWater )
+			{
+				ulQueueHighWater = ulWaiting;
+			}
+
+			if( xArenaUsed > xArenaHighWater )
+			{
+				xArenaHighWater = xArenaUsed;
+			}
+
+			if( pxProducer != NULL )
+			{
+				pxProducer->ulPosted++;
+				pxProducer->ulBlockedTicks += xTaskGetTickCount() - xStart;
+			}
+
+			xSemaphoreGive( xArenaMutex );
+			break;
+		}
+
+		if( ePolicy != eConsoleBlock )
+		{
+			// Drop the message being posted
+			ulDroppedNewest++;
+
+			if( pxProducer != NULL )
+			{
+				pxProducer->ulDropped++;
+			}
+
+			// The last free slot of the queue is kept for the interrupt doorbell
+			if( xArenaDropped > 0 && uxQueueSpacesAvailable( xUartWriteQueue ) > 1 )
+			{
+				// Messages were dropped to make room but not enough. Queue an empty
+				// message so the UART Write task releases their space. Otherwise
+				// messages are already queued and the first one sent releases it
+				xMsg.pcData = cConsoleArena;
+				xMsg.usLen = 0;
+				xMsg.usCost = 0;
+				xQueueSend( xUartWriteQueue, &xMsg, 0 );
+			}
+
+			xSemaphoreGive( xArenaMutex );
+			break;
+		}
+
+		xSemaphoreGive( xArenaMutex );
+
+		// Wait in blocked state till the UART Write task releases some space
+		xSemaphoreTake( xArenaSpaceFreed, portMAX_DELAY );
+	}
+}
+/*******************************************************************************
+*   Procedure: pcArenaMakeRoom
+*
+*   Description: This function takes queued messages out of the UART write
+*   			 queue, oldest first, till a block of xLen bytes can be reserved
+*   			 or the queue is empty. The space of the dropped messages is
+*   			 handed to the UART Write task through xArenaDropped, since the
+*   			 messages it is sending are older and still use the arena.
+*
+*   Notes: Must be called with xArenaMutex held. A doorbell taken out of the
+*   	   queue is not counted as a message and is queued again at the end.
+*
+*   Parameters: xLen - The number of bytes to reserve
+*   			pusCost - A pointer to a location that will hold the number of
+*   			arena bytes taken, including any bytes skipped at the end
+*   			pxProducer - The statistics of the calling task, may be NULL
+*
+*   Return: char* - The start of the reserved block or NULL if there is no room
+*
+*******************************************************************************/
+static char* pcArenaMakeRoom(size_t xLen, uint16_t* pusCost, ConsoleProducer_t* pxProducer)
+{
+	char* pcSlot = NULL;		// Reserved block
+	static const ConsoleMsg_t xDoorbell = { NULL, 0, 0 };	// Empty descriptor used as a doorbell
+	ConsoleMsg_t xOldest;		// Descriptor of the oldest queued message
+	BaseType_t xTaken;			// Flag to indicate if a descriptor was taken out of the queue
+	BaseType_t xRing = pdFALSE;	// Flag to indicate if a doorbell was taken out of the queue
+
+	do
+	{
+		// The UART Write task must not see the descriptor gone before its space is accounted for
+		taskENTER_CRITICAL();
+
+		xTaken = xQueueReceive( xUartWriteQueue, &xOldest, 0 );
+
+		if( xTaken == pdPASS )
+		{
+			if( xOldest.pcData == NULL )
+			{
+				xRing = pdTRUE;
+			}
+			else
+			{
+				xArenaDropped += xOldest.usCost;
+				ulDroppedOldest++;
+			}
+		}
+
+		taskEXIT_CRITICAL();
+
+		if( xTaken == pdPASS && xOldest.pcData != NULL && pxProducer != NULL )
+		{
+			pxProducer->ulDropped++;
+		}
+
+		if( xTaken == pdPASS && uxQueueSpacesAvailable( xUartWriteQueue ) > 1 )
+		{
+			// The arena space of the dropped messages is not free yet, so this only
+			// succeeds if the arena was not the limit
+			pcSlot = pcArenaReserve( xLen, pusCost );
+		}
+	} while( pcSlot == NULL && xTaken == pdPASS );
+
+	if( xRing == pdTRUE )
+	{
+		// Put the doorbell back. There is room since at least one slot is kept for it
+		xQueueSendToBack( xUartWriteQueue, &xDoorbell, 0 );
+	}
+
+	return(pcSlot);
+}
+/*******************************************************************************
+*   Procedure: vPostStatusLine
+*
+*   Description: This function copies a message into the status line and rings
+*   			 the doorbell of the UART Write task. A status line which has not
+*   			 been sent yet is replaced, so only the latest one is printed. The
+*   			 status line is sent after the queued messages.
+*
+*   Notes: Messages longer than CONSOLE_STATUS_SIZE are truncated.
+*
+*   Parameters: pcMsg - A pointer to the message
+*   			xLen - The number of bytes to copy
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vPostStatusLine(const char* pcMsg, size_t xLen)
+{
+	static const ConsoleMsg_t xDoorbell = { NULL, 0, 0 };	// Empty descriptor used as a doorbell
+
+	if( xLen > CONSOLE_STATUS_SIZE )
+	{
+		xLen = CONSOLE_STATUS_SIZE;
+	}
+
+	taskENTER_CRITICAL();
+
+	if( xStatusLen > 0 )
+	{
+		ulStatusReplaced++;
+	}
+
+	memcpy( cStatusLine, pcMsg, xLen );
+	xStatusLen = xLen;
+
+	// The doorbell is shared with interrupt handlers, which also set the flag
+	if( xDoorbellPending == pdFALSE )
+	{
+		// Should the queue be full, the messages queued wake the UART Write task anyway
+		xDoorbellPending = ( xQueueSendToBack( xUartWriteQueue, &xDoorbell, 0 ) == pdPASS ) ? pdTRUE : pdFALSE;
+	}
+
+	taskEXIT_CRITICAL();
+}
+/*******************************************************************************
+*   Procedure: vSendStatusLine
+*
+*   Description: This function transmits the status line if one is waiting. It
+*   			 is copied first so it can be replaced while it is being sent.
+*
+*   Notes: Only called by the UART Write task.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vSendStatusLine(void)
+{
+	size_t xLen;	// Length of the status line
+
+	taskENTER_CRITICAL();
+	xLen = xStatusLen;
+	memcpy( cStatusTx, cStatusLine, xLen );
+	xStatusLen = 0;
+	xStatusSending = ( xLen > 0 ) ? pdTRUE : pdFALSE;
+	taskEXIT_CRITICAL();
+
+	if( xLen > 0 )
+	{
+		vUartWrite( cStatusTx, xLen );
+		xStatusSending = pdFALSE;
+	}
+}
+/*******************************************************************************
+*   Procedure: pxGetProducer
+*
+*   Description: This function returns the statistics entry of the calling task,
+*   			 taking a free entry on its first call.
+*
+*   Notes: Must be called with xArenaMutex held.
+*
+*   Parameters: None
+*
+*   Return: ConsoleProducer_t* - The entry or NULL if the table is full
+*
+*******************************************************************************/
+static ConsoleProducer_t* pxGetProducer(void)
+{
+	TaskHandle_t xTask = xTaskGetCurrentTaskHandle();	// Calling task
+
+	for( uint32_t i = 0; i < CONSOLE_MAX_PRODUCERS; i++ )
+	{
+		if( xProducers[i].xTask == NULL )
+		{
+			xProducers[i].xTask = xTask;
+		}
+
+		if( xProducers[i].xTask == xTask )
+		{
+			return( &xProducers[i] );
+		}
+	}
+
+	return(NULL);
+}
+/*******************************************************************************
+*   Procedure: vConsoleNoteDrop
+*
+*   Description: This function counts a message dropped by the calling task
+*   			 before it reached the console, e.g. a log record which did not
+*   			 fit in the log queue.
+*
+*   Notes: Must not be called from an ISR.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleNoteDrop(void)
+{
+	ConsoleProducer_t* pxProducer;	  // Statistics of the calling task
+
+	xSemaphoreTake( xArenaMutex, portMAX_DELAY );
+
+	ulDroppedNewest++;
+
+	pxProducer = pxGetProducer();
+	if( pxProducer != NULL )
+	{
+		pxProducer->ulDropped++;
+	}
+
+	xSemaphoreGive( xArenaMutex );
+}
+/*******************************************************************************
+*   Procedure: vConsoleReportStats
+*
+*   Description: This function prints the console statistics: the high-water
+*   			 marks of the UART write queue and the arena, the messages
+*   			 dropped per policy, and for each producer task the number of
+*   			 messages posted and dropped and the time spent waiting.
+*
+*   Notes: The report is posted with eConsoleBlock. Must not be called from an ISR.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleReportStats(void)
+{
+	char cLine[120];						// One line of the report
+	ConsoleProducer_t xProducer;			// Snapshot of a producer entry
+
+	xSemaphoreTake( xArenaMutex, portMAX_DELAY );
+	xFmtSnprintf( cLine, sizeof(cLine), "\r\n\nQueue high-water mark: %lu/%u messages\
+			     \r\nArena high-water mark: %u/%u bytes",
+				  (unsigned long)ulQueueHighWater, (unsigned)CONSOLE_QUEUE_LENGTH,
+				  (unsigned)xArenaHighWater, (unsigned)CONSOLE_ARENA_SIZE );
+	xSemaphoreGive( xArenaMutex );
+	vPostMsgToUartQueue( cLine );
+
+	xSemaphoreTake( xArenaMutex, portMAX_DELAY );
+	xFmtSnprintf( cLine, sizeof(cLine), "\r\nDropped: %lu newest, %lu oldest, %lu status, %lu from ISRs",
+				  (unsigned long)ulDroppedNewest, (unsigned long)ulDroppedOldest,
+				  (unsigned long)ulStatusReplaced, (unsigned long)ulIsrMsgsDropped );
+	xSemaphoreGive( xArenaMutex );
+	vPostMsgToUartQueue( cLine );
+
+	vPostMsgToUartQueue( "\r\nTask                 Posted  Dropped  Blocked(ms)" );
+
+	for( uint32_t i = 0; i < CONSOLE_MAX_PRODUCERS; i++ )
+	{
+		xSemaphoreTake( xArenaMutex, portMAX_DELAY );
+		xProducer = xProducers[i];
+		xSemaphoreGive( xArenaMutex );
+
+		if( xProducer.xTask == NULL )
+		{
+			break;
+		}
+
+		xFmtSnprintf( cLine, sizeof(cLine), "\r\n%-20s %7lu  %7lu  %11lu",
+					  pcTaskGetName( xProducer.xTask ), (unsigned long)xProducer.ulPosted,
+					  (unsigned long)xProducer.ulDropped,
+					  (unsigned long)( xProducer.ulBlockedTicks * portTICK_PERIOD_MS ) );
+		vPostMsgToUartQueue( cLine );
+	}
+
+	vPostMsgToUartQueue( "\r\n" );
+}
+/*******************************************************************************
+*   Procedure: vConsoleFlush
+*
+*   Description: This function waits till every message queued so far, from
+*   			 tasks or interrupt handlers, has been handed to UART2. It is
+*   			 used before UART2 stops, e.g. before going to sleep.
+*
+*   Notes: The calling task polls every tick while waiting. The last byte may
+*   	   still be in the UART2 shift register when this function returns.
+*   	   Must not be called from an ISR or by the UART Write task.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleFlush(void)
+{
+	// Arena blocks are released after they are sent, and the ISR ring and the status
+	// line are sent after the queue, so all of them are empty once everything is sent
+	while( xArenaUsed != 0 || ulIsrRingTail != ulIsrRingHead ||
+		   uxQueueMessagesWaiting( xUartWriteQueue ) != 0 ||
+		   xStatusLen != 0 || xStatusSending == pdTRUE )
+	{
+		vTaskDelay(1);
+	}
+}
+/*******************************************************************************
+*   Procedure: xConsoleSetBaudRate
+*
+*   Description: This function switches UART2 to a new baud rate. The messages
+*   			 posted so far by the calling task are sent at the old rate
+*   			 and the ones it posts afterwards at the new rate.
+*
+*   Notes: The UART Write task reprograms UART2 between two transfers, so no
+*   	   producer can start one while the rate changes. The calling task
+*   	   polls every tick while waiting. Must not be called from an ISR or
+*   	   by the UART Write task.
+*
+*   Parameters: ulBaudRate - The new baud rate
+*
+*   Return: BaseType_t - pdPASS if the rate is applied, pdFAIL if
+*   		xUartBaudRateSupported() rejects it
+*
+*******************************************************************************/
+BaseType_t xConsoleSetBaudRate(uint32_t ulBaudRate)
+{
+	static const ConsoleMsg_t xDoorbell = { NULL, 0, 0 };	// Empty descriptor used as a doorbell
+
+	if( xUartBaudRateSupported( ulBaudRate ) == pdFALSE )
+	{
+		return(pdFAIL);
+	}
+
+	taskENTER_CRITICAL();
+
+	ulBaudRateRequest = ulBaudRate;
+
+	// The doorbell is shared with interrupt handlers, which also set the flag
+	if( xDoorbellPending == pdFALSE )
+	{
+		// Should the queue be full, the messages queued wake the UART Write task anyway
+		xDoorbellPending = ( xQueueSendToBack( xUartWriteQueue, &xDoorbell, 0 ) == pdPASS ) ? pdTRUE : pdFALSE;
+	}
+
+	taskEXIT_CRITICAL();
+
+	while( ulBaudRateRequest != 0 )
+	{
+		vTaskDelay(1);
+	}
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: pcArenaReserve
+*
+*   Description: This function reserves a contiguous block of xLen bytes in the
+*   			 output arena. The free space of the ring is the region from the
+*   			 head to the oldest block still in use. If the block does not fit
+*   			 before the end of the arena, the remaining bytes at the end are
+*   			 skipped and the block is placed at the start of the arena.
+*
+*   Notes: Must be called with xArenaMutex held.
+*
+*   Parameters: xLen - The number of bytes to reserve
+*   			pusCost - A pointer to a location that will hold the number of
+*   			arena bytes taken, including any bytes skipped at the end
+*
+*   Return: char* - The start of the reserved block or NULL if there is no room
+*
+*******************************************************************************/
+static char* pcArenaReserve(size_t xLen, uint16_t* pusCost)
+{
+	char* pcSlot = NULL;	// Reserved block
+	size_t xUsed;			// Snapshot of the arena bytes in use
+	size_t xTail;			// Offset of the oldest block still in use
+	size_t xSkip = 0;		// Bytes skipped at the end of the arena
+
+	taskENTER_CRITICAL();
+
+	xUsed = xArenaUsed;
+
+	// If the arena is empty start from the beginning to keep messages contiguous
+	if( xUsed == 0 )
+	{
+		xArenaHead = 0;
+	}
+
+	xTail = ( xArenaHead + CONSOLE_ARENA_SIZE - xUsed ) % CONSOLE_ARENA_SIZE;
+
+	if( xUsed < CONSOLE_ARENA_SIZE )
+	{
+		if( xArenaHead >= xTail )
+		{
+			// Free space is from the head to the end and from the start to the tail
+			if( CONSOLE_ARENA_SIZE - xArenaHead >= xLen )
+			{
+				pcSlot = &cConsoleArena[xArenaHead];
+			}
+			else if( xTail >= xLen )
+			{
+				xSkip = CONSOLE_ARENA_SIZE - xArenaHead;
+				pcSlot = &cConsoleArena[0];
+			}
+		}
+		else if( xTail - xArenaHead >= xLen )
+		{
+			// Free space is from the head to the tail
+			pcSlot = &cConsoleArena[xArenaHead];
+		}
+	}
+
+	if( pcSlot != NULL )
+	{
+		*pusCost = (uint16_t)( xLen + xSkip );
+		xArenaUsed = xUsed + xLen + xSkip;
+		xArenaHead = ( ( pcSlot - cConsoleArena ) + xLen ) % CONSOLE_ARENA_SIZE;
+	}
+
+	taskEXIT_CRITICAL();
+
+	return(pcSlot);
+}
+/*******************************************************************************
+*   Procedure: vArenaRelease
+*
+*   Description: This function releases the oldest reserved block(s) of the output
+*   			 arena and wakes up a producer waiting for space, if any.
+*
+*   Notes: Only called by the UART Write task.
+*
+*   Parameters: xCost - The number of arena bytes taken by the block(s)
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vArenaRelease(size_t xCost)
+{
+	taskENTER_CRITICAL();
+	xArenaUsed -= xCost;
+	taskEXIT_CRITICAL();
+
+	xSemaphoreGive( xArenaSpaceFreed );
+}
+/*******************************************************************************
+*   Procedure: vPostMsgToUartQueueFromISR
+*
+*   Description: This function queues a constant message for transmission from
+*   			 an interrupt handler. It only stores the pointer in the ISR
+*   			 ring and, if the UART Write task is not already due to look at
+*   			 the ring, posts a doorbell to wake it up. No waiting on UART2
+*   			 happens inside the interrupt.
+*
+*   Notes: The message must stay valid forever (e.g. a string literal). The ring
+*   	   has a single producer, so only interrupts of the same priority level may
+*   	   call this function. If the ring is full the message is dropped and
+*   	   counted in ulIsrMsgsDropped.
+*
+*   Parameters: pcConstMsg - A pointer to a constant null terminated message
+*   			pxHigherPriorityTaskWoken - Set to pdTRUE if posting the doorbell
+*   			woke a task with a higher priority than the interrupted one
+*
+*   Return: None
+*
+*******************************************************************************/
+void vPostMsgToUartQueueFromISR(const char* pcConstMsg, BaseType_t* pxHigherPriorityTaskWoken)
+{
+	static const ConsoleMsg_t xDoorbell = { NULL, 0, 0 };	// Empty descriptor used as a doorbell
+	uint32_t ulHead = ulIsrRingHead;	// Local copy of the ring head
+
+	if( ulHead - ulIsrRingTail >= CONSOLE_ISR_RING_SIZE )
+	{
+		// The ring is full
+		ulIsrMsgsDropped++;
+		return;
+	}
+
+	pcIsrRing[ulHead & ( CONSOLE_ISR_RING_SIZE - 1 )] = pcConstMsg;
+
+	// Make sure the entry is written before the consumer can see the new head
+	__DMB();
+	ulIsrRingHead = ulHead + 1;
+
+	if( xDoorbellPending == pdFALSE )
+	{
+		// Should the queue be full, the messages queued wake the UART Write task anyway
+		xDoorbellPending = ( xQueueSendToBackFromISR( xUartWriteQueue, &xDoorbell, pxHigherPriorityTaskWoken ) == pdPASS ) ? pdTRUE : pdFALSE;
+	}
+}
+/*******************************************************************************
+*   Procedure: vDrainIsrRing
+*
+*   Description: This function transmits every message posted by interrupt
+*   			 handlers since the last call, in the order they were posted.
+*
+*   Notes: Only called by the UART Write task.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vDrainIsrRing(void)
+{
+	const char* pcMsg;	// Message taken from the ring
+
+	while( ulIsrRingTail != ulIsrRingHead )
+	{
+		pcMsg = pcIsrRing[ulIsrRingTail & ( CONSOLE_ISR_RING_SIZE - 1 )];
+
+		vUartWrite(pcMsg, strlen(pcMsg));
+
+		// Release the entry only once it has been read and sent, so vConsoleFlush()
+		// does not return while it is still being transmitted
+		__DMB();
+		ulIsrRingTail++;
+	}
+}
@@ -0,0 +1,570 @@
+/**
+  ******************************************************************************
+  * @file    console_in.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Console input service. The Console Input task owns UART2
+  * 		 reception. It sleeps in xUartReadByte() till bytes arrive,
+  * 		 builds a line till the return key (backspace removes the last
+  * 		 character) and sends the line to the queue of the client task
+  * 		 holding the focus. The RTT link of the console cannot interrupt
+  * 		 the target, so its down buffer is polled each time the task
+  * 		 wakes up, at least every CONSOLE_IN_RTT_POLL_MS while a debugger
+  * 		 is attached. Without a debugger nothing can arrive on it, so the
+  * 		 task only wakes up for UART2, which lets the idle task sleep as
+  * 		 long as the other tasks allow. Each link is a session of its own: it has its own
+  * 		 line being typed and its own focus client, so a script can run
+  * 		 on one link while the menu is used on the other. A client
+  * 		 waiting for input is blocked on its own queue, so it uses no CPU
+  * 		 time and cannot take bytes meant for another task.
+  *
+  * 		 A line of the form "@<name> <text>" is sent to the client of that
+  * 		 name with the prefix removed, whichever task holds the focus. A
+  * 		 client in raw mode gets the bytes as they arrive, in chunks of up
+  * 		 to CONSOLE_IN_LINE_SIZE bytes, without any line editing.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <string.h>
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "event_groups.h"
+#include "uart_driver.h"
+#include "SEGGER_RTT.h"
+#include "console.h"
+#include "console_in.h"
+#include "ram_budget.h"
+
+// TYPES
+
+// A line, or a chunk of bytes in raw mode
+typedef struct
+{
+	uint8_t ucLen;							// Number of characters
+	uint8_t ucLink;							// Link the line was typed on (ConsoleLink_t)
+	char cText[CONSOLE_IN_LINE_SIZE];		// Characters, not NUL terminated
+} ConsoleLine_t;
+
+// A task receiving input
+typedef struct
+{
+	TaskHandle_t xTask;						// Client task, NULL if the entry is free
+	const char* pcName;						// Name used to address the client with "@<name>"
+	QueueHandle_t xLines;					// Lines waiting to be read by the client
+	StaticQueue_t xLinesBuffer;				// Storage of the queue, allocated statically
+	uint8_t ucLinesStorage[CONSOLE_IN_QUEUE_LENGTH * sizeof(ConsoleLine_t)];
+	volatile BaseType_t xRaw;				// pdTRUE if the client gets the bytes as they arrive
+	EventGroupHandle_t xEvents;				// Event group told of each line queued, NULL if none
+	EventBits_t uxEventBits;				// Bits set in xEvents
+} ConsoleClient_t;
+
+// CONSOLE INPUT GLOBALS
+
+// Registered clients
+static ConsoleClient_t xClients[CONSOLE_IN_MAX_CLIENTS];
+
+RAM_BUDGET_CHECK( sizeof(xClients), RAM_BUDGET_CONSOLE_IN );
+
+// pdTRUE while the task waits for UART2 only, since no debugger was attached
+static volatile BaseType_t xConsoleInRttIdle = pdFALSE;
+
+// Client holding the focus of each link
+static volatile TaskHandle_t xFocusTask[eConsoleNumLinks];
+
+// Set to drop the line being typed on each link
+static volatile BaseType_t xDiscardPartial[eConsoleNumLinks];
+
+// Number of lines dropped
+volatile uint32_t ulConsoleInLinesDropped = 0;
+
+// FUNCTION PROTOTYPES
+
+// To find the client entry of a task
+static ConsoleClient_t* pxConsoleInFind(TaskHandle_t xTask);
+
+// To receive a byte from a link of the console
+static BaseType_t xConsoleInGetByte(ConsoleLink_t eLink, uint8_t* pucByte, TickType_t xTimeout);
+
+// To add a byte received from a link to the line being typed on it
+static void vConsoleInTake(ConsoleLine_t* pxLines, ConsoleLink_t eLink, uint8_t ucByte);
+
+// To send a complete line to the client it is meant for
+static void vConsoleInRoute(ConsoleLine_t* pxLine, ConsoleLink_t eLink);
+
+// To send a line to the queue of a client
+static void vConsoleInDeliver(ConsoleClient_t* pxClient, const ConsoleLine_t* pxLine);
+/*******************************************************************************
+*   Procedure: xConsoleInRegister
+*
+*   Description: This function registers a task as a client of the console
+*   			 input and creates the queue holding its lines, in the storage
+*   			 of the client entry. A task must be registered to read input or
+*   			 to get the focus.
+*
+*   Notes: Must be called before the scheduler is started.
+*
+*   Parameters: xTask - The client task
+*   			pcName - The name used to address the client with "@<name>". The
+*   			string must remain valid
+*
+*   Return: BaseType_t - pdPASS if the client is registered, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xConsoleInRegister(TaskHandle_t xTask, const char* pcName)
+{
+	for( uint32_t i = 0; i < CONSOLE_IN_MAX_CLIENTS; i++ )
+	{
+		if( xClients[i].xTask == NULL )
+		{
+			xClients[i].xLines = xQueueCreateStatic( CONSOLE_IN_QUEUE_LENGTH, sizeof(ConsoleLine_t),
+													 xClients[i].ucLinesStorage, &xClients[i].xLinesBuffer );
+			if( xClients[i].xLines == NULL )
+			{
+				return(pdFAIL);
+			}
+
+			xClients[i].pcName = pcName;
+			xClients[i].xRaw = pdFALSE;
+			xClients[i].xEvents = NULL;
+			xClients[i].xTask = xTask;
+			return(pdPASS);
+		}
+	}
+
+	return(pdFAIL);
+}
+/*******************************************************************************
+*   Procedure: vConsoleInSetEvent
+*
+*   Description: This function makes the console input set bits of an event
+*   			 group each time a line is queued for a client. A client which
+*   			 also waits for other events, e.g. requests, can then wait for
+*   			 all of them on the event group, and read its lines once woken.
+*
+*   Notes: Must be called before the scheduler is started, once the client is
+*   	   registered. The bits are set after the line is queued.
+*
+*   Parameters: xTask - The client task
+*   			xEvents - The event group
+*   			uxBits - The bits to set
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleInSetEvent(TaskHandle_t xTask, EventGroupHandle_t xEvents, EventBits_t uxBits)
+{
+	ConsoleClient_t* pxClient = pxConsoleInFind( xTask );	// Client entry of the task
+
+	if( pxClient != NULL )
+	{
+		pxClient->uxEventBits = uxBits;
+		pxClient->xEvents = xEvents;
+	}
+}
+/*******************************************************************************
+*   Procedure: vConsoleInSetFocus
+*
+*   Description: This function gives the focus of a link to a client. Every
+*   			 line typed on the link from now on, except the ones addressed
+*   			 with "@<name>", is sent to this client. A client may hold the
+*   			 focus of several links.
+*
+*   Notes: Lines already queued for the previous client stay with it.
+*
+*   Parameters: eLink - The link
+*   			xTask - The client task
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleInSetFocus(ConsoleLink_t eLink, TaskHandle_t xTask)
+{
+	xFocusTask[eLink] = xTask;
+}
+/*******************************************************************************
+*   Procedure: xConsoleInRead
+*
+*   Description: This function receives the next line sent to the calling task.
+*   			 The task waits in blocked state till a line arrives or till
+*   			 xTimeout ticks have passed. The line is copied to pcLine and
+*   			 NUL terminated, and cut if it does not fit.
+*
+*   Notes: In raw mode a "line" is a chunk of bytes, which may include 0x00.
+*   	   A line addressed with "@<name>" may come from any link, the reply
+*   	   to it belongs on the link returned in pxLink.
+*
+*   Parameters: pcLine - A pointer to the buffer to hold the line
+*   			xSize - The size of the buffer, CONSOLE_IN_LINE_SIZE + 1 holds any line
+*   			pxLen - A pointer to a location that will hold the line length, may be NULL
+*   			pxLink - A pointer to a location that will hold the link, may be NULL
+*   			xTimeout - The number of ticks to wait, portMAX_DELAY waits forever
+*
+*   Return: BaseType_t - pdPASS if a line was received, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xConsoleInRead(char* pcLine, size_t xSize, size_t* pxLen, ConsoleLink_t* pxLink, TickType_t xTimeout)
+{
+	ConsoleClient_t* pxClient = pxConsoleInFind( xTaskGetCurrentTaskHandle() );	// Client entry of the calling task
+	ConsoleLine_t xLine;		// Line received
+	size_t xLen;				// Number of characters copied
+
+	if( pxClient == NULL || xSize == 0 || xQueueReceive( pxClient->xLines, &xLine, xTimeout ) != pdPASS )
+	{
+		return(pdFAIL);
+	}
+
+	xLen = ( xLine.ucLen < xSize - 1 ) ? xLine.ucLen : ( xSize - 1 );
+	memcpy( pcLine, xLine.cText, xLen );
+	pcLine[xLen] = '\0';
+
+	if( pxLen != NULL )
+	{
+		*pxLen = xLen;
+	}
+
+	if( pxLink != NULL )
+	{
+		*pxLink = (ConsoleLink_t)xLine.ucLink;
+	}
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: vConsoleInSetRaw
+*
+*   Description: This function switches the calling task between lines and raw
+*   			 mode. In raw mode, while the task holds the focus, the bytes
+*   			 are passed on as they arrive, e.g. for binary packets.
+*
+*   Notes: None
+*
+*   Parameters: xRaw - pdTRUE for raw mode, pdFALSE for lines
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleInSetRaw(BaseType_t xRaw)
+{
+	ConsoleClient_t* pxClient = pxConsoleInFind( xTaskGetCurrentTaskHandle() );	// Client entry of the calling task
+
+	if( pxClient != NULL )
+	{
+		pxClient->xRaw = xRaw;
+	}
+}
+/*******************************************************************************
+*   Procedure: vConsoleInDiscard
+*
+*   Description: This function discards the lines waiting for the calling task
+*   			 and the line being typed on the links it holds the focus of,
+*   			 e.g. the key pressed to wake the application up.
+*
+*   Notes: The line being typed is dropped when the next byte arrives.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleInDiscard(void)
+{
+	ConsoleClient_t* pxClient = pxConsoleInFind( xTaskGetCurrentTaskHandle() );	// Client entry of the calling task
+
+	if( pxClient == NULL )
+	{
+		return;
+	}
+
+	for( uint32_t i = 0; i < eConsoleNumLinks; i++ )
+	{
+		if( xFocusTask[i] == pxClient->xTask )
+		{
+			xDiscardPartial[i] = pdTRUE;
+		}
+	}
+
+	xQueueReset( pxClient->xLines );
+}
+/*******************************************************************************
+*   Procedure: vConsoleInTaskFunction
+*
+*   Description: This is the task function for the Console Input task. It waits
+*   			 in blocked state for the bytes received via UART2, then takes
+*   			 whatever the host has written to the RTT link. The bytes of
+*   			 each link build the line being typed on that link.
+*
+*   Notes: The debug probe can only write the RTT link while a debugger is
+*   	   attached, which is when the link is polled. Otherwise the task waits
+*   	   for UART2 without a timeout, till vConsoleInCheckDebuggerFromISR()
+*   	   sees a debugger attached.
+*
+*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
+*   			in this task function
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleInTaskFunction(void *pvParam)
+{
+	ConsoleLine_t xLines[eConsoleNumLinks];		// Line being typed on each link
+	TickType_t xRttPoll;						// Time to wait for UART2 before polling the RTT link
+	BaseType_t xDebugger;						// pdTRUE if a debugger is attached
+	uint8_t ucByte;								// Byte received
+
+	for( uint32_t i = 0; i < eConsoleNumLinks; i++ )
+	{
+		xLines[i].ucLen = 0;
+	}
+
+	while(1)
+	{
+		xDebugger = ( CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk ) ? pdTRUE : pdFALSE;
+		xRttPoll = ( xDebugger == pdTRUE ) ? pdMS_TO_TICKS(CONSOLE_IN_RTT_POLL_MS) : portMAX_DELAY;
+		xConsoleInRttIdle = ( xDebugger == pdTRUE ) ? pdFALSE : pdTRUE;
+
+		// The task will block till a byte is received or it is time to poll the RTT link
+		if( xConsoleInGetByte( eConsoleLinkUart, &ucByte, xRttPoll ) == pdPASS )
+		{
+			vConsoleInTake( xLines, eConsoleLinkUart, ucByte );
+		}
+
+		while( xConsoleInGetByte( eConsoleLinkRtt, &ucByte, 0 ) == pdPASS )
+		{
+			vConsoleInTake( xLines, eConsoleLinkRtt, ucByte );
+		}
+	}
+}
+/*******************************************************************************
+*   Procedure: vConsoleInCheckDebuggerFromISR
+*
+*   Description: This function wakes the Console Input task up if a debugger
+*   			 was attached while the task waited for UART2 only, so that it
+*   			 starts polling the RTT link
+*
+*   Notes: Called from the RTC wakeup interrupt, once a second while the MCU
+*   	   is not in STOP mode.
+*
+*   Parameters: pxHigherPriorityTaskWoken - Set to pdTRUE if the Console Input
+*   			task has a higher priority than the interrupted one
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleInCheckDebuggerFromISR(BaseType_t* pxHigherPriorityTaskWoken)
+{
+	if( xConsoleInRttIdle == pdTRUE && ( CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk ) != 0 )
+	{
+		xConsoleInRttIdle = pdFALSE;
+		vUartReadAbortFromISR( pxHigherPriorityTaskWoken );
+	}
+}
+/*******************************************************************************
+*   Procedure: xConsoleInGetByte
+*
+*   Description: This function receives the next byte from a link of the
+*   			 console. The task waits in blocked state for a byte received
+*   			 via UART2. The RTT down buffer is only checked.
+*
+*   Notes: None
+*
+*   Parameters: eLink - The link
+*   			pucByte - A pointer to a location that will hold the byte
+*   			xTimeout - The number of ticks to wait for UART2
+*
+*   Return: BaseType_t - pdPASS if a byte was received, otherwise pdFAIL
+*
+*******************************************************************************/
+static BaseType_t xConsoleInGetByte(ConsoleLink_t eLink, uint8_t* pucByte, TickType_t xTimeout)
+{
+	if( eLink == eConsoleLinkUart )
+	{
+		return(xUartReadByte( pucByte, xTimeout ));
+	}
+
+	return( ( SEGGER_RTT_Read( CONSOLE_RTT_CHANNEL, pucByte, 1 ) == 1 ) ? pdPASS : pdFAIL );
+}
+/*******************************************************************************
+*   Procedure: vConsoleInTake
+*
+*   Description: This function adds a byte received from a link to the line
+*   			 being typed on that link. The return key ends the line, line
+*   			 feeds are ignored, and backspace or delete removes the last
+*   			 character. If the focus client of the link is in raw mode the
+*   			 byte is passed on at once, together with the others already
+*   			 received on the link.
+*
+*   Notes: None
+*
+*   Parameters: pxLines - A pointer to the lines being typed, one per link
+*   			eLink - The link the byte was received from
+*   			ucByte - The byte
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vConsoleInTake(ConsoleLine_t* pxLines, ConsoleLink_t eLink, uint8_t ucByte)
+{
+	ConsoleLine_t* pxLine = &pxLines[eLink];	// Line being typed on the link
+	ConsoleClient_t* pxFocus;					// Client holding the focus of the link
+
+	if( xDiscardPartial[eLink] == pdTRUE )
+	{
+		xDiscardPartial[eLink] = pdFALSE;
+		pxLine->ucLen = 0;
+	}
+
+	pxLine->ucLink = (uint8_t)eLink;
+	pxFocus = pxConsoleInFind( xFocusTask[eLink] );
+
+	if( pxFocus != NULL && pxFocus->xRaw == pdTRUE )
+	{
+		// Pass the byte on together with whatever else has been received
+		pxLine->cText[0] = (char)ucByte;
+		pxLine->ucLen = 1;
+		while( pxLine->ucLen < CONSOLE_IN_LINE_SIZE && xConsoleInGetByte( eLink, &ucByte, 0 ) == pdPASS )
+		{
+			pxLine->cText[pxLine->ucLen++] = (char)ucByte;
+		}
+
+		vConsoleInDeliver( pxFocus, pxLine );
+		pxLine->ucLen = 0;
+		return;
+	}
+
+	switch( ucByte )
+	{
+		case '\r':
+
+			vConsoleInRoute( pxLine, eLink );
+			pxLine->ucLen = 0;
+			break;
+
+		case '\n':
+
+			// Terminals sending CR LF end the line on the CR
+			break;
+
+		case '\b':
+		case 0x7F:
+
+			if( pxLine->ucLen > 0 )
+			{
+				pxLine->ucLen--;
+			}
+			break;
+
+		default:
+
+			// Characters beyond the line size are dropped
+			if( pxLine->ucLen < CONSOLE_IN_LINE_SIZE )
+			{
+				pxLine->cText[pxLine->ucLen++] = (char)ucByte;
+			}
+			break;
+	}
+}
+/*******************************************************************************
+*   Procedure: vConsoleInRoute
+*
+*   Description: This function sends a complete line to the client holding the
+*   			 focus of the link it was typed on, or to the client named by a
+*   			 "@<name> " prefix, in which case the prefix is removed.
+*
+*   Notes: A line addressed to an unknown name goes to the focus client as is.
+*
+*   Parameters: pxLine - A pointer to the line
+*   			eLink - The link the line was typed on
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vConsoleInRoute(ConsoleLine_t* pxLine, ConsoleLink_t eLink)
+{
+	size_t xNameLen = 0;		// Length of the name after '@'
+	size_t xSkip;				// Length of the prefix
+
+	if( pxLine->ucLen > 1 && pxLine->cText[0] == '@' )
+	{
+		while( 1 + xNameLen < pxLine->ucLen && pxLine->cText[1 + xNameLen] != ' ' )
+		{
+			xNameLen++;
+		}
+
+		for( uint32_t i = 0; i < CONSOLE_IN_MAX_CLIENTS; i++ )
+		{
+			if( xClients[i].xTask != NULL && strlen(xClients[i].pcName) == xNameLen &&
+				strncmp( xClients[i].pcName, &pxLine->cText[1], xNameLen ) == 0 )
+			{
+				// Remove the prefix and the space after it
+				xSkip = ( 1 + xNameLen < pxLine->ucLen ) ? ( 2 + xNameLen ) : ( 1 + xNameLen );
+				memmove( pxLine->cText, &pxLine->cText[xSkip], pxLine->ucLen - xSkip );
+				pxLine->ucLen -= xSkip;
+
+				vConsoleInDeliver( &xClients[i], pxLine );
+				return;
+			}
+		}
+	}
+
+	vConsoleInDeliver( pxConsoleInFind( xFocusTask[eLink] ), pxLine );
+}
+/*******************************************************************************
+*   Procedure: vConsoleInDeliver
+*
+*   Description: This function sends a line to the queue of a client without
+*   			 waiting. The line is dropped and counted if the queue is full.
+*
+*   Notes: The event bits of the client, if any, are set once the line is
+*   	   queued.
+*
+*   Parameters: pxClient - A pointer to the client entry, may be NULL
+*   			pxLine - A pointer to the line
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vConsoleInDeliver(ConsoleClient_t* pxClient, const ConsoleLine_t* pxLine)
+{
+	if( pxClient == NULL || xQueueSend( pxClient->xLines, pxLine, 0 ) != pdPASS )
+	{
+		ulConsoleInLinesDropped++;
+	}
+	else if( pxClient->xEvents != NULL )
+	{
+		xEventGroupSetBits( pxClient->xEvents, pxClient->uxEventBits );
+	}
+}
+/*******************************************************************************
+*   Procedure: pxConsoleInFind
+*
+*   Description: This function returns the client entry of a task.
+*
+*   Notes: None
+*
+*   Parameters: xTask - The task
+*
+*   Return: ConsoleClient_t* - The client entry, or NULL if the task is not a client
+*
+*******************************************************************************/
+static ConsoleClient_t* pxConsoleInFind(TaskHandle_t xTask)
+{
+	if( xTask == NULL )
+	{
+		return(NULL);
+	}
+
+	for( uint32_t i = 0; i < CONSOLE_IN_MAX_CLIENTS; i++ )
+	{
+		if( xClients[i].xTask == xTask )
+		{
+			return( &xClients[i] );
+		}
+	}
+
+	return(NULL);
+}
@@ -0,0 +1,671 @@
+/**
+  ******************************************************************************
+  * @file    fmt.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Small reentrant text formatter replacing newlib sprintf. Decimal
+  * 		 digits are produced two at a time from a 200 byte table of digit
+  * 		 pairs, and 64-bit divisions are only used while a value does not
+  * 		 fit in 32 bits. All state lives on the caller's stack.
+  *
+  * 		 Supported: flags '-', '0', '+' and ' ', width and precision
+  * 		 (including '*'), length modifiers hh, h, l, ll and z, and the
+  * 		 conversions d, i, u, x, X, c, s, f and %%. %f takes a double and
+  * 		 is rendered as a fixed-point decimal with up to 9 decimals.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <string.h>
+#include "fmt.h"
+
+// CONSTANTS
+
+// Size of the scratch buffer holding the digits of one number
+// (20 digits for 2^64 plus up to 9 decimals and a point)
+#define FMT_DIGITS_SIZE				32
+
+// Largest number of decimals printed for fixed-point values
+#define FMT_MAX_DECIMALS			9
+
+// TYPES
+
+// Output buffer and number of characters produced so far
+typedef struct
+{
+	char* pcOut;		// Output buffer
+	size_t xSize;		// Size of the output buffer
+	size_t xLen;		// Characters produced, including those that did not fit
+} FmtSink_t;
+
+// Conversion specification
+typedef struct
+{
+	uint8_t ucLeft;		// '-' flag: left justify
+	uint8_t ucZero;		// '0' flag: pad numbers with zeros
+	char cPlus;			// '+' or ' ' flag: character printed before positive numbers
+	int32_t lWidth;		// Minimum field width
+	int32_t lPrecision;	// Precision or -1 if not given
+} FmtSpec_t;
+
+// FMT GLOBALS
+
+// Two ASCII digits for every value from 0 to 99
+static const char cDigitPairs[200] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+// Powers of ten used to scale fixed-point values
+static const uint32_t ulPow10[FMT_MAX_DECIMALS + 1] =
+{
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// FUNCTION PROTOTYPES
+
+// To append a character to the output
+static void vFmtPutc(FmtSink_t* pxSink, char cChar);
+
+// To append a character several times to the output
+static void vFmtPad(FmtSink_t* pxSink, char cChar, int32_t lCount);
+
+// To convert an unsigned value to decimal digits, written backwards from pcEnd
+static char* pcFmtDecimal(char* pcEnd, uint64_t ullValue);
+
+// To convert an unsigned value to hexadecimal digits, written backwards from pcEnd
+static char* pcFmtHex(char* pcEnd, uint64_t ullValue, uint8_t ucUpper);
+
+// To append digits with their sign applying the width, precision and flags
+static void vFmtEmitNumber(FmtSink_t* pxSink, const char* pcDigits, size_t xDigits, char cSign,
+						   const FmtSpec_t* pxSpec, uint8_t ucUsePrecision);
+
+// To append a fixed-point decimal given its absolute scaled value and sign
+static void vFmtEmitFixed(FmtSink_t* pxSink, uint64_t ullScaled, uint8_t ucDecimals, char cSign,
+						  const FmtSpec_t* pxSpec);
+/*******************************************************************************
+*   Procedure: xFmtSnprintf
+*
+*   Description: This function formats text into a buffer. It behaves like
+*   			 snprintf for the supported conversions.
+*
+*   Notes: The output is always null terminated if xSize is not 0.
+*
+*   Parameters: pcOut - A pointer to the output buffer
+*   			xSize - The size of the output buffer
+*   			pcFmt - A pointer to the format string
+*
+*   Return: size_t - The length of the complete text, which may be more than
+*   		the number of characters that fit in the buffer
+*
+*******************************************************************************/
+size_t xFmtSnprintf(char* pcOut, size_t xSize, const char* pcFmt, ...)
+{
+	va_list xArgs;		// Arguments to format
+	size_t xLen;		// Length of the formatted text
+
+	va_start(xArgs, pcFmt);
+	xLen = xFmtVsnprintf(pcOut, xSize, pcFmt, xArgs);
+	va_end(xArgs);
+
+	return(xLen);
+}
+/*******************************************************************************
+*   Procedure: xFmtVsnprintf
+*
+*   Description: This function formats text into a buffer using a variable
+*   			 argument list. It behaves like vsnprintf for the supported
+*   			 conversions. Unknown conversions are copied to the output.
+*
+*   Notes: The output is always null terminated if xSize is not 0.
+*
+*   Parameters: pcOut - A pointer to the output buffer
+*   			xSize - The size of the output buffer
+*   			pcFmt - A pointer to the format string
+*   			xArgs - The arguments to format
+*
+*   Return: size_t - The length of the complete text
+*
+*******************************************************************************/
+size_t xFmtVsnprintf(char* pcOut, size_t xSize, const char* pcFmt, va_list xArgs)
+{
+	FmtSink_t xSink = { pcOut, xSize, 0 };	// Output buffer
+	FmtSpec_t xSpec;						// Current conversion specification
+	char cDigits[FMT_DIGITS_SIZE];			// Scratch buffer for the digits of a number
+	char* pcDigits;							// First digit in cDigits
+	uint8_t ucLength;						// Length modifier: 0 none, 1 h, 2 hh, 3 l, 4 ll, 5 z
+	int64_t llSigned;						// Signed value to print
+	uint64_t ullValue;						// Absolute or unsigned value to print
+	char cSign;								// Sign character, or 0 if none
+	const char* pcStr;						// String to print
+	size_t xStrLen;							// Length of the string to print
+	double dValue;							// Floating point value to print
+	char cConv;								// Conversion character
+
+	while( *pcFmt != '\0' )
+	{
+		if( *pcFmt != '%' )
+		{
+			vFmtPutc( &xSink, *pcFmt++ );
+			continue;
+		}
+		pcFmt++;
+
+		// Flags
+		memset( &xSpec, 0, sizeof(xSpec) );
+		xSpec.lPrecision = -1;
+		while( *pcFmt == '-' || *pcFmt == '0' || *pcFmt == '+' || *pcFmt == ' ' )
+		{
+			if( *pcFmt == '-' )
+			{
+				xSpec.ucLeft = 1;
+			}
+			else if( *pcFmt == '0' )
+			{
+				xSpec.ucZero = 1;
+			}
+			else if( *pcFmt == '+' || xSpec.cPlus == 0 )
+			{
+				xSpec.cPlus = *pcFmt;
+			}
+			pcFmt++;
+		}
+
+		// Width
+		if( *pcFmt == '*' )
+		{
+			xSpec.lWidth = va_arg( xArgs, int );
+			if( xSpec.lWidth < 0 )
+			{
+				xSpec.ucLeft = 1;
+				xSpec.lWidth = -xSpec.lWidth;
+			}
+			pcFmt++;
+		}
+		while( *pcFmt >= '0' && *pcFmt <= '9' )
+		{
+			xSpec.lWidth = ( xSpec.lWidth * 10 ) + ( *pcFmt++ - '0' );
+		}
+
+		// Precision
+		if( *pcFmt == '.' )
+		{
+			pcFmt++;
+			xSpec.lPrecision = 0;
+			if( *pcFmt == '*' )
+			{
+				xSpec.lPrecision = va_arg( xArgs, int );
+				pcFmt++;
+			}
+			while( *pcFmt >= '0' && *pcFmt <= '9' )
+			{
+				xSpec.lPrecision = ( xSpec.lPrecision * 10 ) + ( *pcFmt++ - '0' );
+			}
+		}
+
+		// Length modifier
+		ucLength = 0;
+		if( *pcFmt == 'h' )
+		{
+			ucLength = ( pcFmt[1] == 'h' ) ? 2 : 1;
+			pcFmt += ucLength;
+		}
+		else if( *pcFmt == 'l' )
+		{
+			ucLength = ( pcFmt[1] == 'l' ) ? 4 : 3;
+			pcFmt += ucLength - 2;
+		}
+		else if( *pcFmt == 'z' )
+		{
+			ucLength = 5;
+			pcFmt++;
+		}
+
+		cConv = *pcFmt;
+		if( cConv == '\0' )
+		{
+			break;
+		}
+		pcFmt++;
+
+		switch( cConv )
+		{
+			case 'd':
+			case 'i':
+
+				switch( ucLength )
+				{
+					case 1:  llSigned = (short)va_arg( xArgs, int );       break;
+					case 2:  llSigned = (signed char)va_arg( xArgs, int ); break;
+					case 3:  llSigned = va_arg( xArgs, long );             break;
+					case 4:  llSigned = va_arg( xArgs, long long );        break;
+					case 5:  llSigned = (int64_t)va_arg( xArgs, size_t );  break;
+					default: llSigned = va_arg( xArgs, int );              break;
+				}
+
+				cSign = xSpec.cPlus;
+				ullValue = (uint64_t)llSigned;
+				if( llSigned < 0 )
+				{
+					cSign = '-';
+					ullValue = 0 - ullValue;
+				}
+
+				pcDigits = pcFmtDecimal( &cDigits[FMT_DIGITS_SIZE], ullValue );
+
+				// A zero with a precision of 0 prints no digits
+				if( ullValue == 0 && xSpec.lPrecision == 0 )
+				{
+					pcDigits = &cDigits[FMT_DIGITS_SIZE];
+				}
+				vFmtEmitNumber( &xSink, pcDigits, &cDigits[FMT_DIGITS_SIZE] - pcDigits, cSign, &xSpec, 1 );
+				break;
+
+			case 'u':
+			case 'x':
+			case 'X':
+
+				switch( ucLength )
+				{
+					case 1:  ullValue = (unsigned short)va_arg( xArgs, unsigned int ); break;
+					case 2:  ullValue = (unsigned char)va_arg( xArgs, unsigned int );  break;
+					case 3:  ullValue = va_arg( xArgs, unsigned long );                break;
+					case 4:  ullValue = va_arg( xArgs, unsigned long long );           break;
+					case 5:  ullValue = va_arg( xArgs, size_t );                       break;
+					default: ullValue = va_arg( xArgs, unsigned int );                 break;
+				}
+
+				if( cConv == 'u' )
+				{
+					pcDigits = pcFmtDecimal( &cDigits[FMT_DIGITS_SIZE], ullValue );
+				}
+				else
+				{
+					pcDigits = pcFmtHex( &cDigits[FMT_DIGITS_SIZE], ullValue, cConv == 'X' );
+				}
+
+				if( ullValue == 0 && xSpec.lPrecision == 0 )
+				{
+					pcDigits = &cDigits[FMT_DIGITS_SIZE];
+				}
+				vFmtEmitNumber( &xSink, pcDigits, &cDigits[FMT_DIGITS_SIZE] - pcDigits, 0, &xSpec, 1 );
+				break;
+
+			case 'c':
+
+				cDigits[0] = (char)va_arg( xArgs, int );
+				xSpec.ucZero = 0;
+				vFmtEmitNumber( &xSink, cDigits, 1, 0, &xSpec, 0 );
+				break;
+
+			case 's':
+
+				pcStr = va_arg( xArgs, const char* );
+				if( pcStr == NULL )
+				{
+					pcStr = "(null)";
+				}
+
+				// The precision limits the number of characters printed
+				xStrLen = 0;
+				while( pcStr[xStrLen] != '\0' && ( xSpec.lPrecision < 0 || xStrLen < (size_t)xSpec.lPrecision ) )
+				{
+					xStrLen++;
+				}
+
+				xSpec.ucZero = 0;
+				vFmtEmitNumber( &xSink, pcStr, xStrLen, 0, &xSpec, 0 );
+				break;
+
+			case 'f':
+
+				dValue = va_arg( xArgs, double );
+
+				if( xSpec.lPrecision < 0 )
+				{
+					xSpec.lPrecision = 6;
+				}
+				else if( xSpec.lPrecision > FMT_MAX_DECIMALS )
+				{
+					xSpec.lPrecision = FMT_MAX_DECIMALS;
+				}
+
+				cSign = xSpec.cPlus;
+				if( dValue < 0 )
+				{
+					cSign = '-';
+					dValue = -dValue;
+				}
+
+				// Values which do not fit in 64 bits once scaled, NaN and infinity
+				dValue = ( dValue * ulPow10[xSpec.lPrecision] ) + 0.5;
+				if( !( dValue < 18446744073709551615.0 ) )
+				{
+					xSpec.ucZero = 0;
+					vFmtEmitNumber( &xSink, "inf", 3, cSign, &xSpec, 0 );
+					break;
+				}
+
+				vFmtEmitFixed( &xSink, (uint64_t)dValue, (uint8_t)xSpec.lPrecision, cSign, &xSpec );
+				break;
+
+			case '%':
+
+				vFmtPutc( &xSink, '%' );
+				break;
+
+			default:
+
+				// Unknown conversion. Copy it to the output
+				vFmtPutc( &xSink, '%' );
+				vFmtPutc( &xSink, cConv );
+				break;
+		}
+	}
+
+	// Null terminate the output
+	if( xSize > 0 )
+	{
+		pcOut[ ( xSink.xLen < xSize ) ? xSink.xLen : xSize - 1 ] = '\0';
+	}
+
+	return(xSink.xLen);
+}
+/*******************************************************************************
+*   Procedure: xFmtFixed
+*
+*   Description: This function formats a fixed-point decimal. The value is given
+*   			 as an integer scaled by 10^ucDecimals, e.g. a temperature of
+*   			 23.45 C kept in hundredths of a degree is 2345 with 2 decimals.
+*
+*   Notes: ucDecimals is limited to 9. The output is always null terminated if
+*   	   xSize is not 0.
+*
+*   Parameters: pcOut - A pointer to the output buffer
+*   			xSize - The size of the output buffer
+*   			lScaled - The scaled value
+*   			ucDecimals - The number of decimals
+*
+*   Return: size_t - The length of the complete text
+*
+*******************************************************************************/
+size_t xFmtFixed(char* pcOut, size_t xSize, int32_t lScaled, uint8_t ucDecimals)
+{
+	FmtSink_t xSink = { pcOut, xSize, 0 };	// Output buffer
+	FmtSpec_t xSpec;						// Default specification (no width, no flags)
+	uint64_t ullScaled;						// Absolute scaled value
+	char cSign = 0;							// Sign character, or 0 if none
+
+	memset( &xSpec, 0, sizeof(xSpec) );
+
+	if( ucDecimals > FMT_MAX_DECIMALS )
+	{
+		ucDecimals = FMT_MAX_DECIMALS;
+	}
+
+	ullScaled = (uint64_t)(int64_t)lScaled;
+	if( lScaled < 0 )
+	{
+		cSign = '-';
+		ullScaled = 0 - ullScaled;
+	}
+
+	vFmtEmitFixed( &xSink, ullScaled, ucDecimals, cSign, &xSpec );
+
+	if( xSize > 0 )
+	{
+		pcOut[ ( xSink.xLen < xSize ) ? xSink.xLen : xSize - 1 ] = '\0';
+	}
+
+	return(xSink.xLen);
+}
+/*******************************************************************************
+*   Procedure: vFmtPutc
+*
+*   Description: This function appends a character to the output if there is
+*   			 room for it and the null terminator, and counts it in any case.
+*
+*   Notes: None
+*
+*   Parameters: pxSink - A pointer to the output
+*   			cChar - The character to append
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vFmtPutc(FmtSink_t* pxSink, char cChar)
+{
+	if( pxSink->xLen + 1 < pxSink->xSize )
+	{
+		pxSink->pcOut[pxSink->xLen] = cChar;
+	}
+
+	pxSink->xLen++;
+}
+/*******************************************************************************
+*   Procedure: vFmtPad
+*
+*   Description: This function appends a character lCount times to the output.
+*
+*   Notes: Nothing is appended if lCount is not positive.
+*
+*   Parameters: pxSink - A pointer to the output
+*   			cChar - The character to append
+*   			lCount - The number of times to append it
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vFmtPad(FmtSink_t* pxSink, char cChar, int32_t lCount)
+{
+	while( lCount-- > 0 )
+	{
+		vFmtPutc( pxSink, cChar );
+	}
+}
+/*******************************************************************************
+*   Procedure: pcFmtDecimal
+*
+*   Description: This function converts an unsigned value to decimal digits. The
+*   			 digits are written backwards, two at a time, ending just before
+*   			 pcEnd. 64-bit divisions are only used for the upper part of
+*   			 values which do not fit in 32 bits.
+*
+*   Notes: At least 20 characters must be available before pcEnd.
+*
+*   Parameters: pcEnd - A pointer just past the last digit
+*   			ullValue - The value to convert
+*
+*   Return: char* - A pointer to the first digit
+*
+*******************************************************************************/
+static char* pcFmtDecimal(char* pcEnd, uint64_t ullValue)
+{
+	uint64_t ullQuotient;		// Value divided by 100
+	uint32_t ulValue;			// Value once it fits in 32 bits
+	uint32_t ulPair;			// Two lowest digits
+
+	while( ullValue > 0xFFFFFFFFu )
+	{
+		ullQuotient = ullValue / 100;
+		ulPair = (uint32_t)( ullValue - ( ullQuotient * 100 ) );
+		ullValue = ullQuotient;
+
+		pcEnd -= 2;
+		memcpy( pcEnd, &cDigitPairs[ulPair * 2], 2 );
+	}
+
+	ulValue = (uint32_t)ullValue;
+
+	while( ulValue >= 100 )
+	{
+		ulPair = ulValue % 100;
+		ulValue /= 100;
+
+		pcEnd -= 2;
+		memcpy( pcEnd, &cDigitPairs[ulPair * 2], 2 );
+	}
+
+	if( ulValue >= 10 )
+	{
+		pcEnd -= 2;
+		memcpy( pcEnd, &cDigitPairs[ulValue * 2], 2 );
+	}
+	else
+	{
+		*--pcEnd = (char)( '0' + ulValue );
+	}
+
+	return(pcEnd);
+}
+/*******************************************************************************
+*   Procedure: pcFmtHex
+*
+*   Description: This function converts an unsigned value to hexadecimal digits
+*   			 written backwards, ending just before pcEnd.
+*
+*   Notes: At least 16 characters must be available before pcEnd.
+*
+*   Parameters: pcEnd - A pointer just past the last digit
+*   			ullValue - The value to convert
+*   			ucUpper - Non zero to use upper case digits
+*
+*   Return: char* - A pointer to the first digit
+*
+*******************************************************************************/
+static char* pcFmtHex(char* pcEnd, uint64_t ullValue, uint8_t ucUpper)
+{
+	const char* pcHexDigits = ucUpper ? "0123456789ABCDEF" : "0123456789abcdef";  // Digits to use
+
+	do
+	{
+		*--pcEnd = pcHexDigits[ullValue & 0xF];
+		ullValue >>= 4;
+	} while( ullValue != 0 );
+
+	return(pcEnd);
+}
+/*******************************************************************************
+*   Procedure: vFmtEmitNumber
+*
+*   Description: This function appends a field made of a sign and digits (or
+*   			 any other characters) to the output. With ucUsePrecision set,
+*   			 the precision gives the minimum number of digits. The field is
+*   			 then padded to the width with spaces, or with zeros after the
+*   			 sign if the '0' flag is given.
+*
+*   Notes: None
+*
+*   Parameters: pxSink - A pointer to the output
+*   			pcDigits - A pointer to the characters of the field
+*   			xDigits - The number of characters
+*   			cSign - The sign character, or 0 if none
+*   			pxSpec - A pointer to the conversion specification
+*   			ucUsePrecision - Non zero if the precision applies to the digits
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vFmtEmitNumber(FmtSink_t* pxSink, const char* pcDigits, size_t xDigits, char cSign,
+						   const FmtSpec_t* pxSpec, uint8_t ucUsePrecision)
+{
+	int32_t lZeros = 0;		// Zeros printed before the digits
+	int32_t lSpaces;		// Spaces printed to reach the width
+	size_t i;				// Index of the character to append
+
+	if( ucUsePrecision && pxSpec->lPrecision >= 0 )
+	{
+		lZeros = pxSpec->lPrecision - (int32_t)xDigits;
+	}
+	if( lZeros < 0 )
+	{
+		lZeros = 0;
+	}
+
+	lSpaces = pxSpec->lWidth - (int32_t)xDigits - lZeros - ( cSign != 0 ? 1 : 0 );
+
+	// Zero padding only applies if no precision is given
+	if( pxSpec->ucZero && !pxSpec->ucLeft && !( ucUsePrecision && pxSpec->lPrecision >= 0 ) && lSpaces > 0 )
+	{
+		lZeros += lSpaces;
+		lSpaces = 0;
+	}
+
+	if( !pxSpec->ucLeft )
+	{
+		vFmtPad( pxSink, ' ', lSpaces );
+	}
+
+	if( cSign != 0 )
+	{
+		vFmtPutc( pxSink, cSign );
+	}
+
+	vFmtPad( pxSink, '0', lZeros );
+
+	for( i = 0; i < xDigits; i++ )
+	{
+		vFmtPutc( pxSink, pcDigits[i] );
+	}
+
+	if( pxSpec->ucLeft )
+	{
+		vFmtPad( pxSink, ' ', lSpaces );
+	}
+}
+/*******************************************************************************
+*   Procedure: vFmtEmitFixed
+*
+*   Description: This function appends a fixed-point decimal to the output. The
+*   			 integer part and the decimals are produced separately and the
+*   			 decimals are zero padded to ucDecimals digits.
+*
+*   Notes: None
+*
+*   Parameters: pxSink - A pointer to the output
+*   			ullScaled - The absolute value scaled by 10^ucDecimals
+*   			ucDecimals - The number of decimals (0 to 9)
+*   			cSign - The sign character, or 0 if none
+*   			pxSpec - A pointer to the conversion specification
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vFmtEmitFixed(FmtSink_t* pxSink, uint64_t ullScaled, uint8_t ucDecimals, char cSign,
+						  const FmtSpec_t* pxSpec)
+{
+	char cDigits[FMT_DIGITS_SIZE];			// Scratch buffer holding the whole number
+	char* pcEnd = &cDigits[FMT_DIGITS_SIZE];// End of the number
+	char* pcStart;							// Start of the number
+	uint32_t ulFraction;					// Decimals of the value
+	FmtSpec_t xSpec = *pxSpec;				// Specification without precision
+
+	ulFraction = (uint32_t)( ullScaled % ulPow10[ucDecimals] );
+
+	if( ucDecimals > 0 )
+	{
+		// Decimals, zero padded to ucDecimals digits
+		pcStart = pcFmtDecimal( pcEnd, ulFraction );
+		while( pcEnd - pcStart < ucDecimals )
+		{
+			*--pcStart = '0';
+		}
+		*--pcStart = '.';
+		pcEnd = pcStart;
+	}
+
+	// Integer part
+	pcStart = pcFmtDecimal( pcEnd, ullScaled / ulPow10[ucDecimals] );
+
+	xSpec.lPrecision = -1;
+	vFmtEmitNumber( pxSink, pcStart, &cDigits[FMT_DIGITS_SIZE] - pcStart, cSign, &xSpec, 0 );
+}
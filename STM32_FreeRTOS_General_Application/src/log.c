@@ -0,0 +1,322 @@
+/**
+  ******************************************************************************
+  * @file    log.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Deferred binary logging. A record holds a format ID and up to
+  * 		 LOG_MAX_ARGS raw 32-bit values. Posting a record is a copy into
+  * 		 the log queue. The Log task is the only task which formats text.
+  * 		 It uses the fmt module, and renders floats as fixed-point decimals
+  * 		 using single precision only, so newlib printf and its float
+  * 		 support are not needed at all.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "console.h"
+#include "fmt.h"
+#include "log.h"
+#include "ram_budget.h"
+
+// CONSTANTS
+
+// Size of the buffer holding a rendered record
+#define LOG_LINE_SIZE				150
+
+// Size of the buffer holding a single conversion specification (e.g. "%0.2f")
+#define LOG_SPEC_SIZE				16
+
+// LOG GLOBALS
+
+// Queue of records waiting to be rendered
+static QueueHandle_t xLogQueue = NULL;
+
+// Storage of the log queue, allocated statically
+static StaticQueue_t xLogQueueBuffer;
+static uint8_t ucLogQueueStorage[LOG_QUEUE_LENGTH * sizeof(LogRecord_t)];
+
+RAM_BUDGET_CHECK( sizeof(xLogQueueBuffer) + sizeof(ucLogQueueStorage), RAM_BUDGET_LOG );
+
+// Format strings indexed by LogId_t
+static const char* const pcLogFormats[eLogNumFormats] =
+{
+	[eLogTempCurrent] = "\r\n\n%02d-%02d-%02d %02d:%02d:%02d Current Temp Recorded = %0.2f C",
+	[eLogTempHighest] = "\r\n\n%02d-%02d-%02d %02d:%02d:%02d Highest Temp Recorded = %0.2f C",
+	[eLogTempLowest]  = "\r\n\n%02d-%02d-%02d %02d:%02d:%02d Lowest Temp Recorded = %0.2f C\r\n",
+	[eLogDateTime]    = "\r\n\nTime: %02d:%02d:%02d\r\nDate: %02d-%02d-%02d",
+	[eLogCalcResult]  = "\r\n\nThe calculated integer is %ld",
+	[eLogGameWon]     = "\r\n\nYou guessed the correct number!\
+			            \r\nIt took you %ld attempt(s) to guess the number!",
+	[eLogBaudRate]    = "\r\n\nConsole baud rate is %ld (up to %ld)\
+			            \r\nEnter the new baud rate: ",
+};
+
+// FUNCTION PROTOTYPES
+
+// To render a record into text
+static void vLogRender(const LogRecord_t* pxRecord, char* pcOut, size_t xOutSize);
+/*******************************************************************************
+*   Procedure: xLogInit
+*
+*   Description: This function creates the log queue, in statically allocated
+*   			 storage. It must be called before the scheduler is started.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: BaseType_t - pdPASS if the queue was created, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xLogInit(void)
+{
+	xLogQueue = xQueueCreateStatic(LOG_QUEUE_LENGTH, sizeof(LogRecord_t), ucLogQueueStorage, &xLogQueueBuffer);
+
+	return( xLogQueue != NULL ? pdPASS : pdFAIL );
+}
+/*******************************************************************************
+*   Procedure: vLogPost
+*
+*   Description: This function copies a format ID and its raw values into a
+*   			 record and posts it to the log queue. No formatting is done
+*   			 by the calling task. The calling task waits if the log queue
+*   			 or the console is full (eConsoleBlock).
+*
+*   Notes: Values beyond LOG_MAX_ARGS are ignored. Must not be called from an ISR.
+*
+*   Parameters: eId - The ID of the format to render the values with
+*   			pxArgs - A pointer to the values, in the order of the format
+*   			ucNumArgs - The number of values
+*
+*   Return: None
+*
+*******************************************************************************/
+void vLogPost(LogId_t eId, const LogArg_t* pxArgs, uint8_t ucNumArgs)
+{
+	vLogPostWithPolicy( eId, pxArgs, ucNumArgs, eConsoleBlock );
+}
+/*******************************************************************************
+*   Procedure: vLogPostWithPolicy
+*
+*   Description: This function posts a record like vLogPost(). The policy is
+*   			 applied to the log queue and passed on to the console along
+*   			 with the rendered text. With any policy other than eConsoleBlock
+*   			 the calling task never waits: if the log queue is full the new
+*   			 record is dropped (eConsoleDropNewest), or the oldest record is
+*   			 dropped to make room for it.
+*
+*   Notes: Dropped records are counted in the console statistics of the calling
+*   	   task. Must not be called from an ISR.
+*
+*   Parameters: eId - The ID of the format to render the values with
+*   			pxArgs - A pointer to the values, in the order of the format
+*   			ucNumArgs - The number of values
+*   			ePolicy - What to do if the log queue or the console is full
+*
+*   Return: None
+*
+*******************************************************************************/
+void vLogPostWithPolicy(LogId_t eId, const LogArg_t* pxArgs, uint8_t ucNumArgs, ConsolePolicy_t ePolicy)
+{
+	vLogPostToLink( eId, pxArgs, ucNumArgs, ePolicy, xConsoleGetLink() );
+}
+/*******************************************************************************
+*   Procedure: vLogPostToLink
+*
+*   Description: This function posts a record like vLogPostWithPolicy(), to be
+*   			 printed on the given console link instead of the link of the
+*   			 calling task, e.g. the link a command was typed on.
+*
+*   Notes: Must not be called from an ISR.
+*
+*   Parameters: eId - The ID of the format to render the values with
+*   			pxArgs - A pointer to the values, in the order of the format
+*   			ucNumArgs - The number of values
+*   			ePolicy - What to do if the log queue or the console is full
+*   			eLink - The console link
+*
+*   Return: None
+*
+*******************************************************************************/
+void vLogPostToLink(LogId_t eId, const LogArg_t* pxArgs, uint8_t ucNumArgs, ConsolePolicy_t ePolicy, ConsoleLink_t eLink)
+{
+	LogRecord_t xRecord;	// Record to post
+	LogRecord_t xOldest;	// Oldest record, dropped to make room
+
+	if( ucNumArgs > LOG_MAX_ARGS )
+	{
+		ucNumArgs = LOG_MAX_ARGS;
+	}
+
+	xRecord.ucId = (uint8_t)eId;
+	xRecord.ucNumArgs = ucNumArgs;
+	xRecord.ucPolicy = (uint8_t)ePolicy;
+	xRecord.ucLink = (uint8_t)eLink;
+	memcpy( xRecord.xArgs, pxArgs, ucNumArgs * sizeof(LogArg_t) );
+
+	if( ePolicy == eConsoleBlock )
+	{
+		// The task will block waiting indefinitely till space becomes available on the queue
+		xQueueSend( xLogQueue, &xRecord, portMAX_DELAY );
+	}
+	else if( xQueueSend( xLogQueue, &xRecord, 0 ) != pdPASS )
+	{
+		if( ePolicy != eConsoleDropNewest && xQueueReceive( xLogQueue, &xOldest, 0 ) == pdPASS )
+		{
+			// Another task may take the freed slot first, in which case the new record is lost
+			xQueueSend( xLogQueue, &xRecord, 0 );
+		}
+
+		vConsoleNoteDrop();
+	}
+}
+/*******************************************************************************
+*   Procedure: vLogTaskFunction
+*
+*   Description: This is the task function for the Log task. It receives the
+*   			 records posted by the other tasks, renders them into text and
+*   			 posts the text to the console link of the posting task.
+*
+*   Notes: None
+*
+*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
+*   			in this task function
+*
+*   Return: None
+*
+*******************************************************************************/
+void vLogTaskFunction(void *pvParam)
+{
+	LogRecord_t xRecord;			// Record received
+	char cLine[LOG_LINE_SIZE];		// Rendered text
+
+	while(1)
+	{
+		// The task will block waiting indefinitely till a record becomes available on the queue
+		xQueueReceive( xLogQueue, &xRecord, portMAX_DELAY );
+
+		vLogRender( &xRecord, cLine, sizeof(cLine) );
+
+		// The text goes to the session of the task that posted the record
+		vConsoleWriteToLink( (ConsoleLink_t)xRecord.ucLink, cLine, strlen(cLine), (ConsolePolicy_t)xRecord.ucPolicy );
+	}
+}
+/*******************************************************************************
+*   Procedure: vLogRender
+*
+*   Description: This function renders a record using its format string. Literal
+*   			 text is copied as is. Each conversion specification is rendered
+*   			 on its own with the next value of the record. %f conversions are
+*   			 rendered from a float as a fixed-point decimal with the given
+*   			 precision (width is ignored). Any other conversion is rendered
+*   			 from a 32-bit integer.
+*
+*   Notes: The output is truncated if it does not fit. Missing values are printed
+*   	   as 0. Halfway cases are rounded away from zero.
+*
+*   Parameters: pxRecord - A pointer to the record to render
+*   			pcOut - A pointer to the output buffer
+*   			xOutSize - The size of the output buffer
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vLogRender(const LogRecord_t* pxRecord, char* pcOut, size_t xOutSize)
+{
+	const char* pcFmt;				// Current position in the format string
+	char cSpec[LOG_SPEC_SIZE];		// Current conversion specification
+	size_t xSpecLen;				// Length of the conversion specification
+	size_t xPos = 0;				// Current position in the output buffer
+	uint8_t ucArg = 0;				// Index of the next value to print
+	LogArg_t xArg;					// Next value to print
+	size_t xWritten;				// Number of characters rendered by a conversion
+	const char* pcPoint;			// Decimal point in a %f specification
+	uint8_t ucDecimals;				// Number of decimals of a %f conversion
+	float fScale;					// 10^ucDecimals
+
+	pcOut[0] = '\0';
+
+	if( pxRecord->ucId >= eLogNumFormats )
+	{
+		return;
+	}
+
+	pcFmt = pcLogFormats[pxRecord->ucId];
+
+	while( *pcFmt != '\0' && xPos < xOutSize - 1 )
+	{
+		// Copy literal text
+		if( *pcFmt != '%' )
+		{
+			pcOut[xPos++] = *pcFmt++;
+			continue;
+		}
+
+		if( pcFmt[1] == '%' )
+		{
+			pcOut[xPos++] = '%';
+			pcFmt += 2;
+			continue;
+		}
+
+		// Collect the conversion specification up to and including the conversion character
+		xSpecLen = 0;
+		do
+		{
+			cSpec[xSpecLen++] = *pcFmt++;
+		} while( *pcFmt != '\0' && strchr("diuxXcf", pcFmt[-1]) == NULL && xSpecLen < LOG_SPEC_SIZE - 1 );
+		cSpec[xSpecLen] = '\0';
+
+		xArg.lInt = 0;
+		if( ucArg < pxRecord->ucNumArgs )
+		{
+			xArg = pxRecord->xArgs[ucArg];
+		}
+		ucArg++;
+
+		if( cSpec[xSpecLen - 1] == 'f' )
+		{
+			// Precision of the conversion, 6 if not given like printf
+			ucDecimals = 6;
+			pcPoint = strchr( cSpec, '.' );
+			if( pcPoint != NULL )
+			{
+				ucDecimals = 0;
+				while( pcPoint[1] >= '0' && pcPoint[1] <= '9' )
+				{
+					ucDecimals = ( ucDecimals * 10 ) + ( *++pcPoint - '0' );
+				}
+			}
+
+			fScale = 1.0f;
+			for( uint8_t i = 0; i < ucDecimals; i++ )
+			{
+				fScale *= 10.0f;
+			}
+
+			// Scale and round the value so it can be printed as a fixed-point decimal
+			xWritten = xFmtFixed( &pcOut[xPos], xOutSize - xPos,
+								  (int32_t)( ( xArg.fFloat * fScale ) + ( xArg.fFloat < 0.0f ? -0.5f : 0.5f ) ),
+								  ucDecimals );
+		}
+		else
+		{
+			xWritten = xFmtSnprintf( &pcOut[xPos], xOutSize - xPos, cSpec, xArg.lInt );
+		}
+
+		xPos += xWritten;
+	}
+
+	if( xPos > xOutSize - 1 )
+	{
+		xPos = xOutSize - 1;
+	}
+
+	pcOut[xPos] = '\0';
+}
@@ -0,0 +1,460 @@
+/**
+  ******************************************************************************
+  * @file    lowpower.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Tickless idle. STOP mode is only used while the application
+  * 		 sleeps: UART2 and its DMA stop with the clocks, so any byte
+  * 		 received in STOP mode is lost, and the key that wakes the MCU up
+  * 		 may be too. Otherwise the MCU waits in sleep mode, where UART2 and
+  * 		 its DMA keep running, with SysTick counting the whole idle time
+  * 		 instead of interrupting every tick.
+  *
+  * 		 In STOP mode the RTC wakeup timer counts RTCCLK / 16, so it can
+  * 		 end the sleep a tick before the next task is due, up to 32 seconds
+  * 		 away. On leaving STOP mode it counts the 1 Hz ck_spre clock again
+  * 		 for the wall clock. The time slept is the RTC time on leaving STOP
+  * 		 mode minus the time of the time base on entering it. The time base
+  * 		 is then moved to the RTC time, so the rounding of one RTC reading
+  * 		 is made up for by the next, instead of adding up over the sleeps.
+  * 		 The time slept is added to the tick count in whole ticks, and the
+  * 		 rest is kept for the next time, so the tick count does not drift
+  * 		 from the RTC while the MCU sleeps.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <string.h>
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timebase.h"
+#include "wallclock.h"
+#include "uart_driver.h"
+#include "lowpower.h"
+
+// CONSTANTS
+
+// Clock of the RTC wakeup timer in STOP mode, RTCCLK (LSE at 32768 Hz) / 16
+#define LOWPOWER_WUT_HZ				2048
+
+// Longest count of the RTC wakeup timer
+#define LOWPOWER_WUT_MAX			0x10000UL
+
+// Nanoseconds in a tick
+#define LOWPOWER_TICK_NS			( TIMEBASE_NS_PER_SECOND / configTICK_RATE_HZ )
+
+// Largest count of SysTick, which has a 24-bit counter
+#define LOWPOWER_SYSTICK_MAX		0xFFFFFFUL
+
+// LOWPOWER GLOBALS
+
+// Statistics of the tickless idle
+static uint32_t ulLowPowerStops = 0;
+static volatile uint32_t ulLowPowerRxWakes = 0;
+static uint32_t ulLowPowerTicksSlept = 0;
+static uint32_t ulLowPowerLongestTicks = 0;
+
+// Time slept not added to the tick count yet
+static uint64_t ullLowPowerPendingNs = 0;
+
+// Timestamp of the time base when the tick count was 0
+static uint64_t ullLowPowerStartNs = 0;
+
+// FUNCTION PROTOTYPES
+
+// To wait in sleep mode with SysTick counting the idle time
+static void vLowPowerSleep(TickType_t xExpectedIdleTime);
+
+// To set the clock and the count of the RTC wakeup timer
+static void vLowPowerSetWakeUp(uint32_t ulClock, uint32_t ulCount);
+
+// To switch the oscillators and the system clock back on after STOP mode
+static void vLowPowerRestoreClocks(uint32_t ulCr, uint8_t ucSysClkSource);
+/*******************************************************************************
+*   Procedure: vLowPowerInit
+*
+*   Description: This function routes the USART2 RX pin (PA3) to EXTI line 3,
+*   			 falling edge, which is the start bit of a received byte. The
+*   			 line is only unmasked in STOP mode.
+*
+*   Notes: Called just before the scheduler is started, when the tick count is
+*   	   0, so the tick drift is measured from there.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vLowPowerInit(void)
+{
+	EXTI_InitTypeDef xRxExtiInit;		// Configure EXTI line 3 since the USART2 RX pin is connected to it
+
+	// The EXTI multiplexers are in SYSCFG
+	RCC_APB2PeriphClockCmd( RCC_APB2Periph_SYSCFG, ENABLE );
+	SYSCFG_EXTILineConfig( EXTI_PortSourceGPIOA, EXTI_PinSource3 );
+
+	// Zeroing each struct member to avoid random values causing abnormal behaviors
+	memset(&xRxExtiInit, 0, sizeof(xRxExtiInit));
+
+	xRxExtiInit.EXTI_Line = EXTI_Line3;					// Select EXTI line 3
+	xRxExtiInit.EXTI_LineCmd = DISABLE;					// Masked till STOP mode is entered
+	xRxExtiInit.EXTI_Mode = EXTI_Mode_Interrupt;		// Select the mode for the EXTI line (e.g. interrupt or event)
+	xRxExtiInit.EXTI_Trigger = EXTI_Trigger_Falling;	// The start bit pulls the idle high line low
+
+	// Initialize the EXTI line configured
+	EXTI_Init( &xRxExtiInit );
+
+	// The handler uses FreeRTOS, so its priority cannot be less than 5
+	NVIC_SetPriority( EXTI3_IRQn, 5 );
+	NVIC_EnableIRQ( EXTI3_IRQn );
+
+	ullLowPowerStartNs = ullTimebaseNow();
+}
+/*******************************************************************************
+*   Procedure: vLowPowerSuppressTicksAndSleep
+*
+*   Description: This function stops the tick and puts the MCU in STOP mode till
+*   			 a tick before the next task is due, or till any interrupt, e.g.
+*   			 an RTC alarm or input on the USART2 RX pin. Then it restores
+*   			 the clocks, publishes the RTC date and time, moves the time base
+*   			 and the tick count forward by the time slept and restarts the
+*   			 tick.
+*
+*   Notes: Called by the idle task with the scheduler suspended, when no task
+*   	   is due for configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks or more.
+*   	   Unless xLowPowerPortAllowed() returns pdTRUE, or while UART2 still
+*   	   transmits, the MCU only waits in sleep mode, see vLowPowerSleep().
+*   	   The interrupts are disabled from the last check till the
+*   	   tick count is up to date, so the interrupt which ended STOP mode
+*   	   runs after that.
+*
+*   Parameters: xExpectedIdleTime - The ticks till the next task is due
+*
+*   Return: None
+*
+*******************************************************************************/
+void vLowPowerSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+	WallClock_t xAfter;			// RTC date and time after STOP mode
+	uint64_t ullBeforeNs;		// Wall clock time of the time base before STOP mode
+	uint32_t ulSysTickCtrl;		// SysTick control register to restore
+	uint32_t ulCr;				// Oscillators and PLL on before STOP mode
+	uint8_t ucSysClkSource;		// System clock source before STOP mode
+	uint32_t ulCount;			// Count of the RTC wakeup timer
+	uint32_t ulTicks;			// Ticks added to the tick count
+	uint64_t ullRtcNs;			// RTC time after STOP mode
+
+	// UART2 would stop in the middle of a byte
+	if( xLowPowerPortAllowed() == pdFALSE || xUartTxBusy() == pdTRUE )
+	{
+		vLowPowerSleep( xExpectedIdleTime );
+		return;
+	}
+
+	__disable_irq();
+	__DSB();
+	__ISB();
+
+	// A task may have been readied by an interrupt since the scheduler was suspended
+	if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+	{
+		__enable_irq();
+		return;
+	}
+
+	// Stop the tick, unless it is already due
+	ulSysTickCtrl = SysTick->CTRL;
+	SysTick->CTRL = ulSysTickCtrl & ~SysTick_CTRL_ENABLE_Msk;
+	if( SCB->ICSR & SCB_ICSR_PENDSTSET_Msk )
+	{
+		SysTick->CTRL = ulSysTickCtrl;
+		__enable_irq();
+		return;
+	}
+
+	// The part of the current tick already gone is counted with the time slept,
+	// which is measured from here
+	ullLowPowerPendingNs += ( (uint64_t)( SysTick->LOAD - SysTick->VAL ) * TIMEBASE_NS_PER_SECOND ) / SystemCoreClock;
+	ullBeforeNs = ullTimebaseToWall( ullTimebaseNow() );
+
+	// Wake up a tick before the next task is due, so the tick interrupt readies it
+	ulCount = (uint32_t)( ( (uint64_t)( xExpectedIdleTime - 1 ) * LOWPOWER_WUT_HZ ) / configTICK_RATE_HZ );
+	if( ulCount == 0 )
+	{
+		ulCount = 1;
+	}
+	else if( ulCount > LOWPOWER_WUT_MAX )
+	{
+		ulCount = LOWPOWER_WUT_MAX;
+	}
+	vLowPowerSetWakeUp( RTC_WakeUpClock_RTCCLK_Div16, ulCount - 1 );
+
+	// Wake up on input too
+	EXTI_ClearITPendingBit( EXTI_Line3 );
+	EXTI->IMR |= EXTI_Line3;
+
+	// Keep the debug link, and the RTT console with it, while a debugger is attached
+	DBGMCU_Config( DBGMCU_STOP, ( CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk ) ? ENABLE : DISABLE );
+
+	ulCr = RCC->CR;
+	ucSysClkSource = RCC_GetSYSCLKSource();
+
+	PWR_EnterSTOPMode( PWR_LowPowerRegulator_ON, PWR_STOPEntry_WFI );
+
+	// The MCU runs from HSI on leaving STOP mode
+	vLowPowerRestoreClocks( ulCr, ucSysClkSource );
+
+	EXTI->IMR &= ~EXTI_Line3;
+
+	// The RTC shadow registers are only valid once they are synchronized again
+	(void)RTC_WaitForSynchro();
+	vWallClockUpdateFromISR( &xAfter );
+
+	// Restart the tick with a whole period, from the time the sleep was measured to
+	SysTick->VAL = 0;
+	SysTick->CTRL = ulSysTickCtrl;
+
+	// Back to a wakeup every second. The wall clock is already up to date, so a
+	// wakeup of the RTCCLK / 16 count is not handled
+	vLowPowerSetWakeUp( RTC_WakeUpClock_CK_SPRE_16bits, 0 );
+	RTC_ClearITPendingBit( RTC_IT_WUT );
+	EXTI_ClearITPendingBit( EXTI_Line22 );
+	NVIC_ClearPendingIRQ( RTC_WKUP_IRQn );
+
+	// The time base is given the middle of the sub-second step read
+	ullRtcNs = (uint64_t)xAfter.ulSeconds * TIMEBASE_NS_PER_SECOND + xAfter.ulNanoseconds +
+			   TIMEBASE_NS_PER_SECOND / ( 2 * ( ( RTC->PRER & RTC_PRER_PREDIV_S ) + 1 ) );
+	vTimebaseResume( ullRtcNs );
+
+	// As for the time base, a sleep shorter than the rounding of the RTC reading counts as none
+	if( ullRtcNs > ullBeforeNs )
+	{
+		ullLowPowerPendingNs += ullRtcNs - ullBeforeNs;
+	}
+
+	// The tick count must not pass the time the next task is due
+	ulTicks = ( ullLowPowerPendingNs / LOWPOWER_TICK_NS > xExpectedIdleTime - 1 ) ?
+			  xExpectedIdleTime - 1 : (uint32_t)( ullLowPowerPendingNs / LOWPOWER_TICK_NS );
+	ullLowPowerPendingNs -= (uint64_t)ulTicks * LOWPOWER_TICK_NS;
+
+	vTaskStepTick( ulTicks );
+
+	ulLowPowerStops++;
+	ulLowPowerTicksSlept += ulTicks;
+	if( ulTicks > ulLowPowerLongestTicks )
+	{
+		ulLowPowerLongestTicks = ulTicks;
+	}
+
+	__enable_irq();
+}
+/*******************************************************************************
+*   Procedure: vLowPowerGetStats
+*
+*   Description: This function gets the statistics of the tickless idle and the
+*   			 tick drift, the tick count minus the time the RTC counted
+*   			 since the scheduler was started
+*
+*   Notes: The tick runs from the core clock while the MCU is awake, so most of
+*   	   the drift comes from the HSI, not from STOP mode. The time base
+*   	   counts at the rate of the RTC, across STOP mode as well.
+*
+*   Parameters: pxStats - A pointer to the location receiving the statistics
+*
+*   Return: None
+*
+*******************************************************************************/
+void vLowPowerGetStats(LowPowerStats_t* pxStats)
+{
+	uint64_t ullTickNs;		// Time counted by the tick
+	uint64_t ullRtcNs;		// Time counted by the time base
+
+	taskENTER_CRITICAL();
+	ullTickNs = (uint64_t)xTaskGetTickCount() * LOWPOWER_TICK_NS;
+	ullRtcNs = ullTimebaseNow() - ullLowPowerStartNs;
+	pxStats->ulStops = ulLowPowerStops;
+	pxStats->ulRxWakes = ulLowPowerRxWakes;
+	pxStats->ulTicksSlept = ulLowPowerTicksSlept;
+	pxStats->ulLongestTicks = ulLowPowerLongestTicks;
+	pxStats->ulPendingUs = (uint32_t)( ullLowPowerPendingNs / 1000 );
+	taskEXIT_CRITICAL();
+
+	pxStats->lTickDriftUs = (int32_t)( ( (int64_t)ullTickNs - (int64_t)ullRtcNs ) / 1000 );
+}
+/*******************************************************************************
+*   Procedure: EXTI3_IRQHandler
+*
+*   Description: Non-weak implementation of the interrupt handler for EXTI line
+*   			 3. It runs once STOP mode was ended by a start bit on the
+*   			 USART2 RX pin, and hands over to the application.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void EXTI3_IRQHandler(void)
+{
+	EXTI_ClearITPendingBit( EXTI_Line3 );
+
+	ulLowPowerRxWakes++;
+	vLowPowerPortRxWakeFromISR();
+}
+/*******************************************************************************
+*   Procedure: vLowPowerSleep
+*
+*   Description: This function waits in sleep mode till the next task is due,
+*   			 or till any interrupt. SysTick is loaded with the whole idle
+*   			 time instead of one tick, then the tick count is moved forward
+*   			 by the ticks that passed and SysTick is set back to one tick.
+*
+*   Notes: The tickless idle of the FreeRTOS Cortex-M4F port. The idle time is
+*   	   limited to what the 24-bit SysTick counts, about a second at
+*   	   16 MHz. UART2, its DMA and the DWT cycle counter of the time base
+*   	   keep running in sleep mode. The few counts SysTick misses while it
+*   	   is stopped are not made up for, they show in the tick drift.
+*
+*   Parameters: xExpectedIdleTime - The ticks till the next task is due
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vLowPowerSleep(TickType_t xExpectedIdleTime)
+{
+	uint32_t ulTickCounts;		// SysTick counts in a tick
+	uint32_t ulReload;			// SysTick counts till the tick before the next task is due
+	uint32_t ulDone;			// SysTick counts gone while sleeping
+	uint32_t ulTicks;			// Whole ticks gone while sleeping
+
+	ulTickCounts = SysTick->LOAD + 1;
+	if( xExpectedIdleTime > LOWPOWER_SYSTICK_MAX / ulTickCounts )
+	{
+		xExpectedIdleTime = LOWPOWER_SYSTICK_MAX / ulTickCounts;
+	}
+
+	__disable_irq();
+	__DSB();
+	__ISB();
+
+	// Stop SysTick, the rest of the current tick is counted from its current value
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+	// A task may have been readied by an interrupt since the scheduler was suspended
+	if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+	{
+		SysTick->LOAD = SysTick->VAL;
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		SysTick->LOAD = ulTickCounts - 1;
+		__enable_irq();
+		return;
+	}
+
+	ulReload = SysTick->VAL + ulTickCounts * ( xExpectedIdleTime - 1 );
+	SysTick->LOAD = ulReload;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+	__DSB();
+	__WFI();
+	__ISB();
+
+	// Let the interrupt which ended the sleep run, then stop SysTick again
+	__enable_irq();
+	__DSB();
+	__ISB();
+	__disable_irq();
+	__DSB();
+	__ISB();
+
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+	if( SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk )
+	{
+		// The tick before the next task is due ended the sleep, its interrupt
+		// is pending and counts it. The next tick ends a whole tick after it
+		ulDone = ulReload - SysTick->VAL;
+		ulTicks = xExpectedIdleTime - 1;
+		SysTick->LOAD = ( ulDone < ulTickCounts ) ? ulTickCounts - 1 - ulDone : ulTickCounts - 1;
+	}
+	else
+	{
+		// Another interrupt ended the sleep. The next tick ends where the tick
+		// it was in would have ended
+		ulDone = ( xExpectedIdleTime * ulTickCounts ) - SysTick->VAL;
+		ulTicks = ulDone / ulTickCounts;
+		SysTick->LOAD = ( ( ulTicks + 1 ) * ulTickCounts ) - ulDone;
+	}
+
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	vTaskStepTick( ulTicks );
+	SysTick->LOAD = ulTickCounts - 1;
+
+	__enable_irq();
+}
+/*******************************************************************************
+*   Procedure: vLowPowerSetWakeUp
+*
+*   Description: This function sets the clock and the count of the RTC wakeup
+*   			 timer, which wakes up every count + 1 clock periods
+*
+*   Notes: The timer is stopped meanwhile, which takes up to two RTCCLK
+*   	   periods.
+*
+*   Parameters: ulClock - The clock, RTC_WakeUpClock_xxx
+*   			ulCount - The count, 0 to 0xFFFF
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vLowPowerSetWakeUp(uint32_t ulClock, uint32_t ulCount)
+{
+	(void)RTC_WakeUpCmd( DISABLE );
+	RTC_WakeUpClockConfig( ulClock );
+	RTC_SetWakeUpCounter( ulCount );
+	RTC_ClearITPendingBit( RTC_IT_WUT );
+	(void)RTC_WakeUpCmd( ENABLE );
+}
+/*******************************************************************************
+*   Procedure: vLowPowerRestoreClocks
+*
+*   Description: This function switches the oscillators and the PLL which were
+*   			 on before STOP mode back on, and selects the system clock
+*   			 source again
+*
+*   Notes: STOP mode leaves HSI on as the system clock and turns HSE and the PLL
+*   	   off. Their settings are kept. With the default HSI at 16 MHz
+*   	   nothing is to be done.
+*
+*   Parameters: ulCr - RCC_CR before STOP mode
+*   			ucSysClkSource - RCC_GetSYSCLKSource() before STOP mode
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vLowPowerRestoreClocks(uint32_t ulCr, uint8_t ucSysClkSource)
+{
+	if( ulCr & RCC_CR_HSEON )
+	{
+		RCC_HSEConfig( ( ulCr & RCC_CR_HSEBYP ) ? RCC_HSE_Bypass : RCC_HSE_ON );
+		(void)RCC_WaitForHSEStartUp();
+	}
+
+	if( ulCr & RCC_CR_PLLON )
+	{
+		RCC_PLLCmd( ENABLE );
+		while( RCC_GetFlagStatus( RCC_FLAG_PLLRDY ) == RESET );
+	}
+
+	// The SWS field (bits 3:2) holds the source in the same coding as the SW field (bits 1:0)
+	if( RCC_GetSYSCLKSource() != ucSysClkSource )
+	{
+		RCC_SYSCLKConfig( ucSysClkSource >> 2 );
+		while( RCC_GetSYSCLKSource() != ucSysClkSource );
+	}
+}
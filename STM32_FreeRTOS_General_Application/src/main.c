@@ -8,7 +8,7 @@
   * 		 STM32F446RE is the board of choice here. This application will run
   * 		 a main menu which will prompt the user over a serial monitor to select
   * 		 to:
-  * 		 - Display and change time and date; set a daily alarm if needed
+  * 		 - Display and change time and date; set daily alarms if needed
   * 		 - Play guess-a-number game
   * 		 - Run an integers calculator
   * 		 - Toggle an LED on the Nucleo board
@@ -20,7 +20,6 @@
 
 // INCLUDES
 
-#include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -29,76 +28,198 @@
 #include "task.h"
 #include "queue.h"
 #include "timers.h"
+#include "event_groups.h"
+#include "uart_driver.h"
+#include "console.h"
+#include "console_in.h"
+#include "log.h"
+#include "fmt.h"
+#include "proto.h"
+#include "cmd.h"
+#include "tok.h"
+#include "app.h"
+#include "alarm.h"
+#include "timebase.h"
+#include "wallclock.h"
+#include "calendar.h"
+#include "calc.h"
+#include "lowpower.h"
+#include "ram_budget.h"
 
 // CONSTANTS
 
-// Invalid Number
-#define INVALID_NUM 				(int32_t)0xFFFFFFFF
+// Largest number of fields read by ulParseFields()
+#define PARSE_MAX_FIELDS			3
 
-// Applications to choose from
-#define RUN_CLOCK					1
-#define RUN_GAME					2
-#define RUN_CALCULATOR 				3
-#define MONITOR_TEMP				4
-#define TOGGLE_LED					5
-#define SLEEP						6
+// Time the user is given to answer a prompt
+#define APP_INPUT_TIMEOUT_MS		30000
+
+// Largest number of fields of a form
+#define FORM_MAX_FIELDS				3
+
+// Stack of the Temperature Monitor task in words
+#define TEMP_MONITOR_TASK_STACK_SIZE	500
+
+// Stack of the Script Session task in words
+#define SCRIPT_SESSION_TASK_STACK_SIZE	500
+
+// Indexes of the temperature statistics
+#define TEMP_CURRENT				0
+#define TEMP_HIGHEST				1
+#define TEMP_LOWEST					2
+
+// Bits of the control event group. A request bit is cleared by the Temperature
+// Monitor task when it takes the request, then it sets CTRL_TEMP_ACK
+#define CTRL_TEMP_START_REQ			( 1UL << 0 )	// Request to start monitoring
+#define CTRL_TEMP_STOP_REQ			( 1UL << 1 )	// Request to stop monitoring
+#define CTRL_TEMP_ACK				( 1UL << 2 )	// The last request was handled
+#define CTRL_TEMP_RUNNING			( 1UL << 3 )	// Set while the temperature is monitored
+#define CTRL_SLEEP					( 1UL << 4 )	// Set while the application sleeps
+#define CTRL_TEMP_INPUT				( 1UL << 5 )	// Set by the console input when an "@temp" line is queued
+#define CTRL_TEMP_REQS				( CTRL_TEMP_START_REQ | CTRL_TEMP_STOP_REQ )
+#define CTRL_TEMP_WAKE				( CTRL_TEMP_REQS | CTRL_TEMP_INPUT )
+
+// Time the Temperature Monitor task is given to handle a request
+#define CTRL_ACK_TIMEOUT_MS			100
+
+// Period of the temperature measurements
+#define TEMP_MEASURE_PERIOD_MS		500
+
+// Date and time the RTC starts from after a reset, in Unix time (2020-12-03 17:00:00)
+#define RTC_START_TIME				1607014800UL
+
+// Size of the buffer holding a line of the alarm list
+#define ALARM_LINE_SIZE				80
+
+// TYPES
+
+// A temperature statistic and the time it was recorded
+typedef struct
+{
+	float fTemp;
+	uint32_t ulTime;		// Unix time
+} TempStat_t;
+
+// A field of a form, prompted for on its own
+typedef struct
+{
+	const char* pcPrompt;		// Prompt posted to the user
+	int32_t lMin;				// Smallest valid value
+	int32_t lMax;				// Largest valid value
+} FormField_t;
+
+// A form: a number of fields applied together once all of them are valid
+typedef struct Form
+{
+	const FormField_t* pxFields;			// Fields, in the order they are prompted for
+	uint32_t ulNumFields;					// Number of fields, up to FORM_MAX_FIELDS
+	void (*vApply)(const int32_t* plValues);	// To apply the values of the fields
+	const struct Form* pxNext;				// Form to fill in next, NULL to go back to the clock menu
+} Form_t;
 
 // APPLICATION GLOBALS
 
 // Task handles
 TaskHandle_t xUartWriteTaskHandle = NULL;
-TaskHandle_t xMainMenuTaskHandle = NULL;
-TaskHandle_t xClockTaskHandle = NULL;
-TaskHandle_t xGameTaskHandle = NULL;
-TaskHandle_t xCalculatorTaskHandle = NULL;
+TaskHandle_t xLogTaskHandle = NULL;
+TaskHandle_t xConsoleInTaskHandle = NULL;
+TaskHandle_t xAppTaskHandle = NULL;
 TaskHandle_t xTempMonitorTaskHandle = NULL;
+TaskHandle_t xScriptSessionTaskHandle = NULL;
 
 // Timer handle to toggle LED
 TimerHandle_t pxLedToggleTimer = NULL;
 
-// Queue Handles
-// Queue to write to UART
-QueueHandle_t xUartWriteQueue = NULL;
+// Stacks and control blocks of the tasks, allocated statically
+static StackType_t xUartWriteTaskStack[CONSOLE_TASK_STACK_SIZE];
+static StaticTask_t xUartWriteTaskBuffer;
+static StackType_t xLogTaskStack[LOG_TASK_STACK_SIZE];
+static StaticTask_t xLogTaskBuffer;
+static StackType_t xAppTaskStack[APP_TASK_STACK_SIZE];
+static StaticTask_t xAppTaskBuffer;
+static StackType_t xTempMonitorTaskStack[TEMP_MONITOR_TASK_STACK_SIZE];
+static StaticTask_t xTempMonitorTaskBuffer;
+static StackType_t xConsoleInTaskStack[CONSOLE_IN_TASK_STACK_SIZE];
+static StaticTask_t xConsoleInTaskBuffer;
+static StackType_t xScriptSessionTaskStack[SCRIPT_SESSION_TASK_STACK_SIZE];
+static StaticTask_t xScriptSessionTaskBuffer;
+
+// Stacks and control blocks of the Idle and Timer Service tasks, handed to the kernel
+static StackType_t xIdleTaskStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t xIdleTaskBuffer;
+static StackType_t xTimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+static StaticTask_t xTimerTaskBuffer;
+
+// Storage of the LED toggle timer
+static StaticTimer_t xLedToggleTimerBuffer;
+
+RAM_BUDGET_CHECK( sizeof(xIdleTaskStack) + sizeof(xIdleTaskBuffer) + sizeof(xTimerTaskStack) + sizeof(xTimerTaskBuffer),
+				  RAM_BUDGET_KERNEL );
+
+RAM_BUDGET_CHECK( sizeof(xUartWriteTaskStack) + sizeof(xUartWriteTaskBuffer) + sizeof(xLogTaskStack) + sizeof(xLogTaskBuffer) +
+				  sizeof(xAppTaskStack) + sizeof(xAppTaskBuffer) + sizeof(xTempMonitorTaskStack) +
+				  sizeof(xTempMonitorTaskBuffer) + sizeof(xConsoleInTaskStack) + sizeof(xConsoleInTaskBuffer) +
+				  sizeof(xScriptSessionTaskStack) + sizeof(xScriptSessionTaskBuffer) + sizeof(xLedToggleTimerBuffer),
+				  RAM_BUDGET_TASKS );
 
 // ADC init struct used to initialize ADC1 for the
 // purpose of measuring the internal temp sensor
 // For some reason it needs to be in global space
 ADC_InitTypeDef xAdcInit;
 
-// Flag to go to sleep
-BaseType_t xGoToSleep = pdFALSE;
-
-// Flag to show temp stats if requested by the user
-BaseType_t xShowTemps = pdFALSE;
-
-// Flag set by the user to run temp monitoring
-BaseType_t xRunTempMonitor = pdFALSE;
-
-// Menu to display to user of application
-char* pcMenu = "\
-\r\n===============================================\
-\r\nThis is a general FreeRTOS Application\
-\r\nPress the letter Q (or q) and the return key\
-\r\nto return to the main menu below any time\
-\r\n=================MAIN MENU=====================\
-\r\nSelect one of the sub-applications below to run\
-\r\nTime and Alarms					----> 1\
-\r\nGuess-A-Number Game		                ----> 2\
-\r\nCalculator				        ----> 3\
-\r\nMonitor temperature				----> 4\
-\r\nToggle LED				        ----> 5\
-\r\nSleep and Wait for Interrupt			----> 6\
-\r\nType your option: ";
+// Control event group: requests to the Temperature Monitor task, its state, and sleep mode
+static EventGroupHandle_t xControlEvents = NULL;
+static StaticEventGroup_t xControlEventsBuffer;
+
+// Mailbox holding the latest temperature statistics published by the Temperature
+// Monitor task. It is overwritten by each measurement and peeked by the readers
+static QueueHandle_t xTempStatsMailbox = NULL;
+static StaticQueue_t xTempStatsMailboxBuffer;
+static uint8_t ucTempStatsMailboxStorage[sizeof(TempStat_t[3])];
+
+RAM_BUDGET_CHECK( sizeof(xControlEventsBuffer) + sizeof(xTempStatsMailboxBuffer) + sizeof(ucTempStatsMailboxStorage),
+				  RAM_BUDGET_CONTROL );
+
+// Form being filled in, the field being prompted for and the values of the fields so far
+static const Form_t* pxForm = NULL;
+static uint32_t ulFormField = 0;
+static int32_t lFormValues[FORM_MAX_FIELDS];
+
+// Number to guess in the game and the number of guesses so far
+static uint8_t ucGameSelectedNum = 0xFF;
+static uint32_t ulGameNumOfGuesses = 0;
+
+// Numbers of the calculation being entered
+static int32_t lCalcFirstNum = 0;
+static int32_t lCalcSecondNum = 0;
+
+// Baud rate to go back to if the new one is not confirmed
+static uint32_t ulOldBaudRate = 0;
+
+// State to go back to once woken up
+static AppState_t pxSleepReturnState = NULL;
 
 // FUNCTION PROTOTYPES
 
 // Task handler prototypes
-void vUartWriteTaskFunction(void *pvParam);
-void vMainMenuTaskFunction(void *pvParam);
-void vClockTaskFunction(void *pvParam);
-void vGameTaskFunction(void *pvParam);
-void vCalculatorTaskFunction(void *pvParam);
 void vTempMonitorTaskFunction(void *pvPram);
+void vScriptSessionTaskFunction(void *pvParam);
+
+// States of the sub-applications run by the App task
+static void vMainMenuState(const AppEvent_t* pxEvent);
+static void vClockMenuState(const AppEvent_t* pxEvent);
+static void vFormState(const AppEvent_t* pxEvent);
+static void vGameState(const AppEvent_t* pxEvent);
+static void vCalcFirstState(const AppEvent_t* pxEvent);
+static void vCalcSecondState(const AppEvent_t* pxEvent);
+static void vCalcOperatorState(const AppEvent_t* pxEvent);
+static void vTempMenuState(const AppEvent_t* pxEvent);
+static void vLedMenuState(const AppEvent_t* pxEvent);
+static void vSleepState(const AppEvent_t* pxEvent);
+static void vBaudRateState(const AppEvent_t* pxEvent);
+static void vBaudConfirmState(const AppEvent_t* pxEvent);
+static void vProtoState(const AppEvent_t* pxEvent);
+static void vScriptState(const AppEvent_t* pxEvent);
 
 // To toggle the green LED on Nucleo board
 void vLedToggle(TimerHandle_t xTimer);
@@ -106,9 +227,6 @@ void vLedToggle(TimerHandle_t xTimer);
 // To setup the MCU
 static void vSetupHardware(void);
 
-// To setup UART communication
-static void vUartSetup(void);
-
 // To setup RTC peripheral
 static void vRtcSetup(void);
 
@@ -118,23 +236,26 @@ static void vGpioSetup(void);
 // To setup the ADC to use for analog temperature measurement
 static void vAdcSetup(void);
 
-// To send UART messages to a terminal
-static void vSendUartMsg(char *msg);
-
 // To receive UART messages from a terminal
-static BaseType_t xReceiveUartMsg(char* pcMsgBuffer, BaseType_t* pxQuitCurrentApp);
+static BaseType_t xReceiveUartMsg(const AppEvent_t* pxEvent, BaseType_t* pxQuitCurrentApp);
 
-// To send error messages to UART terminal
-static void vPostMsgToUartQueue(char* pcUartMsg);
+// To start filling in a form
+static void vFormStart(const Form_t* pxNewForm);
 
 // To acquire from RTC the current date and time and send them to UART terminal
 static void vReadRtcDateTime(void);
 
 // To convert the number received via UART to INT32 number
-static int32_t lUartMsgtoInt32(char* pcUartMsg);
+static BaseType_t xUartMsgToInt32(const char* pcUartMsg, int32_t* plNum);
+
+// To post why the user's input is not a valid number
+static void vPostTokError(TokError_t xError);
 
-// To manage toggling the green LED of the Nucleo board
-static void vManageLedToggle(void);
+// To conduct a calculation and post its result
+static void vCalculate(int32_t lFirstNum, char cOperator, int32_t lSecondNum);
+
+// To change the console baud rate
+static void vChangeBaudRate(int32_t lNewBaudRate);
 
 // To enable toggling the green LED on the Nucleo board
 static void vLedToggleEnable(uint32_t ulToggleDuration);
@@ -142,14 +263,29 @@ static void vLedToggleEnable(uint32_t ulToggleDuration);
 // To disable toggling the green LED on the Nucleo board
 static void vLedToggleDisable(void);
 
-// To set an alarm by using the RTC peripheral
-static void vSetAlarm( BaseType_t* xQuitCurrentApp );
+// To add a daily alarm once its form is filled in
+static void vApplyAlarm(const int32_t* plValues);
+
+// To add an alarm firing every day at the given time
+static AlarmId_t xAddDailyAlarm(int32_t lHours, int32_t lMinutes, int32_t lSeconds);
+
+// To alert the user that an alarm fired
+static void vAlarmTriggered(AlarmId_t xId, void* pvArg, BaseType_t* pxHigherPriorityTaskWoken);
+
+// To read the RTC as Unix time (seconds since 1970-01-01)
+static uint32_t ulRtcNow(void);
+
+// To make the time base follow the RTC as it is, before the RTC is set
+static void vRtcChanging(void);
+
+// To publish the RTC date and time, resynchronize the time base and program the alarm after the RTC was set
+static void vRtcChanged(void);
 
-// To configure the user desired date and time in the RTC peripheral
-static void vSetDateAndTime( BaseType_t* pxQuitCurrentApp );
+// To configure the user desired time in the RTC peripheral
+static void vApplyTime(const int32_t* plValues);
 
-// To enter and leave sleep mode for this application
-static void vManageAppSleep(void);
+// To configure the user desired date in the RTC peripheral
+static void vApplyDate(const int32_t* plValues);
 
 // To measure actual VDDA using VRefInt in order to have better temp readings
 static float fMeasureVDDA(void);
@@ -157,8 +293,63 @@ static float fMeasureVDDA(void);
 // To measure the temperature using the internal temperature sensor on Nucleo board
 static float fMeasureTemp(void);
 
-// To manage user selections for temp monitor
-static void vManageTempMonitor(void);
+// To post a temperature statistic to the Log task
+static void vPostTempStats(const TempStat_t* pxStats, ConsoleLink_t eLink);
+
+// To post the result of a calculation to the Log task
+static void vPostCalcResult(int32_t lCalcNum);
+
+// To send a request to the Temperature Monitor task and wait till it is handled
+static BaseType_t xTempMonitorRequest(EventBits_t uxRequest);
+
+// To print the share of CPU time used by each task
+static void vReportCpuUsage(void);
+
+// To print the statistics of the tickless idle and the tick drift
+static void vReportLowPower(void);
+
+// To answer the requests of the binary protocol
+static void vProtoHandleRequest(const ProtoFrame_t* pxReq);
+
+// To put a temperature statistic into a binary protocol response
+static uint8_t* pucProtoPutTempStat(uint8_t* pucOut, const TempStat_t* pxStat);
+
+// To read numbers separated by a character, e.g. "08:00:00"
+static uint32_t ulParseFields(const char* pcText, char cSeparator, int32_t* plFields, uint32_t ulMaxFields);
+
+// FORMS
+
+// Fields of the alarm
+static const FormField_t xAlarmFields[] =
+{
+	{ "\r\nEnter the hour of the Alarm\r\n", 0, 23 },
+	{ "\r\nEnter the minute of the Alarm\r\n", 0, 59 },
+	{ "\r\nEnter the second of the Alarm\r\n", 0, 59 }
+};
+
+// Fields of the time
+static const FormField_t xTimeFields[] =
+{
+	{ "\r\n\nConfiguring the time\
+	  \r\nEnter the hour in 24 hour format\r\n", 0, 23 },
+	{ "\r\n\nEnter the minute\r\n", 0, 59 },
+	{ "\r\n\nEnter the second\r\n", 0, 59 }
+};
+
+// Fields of the date
+static const FormField_t xDateFields[] =
+{
+	{ "\r\n\nConfiguring the date\
+	  \r\nEnter the day of the month\r\n", 1, 31 },
+	{ "\r\n\nEnter the month\r\n", 1, 12 },
+	{ "\r\n\nEnter the year\
+	  \r\nEnter 2000 to 2099\r\n", CALENDAR_RTC_FIRST_YEAR, CALENDAR_RTC_LAST_YEAR }
+};
+
+// Forms of the clock sub-application. The date is set after the time
+static const Form_t xAlarmForm = { xAlarmFields, 3, vApplyAlarm, NULL };
+static const Form_t xDateForm = { xDateFields, 3, vApplyDate, NULL };
+static const Form_t xTimeForm = { xTimeFields, 3, vApplyTime, &xDateForm };
 /*******************************************************************************
 *   Procedure: main
 *
@@ -166,9 +357,12 @@ static void vManageTempMonitor(void);
 *   			- Calls various peripheral initialization functions
 *   			- Performs Segger SystemView initialization to be able to get a
 *   			  trace of the application
-*   			- Creates a queue in order to serialize message transmission via
-*   			  UART2
-*   			- Creates the application tasks
+*   			- Creates the console output arena and queue in order to serialize
+*   			  message transmission via UART2
+*   			- Creates the log queue used to defer formatting to the Log task
+*   			- Creates the application tasks and registers the ones reading
+*   			  user input with the console input service. The main menu and
+*   			  the sub-applications run as state machines in the App task
 *   			- Initializes random seed into rand()
 *
 *   Notes: None
@@ -180,6 +374,8 @@ static void vManageTempMonitor(void);
 *******************************************************************************/
 int main(void)
 {
+	WallClock_t xClock;		// RTC date and time the time base starts from
+
 	// Cycle Count is needed to record the time stamp of a trace
 	// Enable CYCCNT (Cycle Count) in DWT Control Register of ARM Cortex M4 processor
 	// DWT stands for Data Watch and Trace
@@ -201,86 +397,88 @@ int main(void)
 	// Set up various peripherals used in this RTA
 	vSetupHardware();
 
+	// Publish the RTC date and time before the first wakeup
+	vWallClockRefresh();
+
+	// Start the monotonic time base, disciplined to the RTC
+	vWallClockGet( &xClock );
+	vTimebaseInit( (uint64_t)xClock.ulSeconds * TIMEBASE_NS_PER_SECOND + xClock.ulNanoseconds );
+
 	// Start recording trace to analyze via SEGGER SystemView
 	SEGGER_SYSVIEW_Conf();
 	// SEGGER SystemView events recording starts only when the below API is called
 	SEGGER_SYSVIEW_Start();
 
-	// Create queue of 10 elements to write to UART
-	xUartWriteQueue = xQueueCreate(10, sizeof(char*));
-
-	if( xUartWriteQueue != NULL )
+	// Create the output arena and the queue to write to UART
+	// Create the queue of records to be rendered by the Log task
+	// Create the App lock shared by the console sessions
+	if( xConsoleInit() == pdPASS && xLogInit() == pdPASS && xAppInit() == pdPASS )
 	{
-		// Create the application tasks
+		// Create the control event group and the mailbox of the temperature statistics
+		xControlEvents = xEventGroupCreateStatic( &xControlEventsBuffer );
+		xTempStatsMailbox = xQueueCreateStatic( 1, sizeof(TempStat_t[3]), ucTempStatsMailboxStorage, &xTempStatsMailboxBuffer );
+
+		// Create the application tasks in their statically allocated stacks
 		// 0 is idle priority. Anything higher than that (e.g. 1) is non-idle-priority task
 		// FreeRTOS APIs will now be used from the task handlers. Thus they will consume more
 		// task memory. Therefore it's better to increase the task's private stack to 500 words
-		xTaskCreate( vUartWriteTaskFunction, "UART_WRITE_TASK", 500, NULL, 2, &xUartWriteTaskHandle );
-		xTaskCreate( vMainMenuTaskFunction, "MAIN_MENU_TASK", 500, NULL, 1, &xMainMenuTaskHandle );
-		xTaskCreate( vClockTaskFunction, "CLOCK_TASK", 500, NULL, 1, &xClockTaskHandle);
-		xTaskCreate( vGameTaskFunction, "GAME_TASK", 500, NULL, 1, &xGameTaskHandle );
-		xTaskCreate( vCalculatorTaskFunction, "CALCULATOR_TASK", 500, NULL, 1, &xCalculatorTaskHandle);
-		xTaskCreate( vTempMonitorTaskFunction, "TEMP_MONITOR_TASK", 500, NULL, 1, &xTempMonitorTaskHandle);
+		xUartWriteTaskHandle = xTaskCreateStatic( vUartWriteTaskFunction, "UART_WRITE_TASK", CONSOLE_TASK_STACK_SIZE, NULL,
+												  CONSOLE_TASK_PRIORITY, xUartWriteTaskStack, &xUartWriteTaskBuffer );
+		xLogTaskHandle = xTaskCreateStatic( vLogTaskFunction, "LOG_TASK", LOG_TASK_STACK_SIZE, NULL,
+											LOG_TASK_PRIORITY, xLogTaskStack, &xLogTaskBuffer );
+		// The main menu and the sub-applications are state machines sharing the App task
+		xAppTaskHandle = xTaskCreateStatic( vAppTaskFunction, "APP_TASK", APP_TASK_STACK_SIZE, NULL,
+											APP_TASK_PRIORITY, xAppTaskStack, &xAppTaskBuffer );
+		xTempMonitorTaskHandle = xTaskCreateStatic( vTempMonitorTaskFunction, "TEMP_MONITOR_TASK", TEMP_MONITOR_TASK_STACK_SIZE, NULL,
+													1, xTempMonitorTaskStack, &xTempMonitorTaskBuffer );
+		xConsoleInTaskHandle = xTaskCreateStatic( vConsoleInTaskFunction, "CONSOLE_IN_TASK", CONSOLE_IN_TASK_STACK_SIZE, NULL,
+												  CONSOLE_IN_TASK_PRIORITY, xConsoleInTaskStack, &xConsoleInTaskBuffer );
+		// The RTT link runs a second session, taking scripts while the menu runs on UART2
+		xScriptSessionTaskHandle = xTaskCreateStatic( vScriptSessionTaskFunction, "SCRIPT_SESSION_TASK", SCRIPT_SESSION_TASK_STACK_SIZE,
+													  NULL, APP_TASK_PRIORITY, xScriptSessionTaskStack, &xScriptSessionTaskBuffer );
+
+		// The output of the Script Session task goes to the RTT link, the rest to UART2
+		xConsoleBindLink( xScriptSessionTaskHandle, eConsoleLinkRtt );
+
+		// Only the Console Input task reads UART2 and RTT. It sends each line typed on a
+		// link to the task holding the focus of that link: the App task on UART2 and
+		// the Script Session task on RTT
+		xConsoleInRegister( xAppTaskHandle, "menu" );
+		xConsoleInRegister( xTempMonitorTaskHandle, "temp" );
+		xConsoleInRegister( xScriptSessionTaskHandle, "script" );
+		vConsoleInSetEvent( xTempMonitorTaskHandle, xControlEvents, CTRL_TEMP_INPUT );
+		vConsoleInSetFocus( eConsoleLinkUart, xAppTaskHandle );
+		vConsoleInSetFocus( eConsoleLinkRtt, xScriptSessionTaskHandle );
+
+		// The App task starts with the main menu
+		vAppSetState( vMainMenuState );
+
+		// Wake up from STOP mode on input, and measure the tick drift from now on
+		vLowPowerInit();
 
 		// Start the scheduler in order to run the tasks
 		vTaskStartScheduler();
 	}
 	else
 	{
-		vSendUartMsg("Queue creation failed\r\n");
+		vSendUartMsg("Console or log creation failed\r\n");
 	}
 
 	// You will never return here unless there is an error
 	for(;;);
 }
 /*******************************************************************************
-*   Procedure: vUartWriteTaskFunction
-*
-*   Description: This is the task function for the UART Write Task. It supports other
-*   			 tasks by serializing message transmission to UART2. This helps avoid
-*   			 race condition to use UART2. A message will first be posted to the
-*   			 xUartWriteQueue. The UART Write Task will then be moved from blocked
-*   			 state to ready state and eventually it will run. Afterwards, this task
-*   			 function will run and the posted message will be de-queued and transmitted
-*   			 via UART2.
-*
-*   Notes: None
-*
-*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
-*   			in this task function
-*
-*   Return: None
-*
-*******************************************************************************/
-void vUartWriteTaskFunction(void *pvParam)
-{
-	char* pcData = NULL;		// To hold the address of the data received
-
-	// Task handler should always be executing
-	while(1)
-	{
-		// Receive an item from the UART write queue
-		// The task will block waiting indefinitely till an item becomes available on the queue to receive
-		xQueueReceive( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-		// Print the data pointed to on terminal window using UART
-		vSendUartMsg(pcData);
-	}
-}
-/*******************************************************************************
-*   Procedure: vMainMenuTaskFunction
-*
-*   Description: This is the task function for the Main Menu task. The Main Menu task
-*                is the first application task to run and notifies other tasks such
-*                as Clock task, Game task, Calculator task, and Temperature Monitor task
-*                if the user selects to run one of them when prompted for an input. The
-*                Main Menu task will notify one of these tasks to run and wait for a
-*                notification back from the unblocked task. This does not apply to the
-*                temperature monitor task which will run in the background once notified.
-*                This will allow the user to run more tasks to run via Main Menu task.
-*                The Main Menu task also allows the user to toggle the green LED on board
-*                or send the application to normal sleep mode. Toggling the LED is handled
-*                by the Timer Service task which runs in the background.
+*   Procedure: vMainMenuState
+*
+*   Description: This is the state of the main menu, the first one the App task
+*   			 runs. It prompts the user to select one of the sub-applications
+*   			 and runs the handler of the option selected (see the xCmd
+*   			 functions). The handlers of the clock, game and calculator
+*   			 options move to the first state of the sub-application, the
+*   			 other handlers act and the menu is entered again. The handlers
+*   			 also allow the user to toggle the green LED on board or send
+*   			 the application to normal sleep mode. Toggling the LED is
+*   			 handled by the Timer Service task which runs in the background.
 *
 *                If the user does not provide his/her input when prompted within 30 seconds
 *                then the whole operation will re-start by prompting the user to select one
@@ -290,105 +488,38 @@ void vUartWriteTaskFunction(void *pvParam)
 *
 *   Notes: None
 *
-*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
-*   			in this task function
+*   Parameters: pxEvent - A pointer to the event
 *
 *   Return: None
 *
 *******************************************************************************/
-void vMainMenuTaskFunction(void *pvParam)
+static void vMainMenuState(const AppEvent_t* pxEvent)
 {
-	char cUartMsg[50] = {0};			   // Buffer to hold the message received via UART
-	uint8_t ucAppSelected = 0;			   // To hold the application selected by the user
 	BaseType_t xQuitCurrentApp = pdFALSE;  // Flag to indicate if the user requested to quit the application
-	BaseType_t xReadSuccess = pdFALSE;	   // Flag to indicate if reading user's input via UART was successful
 
-	while(1)
+	if( pxEvent->eType == eAppEnter )
 	{
-		// Reset the flags
-		xQuitCurrentApp = pdFALSE;
-		xReadSuccess = pdFALSE;
-
 		// Print the Main Menu on the UART window
-		// Push a pointer to the data (i.e. main menu string) into the UART write queue
-		// The task will block waiting indefinitely till space becomes available on the queue
-		xQueueSend( xUartWriteQueue, &pcMenu, portMAX_DELAY );
-
-		// Zeroing the message buffer
-		memset(&cUartMsg, 0, sizeof(cUartMsg));
-		// Receive user's input for the selected app to run
-		xReadSuccess = xReceiveUartMsg(cUartMsg, &xQuitCurrentApp);
-
-		// If the UART read was successful and the user did not request to quit the application
-		if( xReadSuccess == pdTRUE && xQuitCurrentApp == pdFALSE)
-		{
-			// Return the first byte from the buffer, which will contain the user's selection
-			// 48 is subtracted to convert from ASCII to a number
-			ucAppSelected = cUartMsg[0] - 48;
-
-			switch( ucAppSelected )
-			{
-				case RUN_CLOCK:
-
-					// The user has requested to run the clock sub-application
-					// Notify the clock task to run it
-					xTaskNotify( xClockTaskHandle, 0, eNoAction );
-
-					// Wait in blocked state indefinitely till a notification is received
-					xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
-					break;
-
-				case RUN_GAME:
-
-					// The user has requested to run the game sub-application
-					// Notify the game task to run it
-					xTaskNotify( xGameTaskHandle, 0, eNoAction );
-
-					// Wait in blocked state indefinitely till a notification is received
-					xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
-					break;
-
-				case RUN_CALCULATOR:
-
-					// The user has requested to run the calculator sub-application
-					// Notify the calculator task to run it
-					xTaskNotify( xCalculatorTaskHandle, 0, eNoAction );
-
-					// Wait in blocked state indefinitely till a notification is received
-					xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
-					break;
-
-				case MONITOR_TEMP:
-
-					// The user has requested to manage the temp monitor
-					vManageTempMonitor();
-					break;
-
-				case TOGGLE_LED:
-
-					// The user has requested to manage toggling the LED on Nucleo board
-					vManageLedToggle();
-					break;
-
-				case SLEEP:
-
-					// The user has requested to manage the sleep mode for the application
-					vManageAppSleep();
-					break;
+		// The menu text is generated from the command table (see commands.def)
+		vCmdPostMenu( eCmdMenuMain );
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
 
-				default:
+	// Prompt again once the option is handled, unless its handler moves elsewhere
+	vAppSetState( vMainMenuState );
 
-					// Post a message to the UART write queue indicating that the option
-					// selected is not recognized
-					vPostMsgToUartQueue("\r\nError: Unrecognized option selected\r\n");
-			}
-		}
+	// If the UART read was successful and the user did not request to quit the application
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdTRUE && xQuitCurrentApp == pdFALSE )
+	{
+		// Run the handler of the option selected by its key or name (see the xCmd functions)
+		xCmdDispatch( eCmdMenuMain, pxEvent->pcLine, &xQuitCurrentApp );
 	}
 }
 /*******************************************************************************
-*   Procedure: vClockTaskFunction
+*   Procedure: vClockMenuState
 *
-*   Description: This is the task function for the clock task. It allows the user
+*   Description: This is the state of the clock sub-application. It allows the user
 *                to display or update the date and time. It also allows the user to set
 *                an alarm to trigger at a certain time in the day. If the user does not
 *                provide his/her input when prompted within 30 seconds then the whole
@@ -396,352 +527,354 @@ void vMainMenuTaskFunction(void *pvParam)
 *                display or update the date and time, set an alarm, or quit. Similarly if
 *                the user does not provide a valid input then the above sequence will
 *				 repeat. If the user quits by pressing the letter q/Q followed by the
-*				 return key when prompted for an input then the Main Menu task will be
-*				 notified to run and the clock task will wait for a notification in
-*				 blocked state.
+*				 return key when prompted for an input then the main menu is entered.
 *
-*   Notes: None
+*   Notes: Setting the date, time or alarm moves to vFormState.
 *
-*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
-*   			in this task function
+*   Parameters: pxEvent - A pointer to the event
 *
 *   Return: None
 *
 *******************************************************************************/
-void vClockTaskFunction(void *pvParam)
+static void vClockMenuState(const AppEvent_t* pxEvent)
 {
-	char* pcData = NULL;		// To hold the address of the message to post to UART write queue
-	char cUartMsg[150] = {0};   // Buffer to send and receive messages via UART
-	BaseType_t xReadSuccess = pdFALSE;     // Flag to indicate if reading user's input via UART was successful
 	BaseType_t xQuitCurrentApp = pdFALSE;  // Flag to indicate if the user requested to quit the application
-	uint8_t ucOptionSelected = 0;  // To hold the user's selected option
 
-	// Wait in blocked state indefinitely till a notification is received
-	xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
-
-	while(1)
+	if( pxEvent->eType == eAppEnter )
 	{
-		// Prompt the user to select one of the below options
-		pcData = "\r\n\nThis is a clock sub-application\
-				  \r\nDisplay date and time   ------> 1\
-				  \r\nSet date and time	------> 2\
-				  \r\nSet an alarm      	------> 3\
-				  \r\nQuit application  	------> 4\
-				  \r\nEnter your option here: ";
-
-		xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-		// Clear message buffer in order to use to receive a new message
-		memset(&cUartMsg, 0, sizeof(cUartMsg));
-
-		// Receive user's selected option
-		xReadSuccess = xReceiveUartMsg(cUartMsg, &xQuitCurrentApp);
-
-		// If the UART read was successful and the user did not request to quit the application
-		if( xReadSuccess == pdTRUE && xQuitCurrentApp == pdFALSE )
-		{
-			// Return the first byte from the buffer, which will contain the user's selection
-			// 48 is subtracted to convert from ASCII to a number
-			ucOptionSelected = cUartMsg[0] - 48;
-
-			switch( ucOptionSelected )
-			{
-				case 1:
-
-					// Acquire current date and time and post them to UART write queue
-					vReadRtcDateTime();
-					break;
-
-				case 2:
-
-					// Set date and time and check constantly if user requested to quit the sub-application
-					vSetDateAndTime( &xQuitCurrentApp );
-					break;
-
-				case 3:
+		// Prompt the user to select one of the options of the clock menu
+		vCmdPostMenu( eCmdMenuClock );
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
 
-					// Set alarm and check constantly if user requested to quit the sub-application
-					vSetAlarm( &xQuitCurrentApp );
-					break;
+	vAppSetState( vClockMenuState );
 
-				case 4:
+	// If the UART read was successful and the user did not request to quit the application
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdTRUE && xQuitCurrentApp == pdFALSE )
+	{
+		// The quit option sets xQuitCurrentApp
+		xCmdDispatch( eCmdMenuClock, pxEvent->pcLine, &xQuitCurrentApp );
+	}
 
-					// The user requested to quit the sub-application
-					xQuitCurrentApp = pdTRUE;
-					break;
+	// If the user requested to quit the sub-application
+	if( xQuitCurrentApp == pdTRUE )
+	{
+		vAppSetState( vMainMenuState );
+	}
+}
+/*******************************************************************************
+*   Procedure: vFormState
+*
+*   Description: This is the state filling in a form (see Form_t), e.g. the
+*   			 time. It prompts the user for each field in turn and checks
+*   			 the number received is in the range of the field. Once all
+*   			 the fields are valid the form is applied. The form is dropped
+*   			 for any of the following reasons:
+*   			 - the user does not provide an appropriate input,
+*   			 - the user quits by pressing q/Q and the return key, or
+*   			 - the user does not provide an input within 30 seconds
+*
+*   			 The form given as next is then started, or the clock menu is
+*   			 entered. If the user quits the main menu is entered instead.
+*
+*   Notes: Started by vFormStart().
+*
+*   Parameters: pxEvent - A pointer to the event
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vFormState(const AppEvent_t* pxEvent)
+{
+	const FormField_t* pxField = &pxForm->pxFields[ulFormField];	// Field being filled in
+	BaseType_t xQuitCurrentApp = pdFALSE;  // Flag to indicate if the user requested to quit the application
+	int32_t lUsersInput = 0;			   // To hold user's entry
 
-				default:
+	if( pxEvent->eType == eAppEnter )
+	{
+		// Post a UART message to prompt the user for the field
+		vPostMsgToUartQueue( pxField->pcPrompt );
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
 
-					// Post a message to the UART write queue indicating that the option
-					// selected is not recognized
-					vPostMsgToUartQueue("\r\nError: Unrecognized option selected\r\n");
-					break;
-			}
-		}
+	// If the UART read was successful, the user did not quit the sub-application, and user's input is
+	// within the range of the field then go ahead with the next field
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdTRUE && xQuitCurrentApp == pdFALSE &&
+		xUartMsgToInt32(pxEvent->pcLine, &lUsersInput) == pdTRUE &&
+		lUsersInput >= pxField->lMin && lUsersInput <= pxField->lMax )
+	{
+		lFormValues[ulFormField++] = lUsersInput;
 
-		// If the user requested to quit the sub-application
-		if( xQuitCurrentApp == pdTRUE )
+		if( ulFormField < pxForm->ulNumFields )
 		{
-			// Notify the Main Menu task to run it
-			xTaskNotify( xMainMenuTaskHandle, 0, eNoAction );
+			vAppSetState( vFormState );
+			return;
+		}
 
-			// Wait in blocked state indefinitely till a notification is received
-			xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
+		// All the fields are valid
+		pxForm->vApply( lFormValues );
+	}
 
-			// A notification to run is received so reset xQuitCurrentApp
-			xQuitCurrentApp = pdFALSE;
-		}
+	if( xQuitCurrentApp == pdTRUE )
+	{
+		vAppSetState( vMainMenuState );
+	}
+	else if( pxForm->pxNext != NULL )
+	{
+		vFormStart( pxForm->pxNext );
+	}
+	else
+	{
+		vAppSetState( vClockMenuState );
 	}
 }
 /*******************************************************************************
-*   Procedure: vGameTaskFunction
+*   Procedure: vFormStart
+*
+*   Description: This function starts filling in a form with its first field
+*
+*   Notes: None
+*
+*   Parameters: pxNewForm - A pointer to the form
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vFormStart(const Form_t* pxNewForm)
+{
+	pxForm = pxNewForm;
+	ulFormField = 0;
+
+	vAppSetState( vFormState );
+}
+/*******************************************************************************
+*   Procedure: vGameState
 *
-*   Description: This is the task function for the game task. It prompts the user
-*   		     to guess a number between 0-25 and continues to do so until the
-*   		     user guesses the correct number selected by the task function. If
+*   Description: This is the state of the game sub-application. It prompts the
+*   		     user to guess a number between 0-25 and continues to do so until the
+*   		     user guesses the correct number selected on entering the state. If
 *   		     the user does not provide his/her input when prompted within 30
-*   		     seconds then the game will restart. Similarly if the user does not
-*   		     provide a valid guess (i.e. number) then the game will restart as well.
-*				 If the user quits by pressing the letter q/Q followed by the return
-*				 key when prompted for input then the Main Menu task will be notified
-*				 to run and the game task will wait for a notification in blocked
-*				 state.
+*   		     seconds then the game will restart. A guess which is not a number
+*   		     is not counted. If the user quits by pressing the letter q/Q
+*   		     followed by the return key when prompted for input then the main
+*   		     menu is entered.
+*
 *   Notes: None
 *
-*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
-*   			in this task function
+*   Parameters: pxEvent - A pointer to the event
 *
 *   Return: None
 *
 *******************************************************************************/
-void vGameTaskFunction(void *pvParam)
+static void vGameState(const AppEvent_t* pxEvent)
 {
-	char* pcData = NULL;  			      // To hold the address of the message to post to UART write queue
-	char cUartMsg[150] = {0};             // Buffer to receive messages via UART
-	BaseType_t xReadSuccess = pdFALSE;    // Flag to indicate if reading user's input via UART was successful
 	BaseType_t xQuitCurrentApp = pdFALSE; // Flag to indicate if the user requested to quit the application
-	uint8_t lUserGuess = 0xFF;			  // To hold user's guess; initialized to invalid number
-	uint8_t ucSelectedNum = 0xFF; 		  // To hold a random integer from 0 to 25; initialized to invalid number
-	uint32_t ulNumOfGuesses;			  // To hold the number of attempts or guesses by the user
-
-	// Wait in blocked state indefinitely till a notification is received
-	xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
+	int32_t lUserGuess = 0;				  // To hold user's guess
 
-	while(1)
+	if( pxEvent->eType == eAppEnter )
 	{
 		// Generate a new random number from 0 to 25
-		ucSelectedNum = rand() % 26;
+		ucGameSelectedNum = rand() % 26;
 
 		// Reset the guess counter
-		ulNumOfGuesses = 0;
+		ulGameNumOfGuesses = 0;
 
 		// Post a message to the UART write queue asking the user to guess a number
-		pcData = "\r\n\nThis is a game sub-application\
-				  \r\nGuess a number between 0 to 25: ";
+		vPostMsgToUartQueue("\r\n\nThis is a game sub-application\
+							 \r\nGuess a number between 0 to 25: ");
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
 
-		// Push a pointer to the data into the UART write queue
-		// The task will block waiting indefinitely till space becomes available on the queue
-		xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdFALSE )
+	{
+		// No guess in time, restart the game
+		vAppSetState( vGameState );
+		return;
+	}
 
-		// Receive user's guess
-		memset(&cUartMsg, 0, sizeof(cUartMsg));
-		xReadSuccess = xReceiveUartMsg(cUartMsg, &xQuitCurrentApp);
-		lUserGuess = lUartMsgtoInt32(cUartMsg);
+	if( xQuitCurrentApp == pdTRUE )
+	{
+		vAppSetState( vMainMenuState );
+		return;
+	}
 
+	// The reason an invalid guess is rejected is posted already. It does not count as a guess
+	if( xUartMsgToInt32(pxEvent->pcLine, &lUserGuess) == pdTRUE )
+	{
 		// Increment the guess counter
-		ulNumOfGuesses++;
+		ulGameNumOfGuesses++;
 
-		// Keep prompting the user to guess as long as the guess is not correct, the UART read was successful
-		// and the user did not request to quit the sub-application
-		while( lUserGuess!= ucSelectedNum && xReadSuccess == pdTRUE && xQuitCurrentApp == pdFALSE )
+		// If the user has guessed the correct number
+		if( lUserGuess == ucGameSelectedNum )
 		{
-			if(lUserGuess > ucSelectedNum)
-			{
-				pcData = "\r\n\nYou guessed too high\r\n";
-				xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-			}
-			else
-			{
-				pcData = "\r\n\nYou guessed too low\r\n";
-				xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-			}
+			LogArg_t xArgs[] = { LOG_INT(ulGameNumOfGuesses) };
 
-			// Prompt the user to guess again
-			pcData = "\r\nGuess a number between 0 to 25: ";
-			xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+			// Post the number of guesses to the Log task to be printed, then start a new game
+			vLogPost( eLogGameWon, xArgs, 1 );
+			vAppSetState( vGameState );
+			return;
+		}
 
-			// Receive user's guess
-			memset(&cUartMsg, 0, sizeof(cUartMsg));
-			xReadSuccess = xReceiveUartMsg(cUartMsg, &xQuitCurrentApp);
-			lUserGuess = lUartMsgtoInt32(cUartMsg);
+		vPostMsgToUartQueue( ( lUserGuess > ucGameSelectedNum ) ? "\r\n\nYou guessed too high\r\n" :
+																  "\r\n\nYou guessed too low\r\n" );
+	}
 
-			// Increment the guess counter
-			ulNumOfGuesses++;
-		}
+	// Prompt the user to guess again
+	vPostMsgToUartQueue("\r\nGuess a number between 0 to 25: ");
+}
+/*******************************************************************************
+*   Procedure: vCalcFirstState
+*
+*   Description: This is the first state of the calculator sub-application. It
+*   			 prompts the user for the first of two numbers. The second number
+*   			 and the mathematical operation (+ - * /) are asked for in
+*   			 vCalcSecondState and vCalcOperatorState. The whole calculation,
+*   			 e.g. "12 * -3", can also be typed at this prompt. If the user
+*   			 does not provide his/her input when prompted within 30 seconds,
+*   			 or does not provide a valid number or operation, then the user
+*   			 will be prompted for inputs from the start again. If the user
+*   			 quits by pressing the letter q/Q followed by the return key when
+*   			 prompted for input then the main menu is entered.
+*
+*   Notes: None
+*
+*   Parameters: pxEvent - A pointer to the event
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vCalcFirstState(const AppEvent_t* pxEvent)
+{
+	BaseType_t xQuitCurrentApp = pdFALSE;  // Flag to indicate if the user requested to quit the application
+	int32_t lSecondNum;					   // To hold the second number of a whole calculation
+	Token_t xTokens[3];					   // Tokens of a whole calculation typed at once
+	TokError_t xError;					   // Result of reading the numbers of a whole calculation
 
-		// If the user has guessed the correct number
-		if( lUserGuess == ucSelectedNum )
+	if( pxEvent->eType == eAppEnter )
+	{
+		// Post a message to the UART write queue prompting the user to enter the first number
+		// of the calculation
+		vPostMsgToUartQueue("\r\n\nThis is a calculator sub-application\
+							 \r\nEnter the first integer, or the whole calculation (e.g. 12 * -3) = ");
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
+
+	// Start again unless a valid first number is received
+	vAppSetState( vCalcFirstState );
+
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdFALSE )
+	{
+		return;
+	}
+
+	if( xQuitCurrentApp == pdTRUE )
+	{
+		vAppSetState( vMainMenuState );
+	}
+	// If the whole calculation was typed then work it out straight away
+	else if( xTokScan( pxEvent->pcLine, xTokens, 3 ) == 3 && xTokens[1].ucType == eTokSymbol )
+	{
+		xError = xTokGetInt32( &xTokens[0], &lCalcFirstNum );
+		if( xError == eTokOk )
 		{
-			memset(&cUartMsg, 0, sizeof(cUartMsg));
-			sprintf( cUartMsg, "\r\n\nYou guessed the correct number!\
-					            \r\nIt took you %ld attempt(s) to guess the number!", ulNumOfGuesses );
-			pcData = cUartMsg;
-			xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+			xError = xTokGetInt32( &xTokens[2], &lSecondNum );
 		}
 
-		// If the user requested to quit the sub-application
-		if( xQuitCurrentApp == pdTRUE )
+		if( xError == eTokOk )
 		{
-			// Notify the Main Menu task to run it
-			xTaskNotify( xMainMenuTaskHandle, 0, eNoAction );
-
-			// Wait in blocked state indefinitely till a notification is received
-			xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
-
-			// A notification to run is received so reset xQuitCurrentApp
-			xQuitCurrentApp = pdFALSE;
+			vCalculate( lCalcFirstNum, (char)xTokens[1].llValue, lSecondNum );
+		}
+		else
+		{
+			vPostTokError( xError );
 		}
 	}
+	// Otherwise, if the first number is valid then continue to prompt the user to
+	// enter the second number
+	else if( xUartMsgToInt32(pxEvent->pcLine, &lCalcFirstNum) == pdTRUE )
+	{
+		vAppSetState( vCalcSecondState );
+	}
 }
 /*******************************************************************************
-*   Procedure: vCalculatorTaskFunction
+*   Procedure: vCalcSecondState
 *
-*   Description: This is the task function for the calculator task. It prompts
-*   			 the user to provide two numbers and select a mathematical operation
-*   			 (+ - * /). If the user does not provide his/her input when prompted
-*   			 within 30 seconds then the calculation fails and the operation will
-*   			 be restarted. Similarly if a valid number or a valid mathematical
-*   			 operation is not selected then the user input will be ignored and user
-*   			 will be prompted for inputs from the start again. If the user quits
-*   			 by pressing the letter q/Q followed by the return key when prompted
-*   			 for input then the Main Menu task will be notified to run and the
-*   			 calculator task will wait for a notification in blocked state.
+*   Description: This is the state of the calculator prompting the user for the
+*   			 second number of the calculation
 *
 *   Notes: None
 *
-*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
-*   			in this task function
+*   Parameters: pxEvent - A pointer to the event
 *
 *   Return: None
 *
 *******************************************************************************/
-void vCalculatorTaskFunction(void *pvParam)
+static void vCalcSecondState(const AppEvent_t* pxEvent)
 {
-	char cUartMsg[50] = {0};              // Buffer used to send and receive messages via UART
 	BaseType_t xQuitCurrentApp = pdFALSE;  // Flag to indicate if the user requested to quit the application
-	BaseType_t xReadSuccess = pdFALSE;     // Flag to indicate if reading user's input via UART was successful
-	int32_t lFirstNum;                     // To hold the first number of the calculation
-	int32_t lSecondNum;					   // To hold the second number of the calculation
-	int32_t lCalcNum;                      // To hold the result of the calculation
-
-	// Wait in blocked state indefinitely till a notification is received
-	xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
 
-	while(1)
+	if( pxEvent->eType == eAppEnter )
 	{
-		// Set the calculator variables to an invalid number
-		lFirstNum = INVALID_NUM;
-		lSecondNum = INVALID_NUM;
-		lCalcNum = INVALID_NUM;
-
-		// Post a message to the UART write queue prompting the user to enter the first number
-		// of the calculation
-		char* pcData = "\r\n\nThis is a calculator sub-application\
-						\r\nEnter the first integer = ";
-
-		// Push the address of a pointer to the data into the UART write queue
-		// The task will block waiting indefinitely till space becomes available on the queue
-		xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-		// Receive the first number of the calculation from the user
-		memset(&cUartMsg, 0, sizeof(cUartMsg));
-		xReadSuccess = xReceiveUartMsg(cUartMsg, &xQuitCurrentApp);
-		lFirstNum = lUartMsgtoInt32(cUartMsg);
-
-		// If the UART read was successful, the user did not request to quit the sub-application,
-		// and the first number is not an invalid number then continue to prompt the user to
-		// enter the second number
-		if( xReadSuccess == pdTRUE && xQuitCurrentApp == pdFALSE && lFirstNum != INVALID_NUM )
-		{
-			pcData = "\r\n\nEnter the second integer = ";
-			xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+		vPostMsgToUartQueue("\r\n\nEnter the second integer = ");
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
 
-			memset(&cUartMsg, 0, sizeof(cUartMsg));
-			xReadSuccess = xReceiveUartMsg(cUartMsg, &xQuitCurrentApp);
-			lSecondNum = lUartMsgtoInt32(cUartMsg);
+	vAppSetState( vCalcFirstState );
 
-			// If the UART read was successful, the user did not request to quit the sub-application,
-			// and the second number is not an invalid number then continue to prompt the user to
-			// enter the operation for the calculation
-			if( xReadSuccess == pdTRUE && xQuitCurrentApp == pdFALSE && lSecondNum != INVALID_NUM )
-			{
-				pcData = "\r\n\nEnter the operator (+ - * /) = ";
-				xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-				memset(&cUartMsg, 0, sizeof(cUartMsg));
-				xReadSuccess = xReceiveUartMsg(cUartMsg, &xQuitCurrentApp);
-
-				// If the UART read was successful, the user did not request to quit the sub-application
-				// then conduct the appropriate mathematical operation based on the operator selected
-				if( xReadSuccess == pdTRUE && xQuitCurrentApp == pdFALSE )
-				{
-					switch( cUartMsg[0] )
-					{
-						case '+':
-
-							lCalcNum = lFirstNum + lSecondNum;
-							sprintf( cUartMsg, "\r\n\nThe calculated integer is %ld", lCalcNum );
-							pcData = cUartMsg;
-							xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-							break;
-
-						case '-':
-
-							lCalcNum = lFirstNum - lSecondNum;
-							sprintf( cUartMsg, "\r\n\nThe calculated integer is %ld", lCalcNum );
-							pcData = cUartMsg;
-							xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-							break;
-
-						case '*':
-
-							lCalcNum = lFirstNum * lSecondNum;
-							sprintf( cUartMsg, "\r\n\nThe calculated integer is %ld", lCalcNum );
-							pcData = cUartMsg;
-							xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-							break;
-
-						case '/':
-
-							lCalcNum = lFirstNum / lSecondNum;
-							sprintf( cUartMsg, "\r\n\nThe calculated integer is %ld", lCalcNum);
-							pcData = cUartMsg;
-							xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-							break;
-
-						default:
-
-							// Post a message to the UART write queue indicating that the operator
-							// selected is not recognized
-							vPostMsgToUartQueue("\r\nError: Unrecognized mathematical operator selected\r\n");
-							break;
-					}
-				}
-			}
-		}
+	// If the UART read was successful, the user did not request to quit the sub-application,
+	// and the second number is valid then continue to prompt the user to
+	// enter the operation for the calculation
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdTRUE && xQuitCurrentApp == pdFALSE &&
+		xUartMsgToInt32(pxEvent->pcLine, &lCalcSecondNum) == pdTRUE )
+	{
+		vAppSetState( vCalcOperatorState );
+	}
+	else if( xQuitCurrentApp == pdTRUE )
+	{
+		vAppSetState( vMainMenuState );
+	}
+}
+/*******************************************************************************
+*   Procedure: vCalcOperatorState
+*
+*   Description: This is the state of the calculator prompting the user for the
+*   			 mathematical operation. The calculation is then conducted and
+*   			 the calculator starts again.
+*
+*   Notes: None
+*
+*   Parameters: pxEvent - A pointer to the event
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vCalcOperatorState(const AppEvent_t* pxEvent)
+{
+	BaseType_t xQuitCurrentApp = pdFALSE;  // Flag to indicate if the user requested to quit the application
 
-		// If the user has requested to quit the sub-application
-		if( xQuitCurrentApp == pdTRUE )
-		{
-			// Notify the Main Menu task to run it
-			xTaskNotify( xMainMenuTaskHandle, 0, eNoAction );
+	if( pxEvent->eType == eAppEnter )
+	{
+		vPostMsgToUartQueue("\r\n\nEnter the operator (+ - * /) = ");
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
 
-			// Wait in blocked state indefinitely till a notification is received
-			xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
+	vAppSetState( vCalcFirstState );
 
-			// A notification to run is received so reset xQuitCurrentApp
-			xQuitCurrentApp = pdFALSE;
-		}
+	// If the UART read was successful, the user did not request to quit the sub-application
+	// then conduct the appropriate mathematical operation based on the operator selected
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdTRUE && xQuitCurrentApp == pdFALSE )
+	{
+		vCalculate( lCalcFirstNum, pxEvent->pcLine[0], lCalcSecondNum );
+	}
+	else if( xQuitCurrentApp == pdTRUE )
+	{
+		vAppSetState( vMainMenuState );
 	}
 }
 /*******************************************************************************
@@ -749,8 +882,16 @@ void vCalculatorTaskFunction(void *pvParam)
 *
 *   Description: This is the task function for the temperature monitor task. It
 *   			 keeps track of the current, highest, and lowest temperatures.
-*   			 It displays these temperatures when the user requests them.
-*   Notes: None
+*   			 It takes the requests set in the control event group, and sets
+*   			 CTRL_TEMP_ACK once they are handled. While it runs, it measures
+*   			 the temperature every TEMP_MEASURE_PERIOD_MS, publishes the
+*   			 statistics in the mailbox, and also takes the commands
+*   			 "@temp show" and "@temp stop", which can be typed at any time
+*   			 whichever task holds the console focus.
+*   Notes: The console input sets CTRL_TEMP_INPUT when it queues a command, so
+*   	   the task waits for the requests and the commands together and
+*   	   reads every queued command once woken. The commands typed while
+*   	   the monitor is stopped are discarded.
 *
 *   Parameters: pvParam - A pointer to data passed during task creation. It is not used
 *   			in this task function
@@ -759,147 +900,107 @@ void vCalculatorTaskFunction(void *pvParam)
 *******************************************************************************/
 void vTempMonitorTaskFunction(void *pvPram)
 {
-	float fHighestTemp = 0.0;			// To hold the highest temperature measured
-	float fLowestTemp = 100.0;			// To hold the lowest temperature measured
-	float fCurrentTemp;					// To hold the current temperature measured
-	char cTempStatsMsg[100] = {0};      // Buffer to hold the message to post to the UART write queue
-	char* pcDateTime = cTempStatsMsg;   // Pointer to the start of the message buffer
-	RTC_DateTypeDef xDateForHTemp;      // To hold the recorded date of highest temp
-	RTC_TimeTypeDef xTimeForHTemp;      // To hold the recorded time of highest temp
-	RTC_DateTypeDef xDateForLTemp;      // To hold the recorded date of lowest temp
-	RTC_TimeTypeDef xTimeForLTemp;      // To hold the recorded time of lowest temp
-	RTC_DateTypeDef xCurrentDate;       // To hold the current date
-	RTC_TimeTypeDef xCurrentTime;       // To hold the current time
+	static const char cStopped[] = "\r\n\nTemperature monitor stopped\r\n";
+	TempStat_t xStats[3];				// Current, highest, and lowest temperatures
+	TickType_t xLastMeasure = 0;		// Tick count of the last measurement
+	TickType_t xElapsed;				// Ticks since the last measurement
+	EventBits_t uxBits;					// Requests received
+	BaseType_t xStop;					// pdTRUE once "@temp stop" is read
+	char cCommand[CONSOLE_IN_LINE_SIZE + 1];	// Command sent with "@temp"
+	ConsoleLink_t eLink;				// Link the command was typed on
 
 	while(1)
 	{
 		// If the user has requested to stop temp monitoring
 		// Or the user has not requested to start temp monitoring
-		if( xRunTempMonitor == pdFALSE )
+		if( ( xEventGroupGetBits( xControlEvents ) & CTRL_TEMP_RUNNING ) == 0 )
 		{
 			// Reset temperature stats
-			fHighestTemp = 0.0;
-			fLowestTemp = 100.0;
-			memset(&xDateForHTemp, 0, sizeof(xDateForHTemp));
-			memset(&xTimeForHTemp, 0, sizeof(xTimeForHTemp));
-			memset(&xDateForLTemp, 0, sizeof(xDateForLTemp));
-			memset(&xTimeForLTemp, 0, sizeof(xTimeForLTemp));
-
-			// Wait in blocked state indefinitely till a notification is received
-			xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
-
-			// A notification to run is received so set xRunTempMonitor flag
-			xRunTempMonitor = pdTRUE;
-		}
+			memset( xStats, 0, sizeof(xStats) );
+			xStats[TEMP_LOWEST].fTemp = 100.0;
 
-		// Acquire current time
-		RTC_GetTime( RTC_Format_BIN, &xCurrentTime );
+			// Wait in blocked state indefinitely till a request or a command is received
+			uxBits = xEventGroupWaitBits( xControlEvents, CTRL_TEMP_WAKE, pdTRUE, pdFALSE, portMAX_DELAY );
 
-		// Acquire current date
-		// RTC_GetDate() needs to be called twice to get the updated date
-		RTC_GetDate( RTC_Format_BIN, &xCurrentDate );
-		RTC_GetDate( RTC_Format_BIN, &xCurrentDate );
+			// "@temp" lines typed while the monitor is stopped are stale, e.g. a
+			// "stop" which would end the next run at once
+			vConsoleInDiscard();
 
-		// Acquire current temp from sensor
-		fCurrentTemp = fMeasureTemp();
-
-		// Check to see if our lowest or highest temps have changed
-		// If so, record the new temps and the time and date for those temps
-		if( fCurrentTemp > fHighestTemp )
-		{
-			fHighestTemp = fCurrentTemp;
+			if( uxBits & CTRL_TEMP_START_REQ )
+			{
 
-			xDateForHTemp = xCurrentDate;
-			xTimeForHTemp = xCurrentTime;
-		}
-		else if( fCurrentTemp < fLowestTemp )
-		{
-			fLowestTemp = fCurrentTemp;
+				// Measure at once, then every TEMP_MEASURE_PERIOD_MS
+				xEventGroupSetBits( xControlEvents, CTRL_TEMP_RUNNING );
+				xLastMeasure = xTaskGetTickCount() - pdMS_TO_TICKS(TEMP_MEASURE_PERIOD_MS);
+			}
 
-			xDateForLTemp = xCurrentDate;
-			xTimeForLTemp = xCurrentTime;
+			// Nothing to stop otherwise
+			if( uxBits & CTRL_TEMP_REQS )
+			{
+				xEventGroupSetBits( xControlEvents, CTRL_TEMP_ACK );
+			}
+			continue;
 		}
 
-		vTaskDelay(pdMS_TO_TICKS(500));
+		xElapsed = xTaskGetTickCount() - xLastMeasure;
 
-		if( xShowTemps == pdTRUE )
+		if( xElapsed >= pdMS_TO_TICKS(TEMP_MEASURE_PERIOD_MS) )
 		{
-			sprintf(cTempStatsMsg, "\r\n\n%02d-%02d-%02d %02d:%02d:%02d Current Temp Recorded = %0.2f C",\
-					xCurrentDate.RTC_Date, xCurrentDate.RTC_Month, xCurrentDate.RTC_Year,\
-					xCurrentTime.RTC_Hours, xCurrentTime.RTC_Minutes, xCurrentTime.RTC_Seconds, fCurrentTemp);
+			// Acquire current date and time from the time base, without reading the RTC
+			xStats[TEMP_CURRENT].ulTime = (uint32_t)( ullTimebaseToWall( ullTimebaseNow() ) / TIMEBASE_NS_PER_SECOND );
 
-			// Post the address of the message to the UART write queue
-			xQueueSend( xUartWriteQueue, &pcDateTime, portMAX_DELAY );
+			// Acquire current temp from sensor
+			xStats[TEMP_CURRENT].fTemp = fMeasureTemp();
 
-			sprintf(cTempStatsMsg, "\r\n\n%02d-%02d-%02d %02d:%02d:%02d Highest Temp Recorded = %0.2f C",\
-				    xDateForHTemp.RTC_Date, xDateForHTemp.RTC_Month, xDateForHTemp.RTC_Year,\
-					xTimeForHTemp.RTC_Hours, xTimeForHTemp.RTC_Minutes, xTimeForHTemp.RTC_Seconds, fHighestTemp);
-
-			// Post the address of the message to the UART write queue
-			xQueueSend( xUartWriteQueue, &pcDateTime, portMAX_DELAY );
-
-			sprintf(cTempStatsMsg, "\r\n\n%02d-%02d-%02d %02d:%02d:%02d Lowest Temp Recorded = %0.2f C\r\n",\
-					xDateForLTemp.RTC_Date, xDateForLTemp.RTC_Month, xDateForLTemp.RTC_Year,\
-					xTimeForLTemp.RTC_Hours, xTimeForLTemp.RTC_Minutes, xTimeForLTemp.RTC_Seconds, fLowestTemp);
+			// Check to see if our lowest or highest temps have changed
+			// If so, record the new temps and the time and date for those temps
+			if( xStats[TEMP_CURRENT].fTemp > xStats[TEMP_HIGHEST].fTemp )
+			{
+				xStats[TEMP_HIGHEST] = xStats[TEMP_CURRENT];
+			}
+			else if( xStats[TEMP_CURRENT].fTemp < xStats[TEMP_LOWEST].fTemp )
+			{
+				xStats[TEMP_LOWEST] = xStats[TEMP_CURRENT];
+			}
 
-			// Post the address of the message to the UART write queue
-			xQueueSend( xUartWriteQueue, &pcDateTime, portMAX_DELAY );
+			// Publish the statistics for the show commands and the binary protocol
+			xQueueOverwrite( xTempStatsMailbox, xStats );
 
-			// Reset xShowTemps flag
-			xShowTemps = pdFALSE;
+			xLastMeasure += xElapsed;
+			xElapsed = 0;
 		}
-	}
-}
-/*******************************************************************************
-*   Procedure: vUartSetup
-*
-*   Description: This function configures and enables UART2 to allow message
-*   			 transmission and reception
-*
-*   Notes: None
-*
-*   Parameters: None
-*
-*   Return: None
-*
-*******************************************************************************/
-static void vUartSetup(void)
-{
-	GPIO_InitTypeDef xGpioUartPins;	// To hold the configurations for the GPIO UART pins to be initialized
-	USART_InitTypeDef xUart2Init;       // To hold the configurations for the UART peripheral to be initialized
-
-	// Enable UART2 peripheral clock and GPIOA peripheral clock
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART2, ENABLE);
-	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOA, ENABLE);
-
-	// Zeroing each struct member
-	memset(&xGpioUartPins, 0, sizeof(xGpioUartPins));
-
-	// Alternate function configuration of MCU pins to behave as UART2 TX and RX
-	// PA2 is UART2_TX and PA3 is UART2_RX
-	xGpioUartPins.GPIO_Pin = GPIO_Pin_2 | GPIO_Pin_3;
-	xGpioUartPins.GPIO_Mode = GPIO_Mode_AF;
-	xGpioUartPins.GPIO_PuPd = GPIO_PuPd_UP;  // UART frame is high (logic 1) when idle
-	GPIO_Init(GPIOA, &xGpioUartPins);
 
-	// AF mode settings for the pins
-	GPIO_PinAFConfig(GPIOA, GPIO_PinSource2, GPIO_AF_USART2); 	// Configure AF mode for PA2 as UART2_TX
-	GPIO_PinAFConfig(GPIOA, GPIO_PinSource3, GPIO_AF_USART2); 	// Configure AF mode for PA3 as UART2_RX
+		// Wait for the next measurement, or for a request or a command
+		uxBits = xEventGroupWaitBits( xControlEvents, CTRL_TEMP_WAKE, pdTRUE, pdFALSE,
+									  pdMS_TO_TICKS(TEMP_MEASURE_PERIOD_MS) - xElapsed );
 
-	// Zeroing each struct member
-	memset(&xUart2Init, 0, sizeof(xUart2Init));
+		// Take every command sent by the console input service
+		xStop = pdFALSE;
+		while( xConsoleInRead( cCommand, sizeof(cCommand), NULL, &eLink, 0 ) == pdPASS )
+		{
+			// Reply on the session the command was typed in
+			if( strcmp( cCommand, "show" ) == 0 )
+			{
+				vPostTempStats( xStats, eLink );
+			}
+			else if( strcmp( cCommand, "stop" ) == 0 )
+			{
+				xStop = pdTRUE;
+				vConsoleWriteToLink( eLink, cStopped, sizeof(cStopped) - 1, eConsoleDropOldest );
+			}
+		}
 
-	// UART parameter initializations
-	xUart2Init.USART_BaudRate = 115200;
-	xUart2Init.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	xUart2Init.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
-	xUart2Init.USART_Parity = USART_Parity_No;
-	xUart2Init.USART_StopBits = USART_StopBits_1;
-	xUart2Init.USART_WordLength = USART_WordLength_8b;
-	USART_Init(USART2, &xUart2Init);
+		if( ( uxBits & CTRL_TEMP_STOP_REQ ) || xStop == pdTRUE )
+		{
+			xEventGroupClearBits( xControlEvents, CTRL_TEMP_RUNNING );
+		}
 
-	// Enable UART2 peripheral
-	USART_Cmd(USART2, ENABLE);
+		// Acknowledge the requests taken from the event group
+		if( uxBits & CTRL_TEMP_REQS )
+		{
+			xEventGroupSetBits( xControlEvents, CTRL_TEMP_ACK );
+		}
+	}
 }
 /*******************************************************************************
 *   Procedure: vGpioSetup
@@ -958,134 +1059,63 @@ static void vSetupHardware(void)
 	// To setup the RTC to track date, time, and set up an alarm
 	vRtcSetup();
 
+	// To switch UART2 to the baud rate saved in the RTC backup registers, if any
+	vUartRestoreBaudRate();
+
 	// To setup the ADC to use for analog temperature measurement
 	vAdcSetup();
 }
 /*******************************************************************************
-*   Procedure: vSendUartMsg
-*
-*   Description: This function transmits data byte by byte via UART2 peripheral.
-*
-*   Notes: The user should avoid using this function to transmit UART messages.
-*   	   Rather the user should post messages to the UART write queue in order
-*   	   to serialize message transmission and avoid race condition for UART2
-*   	   peripheral.
-*
-*   Parameters: pcMsg - A pointer to a message buffer of type char
-*
-*   Return: None
-*
-*******************************************************************************/
-static void vSendUartMsg(char* pcMsg)
-{
-	// Continue to loop while there are still bytes in the buffer to send
-	for(int i = 0; i < strlen(pcMsg); i++)
-	{
-		// Loop until the transmit data register for UART2 is empty
-		while(USART_GetFlagStatus(USART2, USART_FLAG_TXE) != SET);
-
-		// Send one byte at a time
-		USART_SendData(USART2, pcMsg[i]);
-	}
-}
-/*******************************************************************************
 *   Procedure: xReceiveUartMsg
 *
-*   Description: This function receives a message from the user via the UART window
-*   			 whenever the user is prompted to provide an input. It will time out
-*   			 if the user input is not received within 30 seconds It will also
-*   			 flag that the user has requested to quit the current task if the
-*   			 the user presses the letter q/Q followed by the return key.
+*   Description: This function takes the user's input out of an event, once the
+*   			 user has been prompted to provide an input. If the user input
+*   			 was not received within the timeout of the state, 30 seconds,
+*   			 the timeout is posted. It will also flag that the user has
+*   			 requested to quit the current sub-application if the user
+*   			 presses the letter q/Q followed by the return key.
 *
-*   Notes: None
+*   Notes: The message is the line the console input service sent to the App
+*   	   task. It is NUL terminated and holds up to CONSOLE_IN_LINE_SIZE
+*   	   characters.
 *
-*   Parameters: - pucMsgBuffer - A pointer to a message buffer to hold the received
-*   			  message from the user
+*   Parameters: - pxEvent - A pointer to the eAppLine or eAppTimeout event
 *
 *   			- pxQuitCurrentApp - A pointer to BaseType_t location that will hold
 *   		      pdTRUE if the user has requested to quit the application, otherwise
-*   		      it will hold pdFALSE.
+*   		      it is left unchanged.
 *
-*   Return: BaseType_t - pdTRUE is returned if the user provided his/her input in less
-*   		than 30 seconds, otherwise pdFALSE is returned.
+*   Return: BaseType_t - pdTRUE is returned if the user provided his/her input in time,
+*   		otherwise pdFALSE is returned.
 *
 *******************************************************************************/
-static BaseType_t xReceiveUartMsg(char* pcMsgBuffer, BaseType_t* pxQuitCurrentApp)
+static BaseType_t xReceiveUartMsg(const AppEvent_t* pxEvent, BaseType_t* pxQuitCurrentApp)
 {
-	uint8_t ucDataByte = 0;			// To hold current data byte received
-	uint8_t ucPrvDataByte = 0;		// Previous data byte to check if the user quit the current app
-	uint16_t usMsgLen = 0;			// To index the bytes received
-	TickType_t xCurrentTickCount= xTaskGetTickCount();   // To hold the tick count at the start of the call
-	char* pcData = NULL;   // To hold the address of the message to post to UART write queue
+	size_t xMsgLen = pxEvent->xLen;	// Number of characters received
 
-	// Wait for user's input no more than 30 seconds
-	while( xTaskGetTickCount() < ( xCurrentTickCount + pdMS_TO_TICKS(30000) ) )
+	if( pxEvent->eType == eAppLine )
 	{
-		// Wait till data is received at the data register of USART2
-		while ( USART_GetFlagStatus(USART2, USART_FLAG_RXNE) != SET );
-
-		ucPrvDataByte = ucDataByte; 	// Hold the previous byte to check if the user quit the current app
-
-		// Retrieve a byte of data
-		ucDataByte = (uint8_t)( USART_ReceiveData( USART2 ) & 0xFF );
-
-		// If the return key is pressed by the user then exit
-		if( ucDataByte != '\r' )
-		{
-			// Push the byte received into the message buffer provided
-			pcMsgBuffer[usMsgLen++] = ucDataByte;
-		}
-		else
+		if( xMsgLen > 0 && ( pxEvent->pcLine[xMsgLen - 1] == 'q' || pxEvent->pcLine[xMsgLen - 1] == 'Q' ) )
 		{
-			if( ucPrvDataByte == 'q' || ucPrvDataByte == 'Q' )
-			{
-				// User wants to quit current app and go back to Main Menu app
-				*pxQuitCurrentApp = pdTRUE;
-			}
-
-			break;
+			// User wants to quit current app and go back to Main Menu app
+			*pxQuitCurrentApp = pdTRUE;
 		}
-	}
 
-	// Message is successfully received if the message was typed before the 30 seconds limit
-	if( xTaskGetTickCount() < ( xCurrentTickCount + pdMS_TO_TICKS(30000) ))
-	{
-		// Return true if the message is received
+		// Return true if the message is received before the 30 seconds limit
 		return(pdTRUE);
 	}
-	else
-	{
-		pcData = "\r\nUser input timeout...\r\n";
-		xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
 
-		// Return false if the message is not received in time
-		return(pdFALSE);
-	}
-}
-/*******************************************************************************
-*   Procedure: vPostMsgToUartQueue
-*
-*   Description: This function posts an error message to the UART write queue so
-*   		     it can be printed on the UART window for the user to see.
-*
-*   Notes: None
-*
-*   Parameters: pcErrorMsg- A pointer to a location holding the error message
-*
-*   Return: None
-*
-*******************************************************************************/
-static void vPostMsgToUartQueue(char* pcUartMsg)
-{
-	// Post error message to the UART write queue
-	xQueueSend( xUartWriteQueue, &pcUartMsg, portMAX_DELAY );
+	vPostMsgToUartQueue("\r\nUser input timeout...\r\n");
+
+	// Return false if the message is not received in time
+	return(pdFALSE);
 }
 /*******************************************************************************
 *   Procedure: vRtcSetup
 *
 *   Description: This function configures and enables the RTC peripheral to track
-*   		     date and time. It also enables Alarm A so it can be configured
-*   		     by the user using the clock task to trigger an alarm.
+*   		     date and time. It also enables the interrupt of Alarm A, which
+*   		     is shared by the alarms of the alarm scheduler.
 *
 *   Notes: None
 *
@@ -1100,6 +1130,7 @@ static void vRtcSetup(void)
 	RTC_DateTypeDef xDateToSet;         // A place holder date for the RTC peripheral to go with
 	RTC_TimeTypeDef xTimeToSet;         // A place holder time for the RTC peripheral to go with
 	EXTI_InitTypeDef xAlarmExtiInit;	// Configure EXTI line 17 since the RTC Alarm A and B are connected to it
+	EXTI_InitTypeDef xWakeUpExtiInit;	// Configure EXTI line 22 since the RTC wakeup timer is connected to it
 
 	// As the RTC clock configuration bits are in the Backup domain and write
 	// access is denied to this domain after reset, you have to enable write
@@ -1121,26 +1152,20 @@ static void vRtcSetup(void)
 
 	// Configure the parameters of the RTC peripheral
 	xRtcInitStruct.RTC_HourFormat = RTC_HourFormat_24;
-	xRtcInitStruct.RTC_AsynchPrediv = 0x7F;		//127
-	xRtcInitStruct.RTC_SynchPrediv = 0xFF;		//255
+	// 32768 Hz / 32 / 1024 gives 1 Hz, and the sub-second counter counts 1024 steps a second
+	// which the wall clock reads for the fraction of a second
+	xRtcInitStruct.RTC_AsynchPrediv = 0x1F;		//31
+	xRtcInitStruct.RTC_SynchPrediv = 0x3FF;		//1023
 
 	// Initialize RTC peripheral
 	RTC_Init(&xRtcInitStruct);
 
-	// Configure the time. Random time is chosen
-	xTimeToSet.RTC_Hours = 17;
-	xTimeToSet.RTC_Minutes = 0;
-	xTimeToSet.RTC_Seconds = 0;
+	// Configure the date and time, the day of the week included, from the start time
+	vCalendarToRtc( RTC_START_TIME, &xDateToSet, &xTimeToSet );
 
 	// Set time
 	RTC_SetTime( RTC_Format_BIN, &xTimeToSet);
 
-	// Configure the date. Random date is chosen
-	xDateToSet.RTC_Date = 3;
-	xDateToSet.RTC_Month = 12;
-	xDateToSet.RTC_Year = 20;	// 20 for 2020
-	xDateToSet.RTC_WeekDay = RTC_Weekday_Thursday;
-
 	// Set date
 	RTC_SetDate( RTC_Format_BIN, &xDateToSet );
 
@@ -1157,6 +1182,9 @@ static void vRtcSetup(void)
 	// Initialize the EXTI line configured
 	EXTI_Init( &xAlarmExtiInit );
 
+	// No alarm is set yet, Alarm A is programmed by the alarm scheduler
+	vAlarmInit();
+
 	// Turn on interrupt for Alarm A
 	RTC_ITConfig( RTC_IT_ALRA, ENABLE);
 
@@ -1167,17 +1195,92 @@ static void vRtcSetup(void)
 
 	// Enable Alarm A/B interrupt reception at the NVIC
 	NVIC_EnableIRQ(RTC_Alarm_IRQn);
+
+	// Periodic wakeup of the RTC, publishing the date and time once a second
+
+	// The wakeup timer must be disabled to be configured
+	RTC_WakeUpCmd( DISABLE );
+
+	// Count the 1 Hz ck_spre clock, an interrupt each time the counter of 0 is reached, i.e. every second
+	// and in step with the seconds of the calendar
+	RTC_WakeUpClockConfig( RTC_WakeUpClock_CK_SPRE_16bits );
+	RTC_SetWakeUpCounter( 0 );
+
+	// Zeroing each struct member to avoid random values causing abnormal behaviors
+	memset(&xWakeUpExtiInit, 0, sizeof(xWakeUpExtiInit));
+
+	xWakeUpExtiInit.EXTI_Line = EXTI_Line22;				// Select EXTI line 22
+	xWakeUpExtiInit.EXTI_LineCmd = ENABLE;					// Select the desired state for the EXTI line
+	xWakeUpExtiInit.EXTI_Mode = EXTI_Mode_Interrupt;		// Select the mode for the EXTI line (e.g. interrupt or event)
+	xWakeUpExtiInit.EXTI_Trigger = EXTI_Trigger_Rising;	// For RTC wakeup a rising edge trigger is needed
+
+	// Initialize the EXTI line configured
+	EXTI_Init( &xWakeUpExtiInit );
+
+	// Turn on interrupt for the wakeup timer, then start it
+	RTC_ITConfig( RTC_IT_WUT, ENABLE );
+	RTC_WakeUpCmd( ENABLE );
+
+	// Same priority as Alarm A, the readers of the wall clock must not preempt the writer
+	NVIC_SetPriority( RTC_WKUP_IRQn, 5 );
+
+	// Enable wakeup interrupt reception at the NVIC
+	NVIC_EnableIRQ( RTC_WKUP_IRQn );
+}
+/*******************************************************************************
+*   Procedure: RTC_WKUP_IRQHandler
+*
+*   Description: Non-weak implementation of the interrupt handler for the RTC
+*   			 wakeup timer. Runs once a second, at the start of the second.
+*   			 It publishes the RTC date and time for the tasks,
+*   			 synchronizes the time base with the RTC, and wakes the Console
+*   			 Input task up once a debugger is attached.
+*
+*   Notes: The tasks read the published date and time instead of the RTC
+*   	   registers, so they neither wait on the shadow registers nor read a
+*   	   date and a time from different seconds.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void RTC_WKUP_IRQHandler(void)
+{
+	WallClock_t xClock;								// Date and time published
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;	// Set if a higher priority task is woken by the handler
+
+	// Clear the wakeup flag, otherwise the next wakeup does not raise EXTI line 22
+	if( RTC_GetITStatus( RTC_IT_WUT ) != RESET )
+	{
+		RTC_ClearITPendingBit( RTC_IT_WUT );
+	}
+
+	// The wakeup timer is connected to EXTI line 22
+	EXTI_ClearITPendingBit( EXTI_Line22 );
+
+	vWallClockUpdateFromISR( &xClock );
+
+	// Read at the start of the second, the RTC time has no rounding
+	vTimebaseSyncFromISR( (uint64_t)xClock.ulSeconds * TIMEBASE_NS_PER_SECOND + xClock.ulNanoseconds );
+
+	// The RTT link is only polled once a debugger is attached
+	vConsoleInCheckDebuggerFromISR( &xHigherPriorityTaskWoken );
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 /*******************************************************************************
 *   Procedure: RTC_Alarm_IRQHandler
 *
 *   Description: Non-weak implementation of the interrupt handler for RTC Alarm
-*   			 A and B. If an alarm is configured by the user using the clock
-*   			 task then this handler will get executed once the RTC alarm is
-*   			 triggered. Generally, the handler will print a message on the UART
-*   			 window notifying the user that the alarm has been triggered.
+*   			 A and B. Alarm A is programmed with the earliest alarm of the
+*   			 alarm scheduler. This handler fires the alarms due, which
+*   			 programs Alarm A again with the next one.
 *
-*   Notes: None
+*   Notes: Also run when vAlarmPortProgram() makes the interrupt pending for
+*   	   an alarm already due. The messages of the alarms are not sent from
+*   	   here. They are only recorded in the console ISR ring and transmitted
+*   	   later by the UART Write task, so the handler does not wait on UART2.
 *
 *   Parameters: None
 *
@@ -1186,100 +1289,322 @@ static void vRtcSetup(void)
 *******************************************************************************/
 void RTC_Alarm_IRQHandler(void)
 {
-	// We will only be here if an Alarm A has occurred
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;  // Set if a higher priority task is woken by posting the messages
+
+	// Clear the Alarm A flag, otherwise the next match does not raise EXTI line 17
+	if( RTC_GetITStatus( RTC_IT_ALRA ) != RESET )
+	{
+		RTC_ClearITPendingBit( RTC_IT_ALRA );
+	}
 
 	// Alarm A and B are connected to EXTI line 17
 	// To avoid the interrupt handler being executed continuously
 	// clear the interrupt pending bit of EXTI line 17
 	EXTI_ClearITPendingBit( EXTI_Line17 );
 
+	// Fire the alarms due and program the next one
+	vAlarmFireFromISR( ulRtcNow(), &xHigherPriorityTaskWoken );
+
+	// If the UART Write task was woken and has a higher priority than the interrupted task then yield
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+/*******************************************************************************
+*   Procedure: vAlarmTriggered
+*
+*   Description: This function is the callback of the alarms set by the user. It
+*   			 posts a message on the UART window notifying the user that
+*   			 the alarm has been triggered.
+*
+*   Notes: Called from the RTC Alarm interrupt.
+*
+*   Parameters: xId - The ID of the alarm
+*   			pvArg - A pointer given when the alarm was added (unused)
+*   			pxHigherPriorityTaskWoken - Set if posting the messages wakes a higher
+*   			priority task
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vAlarmTriggered(AlarmId_t xId, void* pvArg, BaseType_t* pxHigherPriorityTaskWoken)
+{
 	// Alert the user that the alarm was triggered
-	vSendUartMsg("\r\nThe alarm was triggered\r\n");
+	vPostMsgToUartQueueFromISR("\r\nThe alarm was triggered\r\n", pxHigherPriorityTaskWoken);
 
-	if( xGoToSleep == pdTRUE)
+	if( xEventGroupGetBitsFromISR( xControlEvents ) & CTRL_SLEEP )
 	{
-		vSendUartMsg("\r\nStill in sleep mode\
-				      \r\nPress any keyboard letter/number to wake up\r\n");
+		vPostMsgToUartQueueFromISR("\r\nStill in sleep mode\
+				      \r\nPress any keyboard letter/number to wake up\r\n", pxHigherPriorityTaskWoken);
 	}
 }
 /*******************************************************************************
-*   Procedure: vReadRtcDateTime
+*   Procedure: vAlarmPortProgram
 *
-*   Description: This function reads the current date and time and post them to
-*   			 the UART write queue in order to display them on the UART window.
+*   Description: This function programs RTC Alarm A to match the date of the
+*   			 month, hour, minute and second of a fire time. The RTC does not
+*   			 compare the month, so an alarm more than a month away may fire
+*   			 early, in which case the scheduler programs it again.
 *
-*   Notes: None
+*   Notes: Called by the alarm scheduler with its tables protected. The RTC
+*   	   only fires on a match, so if the time is already reached the
+*   	   interrupt is made pending instead.
 *
-*   Parameters: None
+*   Parameters: ulTime - The fire time, in Unix time
 *
 *   Return: None
 *
 *******************************************************************************/
-static void vReadRtcDateTime(void)
+void vAlarmPortProgram(uint32_t ulTime)
 {
-	char cDateTimeMsg[100] = {0};     // Buffer to hold the message to post to the UART write queue
-	char* pcDateTime = cDateTimeMsg;  // Pointer to the start of the message buffer
-	RTC_DateTypeDef xCurrentDate;     // To hold the current date parameters
-	RTC_TimeTypeDef xCurrentTime;     // To hold the current time parameters
+	RTC_AlarmTypeDef xAlarmAConfig;		// To hold the configurations to initialize Alarm A with
+	RTC_DateTypeDef xDate;				// Date of the fire time
 
 	// Zeroing each struct member
-	memset(&xCurrentDate, 0, sizeof(xCurrentDate));
-	memset(&xCurrentTime, 0, sizeof(xCurrentTime));
+	memset(&xAlarmAConfig, 0, sizeof(xAlarmAConfig));
 
-	// Acquire time info
-	RTC_GetTime( RTC_Format_BIN, &xCurrentTime );
+	vCalendarToRtc( ulTime, &xDate, &xAlarmAConfig.RTC_AlarmTime );
+	xAlarmAConfig.RTC_AlarmMask = RTC_AlarmMask_None;
+	xAlarmAConfig.RTC_AlarmDateWeekDaySel = RTC_AlarmDateWeekDaySel_Date;
+	xAlarmAConfig.RTC_AlarmDateWeekDay = xDate.RTC_Date;
 
-	// Acquire date info
-	// RTC_GetDate() needs to be called twice to get the updated date
-	RTC_GetDate( RTC_Format_BIN, &xCurrentDate );
-	RTC_GetDate( RTC_Format_BIN, &xCurrentDate );
+	// The Alarm register can only be written when the corresponding Alarm is disabled
+	RTC_AlarmCmd(RTC_Alarm_A, DISABLE);
+	RTC_SetAlarm( RTC_Format_BIN, RTC_Alarm_A, &xAlarmAConfig);
+	RTC_AlarmCmd(RTC_Alarm_A, ENABLE);
 
+	if( ulTime <= ulRtcNow() )
+	{
+		NVIC_SetPendingIRQ( RTC_Alarm_IRQn );
+	}
+}
+/*******************************************************************************
+*   Procedure: vAlarmPortDisable
+*
+*   Description: This function turns RTC Alarm A off when no alarm is set
+*
+*   Notes: Called by the alarm scheduler with its tables protected.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAlarmPortDisable(void)
+{
+	RTC_AlarmCmd(RTC_Alarm_A, DISABLE);
+}
+/*******************************************************************************
+*   Procedure: ulRtcNow
+*
+*   Description: This function reads the current date and time of the RTC as
+*   			 Unix time
+*
+*   Notes: Called from tasks and from the RTC Alarm interrupt. The registers are
+*   	   read instead of the cached wall clock, which is up to a second old:
+*   	   an alarm due at the second just started would otherwise be
+*   	   programmed in the past or fired a second late.
+*
+*   Parameters: None
+*
+*   Return: uint32_t - The seconds since 1970-01-01 00:00:00
+*
+*******************************************************************************/
+static uint32_t ulRtcNow(void)
+{
+	WallClock_t xClock;		// Current date and time
 
-	sprintf(cDateTimeMsg, "\r\n\nTime: %02d:%02d:%02d\r\nDate: %02d-%02d-%02d",\
-			xCurrentTime.RTC_Hours, xCurrentTime.RTC_Minutes,xCurrentTime.RTC_Seconds,\
-			xCurrentDate.RTC_Date, xCurrentDate.RTC_Month, xCurrentDate.RTC_Year);
+	vWallClockReadRtc( &xClock );
 
-	// Post the address of the message to the UART write queue
-	xQueueSend( xUartWriteQueue, &pcDateTime, portMAX_DELAY );
+	return( xClock.ulSeconds );
 }
 /*******************************************************************************
-*   Procedure: lUartMsgtoInt32
+*   Procedure: vRtcChanging
 *
-*   Description: This function converts the ASCII input received from the user via
-*   			 UART to an INT32 number.
+*   Description: This function makes the time base take the RTC date and time
+*   			 as they are, while they are being set
 *
-*   Notes: None
+*   Notes: Called from tasks before the RTC date or time is set, then
+*   	   vRtcChanged() is called once it is. The RTC wakeup interrupt may
+*   	   run in between, even between two writes of the RTC.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vRtcChanging(void)
+{
+	vTimebaseResyncBegin();
+}
+/*******************************************************************************
+*   Procedure: vRtcChanged
+*
+*   Description: This function publishes the new RTC date and time at once,
+*   			 makes the time base take them as they are, and programs RTC
+*   			 Alarm A again for the new date and time
+*
+*   Notes: Called from tasks whenever the RTC date or time is set, after
+*   	   vRtcChanging().
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vRtcChanged(void)
+{
+	vWallClockRefresh();
+	vTimebaseResyncEnd();
+	vAlarmRtcChanged();
+}
+/*******************************************************************************
+*   Procedure: xAddDailyAlarm
+*
+*   Description: This function adds an alarm firing every day at the given
+*   			 time, first at its next occurrence
 *
-*   Parameters: pucUartMsg- A pointer to a location holding the UART message
+*   Notes: The alarms already set are kept.
 *
-*   Return: INT32 number
+*   Parameters: lHours - The hour, 0 to 23
+*   			lMinutes - The minute, 0 to 59
+*   			lSeconds - The second, 0 to 59
+*
+*   Return: AlarmId_t - The ID of the alarm, or ALARM_NONE if no more alarms
+*   		can be set
 *
 *******************************************************************************/
-static int32_t lUartMsgtoInt32(char* pcUartMsg)
+static AlarmId_t xAddDailyAlarm(int32_t lHours, int32_t lMinutes, int32_t lSeconds)
 {
-	uint32_t i = 0;  		// Iteration index
-	int32_t ulNum = 0;		// To hold the constructed number
+	uint32_t ulNow = ulRtcNow();	// Current time
+	uint32_t ulTime;				// First fire time
 
-	// Continue to construct the number as long as the byte in hand
-	// is a number within 0 to 9
-	while ( pcUartMsg[i] >= '0' && pcUartMsg[i] <= '9' )
+	ulTime = ulNow - ( ulNow % CALENDAR_SECONDS_PER_DAY ) + lHours * 3600UL + lMinutes * 60UL + lSeconds;
+	if( ulTime <= ulNow )
 	{
-		// Convert the digit in hand from ASCII to a number, shift the current digits
-		// to the left and combine the new digit
-		ulNum = (ulNum * 10) + (pcUartMsg[i] - 48);
-		i++;
+		ulTime += CALENDAR_SECONDS_PER_DAY;
 	}
 
-	if( i > 0 )
+	return( xAlarmAdd( ulTime, ALARM_PERIOD_DAILY, vAlarmTriggered, NULL ) );
+}
+/*******************************************************************************
+*   Procedure: vReadRtcDateTime
+*
+*   Description: This function reads the current date and time and posts them to
+*   			 the Log task in order to display them on the UART window.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vReadRtcDateTime(void)
+{
+	WallClock_t xClock;		// To hold the current date and time
+
+	// Acquire the date and time published by the RTC wakeup interrupt, no RTC register is read
+	vWallClockGet( &xClock );
+
+	LogArg_t xArgs[] = { LOG_INT(xClock.xTime.RTC_Hours), LOG_INT(xClock.xTime.RTC_Minutes),
+						 LOG_INT(xClock.xTime.RTC_Seconds), LOG_INT(xClock.xDate.RTC_Date),
+						 LOG_INT(xClock.xDate.RTC_Month), LOG_INT(xClock.xDate.RTC_Year) };
+
+	// Post the raw time and date to the Log task to be printed
+	vLogPost( eLogDateTime, xArgs, 6 );
+}
+/*******************************************************************************
+*   Procedure: xUartMsgToInt32
+*
+*   Description: This function converts the input received from the user via
+*   			 UART to an INT32 number. The input may be a signed decimal, a
+*   			 hexadecimal (0x) or a binary (0b) number. If it is not a number,
+*   			 or the number does not fit in an INT32, the reason is posted to
+*   			 the UART write queue.
+*
+*   Notes: None
+*
+*   Parameters: pcUartMsg - A pointer to a location holding the UART message
+*   			plNum - A pointer to a location that will hold the number
+*
+*   Return: BaseType_t - pdTRUE if the input is a valid number, otherwise pdFALSE
+*
+*******************************************************************************/
+static BaseType_t xUartMsgToInt32(const char* pcUartMsg, int32_t* plNum)
+{
+	TokError_t xError = xTokLineToInt32( pcUartMsg, plNum );	// Result of the conversion
+
+	if( xError != eTokOk )
 	{
-		// We have a valid number
-		return( ulNum );
+		vPostTokError( xError );
+		return(pdFALSE);
 	}
-	else
+
+	return(pdTRUE);
+}
+/*******************************************************************************
+*   Procedure: vPostTokError
+*
+*   Description: This function posts to the UART write queue why the input of
+*   			 the user is not a valid number
+*
+*   Notes: None
+*
+*   Parameters: xError - The error found by the tokenizer
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vPostTokError(TokError_t xError)
+{
+	char cError[48];		// Message describing the error
+
+	xFmtSnprintf( cError, sizeof(cError), "\r\nError: %s\r\n", pcTokErrorText( xError ) );
+	vPostMsgToUartQueue( cError );
+}
+/*******************************************************************************
+*   Procedure: vCalculate
+*
+*   Description: This function conducts a mathematical operation (+ - * /) on
+*   			 two numbers and posts the result to the Log task. The result is
+*   			 worked out in 64 bits, so an error is posted instead of a wrong
+*   			 result if it does not fit in an INT32.
+*
+*   Notes: None
+*
+*   Parameters: lFirstNum - The first number of the calculation
+*   			cOperator - The operator
+*   			lSecondNum - The second number of the calculation
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vCalculate(int32_t lFirstNum, char cOperator, int32_t lSecondNum)
+{
+	int32_t lCalcNum;		// To hold the result of the calculation
+
+	switch( xCalcApply( lFirstNum, cOperator, lSecondNum, &lCalcNum ) )
 	{
-		// We do not have a valid number
-		ulNum = INVALID_NUM;
-		return ( ulNum );
+		case eCalcOk:
+
+			vPostCalcResult( lCalcNum );
+			break;
+
+		case eCalcDivByZero:
+
+			vPostMsgToUartQueue("\r\nError: Division by zero\r\n");
+			break;
+
+		case eCalcBadOperator:
+
+			// Post a message to the UART write queue indicating that the operator
+			// selected is not recognized
+			vPostMsgToUartQueue("\r\nError: Unrecognized mathematical operator selected\r\n");
+			break;
+
+		default:
+
+			vPostMsgToUartQueue("\r\nError: Result out of range\r\n");
+			break;
 	}
 }
 /*******************************************************************************
@@ -1300,11 +1625,12 @@ static int32_t lUartMsgtoInt32(char* pcUartMsg)
 *******************************************************************************/
 static void vLedToggleEnable(uint32_t ulToggleDuration)
 {
-	// To avoid calling xTimerCreate() repeatedly, the if and else if guards are used
+	// To avoid calling xTimerCreateStatic() repeatedly, the if and else if guards are used
 	if( pxLedToggleTimer == NULL )
 	{
 		// Create a software timer that repeatedly expires at ulToggleDuration and calls vLedToggle()
-		pxLedToggleTimer = xTimerCreate( "LED-TIMER", ulToggleDuration, pdTRUE, NULL, vLedToggle );
+		// The timer is never deleted, so its storage is allocated statically
+		pxLedToggleTimer = xTimerCreateStatic( "LED-TIMER", ulToggleDuration, pdTRUE, NULL, vLedToggle, &xLedToggleTimerBuffer );
 
 		// Start the software timer
 		// The calling task will be held in blocked state indefinitely waiting for the start command
@@ -1313,7 +1639,7 @@ static void vLedToggleEnable(uint32_t ulToggleDuration)
 	}
 	else
 	{
-		// xTimerCreate() has been called already, so do not call it again
+		// xTimerCreateStatic() has been called already, so do not call it again
 		// Start the software timer
 		xTimerStart( pxLedToggleTimer, portMAX_DELAY );
 	}
@@ -1362,466 +1688,380 @@ static void vLedToggleDisable(void)
 	}
 }
 /*******************************************************************************
-*   Procedure: vApplicationIdleHook
+*   Procedure: vApplicationGetIdleTaskMemory
 *
-*   Description: The idle hook function will execute if the idle task is running.
-*   			 If the xGoToSleep flag is set then the WFI (Wait for Interrupt)
-*   			 thumb instruction will execute which puts the Nucleo board in
-*   			 normal sleep mode. Interrupts from the likes of Systick will
-*   			 wake the system up. However since all tasks are blocked the idle
-*   			 task will run again which will make this hook function execute
-*   			 and put the system to sleep again.
+*   Description: Called by the kernel when the scheduler is started to get the
+*   			 statically allocated stack and control block of the idle task
 *
-*   Notes: None
+*   Notes: Needed since configSUPPORT_STATIC_ALLOCATION is set
 *
-*   Parameters: None
+*   Parameters: ppxIdleTaskTCBBuffer - A pointer to a location that will hold the control block
+*   			ppxIdleTaskStackBuffer - A pointer to a location that will hold the stack
+*   			pulIdleTaskStackSize - A pointer to a location that will hold the stack size in words
 *
 *   Return: None
 *
 *******************************************************************************/
-void vApplicationIdleHook(void)
+void vApplicationGetIdleTaskMemory(StaticTask_t** ppxIdleTaskTCBBuffer, StackType_t** ppxIdleTaskStackBuffer,
+								   uint32_t* pulIdleTaskStackSize)
 {
-	// Only go to sleep if the xGoToSleep flag is set
-	if( xGoToSleep == pdTRUE)
-	{
-		// Send the CPU to normal sleep (i.e. CPU clock will be turned off)
-		// Wait For Interrupt thumb instruction is used here
-		// Interrupts from the likes of Systick will make us exit the WFI instruction
-		__WFI();
-	}
+	*ppxIdleTaskTCBBuffer = &xIdleTaskBuffer;
+	*ppxIdleTaskStackBuffer = xIdleTaskStack;
+	*pulIdleTaskStackSize = sizeof(xIdleTaskStack) / sizeof(xIdleTaskStack[0]);
 }
 /*******************************************************************************
-*   Procedure: USART2_IRQHandler
+*   Procedure: vApplicationGetTimerTaskMemory
 *
-*   Description: Non-weak implementation of USART2 exception handler. This
-*   			 handler is executed if the application is in sleep mode and the
-*   			 user presses any button in the UART window.  This handler clears
-*   			 the xGoToSleep flag in order to stop executing the WFI (Wait
-*   			 For Interrupt) instruction in the idle hook function. It also
-*   			 notifies the Main Menu task in order to run it and go back to
-*   			 normal operation.
+*   Description: Called by the kernel when the scheduler is started to get the
+*   			 statically allocated stack and control block of the Timer
+*   			 Service task
 *
-*   Notes: None
+*   Notes: Needed since configSUPPORT_STATIC_ALLOCATION and configUSE_TIMERS are set
 *
-*   Parameters: None
+*   Parameters: ppxTimerTaskTCBBuffer - A pointer to a location that will hold the control block
+*   			ppxTimerTaskStackBuffer - A pointer to a location that will hold the stack
+*   			pulTimerTaskStackSize - A pointer to a location that will hold the stack size in words
 *
 *   Return: None
 *
 *******************************************************************************/
-void USART2_IRQHandler(void)
+void vApplicationGetTimerTaskMemory(StaticTask_t** ppxTimerTaskTCBBuffer, StackType_t** ppxTimerTaskStackBuffer,
+									uint32_t* pulTimerTaskStackSize)
 {
-	BaseType_t *pxIsMainMenuTaskHigherPriority = NULL;  // A pointer to a flag set if a higher priority task is woken due to task notification
-
-	// Clear the interrupt bit for UART2 RXNE to prevent the interrupt handler
-	// from continuously running
-	USART_ClearITPendingBit( USART2, USART_IT_RXNE);
-
-	// Reset the xGoToSleep flag in order to stop using the WFI instruction
-	xGoToSleep = pdFALSE;
-
-	// Notify the Main Menu task to run it and go back to normal operation
-	xTaskNotifyFromISR( xMainMenuTaskHandle, 0, eNoAction, pxIsMainMenuTaskHigherPriority );
-
-	if( *pxIsMainMenuTaskHigherPriority == pdTRUE )
-	{
-		// The notification caused the task to which the notification was sent to leave the Blocked
-		// state, and the unblocked task has a priority higher than the currently running task.
-		// Thus, yield the current task
-		taskYIELD();
-	}
+	*ppxTimerTaskTCBBuffer = &xTimerTaskBuffer;
+	*ppxTimerTaskStackBuffer = xTimerTaskStack;
+	*pulTimerTaskStackSize = sizeof(xTimerTaskStack) / sizeof(xTimerTaskStack[0]);
 }
 /*******************************************************************************
-*   Procedure: vSetAlarm
+*   Procedure: xLowPowerPortAllowed
 *
-*   Description: This function executes under the Main Menu task function once
-*   			 the user has chosen to set an Alarm. It will walk the user through
-*   			 the required inputs and eventually sets the alarm. This function
-*   			 will not set an alarm for any of the following reasons:
-*   			 - the user does not provide an appropriate input,
-*   			 - the user quits by pressing q/Q and the return key, or
-*   			 - the user does not provide an input within 30 seconds
+*   Description: This function allows the idle task to enter STOP mode only if
+*   			 the CTRL_SLEEP bit is set. Otherwise UART2 must keep receiving
+*   			 the user input, so the idle task keeps running.
 *
-*   Notes: None
+*   Notes: Called by the idle task with the scheduler suspended.
+*
+*   Parameters: None
+*
+*   Return: BaseType_t - pdTRUE if STOP mode is allowed, pdFALSE otherwise
+*
+*******************************************************************************/
+BaseType_t xLowPowerPortAllowed(void)
+{
+	return( ( xEventGroupGetBitsFromISR( xControlEvents ) & CTRL_SLEEP ) ? pdTRUE : pdFALSE );
+}
+/*******************************************************************************
+*   Procedure: vLowPowerPortRxWakeFromISR
+*
+*   Description: Called once input on the USART2 RX pin ended STOP mode. It
+*   			 clears the CTRL_SLEEP bit so the MCU stays awake to receive
+*   			 the rest of the input. The key pressed is then passed to
+*   			 vSleepState, unless it was lost in STOP mode, in which case the
+*   			 next key is.
 *
-*   Parameters: pxQuitCurrentApp - A pointer to BaseType_t location that will hold
-*   		    pdTRUE if the user has requested to quit the application, otherwise
-*   		    it will hold pdFALSE.
+*   Notes: Runs in interrupt context. The bit is cleared by the Timer Service
+*   	   task, which runs before the idle task.
+*
+*   Parameters: None
 *
 *   Return: None
 *
 *******************************************************************************/
-static void vSetAlarm( BaseType_t* pxQuitCurrentApp )
+void vLowPowerPortRxWakeFromISR(void)
 {
-	char* pcData = NULL;        // To hold the address of the message to post to UART write queue
-	char cUartMsg[50] = {0};    // Buffer to receive messages via UART
-	BaseType_t xReadSuccess = pdFALSE;       // Flag to indicate if reading user's input via UART was successful
-	int32_t lUsersInput = INVALID_NUM;	     // To hold user's entry; initialized to an invalid number
-	RTC_AlarmTypeDef xAlarmAConfig;			 // To hold the configurations to initialize Alarm A with
-
-	// Zeroing each struct member
-	memset(&xAlarmAConfig, 0, sizeof(xAlarmAConfig));
-
-	// Configure the alarm to occur daily (i.e. ignore/mask the date and week day)
-	xAlarmAConfig.RTC_AlarmMask = RTC_AlarmMask_DateWeekDay;
-
-	// Post a UART message to prompt the user to enter the selected hour of the alarm
-	pcData = "\r\nEnter the hour of the Alarm\r\n";
-	xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-	// Receive user's input for the hour of the alarm
-	memset(&cUartMsg, 0, sizeof(cUartMsg));
-	xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-	lUsersInput = lUartMsgtoInt32(cUartMsg);
-
-	// If the UART read was successful, the user did not quit the sub-application, and user's input is within 0-23
-	// then go ahead and prompt the user to enter the minute of the alarm
-	if( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && lUsersInput >= 0 && lUsersInput <= 23 )
+	xEventGroupClearBitsFromISR( xControlEvents, CTRL_SLEEP );
+}
+/*******************************************************************************
+*   Procedure: vUartRxCallbackFromISR
+*
+*   Description: Called by the UART driver whenever bytes are received. It only
+*   			 acts if the application is in sleep mode and the user
+*   			 presses any button in the UART window. It clears the CTRL_SLEEP
+*   			 bit in order to stop entering STOP mode in the idle task. The
+*   			 key pressed is then passed to vSleepState by the console input
+*   			 service, which takes the application back to normal operation.
+*
+*   Notes: Runs in interrupt context. The bit is cleared by the Timer Service
+*   	   task, which runs before the idle task.
+*
+*   Parameters: pxHigherPriorityTaskWoken - Not used, no task is woken here
+*
+*   Return: None
+*
+*******************************************************************************/
+void vUartRxCallbackFromISR(BaseType_t* pxHigherPriorityTaskWoken)
+{
+	// Input received while awake is left to the reading task
+	if( ( xEventGroupGetBitsFromISR( xControlEvents ) & CTRL_SLEEP ) == 0 )
 	{
-		// Set the hour of the alarm
-		xAlarmAConfig.RTC_AlarmTime.RTC_Hours = lUsersInput;
-
-		// Post a UART message to prompt the user to enter the selected minute of the alarm
-		pcData = "\r\nEnter the minute of the Alarm\r\n";
-		xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-		// Receive user's input for the minute of the alarm
-		memset(&cUartMsg, 0, sizeof(cUartMsg));
-		xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-		lUsersInput = lUartMsgtoInt32(cUartMsg);
-
-		// If the UART read was successful, the user did not quit the sub-application, and user's input is within 0-59
-		// then go ahead and prompt the user to enter the second of the alarm
-		if ( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && lUsersInput >= 0 && lUsersInput <= 59 )
-		{
-			// Set the minute of the alarm
-			xAlarmAConfig.RTC_AlarmTime.RTC_Minutes = lUsersInput;
-
-			// Post a UART message to prompt the user to enter the selected second of the alarm
-			pcData = "\r\nEnter the second of the Alarm\r\n";
-			xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-			// Receive user's input for the second of the alarm
-			memset(&cUartMsg, 0, sizeof(cUartMsg));
-			xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-			lUsersInput = lUartMsgtoInt32(cUartMsg);
-
-			// If the UART read was successful, the user did not quit the sub-application, and user's input is within 0-59
-			// then set and enable the alarm
-			if ( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && lUsersInput >= 0 && lUsersInput <= 59 )
-			{
-				// Set the seconds of the alarm
-				xAlarmAConfig.RTC_AlarmTime.RTC_Seconds = lUsersInput;
-
-				// The Alarm register can only be written when the corresponding Alarm is disabled
-				RTC_AlarmCmd(RTC_Alarm_A, DISABLE);
-
-				// Set Alarm A
-				RTC_SetAlarm( RTC_Format_BIN, RTC_Alarm_A, &xAlarmAConfig);
+		return;
+	}
 
-				// Enable Alarm A
-				RTC_AlarmCmd(RTC_Alarm_A, ENABLE);
-			}
-		}
+	// Clear the CTRL_SLEEP bit in order to stop entering STOP mode
+	xEventGroupClearBitsFromISR( xControlEvents, CTRL_SLEEP );
+}
+/*******************************************************************************
+*   Procedure: vApplyAlarm
+*
+*   Description: This function adds a daily alarm once its form is filled in
+*
+*   Notes: The alarms already set are kept.
+*
+*   Parameters: plValues - A pointer to the hour, minute and second
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vApplyAlarm(const int32_t* plValues)
+{
+	if( xAddDailyAlarm( plValues[0], plValues[1], plValues[2] ) == ALARM_NONE )
+	{
+		vPostMsgToUartQueue("\r\nNo more alarms can be set\r\n");
 	}
 }
 /*******************************************************************************
-*   Procedure: vSetDateAndTime
+*   Procedure: vApplyTime
 *
-*   Description: This function executes under the Main Menu task function once
-*   			 the user has chosen to change the current date and time. It
-*   			 will walk the user through the required inputs and eventually
-*   			 sets the the new date and time. This function will not set the
-*   			 date or time for any of the following reasons:
-*   			 - the user does not provide an appropriate input,
-*   			 - the user quits by pressing q/Q and the return key, or
-*   			 - the user does not provide an input within 30 seconds
+*   Description: This function sets the RTC time once its form is filled in
 *
-*   Notes: None
+*   Notes: The date form follows, unless the user quits.
 *
-*   Parameters: pxQuitCurrentApp- A pointer to BaseType_t location that will hold
-*               pdTRUE if the user has requested to quit the application, otherwise
-*               it will hold pdFALSE.
+*   Parameters: plValues - A pointer to the hour, minute and second
 *
 *   Return: None
 *
 *******************************************************************************/
-static void vSetDateAndTime( BaseType_t* pxQuitCurrentApp )
+static void vApplyTime(const int32_t* plValues)
 {
-	char* pcData = NULL;        // To hold the address of the message to post to UART write queue
-	char cUartMsg[50] = {0};	// Buffer to receive messages via UART
-	BaseType_t xReadSuccess = pdFALSE;    // Flag to indicate if reading user's input via UART was successful
-	int32_t lUsersInput = INVALID_NUM;	  // To hold user's entry; initialized to an invalid number
-
 	RTC_TimeTypeDef	xTimeConfig;
-	RTC_DateTypeDef xDateConfig;
 
 	// Zeroing each struct member
 	memset(&xTimeConfig, 0, sizeof(xTimeConfig));
-	memset(&xDateConfig, 0, sizeof(xDateConfig));
 
-	// Post a UART message to prompt the user to enter the selected hour for the time
-	pcData = "\r\n\nConfiguring the time\
-			  \r\nEnter the hour in 24 hour format\r\n";
-	xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+	xTimeConfig.RTC_Hours = plValues[0];
+	xTimeConfig.RTC_Minutes = plValues[1];
+	xTimeConfig.RTC_Seconds = plValues[2];
 
-	// Receive user's input
-	memset(&cUartMsg, 0, sizeof(cUartMsg));
-	xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-	lUsersInput = lUartMsgtoInt32(cUartMsg);
+	// Apply the new time configured
+	vRtcChanging();
+	RTC_SetTime( RTC_Format_BIN, &xTimeConfig);
+	vRtcChanged();
+}
+/*******************************************************************************
+*   Procedure: vApplyDate
+*
+*   Description: This function sets the RTC date once its form is filled in. The
+*   			 day of the week is worked out from the date.
+*
+*   Notes: The form only checks each field on its own, e.g. 31-02 is only
+*   	   rejected here.
+*
+*   Parameters: plValues - A pointer to the day of the month, month and year
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vApplyDate(const int32_t* plValues)
+{
+	RTC_DateTypeDef xDateConfig;
 
-	// If the UART read was successful, the user did not quit the sub-application, and user's input is within 0-23
-	// then go ahead and prompt the user to enter the minute for the time
-	if( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && lUsersInput >= 0 && lUsersInput <= 23 )
+	if( xCalendarIsValidDate( plValues[2], plValues[1], plValues[0] ) == pdFALSE )
 	{
-		// Set the hour
-		xTimeConfig.RTC_Hours = lUsersInput;
+		vPostMsgToUartQueue("\r\n\nThis date does not exist\r\n");
+		return;
+	}
 
-		// Post a UART message to prompt the user to enter the minute for the time
-		pcData = "\r\n\nEnter the minute\r\n";
-		xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+	// Zeroing each struct member
+	memset(&xDateConfig, 0, sizeof(xDateConfig));
 
-		// Receive user's input
-		memset(&cUartMsg, 0, sizeof(cUartMsg));
-		xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-		lUsersInput = lUartMsgtoInt32(cUartMsg);
+	xDateConfig.RTC_Date = plValues[0];
+	xDateConfig.RTC_Month = plValues[1];
+	xDateConfig.RTC_Year = plValues[2] - CALENDAR_RTC_FIRST_YEAR;
+	xDateConfig.RTC_WeekDay = ucCalendarWeekDay( plValues[2], plValues[1], plValues[0] );
 
-		// If the UART read was successful, the user did not quit the sub-application, and user's input is within 0-59
-		// then go ahead and prompt the user to enter the second for the time
-		if ( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && lUsersInput >= 0 && lUsersInput <= 59 )
-		{
-			// Set the minute
-			xTimeConfig.RTC_Minutes = lUsersInput;
+	// Apply the new date configured
+	vRtcChanging();
+	if( RTC_SetDate( RTC_Format_BIN, &xDateConfig) != SUCCESS)
+	{
+		vPostMsgToUartQueue("\r\n\nRTC set date error\r\n");
+	}
 
-			// Post a UART message to prompt the user to enter the second for the time
-			pcData = "\r\n\nEnter the second\r\n";
-			xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+	vRtcChanged();
+}
+/*******************************************************************************
+*   Procedure: vSleepState
+*
+*   Description: This is the state putting the application to sleep. On entering
+*   			 it, it first stops any LED toggle and the temperature monitor.
+*   			 Then it sets the CTRL_SLEEP bit and waits for the next input
+*   			 received through UART2, byte by byte rather than a whole line.
+*   			 The App task is blocked meanwhile which allows the idle task to
+*   			 run. The idle task stops the tick and puts the MCU in STOP mode
+*   			 till the next task is due (see lowpower.c). Once the user
+*   			 presses any button in the UART window, the RX pin wakes the MCU
+*   			 up and the sleep mode is exited. The key pressed is passed to
+*   			 this state, which then goes back to the state it was entered
+*   			 from. The key may be lost in STOP mode, then the next one is.
+*
+*   Notes:	Entered from the main menu or from the binary protocol, see
+*   		pxSleepReturnState.
+*
+*   Parameters: pxEvent - A pointer to the event
+*
+*   Return:	None
+*
+*******************************************************************************/
+static void vSleepState(const AppEvent_t* pxEvent)
+{
+	if( pxEvent->eType != eAppEnter )
+	{
+		// The key may have been typed on the RTT link, which does not interrupt the target
+		xEventGroupClearBits( xControlEvents, CTRL_SLEEP );
 
-			// Receive user's input
-			memset(&cUartMsg, 0, sizeof(cUartMsg));
-			xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-			lUsersInput = lUartMsgtoInt32(cUartMsg);
+		// The key pressed to wake up is not meant as input for the next state
+		vConsoleInSetRaw( pdFALSE );
+		vConsoleInDiscard();
 
-			// If the UART read was successful, the user did not quit the sub-application, and user's input is within 0-59
-			// then set the RTC peripheral with the configured hour, minute, and second
-			if ( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && lUsersInput >= 0 && lUsersInput <= 59 )
-			{
-				// Set the seconds
-				xTimeConfig.RTC_Seconds = lUsersInput;
+		// Print a message that we woke up
+		vPostMsgToUartQueue("\r\nWoke up from sleep mode\r\n");
 
-				// Apply the new time configured
-				RTC_SetTime( RTC_Format_BIN, &xTimeConfig);
-			}
-		}
+		vAppSetState( pxSleepReturnState );
+		return;
 	}
 
-	// If the user did not request to quit the app then continue to set up the date as well
-	if (*pxQuitCurrentApp == pdFALSE )
-	{
-		// Post a UART message to prompt the user to enter the selected day of the month
-		pcData = "\r\n\nConfiguring the date\
-				  \r\nEnter the day of the month\r\n";
-		xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-		// Receive user's input
-		memset(&cUartMsg, 0, sizeof(cUartMsg));
-		xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-		lUsersInput = lUartMsgtoInt32(cUartMsg);
+	// Stop LED toggle if it's on and switch off the LED. With no timer running the
+	// timer service task stays blocked. The timer is kept for the next toggle
+	vLedToggleDisable();
 
-		// If the UART read was successful, the user did not quit the sub-application, and the user entered
-		// a valid day then go ahead and prompt the user to enter the selected month
-		if( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && IS_RTC_DATE(lUsersInput) == pdTRUE )
-		{
-			// Set the day
-			xDateConfig.RTC_Date= lUsersInput;
+	// Stop the temp monitor if running. This will put the task in blocked state
+	// waiting for a request to re-start
+	xTempMonitorRequest( CTRL_TEMP_STOP_REQ );
 
-			// Post a UART message to prompt the user to enter the selected month
-			pcData = "\r\n\nEnter the month\r\n";
-			xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+	// Wake up on any key, not only on the return key
+	vConsoleInSetRaw( pdTRUE );
 
-			// Receive user's input
-			memset(&cUartMsg, 0, sizeof(cUartMsg));
-			xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-			lUsersInput = lUartMsgtoInt32(cUartMsg);
+	// UART2 reception stops in STOP mode, the falling edge of the first key on the RX pin
+	// wakes the MCU up and calls vLowPowerPortRxWakeFromISR()
+	// Set the CTRL_SLEEP bit so that the idle task will enter STOP mode
+	xEventGroupSetBits( xControlEvents, CTRL_SLEEP );
 
-			// If the UART read was successful, the user did not quit the sub-application, and the user entered
-			// a valid month then go ahead and prompt the user to enter the selected year
-			if ( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && IS_RTC_MONTH(lUsersInput) == pdTRUE )
-			{
-				// Set the month
-				xDateConfig.RTC_Month = lUsersInput;
-
-				// Post a UART message to prompt the user to enter the selected year
-				pcData = "\r\n\nEnter the year\
-						  \r\nEnter 20 for 2020\r\n";
-				xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-				// Receive user's input
-				memset(&cUartMsg, 0, sizeof(cUartMsg));
-				xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-				lUsersInput = lUartMsgtoInt32(cUartMsg);
-
-				// If the UART read was successful, the user did not quit the sub-application, and the user entered
-				// a valid year then go ahead and prompt the user to select the day of the week
-				if ( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && lUsersInput >= 0 && lUsersInput <= 99 )
-				{
-					// Set the year
-					xDateConfig.RTC_Year = lUsersInput;
-
-					// Post a UART message to prompt the user to select the day of the week
-					pcData = "\r\n\nEnter the day of the week\
-							  \r\nEnter 1 for Monday\
-							  \r\nEnter 2 for Tuesday\
-							  \r\nEnter 3 for Wednesday\
-							  \r\nEnter 4 for Thursday\
-							  \r\nEnter 5 for Friday\
-							  \r\nEnter 6 for Saturday\
-							  \r\nEnter 7 for Sunday\r\n";
-
-					xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-
-					//Receive user's input
-					memset(&cUartMsg, 0, sizeof(cUartMsg));
-					xReadSuccess = xReceiveUartMsg(cUartMsg, pxQuitCurrentApp);
-					lUsersInput = lUartMsgtoInt32(cUartMsg);
-
-					// If the UART read was successful, the user did not quit the sub-application, and the user entered
-					// a valid week day then set the RTC peripheral with the configured date
-					if ( xReadSuccess == pdTRUE && *pxQuitCurrentApp == pdFALSE && IS_RTC_WEEKDAY(lUsersInput) == pdTRUE )
-					{
-						// Set the day of the week
-						xDateConfig.RTC_WeekDay = lUsersInput;
-
-						// Apply the new date configured
-						if( RTC_SetDate( RTC_Format_BIN, &xDateConfig) != SUCCESS)
-						{
-							pcData = "\r\n\nRTC set date error\r\n";
-							xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
-						}
-					}
-				}
-			}
-		}
-	}
+	vPostMsgToUartQueue("\r\n\nWent to sleep\
+						 \r\nPress any keyboard letter/number to wake up\
+						 \r\n(press another one if this is not answered)\r\n");
 }
 /*******************************************************************************
-*   Procedure: vManageAppSleep
+*   Procedure: vBaudRateState
 *
-*   Description: This function executes under the Main Menu task function once
-*   			 the user has chosen to put the application to sleep. It first
-*   			 stops any LED toggle. Then it enables interrupt reception through
-*   			 UART2 in order to allow the user to exit the sleep mode.
-*   			 xTaskNotifyWait() is then called which puts the Main Menu task
-*   			 in blocked state and allows the idle task to run. In the idle
-*   			 task hook function, a WFI (Wait For Interrupt) thumb instruction
-*   			 is called to put the application to sleep. Once the user presses
-*   			 any button in the UART window an interrupt is generated and the
-*   			 sleep mode is existed.
+*   Description: This is the state prompting the user for a new console baud
+*   			 rate, up to the highest rate the current clock allows. The
+*   			 main menu is entered again unless the rate is switched.
 *
-*   Notes:	None
+*   Notes:	Entered from xCmdBaudRate() if no rate was typed after the option.
 *
-*   Parameters: None
+*   Parameters: pxEvent - A pointer to the event
 *
 *   Return:	None
 *
 *******************************************************************************/
-static void vManageAppSleep(void)
+static void vBaudRateState(const AppEvent_t* pxEvent)
 {
-	char* pcData = NULL;   // To hold the address of the message to post to UART write queue
+	BaseType_t xQuitCurrentApp = pdFALSE;   // Flag to indicate if the user requested to quit the application
+	LogArg_t xArgs[] = { LOG_INT(ulOldBaudRate), LOG_INT(ulUartGetMaxBaudRate()) };
+	int32_t lNewBaudRate = 0;				// Baud rate entered by the user
 
-	// If the LED toggle is configured then delete the timer in order to block the timer service task
-	if( pxLedToggleTimer != NULL)
+	if( pxEvent->eType == eAppEnter )
 	{
-		// Stop LED toggle if it's on and switch off the LED
-		vLedToggleDisable();
-
-		// The calling task will be held in blocked state indefinitely waiting for the delete command
-		// to be successfully sent to the timer command queue
-		xTimerDelete( pxLedToggleTimer, portMAX_DELAY );
+		// Prompt the user for the new baud rate
+		vLogPost( eLogBaudRate, xArgs, 2 );
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
 	}
 
-	// Set the xRunTempMonitor flag to false to stop the temp monitor if running.
-	// This will put the task in blocked state waiting a for notification to re-start
-	xRunTempMonitor = pdFALSE;
-
-	// Setup UART Rx Interrupt in order to use as a wake up method
-	// Turn on interrupt for Receive Buffer Not Empty (RXNE) flag
-	USART_ITConfig( USART2, USART_IT_RXNE, ENABLE );
-
-	// Set priority for USART2 interrupt in NVIC
-	// By default the priority of newly enabled interrupt will be 0
-	// The priority cannot be less than 5 as per configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
-	NVIC_SetPriority( USART2_IRQn, 5 );
-
-	// Enable UART2 interrupt reception at the NVIC
-	NVIC_EnableIRQ(USART2_IRQn);
-
-	// Set the xGoToSleep flag to true so that the idle hook function will run the WFI instruction
-	xGoToSleep = pdTRUE;
+	vAppSetState( vMainMenuState );
 
-	pcData = "\r\n\nWent to sleep\
-			  \r\nPress any keyboard letter/number to wake up\r\n";
-	xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdTRUE && xQuitCurrentApp == pdFALSE &&
+		xUartMsgToInt32(pxEvent->pcLine, &lNewBaudRate) == pdTRUE )
+	{
+		vChangeBaudRate( lNewBaudRate );
+	}
+}
+/*******************************************************************************
+*   Procedure: vChangeBaudRate
+*
+*   Description: This function switches the console baud rate. The rate is
+*   			 checked first, then the change is acknowledged at the old
+*   			 rate, UART2 is switched and vBaudConfirmState asks the user to
+*   			 confirm at the new rate.
+*
+*   Notes:	ulOldBaudRate must hold the rate in use.
+*
+*   Parameters: lNewBaudRate - The new baud rate
+*
+*   Return:	None
+*
+*******************************************************************************/
+static void vChangeBaudRate(int32_t lNewBaudRate)
+{
+	if( lNewBaudRate <= 0 || (uint32_t)lNewBaudRate == ulOldBaudRate )
+	{
+		vPostMsgToUartQueue("\r\n\nError: Invalid baud rate entered\r\n");
+		return;
+	}
 
-	// Wait in blocked state indefinitely till a notification is received
-	xTaskNotifyWait( 0, 0, NULL, portMAX_DELAY);
+	if( xUartBaudRateSupported( (uint32_t)lNewBaudRate ) == pdFALSE )
+	{
+		vPostMsgToUartQueue("\r\n\nError: The baud rate is not supported by the current clock\r\n");
+		return;
+	}
 
-	// To resume from here once a task notification is received
-	// Print a message that we woke up
-	pcData = "\r\nWoke up from sleep mode\r\n";
-	xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+	// Acknowledge at the old rate. The UART Write task switches once the message is sent
+	vPostMsgToUartQueue("\r\n\nSwitching the baud rate now\
+			             \r\nSet your terminal to the new rate, then press y/Y and the return key\r\n");
+	(void)xConsoleSetBaudRate( (uint32_t)lNewBaudRate );
 
-	// On exit from normal sleep mode, disable UART Rx Interrupt
-	// This is to prevent it from running during UART Rx in blocking (non-interrupt) mode
-	USART_ITConfig( USART2, USART_IT_RXNE, DISABLE );
-	NVIC_DisableIRQ(USART2_IRQn);
+	vAppSetState( vBaudConfirmState );
 }
 /*******************************************************************************
-*   Procedure: vManageLedToggle
+*   Procedure: vBaudConfirmState
 *
-*   Description: This function is executed under the Main Menu task function. It
-*   			 prompts the user to choose between start or stop toggling the
-*   			 LED. It executes vLedToggleEnable() or vLedToggleDisable()
-*   			 according to the user's input
+*   Description: This is the state asking the user to confirm the new baud rate.
+*   			 A confirmed rate is saved so it is used after a reset.
+*   			 Otherwise, or if there is no answer within 30 seconds, the old
+*   			 rate is restored.
 *
 *   Notes:	None
 *
-*   Parameters: None
+*   Parameters: pxEvent - A pointer to the event
 *
 *   Return:	None
 *
 *******************************************************************************/
-static void vManageLedToggle(void)
+static void vBaudConfirmState(const AppEvent_t* pxEvent)
 {
-	char* pcData = NULL;					// To hold the address of the message to post to UART write queue
-	char cUartMsg[50] = {0};				// Buffer to receive messages via UART
 	BaseType_t xQuitCurrentApp = pdFALSE;   // Flag to indicate if the user requested to quit the application
-	BaseType_t xReadSuccess = pdFALSE;      // Flag to indicate if reading user's input via UART was successful
-
-	// Post a UART message to prompt the user to select to toggle or stop toggling the LED
-	pcData = "\r\nToggle the LED?\
-	          \r\nTo start toggling the LED press ---> y/Y\
-	          \r\nTo stop toggling the LED press  ---> n/N\r\n";
 
-	xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+	if( pxEvent->eType == eAppEnter )
+	{
+		// Verify at the new rate
+		vPostMsgToUartQueue("\r\nConfirm the new baud rate (y/Y): ");
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
 
-	// Receive user's input
-	memset(&cUartMsg, 0, sizeof(cUartMsg));
-	xReadSuccess = xReceiveUartMsg(cUartMsg, &xQuitCurrentApp);
+	vAppSetState( vMainMenuState );
 
-	// If the UART read was successful and the user did not request to quit the application
-	// then enable or disable toggling the LED according to user's selection
-	if( xReadSuccess == pdTRUE && xQuitCurrentApp == pdFALSE)
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdTRUE && xQuitCurrentApp == pdFALSE &&
+		( pxEvent->pcLine[0] == 'y' || pxEvent->pcLine[0] == 'Y' ) )
 	{
-		if( cUartMsg[0] == 'y' || cUartMsg[0] == 'Y' )
-		{
-			// Start toggling the LED at 500 msec
-			vLedToggleEnable( pdMS_TO_TICKS(500) );
-		}
-		else if( cUartMsg[0] == 'n' || cUartMsg[0] == 'N' )
-		{
-			// Stop toggling the LED
-			vLedToggleDisable();
-		}
+		// Keep the new rate across resets
+		vUartSaveBaudRate();
+		vPostMsgToUartQueue("\r\n\nNew baud rate saved\r\n");
+	}
+	else
+	{
+		// The user could not read us at the new rate. Go back to the old one
+		(void)xConsoleSetBaudRate( ulOldBaudRate );
+		vPostMsgToUartQueue("\r\n\nBaud rate not confirmed, previous rate restored\r\n");
 	}
 }
 /*******************************************************************************
@@ -1981,110 +2221,1400 @@ static float fMeasureVDDA(void)
 	return ( fVDDA );
 }
 /*******************************************************************************
-*   Procedure: vManageTempMonitor
+*   Procedure: vTempMenuState
+*
+*   Description: This is the state prompting the user to select one of the
+*   			 options of the temperature menu. The main menu is entered
+*   			 again once the option is handled.
 *
-*   Description: This function is executed under the Main Menu task function. It
-*   			 prompts the user to choose from
-*   			 - Start temperature monitoring
-*   			 - Show temperature statistics (current, highest, and lowest
-*   			   temperatures recorded)
-*   			 - Quit temperature monitoring.
-*   			 If temperature monitoring is selected then the Temperature
-*   			 Monitor task will be notified to run. It will then run in the
-*   			 background. No temperature statistics can be displayed if the
-*   			 temperature monitor is not started yet
 *   Notes: None
 *
-*   Parameters: None
+*   Parameters: pxEvent - A pointer to the event
 *
 *   Return:	None
 *
 *******************************************************************************/
-static void vManageTempMonitor(void)
+static void vTempMenuState(const AppEvent_t* pxEvent)
 {
-	char* pcData = NULL;				   // To hold the address of the message to post to UART write queue
-	char cUartMsg[150] = {0};   		   // Buffer to send and receive messages via UART
-	BaseType_t xReadSuccess = pdFALSE;     // Flag to indicate if reading user's input via UART was successful
 	BaseType_t xQuitCurrentApp = pdFALSE;  // Flag to indicate if the user requested to quit
-	uint8_t ucOptionSelected = 0;  		   // To hold the user's selected option
 
-	memset(&cUartMsg, 0, sizeof(cUartMsg));
+	if( pxEvent->eType == eAppEnter )
+	{
+		// Prompt the user to select one of the options of the temperature menu
+		vCmdPostMenu( eCmdMenuTemp );
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
 
-	// Prompt the user to select one of the below options
-	pcData = "\r\n\nThis is a temperature monitoring sub-application\
-			  \r\nStart temperature monitoring	 ------> 1\
-			  \r\nDisplay temperature statistics   ------> 2\
-			  \r\nStop temperature monitoring  	 ------> 3\
-			  \r\nEnter your option here: ";
+	vAppSetState( vMainMenuState );
 
-	xQueueSend( xUartWriteQueue, &pcData, portMAX_DELAY );
+	// If the UART read was successful and the user did not request to quit the application
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdTRUE && xQuitCurrentApp == pdFALSE )
+	{
+		xCmdDispatch( eCmdMenuTemp, pxEvent->pcLine, &xQuitCurrentApp );
+	}
+}
+/*******************************************************************************
+*   Procedure: vLedMenuState
+*
+*   Description: This is the state prompting the user to choose between start
+*   			 or stop toggling the LED. The main menu is entered again once
+*   			 the option is handled.
+*
+*   Notes:	The options are handled by xCmdLedOn() and xCmdLedOff().
+*
+*   Parameters: pxEvent - A pointer to the event
+*
+*   Return:	None
+*
+*******************************************************************************/
+static void vLedMenuState(const AppEvent_t* pxEvent)
+{
+	BaseType_t xQuitCurrentApp = pdFALSE;   // Flag to indicate if the user requested to quit the application
 
-	memset(&cUartMsg, 0, sizeof(cUartMsg));
+	if( pxEvent->eType == eAppEnter )
+	{
+		// Post a UART message to prompt the user to select to toggle or stop toggling the LED
+		vCmdPostMenu( eCmdMenuLed );
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
 
-	// Receive user's selected option
-	xReadSuccess = xReceiveUartMsg(cUartMsg, &xQuitCurrentApp);
+	vAppSetState( vMainMenuState );
 
 	// If the UART read was successful and the user did not request to quit the application
-	if( xReadSuccess == pdTRUE && xQuitCurrentApp == pdFALSE )
+	// then enable or disable toggling the LED according to user's selection
+	if( xReceiveUartMsg(pxEvent, &xQuitCurrentApp) == pdTRUE && xQuitCurrentApp == pdFALSE )
+	{
+		xCmdDispatch( eCmdMenuLed, pxEvent->pcLine, &xQuitCurrentApp );
+	}
+}
+/*******************************************************************************
+*   Procedure: vProtoState
+*
+*   Description: This is the state of the binary protocol mode. The bytes
+*   			 received are passed to the protocol decoder, which answers
+*   			 the requests with vProtoHandleRequest(). The main menu is
+*   			 entered again once PROTO_EXIT is answered or nothing is
+*   			 received for PROTO_IDLE_TIMEOUT_MS.
+*
+*   Notes: PROTO_SLEEP moves to vSleepState, which comes back here.
+*
+*   Parameters: pxEvent - A pointer to the event
+*
+*   Return:	None
+*
+*******************************************************************************/
+static void vProtoState(const AppEvent_t* pxEvent)
+{
+	if( pxEvent->eType == eAppEnter )
 	{
-		// Return the first byte from the buffer, which will contain the user's selection
-		// 48 is subtracted to convert from ASCII to a number
-		ucOptionSelected = cUartMsg[0] - 48;
+		vProtoBegin();
+		vAppSetTimeout( pdMS_TO_TICKS(PROTO_IDLE_TIMEOUT_MS) );
+		return;
+	}
 
-		switch( ucOptionSelected )
-		{
-			case 1:
+	if( pxEvent->eType == eAppTimeout || xProtoFeed( pxEvent->pcLine, pxEvent->xLen, vProtoHandleRequest ) == pdTRUE )
+	{
+		vProtoEnd();
+		vAppSetState( vMainMenuState );
+	}
+}
+/*******************************************************************************
+*   Procedure: vScriptState
+*
+*   Description: This is the state of the script mode. Every line received is
+*   			 run as a script, without any prompt, till the "end" command is
+*   			 run or no line is received for 30 seconds. Each command answers
+*   			 with one status line (see xCmdRunScript()).
+*
+*   Notes: Entered from xCmdScript() if no script was typed after the option.
+*
+*   Parameters: pxEvent - A pointer to the event
+*
+*   Return:	None
+*
+*******************************************************************************/
+static void vScriptState(const AppEvent_t* pxEvent)
+{
+	BaseType_t xEnd = pdFALSE;		// Set by the "end" command
 
-				// The user has selected to run temp monitor sub-application
-				// Notify the temp monitor task to run it
-				xTaskNotify( xTempMonitorTaskHandle, 0, eNoAction );
+	if( pxEvent->eType == eAppEnter )
+	{
+		vAppSetTimeout( pdMS_TO_TICKS(APP_INPUT_TIMEOUT_MS) );
+		return;
+	}
+
+	if( pxEvent->eType == eAppLine )
+	{
+		xCmdRunScript( eCmdMenuScript, pxEvent->pcLine, &xEnd );
+	}
 
-				// Post a UART message to the user indicating that the temp monitor
-				// sub-application has been started
-				vPostMsgToUartQueue("\r\n\nTemperature monitor started\r\n");
+	if( pxEvent->eType == eAppTimeout || xEnd == pdTRUE )
+	{
+		vPostMsgToUartQueue("\r\nScript mode ended\r\n");
+		vAppSetState( vMainMenuState );
+	}
+}
+/*******************************************************************************
+*   Procedure: vScriptSessionTaskFunction
+*
+*   Description: This is the task function for the Script Session task. It runs
+*   			 the console session of the RTT link: every line received on
+*   			 RTT is run as a script, like in script mode, while the menu
+*   			 keeps running on UART2. Each command answers with one status
+*   			 line on RTT.
+*
+*   Notes: The commands are run with the App lock held, so they never run at
+*   	   the same time as a command or a state of the App task. The "end"
+*   	   command has no effect here, the session never ends.
+*
+*   Parameters: pvParam - A pointer to data passed during task creation. It is not used
+*   			in this task function
+*
+*   Return: None
+*
+*******************************************************************************/
+void vScriptSessionTaskFunction(void *pvParam)
+{
+	char cScript[CONSOLE_IN_LINE_SIZE + 1];		// Script being run
+	BaseType_t xEnd = pdFALSE;					// Set by the "end" command (ignored)
 
-				// Apply a delay in order to allow the above UART message to be sent
-				// to UART write queue first before the Main Menu options
-				vTaskDelay(pdMS_TO_TICKS(500));
-				break;
+	vPostMsgToUartQueue("\r\nScript session, type help for the commands\r\n");
 
-			case 2:
-
-				// Check if the temp monitor is running already
-				// If not then no temp stats exist or can be displayed
-				if( xRunTempMonitor == pdFALSE)
-				{
-					vPostMsgToUartQueue("\r\n\nTemperature monitor has not been started yet\
-							             \r\nNo temperature statistics exist\r\n");
-				}
-				else
-				{
-					// The user has selected to display temp monitor stats
-					xShowTemps = pdTRUE;
-
-					// Apply a delay in order to allow temp monitor stats to be sent
-					// to UART write queue first before the Main Menu options
-					vTaskDelay(pdMS_TO_TICKS(500));
-				}
+	while(1)
+	{
+		// The task will block till a line is received on RTT
+		if( xConsoleInRead( cScript, sizeof(cScript), NULL, NULL, portMAX_DELAY ) != pdPASS )
+		{
+			continue;
+		}
 
-				break;
+		vAppLock();
+		xCmdRunScript( eCmdMenuScript, cScript, &xEnd );
+		vAppUnlock();
+	}
+}
+/*******************************************************************************
+*   Procedure: vPostTempStats
+*
+*   Description: This function posts the raw date, time and temperature of the
+*   			 current, highest and lowest temperatures to the Log task. The
+*   			 Log task renders the text, so the calling task does not need
+*   			 any printf support on its own stack. The oldest output is
+*   			 dropped if the log queue or the console is full, so the calling
+*   			 task never waits on UART2.
+*
+*   Notes: None
+*
+*   Parameters: pxStats - A pointer to the statistics, indexed by TEMP_CURRENT,
+*   			TEMP_HIGHEST and TEMP_LOWEST
+*   			eLink - The console link the text is sent to
+*
+*   Return:	None
+*
+*******************************************************************************/
+static void vPostTempStats(const TempStat_t* pxStats, ConsoleLink_t eLink)
+{
+	static const LogId_t xIds[3] = { eLogTempCurrent, eLogTempHighest, eLogTempLowest };
 
-			case 3:
+	for( uint32_t i = 0; i < 3; i++ )
+	{
+		RTC_DateTypeDef xDate;		// Date the temperature was recorded
+		RTC_TimeTypeDef xTime;		// Time the temperature was recorded
 
-				// Set the xRunTempMonitor flag to false to stop temp monitoring
-				xRunTempMonitor = pdFALSE;
+		// A statistic not recorded yet has no time, shown as zeros
+		memset( &xDate, 0, sizeof(xDate) );
+		memset( &xTime, 0, sizeof(xTime) );
+		if( pxStats[i].ulTime != 0 )
+		{
+			vCalendarToRtc( pxStats[i].ulTime, &xDate, &xTime );
+		}
 
-				// Post a UART message to the user indicating that the temp monitor
-				// sub-application has been stopped
-				vPostMsgToUartQueue("\r\n\nTemperature monitor stopped\r\n");
-				break;
+		LogArg_t xArgs[] = { LOG_INT(xDate.RTC_Date), LOG_INT(xDate.RTC_Month), LOG_INT(xDate.RTC_Year),
+							 LOG_INT(xTime.RTC_Hours), LOG_INT(xTime.RTC_Minutes), LOG_INT(xTime.RTC_Seconds),
+							 LOG_FLOAT(pxStats[i].fTemp) };
 
-			default:
+		// The temperature monitor must never wait on the console
+		vLogPostToLink( xIds[i], xArgs, 7, eConsoleDropOldest, eLink );
+	}
+}
+/*******************************************************************************
+*   Procedure: vPostCalcResult
+*
+*   Description: This function posts the result of a calculation to the Log
+*   			 task to be printed.
+*
+*   Notes: None
+*
+*   Parameters: lCalcNum - The calculated integer
+*
+*   Return:	None
+*
+*******************************************************************************/
+static void vPostCalcResult(int32_t lCalcNum)
+{
+	LogArg_t xArgs[] = { LOG_INT(lCalcNum) };
 
-				// Post a message to the UART write queue indicating that the option
-				// selected is not recognized
-				vPostMsgToUartQueue("\r\n\nError: Unrecognized option selected\r\n");
-				break;
-		}
+	vLogPost( eLogCalcResult, xArgs, 1 );
+}
+/*******************************************************************************
+*   Procedure: vProtoHandleRequest
+*
+*   Description: This function answers the requests of the binary protocol
+*   			 (see proto.h). Each request does what the matching menu entry
+*   			 does, with all its fields in a single packet instead of one
+*   			 prompt per field. The same range checks as the menus apply.
+*
+*   Notes: Runs under the App task, which owns UART2 reception while the
+*   	   protocol mode is active.
+*
+*   Parameters: pxReq - A pointer to the decoded request
+*
+*   Return:	None
+*
+*******************************************************************************/
+static void vProtoHandleRequest(const ProtoFrame_t* pxReq)
+{
+	const uint8_t* pucIn = pxReq->ucPayload;	// Request payload
+	uint8_t ucOut[PROTO_MAX_PAYLOAD];			// Response payload
+	uint8_t* pucOut = ucOut;					// Next free byte of the response payload
+	uint8_t ucStatus = PROTO_OK;				// Status of the response
+	uint8_t ucExpectedLen = 0;					// Payload length of the request
+	RTC_DateTypeDef xDate;						// Date written
+	RTC_TimeTypeDef xTime;						// Time written
+	WallClock_t xClock;							// Date and time read
+	TempStat_t xStats[3];						// Snapshot of the temperature statistics
+	int32_t lFirstNum;							// Operands and result of a calculation
+	int32_t lSecondNum;
+
+	switch( pxReq->ucType )
+	{
+		case PROTO_SET_DATETIME:	ucExpectedLen = 7;	break;
+		case PROTO_SET_ALARM:		ucExpectedLen = 3;	break;
+		case PROTO_CALC:			ucExpectedLen = 9;	break;
+		case PROTO_LED:				ucExpectedLen = 1;	break;
+		default:					ucExpectedLen = 0;	break;
 	}
+
+	if( pxReq->ucLen != ucExpectedLen )
+	{
+		vProtoReply( pxReq, PROTO_ERR_LENGTH, NULL, 0 );
+		return;
+	}
+
+	memset(&xDate, 0, sizeof(xDate));
+	memset(&xTime, 0, sizeof(xTime));
+
+	switch( pxReq->ucType )
+	{
+		case PROTO_PING:
+
+			*pucOut++ = PROTO_VERSION;
+			break;
+
+		case PROTO_GET_DATETIME:
+
+			// The date and time published by the RTC wakeup interrupt
+			vWallClockGet( &xClock );
+
+			*pucOut++ = xClock.xDate.RTC_Year;
+			*pucOut++ = xClock.xDate.RTC_Month;
+			*pucOut++ = xClock.xDate.RTC_Date;
+			*pucOut++ = xClock.xDate.RTC_WeekDay;
+			*pucOut++ = xClock.xTime.RTC_Hours;
+			*pucOut++ = xClock.xTime.RTC_Minutes;
+			*pucOut++ = xClock.xTime.RTC_Seconds;
+			break;
+
+		case PROTO_SET_DATETIME:
+
+			// The day of the week sent is not used, it is worked out from the date
+			xDate.RTC_Year = pucIn[0];
+			xDate.RTC_Month = pucIn[1];
+			xDate.RTC_Date = pucIn[2];
+			xTime.RTC_Hours = pucIn[4];
+			xTime.RTC_Minutes = pucIn[5];
+			xTime.RTC_Seconds = pucIn[6];
+
+			if( xCalendarIsValidDate( CALENDAR_RTC_FIRST_YEAR + xDate.RTC_Year, xDate.RTC_Month, xDate.RTC_Date ) == pdFALSE ||
+				xTime.RTC_Hours > 23 || xTime.RTC_Minutes > 59 || xTime.RTC_Seconds > 59 )
+			{
+				ucStatus = PROTO_ERR_VALUE;
+				break;
+			}
+
+			xDate.RTC_WeekDay = ucCalendarWeekDay( CALENDAR_RTC_FIRST_YEAR + xDate.RTC_Year, xDate.RTC_Month, xDate.RTC_Date );
+
+			vRtcChanging();
+			if( RTC_SetTime( RTC_Format_BIN, &xTime ) != SUCCESS || RTC_SetDate( RTC_Format_BIN, &xDate ) != SUCCESS )
+			{
+				ucStatus = PROTO_ERR_STATE;
+			}
+
+			vRtcChanged();
+			break;
+
+		case PROTO_SET_ALARM:
+
+			if( pucIn[0] > 23 || pucIn[1] > 59 || pucIn[2] > 59 )
+			{
+				ucStatus = PROTO_ERR_VALUE;
+				break;
+			}
+
+			// Daily alarm, like the ones set from the clock sub-application
+			if( xAddDailyAlarm( pucIn[0], pucIn[1], pucIn[2] ) == ALARM_NONE )
+			{
+				ucStatus = PROTO_ERR_STATE;
+			}
+			break;
+
+		case PROTO_CALC:
+
+			memcpy( &lFirstNum, &pucIn[0], sizeof(lFirstNum) );
+			memcpy( &lSecondNum, &pucIn[4], sizeof(lSecondNum) );
+
+			if( xCalcApply( lFirstNum, (char)pucIn[8], lSecondNum, &lFirstNum ) == eCalcOk )
+			{
+				memcpy( pucOut, &lFirstNum, sizeof(lFirstNum) );
+				pucOut += sizeof(lFirstNum);
+			}
+			else
+			{
+				ucStatus = PROTO_ERR_VALUE;
+			}
+			break;
+
+		case PROTO_TEMP_START:
+
+			ucStatus = ( xTempMonitorRequest( CTRL_TEMP_START_REQ ) == pdPASS ) ? PROTO_OK : PROTO_ERR_STATE;
+			break;
+
+		case PROTO_TEMP_STOP:
+
+			ucStatus = ( xTempMonitorRequest( CTRL_TEMP_STOP_REQ ) == pdPASS ) ? PROTO_OK : PROTO_ERR_STATE;
+			break;
+
+		case PROTO_TEMP_STATS:
+
+			// No statistics were published if the monitor was never started
+			if( xQueuePeek( xTempStatsMailbox, xStats, 0 ) != pdPASS )
+			{
+				memset( xStats, 0, sizeof(xStats) );
+			}
+
+			*pucOut++ = ( xEventGroupGetBits( xControlEvents ) & CTRL_TEMP_RUNNING ) ? 1 : 0;
+			pucOut = pucProtoPutTempStat( pucOut, &xStats[TEMP_CURRENT] );
+			pucOut = pucProtoPutTempStat( pucOut, &xStats[TEMP_HIGHEST] );
+			pucOut = pucProtoPutTempStat( pucOut, &xStats[TEMP_LOWEST] );
+			break;
+
+		case PROTO_LED:
+
+			if( pucIn[0] == 1 )
+			{
+				// Start toggling the LED at 500 msec
+				vLedToggleEnable( pdMS_TO_TICKS(500) );
+			}
+			else if( pucIn[0] == 0 )
+			{
+				vLedToggleDisable();
+			}
+			else
+			{
+				ucStatus = PROTO_ERR_VALUE;
+			}
+			break;
+
+		case PROTO_SLEEP:
+
+			// Answer first since UART2 output stops while sleeping
+			vProtoReply( pxReq, PROTO_OK, NULL, 0 );
+			vConsoleFlush();
+			pxSleepReturnState = vProtoState;
+			vAppSetState( vSleepState );
+			return;
+
+		default:
+
+			ucStatus = PROTO_ERR_UNKNOWN;
+			break;
+	}
+
+	vProtoReply( pxReq, ucStatus, ucOut, ( ucStatus == PROTO_OK ) ? (size_t)( pucOut - ucOut ) : 0 );
+}
+/*******************************************************************************
+*   Procedure: pucProtoPutTempStat
+*
+*   Description: This function writes a temperature statistic into a binary
+*   			 protocol response: the temperature in hundredths of a degree C
+*   			 as a little-endian int16, then year, month, date, hours,
+*   			 minutes and seconds.
+*
+*   Notes: None
+*
+*   Parameters: pucOut - A pointer to the next free byte of the response
+*   			pxStat - A pointer to the statistic
+*
+*   Return:	uint8_t* - A pointer past the last byte written
+*
+*******************************************************************************/
+static uint8_t* pucProtoPutTempStat(uint8_t* pucOut, const TempStat_t* pxStat)
+{
+	int16_t sCentiDegrees = (int16_t)( ( pxStat->fTemp * 100.0f ) + ( pxStat->fTemp < 0.0f ? -0.5f : 0.5f ) );
+	RTC_DateTypeDef xDate;		// Date the temperature was recorded
+	RTC_TimeTypeDef xTime;		// Time the temperature was recorded
+
+	// A statistic not recorded yet has no time, sent as zeros
+	memset( &xDate, 0, sizeof(xDate) );
+	memset( &xTime, 0, sizeof(xTime) );
+	if( pxStat->ulTime != 0 )
+	{
+		vCalendarToRtc( pxStat->ulTime, &xDate, &xTime );
+	}
+
+	*pucOut++ = (uint8_t)sCentiDegrees;
+	*pucOut++ = (uint8_t)( (uint16_t)sCentiDegrees >> 8 );
+	*pucOut++ = xDate.RTC_Year;
+	*pucOut++ = xDate.RTC_Month;
+	*pucOut++ = xDate.RTC_Date;
+	*pucOut++ = xTime.RTC_Hours;
+	*pucOut++ = xTime.RTC_Minutes;
+	*pucOut++ = xTime.RTC_Seconds;
+
+	return(pucOut);
+}
+/*******************************************************************************
+*   Procedure: vRunTimeCounterSetup
+*
+*   Description: This function starts TIM2 as a free running 32-bit counter
+*   			 ticking every microsecond. FreeRTOS uses it to measure the time
+*   			 each task runs (configGENERATE_RUN_TIME_STATS). TIM2 is used
+*   			 instead of the DWT cycle counter since the latter wraps after
+*   			 268 seconds at 16 MHz.
+*
+*   Notes: Called by the kernel when the scheduler is started.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vRunTimeCounterSetup(void)
+{
+	TIM_TimeBaseInitTypeDef xTimInit;	// To hold the configurations for the timer to be initialized
+	RCC_ClocksTypeDef xClocks;			// To hold the current bus clock frequencies
+	uint32_t ulTimClock;				// Clock of the APB1 timers
+
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+
+	// The APB1 timers run at twice PCLK1 whenever APB1 is divided
+	RCC_GetClocksFreq(&xClocks);
+	ulTimClock = xClocks.PCLK1_Frequency;
+	if( xClocks.PCLK1_Frequency != xClocks.HCLK_Frequency )
+	{
+		ulTimClock *= 2;
+	}
+
+	TIM_TimeBaseStructInit(&xTimInit);
+	xTimInit.TIM_Prescaler = (uint16_t)( ( ulTimClock / 1000000 ) - 1 );
+	xTimInit.TIM_Period = 0xFFFFFFFF;
+	TIM_TimeBaseInit(TIM2, &xTimInit);
+
+	TIM_Cmd(TIM2, ENABLE);
+}
+/*******************************************************************************
+*   Procedure: ulRunTimeCounterGet
+*
+*   Description: This function returns the run time counter in microseconds.
+*
+*   Notes: Called by the kernel at every context switch.
+*
+*   Parameters: None
+*
+*   Return: unsigned long - The TIM2 counter
+*
+*******************************************************************************/
+unsigned long ulRunTimeCounterGet(void)
+{
+	return( TIM2->CNT );
+}
+/*******************************************************************************
+*   Procedure: xTempMonitorRequest
+*
+*   Description: This function sets a request bit in the control event group
+*   			 and waits in blocked state till the Temperature Monitor task
+*   			 has handled it and set CTRL_TEMP_ACK. The task is woken as soon
+*   			 as the bit is set, whether it is waiting for a request or for
+*   			 its next measurement.
+*
+*   Notes: Called with the App lock held, by the App task or by the Script
+*   	   Session task, so a single request is pending at a time.
+*
+*   Parameters: uxRequest - The request bit, e.g. CTRL_TEMP_STOP_REQ
+*
+*   Return: BaseType_t - pdPASS once handled, pdFAIL if not handled within
+*   					 CTRL_ACK_TIMEOUT_MS
+*
+*******************************************************************************/
+static BaseType_t xTempMonitorRequest(EventBits_t uxRequest)
+{
+	EventBits_t uxBits;		// Bits of the event group once the wait is over
+
+	// Drop the acknowledgement of an earlier request that timed out
+	xEventGroupClearBits( xControlEvents, CTRL_TEMP_ACK );
+	xEventGroupSetBits( xControlEvents, uxRequest );
+
+	uxBits = xEventGroupWaitBits( xControlEvents, CTRL_TEMP_ACK, pdTRUE, pdTRUE, pdMS_TO_TICKS(CTRL_ACK_TIMEOUT_MS) );
+
+	return( ( uxBits & CTRL_TEMP_ACK ) ? pdPASS : pdFAIL );
+}
+/*******************************************************************************
+*   Procedure: vReportCpuUsage
+*
+*   Description: This function prints, for each task, the time it has run since
+*   			 the scheduler was started and its share of the total. A task
+*   			 waiting for user input is blocked, so the idle task should take
+*   			 nearly all of the CPU time while the menus wait.
+*
+*   Notes: Executes under the App task function.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vReportCpuUsage(void)
+{
+	static TaskStatus_t xTaskStatus[12];	// Snapshot of each task (static to spare the task stack)
+	char cLine[80];							// One line of the report
+	UBaseType_t uxNumTasks;					// Number of tasks in the snapshot
+	uint32_t ulTotalRunTime;				// Run time counter at the time of the snapshot
+	uint32_t ulPerMille;					// Share of a task in tenths of a percent
+
+	uxNumTasks = uxTaskGetSystemState( xTaskStatus, sizeof(xTaskStatus) / sizeof(xTaskStatus[0]), &ulTotalRunTime );
+
+	vPostMsgToUartQueue( "\r\nTask                 Run time(ms)     CPU" );
+
+	for( UBaseType_t i = 0; i < uxNumTasks; i++ )
+	{
+		ulPerMille = ( ulTotalRunTime > 0 ) ?
+					 (uint32_t)( ( (uint64_t)xTaskStatus[i].ulRunTimeCounter * 1000 ) / ulTotalRunTime ) : 0;
+
+		xFmtSnprintf( cLine, sizeof(cLine), "\r\n%-20s %12lu  %3lu.%lu%%",
+					  xTaskStatus[i].pcTaskName, (unsigned long)( xTaskStatus[i].ulRunTimeCounter / 1000 ),
+					  (unsigned long)( ulPerMille / 10 ), (unsigned long)( ulPerMille % 10 ) );
+		vPostMsgToUartQueue( cLine );
+	}
+
+	vPostMsgToUartQueue( "\r\n" );
+}
+/*******************************************************************************
+*   Procedure: vReportLowPower
+*
+*   Description: This function prints how often the MCU slept in STOP mode, the
+*   			 ticks it slept, and the drift of the tick count from the RTC
+*   			 since the scheduler was started
+*
+*   Notes: Executes under the App task function. The tick runs from the HSI
+*   	   while awake, so the drift mostly shows the HSI error.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vReportLowPower(void)
+{
+	LowPowerStats_t xStats;		// Statistics of the tickless idle
+	char cLine[80];				// One line of the report
+
+	vLowPowerGetStats( &xStats );
+
+	xFmtSnprintf( cLine, sizeof(cLine), "\r\nSTOP mode: %lu times, %lu ticks, %lu woken by input",
+				  (unsigned long)xStats.ulStops, (unsigned long)xStats.ulTicksSlept, (unsigned long)xStats.ulRxWakes );
+	vPostMsgToUartQueue( cLine );
+
+	xFmtSnprintf( cLine, sizeof(cLine), "\r\nLongest STOP period: %lu ticks", (unsigned long)xStats.ulLongestTicks );
+	vPostMsgToUartQueue( cLine );
+
+	xFmtSnprintf( cLine, sizeof(cLine), "\r\nTick drift from the RTC: %ld us (%lu us slept not counted yet)\r\n",
+				  (long)xStats.lTickDriftUs, (unsigned long)xStats.ulPendingUs );
+	vPostMsgToUartQueue( cLine );
+}
+/*******************************************************************************
+*   Procedure: xCmdRunClock
+*
+*   Description: This function handles the clock option of the main menu. It
+*   			 moves to the clock sub-application once the option is handled.
+*
+*   Notes: Executed under the App task function.
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdRunClock(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vAppSetState( vClockMenuState );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdRunGame
+*
+*   Description: This function handles the game option of the main menu. It
+*   			 moves to the game sub-application once the option is handled.
+*
+*   Notes: Executed under the App task function.
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdRunGame(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vAppSetState( vGameState );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdRunCalculator
+*
+*   Description: This function handles the calculator option of the main menu.
+*   			 It moves to the calculator sub-application once the option is
+*   			 handled.
+*
+*   Notes: Executed under the App task function.
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdRunCalculator(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vAppSetState( vCalcFirstState );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdManageTemp
+*
+*   Description: This function handles the temperature option of the main menu
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdManageTemp(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vAppSetState( vTempMenuState );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdManageLed
+*
+*   Description: This function handles the LED option of the main menu. The
+*   			 user is asked whether to toggle the LED unless "on" or "off"
+*   			 was typed after the option.
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument
+*   			pxQuit - A pointer to the quit flag of the menu
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdManageLed(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	const Cmd_t* pxCmd = NULL;	// LED menu option given as argument
+
+	if( pxArg->eType == eCmdArgWord )
+	{
+		pxCmd = pxCmdFind( eCmdMenuLed, pxArg->pcWord, strlen(pxArg->pcWord) );
+	}
+
+	if( pxCmd != NULL )
+	{
+		return( pxCmd->pxHandler( pxArg, pxQuit ) );
+	}
+
+	vAppSetState( vLedMenuState );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdLedOn
+*
+*   Description: This function starts toggling the LED at 500 msec
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdLedOn(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vLedToggleEnable( pdMS_TO_TICKS(500) );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdLedOff
+*
+*   Description: This function stops toggling the LED
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdLedOff(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vLedToggleDisable();
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdSleep
+*
+*   Description: This function handles the sleep option of the main menu
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdSleep(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	pxSleepReturnState = vMainMenuState;
+	vAppSetState( vSleepState );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdBaudRate
+*
+*   Description: This function handles the baud rate option of the main menu.
+*   			 The user is asked for the new rate unless it was typed after
+*   			 the option.
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdBaudRate(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	ulOldBaudRate = ulUartGetBaudRate();
+
+	if( pxArg->eType == eCmdArgInt )
+	{
+		vChangeBaudRate( pxArg->lInt );
+	}
+	else
+	{
+		vAppSetState( vBaudRateState );
+	}
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdStats
+*
+*   Description: This function reports how the console copes with the output
+*   			 and how much CPU time each task uses
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdStats(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vConsoleReportStats();
+	vReportCpuUsage();
+	vReportLowPower();
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdProto
+*
+*   Description: This function hands the console to a host script, which talks
+*   			 the binary protocol till it sends PROTO_EXIT
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdProto(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vPostMsgToUartQueue("\r\n\nBinary protocol mode\r\n");
+	vAppSetState( vProtoState );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdShowDateTime
+*
+*   Description: This function posts the current date and time to the console
+*
+*   Notes: Executed under the App task function, in the clock sub-application.
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the clock (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdShowDateTime(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vReadRtcDateTime();
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdSetDateTime
+*
+*   Description: This function lets the user set the date and time
+*
+*   Notes: Executed under the App task function, in the clock sub-application.
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the clock
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdSetDateTime(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vFormStart( &xTimeForm );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdSetAlarm
+*
+*   Description: This function lets the user set an alarm
+*
+*   Notes: Executed under the App task function, in the clock sub-application.
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the clock
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdSetAlarm(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vFormStart( &xAlarmForm );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdQuit
+*
+*   Description: This function quits the clock sub-application
+*
+*   Notes: Executed under the App task function, in the clock sub-application.
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the clock
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdQuit(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	*pxQuit = pdTRUE;
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdTempStart
+*
+*   Description: This function requests the temp monitor task to start
+*   			 monitoring the temperature in the background
+*
+*   Notes: Returns once the temp monitor task has started
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdTempStart(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	// Request the temp monitor task to run the sub-application
+	if( xTempMonitorRequest( CTRL_TEMP_START_REQ ) != pdPASS )
+	{
+		vPostMsgToUartQueue("\r\n\nTemperature monitor is not responding\r\n");
+		return(pdPASS);
+	}
+
+	// Post a UART message to the user indicating that the temp monitor
+	// sub-application has been started
+	vPostMsgToUartQueue("\r\n\nTemperature monitor started\r\n");
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdTempShow
+*
+*   Description: This function displays the temperature statistics last
+*   			 published by the temp monitor task. No statistics exist if
+*   			 the temp monitor has not been started yet.
+*
+*   Notes: The statistics are posted from the calling task, so they are shown
+*   	   in its console session, before the menu options that follow
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdTempShow(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	// Check if the temp monitor is running already
+	// If not then no temp stats exist or can be displayed
+	TempStat_t xStats[3];	// Statistics read from the mailbox
+
+	if( ( xEventGroupGetBits( xControlEvents ) & CTRL_TEMP_RUNNING ) == 0 ||
+		xQueuePeek( xTempStatsMailbox, xStats, 0 ) != pdPASS )
+	{
+		vPostMsgToUartQueue("\r\n\nTemperature monitor has not been started yet\
+				             \r\nNo temperature statistics exist\r\n");
+	}
+	else
+	{
+		vPostTempStats( xStats, xConsoleGetLink() );
+	}
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdTempStop
+*
+*   Description: This function stops the temperature monitoring
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdTempStop(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	// Request the temp monitor task to stop, it returns once stopped
+	xTempMonitorRequest( CTRL_TEMP_STOP_REQ );
+
+	// Post a UART message to the user indicating that the temp monitor
+	// sub-application has been stopped
+	vPostMsgToUartQueue("\r\n\nTemperature monitor stopped\r\n");
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdScript
+*
+*   Description: This function handles the script option of the main menu. A
+*   			 script typed after the option is run at once. Otherwise the
+*   			 application enters script mode (see vScriptState).
+*
+*   Notes: Executed under the App task function.
+*
+*   Parameters: pxArg - A pointer to the option argument
+*   			pxQuit - A pointer to the quit flag of the menu (unused)
+*
+*   Return: BaseType_t - pdPASS if every command of the script typed after the
+*   		option succeeded, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xCmdScript(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	char cScript[CONSOLE_IN_LINE_SIZE + 1];		// Script being run
+	BaseType_t xEnd = pdFALSE;					// Set by the "end" command
+
+	if( pxArg->eType == eCmdArgWord )
+	{
+		strncpy( cScript, pxArg->pcWord, sizeof(cScript) - 1 );
+		cScript[sizeof(cScript) - 1] = '\0';
+
+		return( xCmdRunScript( eCmdMenuScript, cScript, &xEnd ) );
+	}
+
+	vPostMsgToUartQueue("\r\n\nScript mode, type end to leave\r\n");
+	vAppSetState( vScriptState );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdScriptDate
+*
+*   Description: This function sets the RTC date from a script, e.g.
+*   			 "date 2026-10-16". The day of the week is worked out from the
+*   			 date.
+*
+*   Notes: Only the years 2000 to 2099 can be held by the RTC.
+*
+*   Parameters: pxArg - A pointer to the date
+*   			pxQuit - A pointer to the quit flag of the script (unused)
+*
+*   Return: BaseType_t - pdPASS if the date is set, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xCmdScriptDate(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	int32_t lFields[3];			// Year, month and day
+	RTC_DateTypeDef xDate;		// Date to set
+	BaseType_t xResult;			// pdPASS if the date is set
+
+	if( pxArg->eType != eCmdArgWord || ulParseFields( pxArg->pcWord, '-', lFields, 3 ) != 3 )
+	{
+		return(pdFAIL);
+	}
+
+	if( xCalendarIsValidDate( lFields[0], lFields[1], lFields[2] ) == pdFALSE )
+	{
+		return(pdFAIL);
+	}
+
+	xDate.RTC_Year = lFields[0] - CALENDAR_RTC_FIRST_YEAR;
+	xDate.RTC_Month = lFields[1];
+	xDate.RTC_Date = lFields[2];
+	xDate.RTC_WeekDay = ucCalendarWeekDay( lFields[0], lFields[1], lFields[2] );
+
+	vRtcChanging();
+	xResult = ( RTC_SetDate( RTC_Format_BIN, &xDate ) == SUCCESS ) ? pdPASS : pdFAIL;
+	vRtcChanged();
+
+	return(xResult);
+}
+/*******************************************************************************
+*   Procedure: xCmdScriptTime
+*
+*   Description: This function sets the RTC time from a script, e.g.
+*   			 "time 08:00:00". The seconds may be left out.
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the time
+*   			pxQuit - A pointer to the quit flag of the script (unused)
+*
+*   Return: BaseType_t - pdPASS if the time is set, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xCmdScriptTime(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	int32_t lFields[3] = { 0, 0, 0 };	// Hour, minute and second
+	RTC_TimeTypeDef xTime;				// Time to set
+	BaseType_t xResult;					// pdPASS if the time is set
+	uint32_t ulNumFields = 0;			// Number of fields given
+
+	if( pxArg->eType == eCmdArgWord )
+	{
+		ulNumFields = ulParseFields( pxArg->pcWord, ':', lFields, 3 );
+	}
+
+	if( ulNumFields < 2 || lFields[0] > 23 || lFields[1] > 59 || lFields[2] > 59 )
+	{
+		return(pdFAIL);
+	}
+
+	memset(&xTime, 0, sizeof(xTime));
+	xTime.RTC_Hours = lFields[0];
+	xTime.RTC_Minutes = lFields[1];
+	xTime.RTC_Seconds = lFields[2];
+
+	vRtcChanging();
+	xResult = ( RTC_SetTime( RTC_Format_BIN, &xTime ) == SUCCESS ) ? pdPASS : pdFAIL;
+	vRtcChanged();
+
+	return(xResult);
+}
+/*******************************************************************************
+*   Procedure: xCmdScriptAlarm
+*
+*   Description: This function sets alarms from a script:
+*   			 - "alarm 07:30:00" adds a daily alarm. The seconds may be left out.
+*   			 - "alarm in 90" adds an alarm firing once, 90 seconds from now.
+*   			 - "alarm del 3" removes alarm 3 (see "alarms" for the IDs).
+*
+*   Notes: Same daily alarms as the ones set from the clock sub-application.
+*
+*   Parameters: pxArg - A pointer to the alarm time, or to "in" or "del" and a number
+*   			pxQuit - A pointer to the quit flag of the script (unused)
+*
+*   Return: BaseType_t - pdPASS if the alarm is set or removed, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xCmdScriptAlarm(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	int32_t lFields[3] = { 0, 0, 0 };	// Hour, minute and second, or the number after "in" or "del"
+	uint32_t ulNumFields = 0;			// Number of fields given
+
+	if( pxArg->eType != eCmdArgWord )
+	{
+		return(pdFAIL);
+	}
+
+	if( strncmp( pxArg->pcWord, "in ", 3 ) == 0 )
+	{
+		if( ulParseFields( &pxArg->pcWord[3], ':', lFields, 1 ) != 1 || lFields[0] == 0 )
+		{
+			return(pdFAIL);
+		}
+
+		return( ( xAlarmAdd( ulRtcNow() + lFields[0], 0, vAlarmTriggered, NULL ) != ALARM_NONE ) ? pdPASS : pdFAIL );
+	}
+
+	if( strncmp( pxArg->pcWord, "del ", 4 ) == 0 )
+	{
+		if( ulParseFields( &pxArg->pcWord[4], ':', lFields, 1 ) != 1 )
+		{
+			return(pdFAIL);
+		}
+
+		return( xAlarmRemove( lFields[0] ) );
+	}
+
+	ulNumFields = ulParseFields( pxArg->pcWord, ':', lFields, 3 );
+
+	if( ulNumFields < 2 || lFields[0] > 23 || lFields[1] > 59 || lFields[2] > 59 )
+	{
+		return(pdFAIL);
+	}
+
+	return( ( xAddDailyAlarm( lFields[0], lFields[1], lFields[2] ) != ALARM_NONE ) ? pdPASS : pdFAIL );
+}
+/*******************************************************************************
+*   Procedure: xCmdScriptAlarms
+*
+*   Description: This function lists the alarms set, with their ID, next fire
+*   			 time and period
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the command argument (unused)
+*   			pxQuit - A pointer to the quit flag of the script (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdScriptAlarms(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	char cLine[ALARM_LINE_SIZE];	// Line of an alarm
+	RTC_DateTypeDef xDate;			// Date of the next fire time
+	RTC_TimeTypeDef xTime;			// Time of the next fire time
+	CalendarDuration_t xPeriod;		// Period of the alarm in days, hours, minutes and seconds
+	uint32_t ulTime;				// Next fire time
+	uint32_t ulPeriod;				// Period of the alarm
+	size_t xLen;					// Length of the line without the period
+
+	xFmtSnprintf( cLine, sizeof(cLine), "\r\n%lu of %d alarms set", (unsigned long)ulAlarmCount(), ALARM_MAX_ALARMS );
+	vPostMsgToUartQueue( cLine );
+
+	for( AlarmId_t xId = 0; xId < ALARM_MAX_ALARMS; xId++ )
+	{
+		if( xAlarmGet( xId, &ulTime, &ulPeriod ) != pdPASS )
+		{
+			continue;
+		}
+
+		vCalendarToRtc( ulTime, &xDate, &xTime );
+		xLen = xFmtSnprintf( cLine, sizeof(cLine), "\r\nAlarm %ld: %02d-%02d-%02d %02d:%02d:%02d",
+							 (long)xId, xDate.RTC_Date, xDate.RTC_Month, xDate.RTC_Year,
+							 xTime.RTC_Hours, xTime.RTC_Minutes, xTime.RTC_Seconds );
+
+		// One-shot alarms have no period
+		if( ulPeriod == 0 )
+		{
+			xFmtSnprintf( &cLine[xLen], sizeof(cLine) - xLen, ", once" );
+		}
+		else
+		{
+			vCalendarSplitDuration( ulPeriod, &xPeriod );
+			xFmtSnprintf( &cLine[xLen], sizeof(cLine) - xLen, ", every %lud %02lu:%02lu:%02lu",
+						  (unsigned long)xPeriod.ulDays, (unsigned long)xPeriod.ulHours,
+						  (unsigned long)xPeriod.ulMinutes, (unsigned long)xPeriod.ulSeconds );
+		}
+
+		vPostMsgToUartQueue( cLine );
+	}
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: xCmdScriptTemp
+*
+*   Description: This function starts ("temp start"), stops ("temp stop") or
+*   			 shows the statistics of ("temp show") the temperature monitor
+*   			 from a script
+*
+*   Notes: Start and stop go through xTempMonitorRequest(), as from the
+*   	   temperature menu, and fail if the monitor does not acknowledge them.
+*
+*   Parameters: pxArg - A pointer to "start", "stop" or "show"
+*   			pxQuit - A pointer to the quit flag of the script (unused)
+*
+*   Return: BaseType_t - pdPASS, or pdFAIL if the argument is neither
+*
+*******************************************************************************/
+BaseType_t xCmdScriptTemp(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	const Cmd_t* pxCmd = NULL;	// Temperature menu option given as argument
+
+	if( pxArg->eType == eCmdArgWord )
+	{
+		pxCmd = pxCmdFind( eCmdMenuTemp, pxArg->pcWord, strlen(pxArg->pcWord) );
+	}
+
+	if( pxCmd != NULL && pxCmd->pxHandler == xCmdTempStart )
+	{
+		return(xTempMonitorRequest( CTRL_TEMP_START_REQ ));
+	}
+
+	if( pxCmd != NULL && pxCmd->pxHandler == xCmdTempStop )
+	{
+		return(xTempMonitorRequest( CTRL_TEMP_STOP_REQ ));
+	}
+
+	if( pxCmd != NULL && pxCmd->pxHandler == xCmdTempShow )
+	{
+		return(xCmdTempShow( pxArg, pxQuit ));
+	}
+
+	return(pdFAIL);
+}
+/*******************************************************************************
+*   Procedure: xCmdScriptLed
+*
+*   Description: This function starts ("led on") or stops ("led off") toggling
+*   			 the LED from a script
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to "on" or "off"
+*   			pxQuit - A pointer to the quit flag of the script
+*
+*   Return: BaseType_t - pdPASS, or pdFAIL if the argument is neither
+*
+*******************************************************************************/
+BaseType_t xCmdScriptLed(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	const Cmd_t* pxCmd = NULL;	// LED menu option given as argument
+
+	if( pxArg->eType == eCmdArgWord )
+	{
+		pxCmd = pxCmdFind( eCmdMenuLed, pxArg->pcWord, strlen(pxArg->pcWord) );
+	}
+
+	return( ( pxCmd != NULL ) ? pxCmd->pxHandler( pxArg, pxQuit ) : pdFAIL );
+}
+/*******************************************************************************
+*   Procedure: xCmdScriptHelp
+*
+*   Description: This function posts the list of the script commands
+*
+*   Notes: None
+*
+*   Parameters: pxArg - A pointer to the option argument (unused)
+*   			pxQuit - A pointer to the quit flag of the script (unused)
+*
+*   Return: BaseType_t - pdPASS
+*
+*******************************************************************************/
+BaseType_t xCmdScriptHelp(const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	vCmdPostMenu( eCmdMenuScript );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: ulParseFields
+*
+*   Description: This function reads numbers, not negative, separated by a
+*   			 character, e.g. "2026-10-16" with '-' or "08:00:00" with ':'.
+*
+*   Notes: Up to PARSE_MAX_FIELDS numbers can be read.
+*
+*   Parameters: pcText - A pointer to the NUL terminated text
+*   			cSeparator - The character between the numbers
+*   			plFields - A pointer to an array that will hold the numbers
+*   			ulMaxFields - The size of the array
+*
+*   Return: uint32_t - The number of numbers read, or 0 if the text is not made
+*   		of 1 to ulMaxFields numbers
+*
+*******************************************************************************/
+static uint32_t ulParseFields(const char* pcText, char cSeparator, int32_t* plFields, uint32_t ulMaxFields)
+{
+	Token_t xTokens[( 2 * PARSE_MAX_FIELDS ) - 1];		// Numbers and separators
+	size_t xNumTokens;									// Number of tokens in the text
+
+	if( ulMaxFields > PARSE_MAX_FIELDS )
+	{
+		ulMaxFields = PARSE_MAX_FIELDS;
+	}
+
+	// The numbers are the even tokens and the separators the odd ones
+	xNumTokens = xTokScan( pcText, xTokens, ( 2 * ulMaxFields ) - 1 );
+	if( xNumTokens == 0 || xNumTokens > ( 2 * ulMaxFields ) - 1 || ( xNumTokens % 2 ) == 0 )
+	{
+		return(0);
+	}
+
+	for( size_t i = 0; i < xNumTokens; i++ )
+	{
+		if( ( i % 2 ) == 1 )
+		{
+			if( xTokens[i].ucType != eTokSymbol || xTokens[i].llValue != cSeparator )
+			{
+				return(0);
+			}
+		}
+		else if( xTokGetInt32( &xTokens[i], &plFields[i / 2] ) != eTokOk || plFields[i / 2] < 0 )
+		{
+			return(0);
+		}
+	}
+
+	return( ( xNumTokens + 1 ) / 2 );
 }
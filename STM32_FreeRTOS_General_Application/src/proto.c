@@ -0,0 +1,408 @@
+/**
+  ******************************************************************************
+  * @file    proto.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Binary request/response protocol over the USART2 console. The
+  * 		 packets are framed with COBS (Consistent Overhead Byte Stuffing),
+  * 		 which removes every 0x00 from the packet so 0x00 can delimit the
+  * 		 frames. Packets are checked with a CRC-32 computed by the STM32
+  * 		 CRC unit. Responses are sent through the console like any other
+  * 		 output. See proto.h for the packet layout.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <string.h>
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "console.h"
+#include "console_in.h"
+#include "proto.h"
+
+// CONSTANTS
+
+// Bytes before the payload of a request (type, seq) and of a response (type, seq, status)
+#define PROTO_REQ_HEADER			2
+#define PROTO_RESP_HEADER			3
+
+// Bytes of the CRC at the end of a packet
+#define PROTO_CRC_SIZE				4
+
+// Largest decoded packet
+#define PROTO_MAX_PACKET			( PROTO_RESP_HEADER + PROTO_MAX_PAYLOAD + PROTO_CRC_SIZE )
+
+// Largest encoded packet. COBS adds one byte per 254 bytes, plus one
+#define PROTO_MAX_ENCODED			( PROTO_MAX_PACKET + ( PROTO_MAX_PACKET / 254 ) + 1 )
+
+// PROTOCOL GLOBALS
+
+// Number of packets dropped because of a bad encoding, length or CRC
+volatile uint32_t ulProtoFramesDropped = 0;
+
+// Bytes received since the last delimiter. A packet may arrive over several chunks
+static uint8_t ucProtoEncoded[PROTO_MAX_ENCODED];
+
+// Number of bytes in ucProtoEncoded
+static size_t xProtoEncodedLen = 0;
+
+// Set if the packet did not fit in ucProtoEncoded
+static BaseType_t xProtoOverflow = pdFALSE;
+
+// FUNCTION PROTOTYPES
+
+// To compute the CRC-32 of a packet with the CRC unit
+static uint32_t ulProtoCrc(const uint8_t* pucData, size_t xLen);
+
+// To COBS encode a packet
+static size_t xCobsEncode(const uint8_t* pucIn, size_t xLen, uint8_t* pucOut);
+
+// To decode a COBS encoded packet
+static size_t xCobsDecode(const uint8_t* pucIn, size_t xLen, uint8_t* pucOut, size_t xOutSize);
+
+// To check and decode a received packet into a request
+static BaseType_t xProtoParse(const uint8_t* pucEncoded, size_t xLen, ProtoFrame_t* pxReq);
+/*******************************************************************************
+*   Procedure: vProtoBegin
+*
+*   Description: This function starts the protocol mode. The decoder is reset
+*   			 and the console input is switched to raw so the bytes are
+*   			 passed on as they arrive.
+*
+*   Notes: Must only be called by the client holding the console focus.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vProtoBegin(void)
+{
+	// The CRC unit is hanging on AHB1 bus
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_CRC, ENABLE);
+
+	xProtoEncodedLen = 0;
+	xProtoOverflow = pdFALSE;
+
+	// Packets are not lines, so get the bytes as they arrive
+	vConsoleInSetRaw( pdTRUE );
+}
+/*******************************************************************************
+*   Procedure: xProtoFeed
+*
+*   Description: This function processes the bytes received in protocol mode.
+*   			 The bytes are collected till a 0x00 delimiter, then the packet
+*   			 is decoded and checked and the request is passed to the
+*   			 handler. Bad packets are dropped without a response, the host
+*   			 retries once it times out. PROTO_EXIT is answered here and ends
+*   			 the mode. A packet may be split over several calls.
+*
+*   Notes: It returns as soon as the bytes are processed, it never waits for
+*   	   more. The caller leaves the mode with vProtoEnd() if nothing is
+*   	   received for PROTO_IDLE_TIMEOUT_MS.
+*
+*   Parameters: pcChunk - A pointer to the bytes received
+*   			xLen - The number of bytes
+*   			pxHandler - The function answering the requests
+*
+*   Return: BaseType_t - pdTRUE once PROTO_EXIT is answered, the bytes after it
+*   		are dropped. Otherwise pdFALSE.
+*
+*******************************************************************************/
+BaseType_t xProtoFeed(const char* pcChunk, size_t xLen, ProtoHandler_t pxHandler)
+{
+	ProtoFrame_t xReq;		// Decoded request
+	uint8_t ucByte;			// Byte being processed
+
+	for( size_t i = 0; i < xLen; i++ )
+	{
+		ucByte = (uint8_t)pcChunk[i];
+
+		if( ucByte != 0x00 )
+		{
+			if( xProtoEncodedLen < sizeof(ucProtoEncoded) )
+			{
+				ucProtoEncoded[xProtoEncodedLen++] = ucByte;
+			}
+			else
+			{
+				xProtoOverflow = pdTRUE;
+			}
+
+			continue;
+		}
+
+		// A delimiter ends the packet. Empty packets come from back to back delimiters
+		if( xProtoEncodedLen > 0 )
+		{
+			if( xProtoOverflow == pdFALSE && xProtoParse( ucProtoEncoded, xProtoEncodedLen, &xReq ) == pdPASS )
+			{
+				if( xReq.ucType == PROTO_EXIT )
+				{
+					vProtoReply( &xReq, PROTO_OK, NULL, 0 );
+					xProtoEncodedLen = 0;
+					xProtoOverflow = pdFALSE;
+
+					return(pdTRUE);
+				}
+
+				pxHandler( &xReq );
+			}
+			else
+			{
+				ulProtoFramesDropped++;
+			}
+		}
+
+		xProtoEncodedLen = 0;
+		xProtoOverflow = pdFALSE;
+	}
+
+	return(pdFALSE);
+}
+/*******************************************************************************
+*   Procedure: vProtoEnd
+*
+*   Description: This function leaves the protocol mode. A packet partly
+*   			 received is dropped and the console input goes back to lines.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vProtoEnd(void)
+{
+	xProtoEncodedLen = 0;
+	xProtoOverflow = pdFALSE;
+
+	vConsoleInSetRaw( pdFALSE );
+}
+/*******************************************************************************
+*   Procedure: vProtoReply
+*
+*   Description: This function builds the response to a request, adds its CRC,
+*   			 COBS encodes it and posts it to the console between two 0x00
+*   			 delimiters.
+*
+*   Notes: Payloads longer than PROTO_MAX_PAYLOAD are truncated.
+*
+*   Parameters: pxReq - A pointer to the request answered
+*   			ucStatus - The status code of the response
+*   			pucPayload - A pointer to the payload, may be NULL if xLen is 0
+*   			xLen - The payload length
+*
+*   Return: None
+*
+*******************************************************************************/
+void vProtoReply(const ProtoFrame_t* pxReq, uint8_t ucStatus, const uint8_t* pucPayload, size_t xLen)
+{
+	uint8_t ucPacket[PROTO_MAX_PACKET];			// Decoded response
+	uint8_t ucFrame[PROTO_MAX_ENCODED + 2];		// Encoded response with its delimiters
+	size_t xFrameLen;							// Length of the encoded response
+	uint32_t ulCrc;								// CRC of the response
+
+	if( xLen > PROTO_MAX_PAYLOAD )
+	{
+		xLen = PROTO_MAX_PAYLOAD;
+	}
+
+	ucPacket[0] = pxReq->ucType | PROTO_RESPONSE_FLAG;
+	ucPacket[1] = pxReq->ucSeq;
+	ucPacket[2] = ucStatus;
+	if( xLen > 0 )
+	{
+		memcpy( &ucPacket[PROTO_RESP_HEADER], pucPayload, xLen );
+	}
+	xLen += PROTO_RESP_HEADER;
+
+	ulCrc = ulProtoCrc( ucPacket, xLen );
+	ucPacket[xLen++] = (uint8_t)ulCrc;
+	ucPacket[xLen++] = (uint8_t)( ulCrc >> 8 );
+	ucPacket[xLen++] = (uint8_t)( ulCrc >> 16 );
+	ucPacket[xLen++] = (uint8_t)( ulCrc >> 24 );
+
+	// The leading delimiter ends any text the host received before the response
+	ucFrame[0] = 0x00;
+	xFrameLen = 1 + xCobsEncode( ucPacket, xLen, &ucFrame[1] );
+	ucFrame[xFrameLen++] = 0x00;
+
+	vConsoleWrite( (const char*)ucFrame, xFrameLen, eConsoleBlock );
+}
+/*******************************************************************************
+*   Procedure: xProtoParse
+*
+*   Description: This function decodes a received packet, checks its length
+*   			 and its CRC, and copies its fields into a request.
+*
+*   Notes: None
+*
+*   Parameters: pucEncoded - A pointer to the encoded packet, without delimiters
+*   			xLen - The length of the encoded packet
+*   			pxReq - A pointer to the request to fill
+*
+*   Return: BaseType_t - pdPASS if the packet is valid, otherwise pdFAIL
+*
+*******************************************************************************/
+static BaseType_t xProtoParse(const uint8_t* pucEncoded, size_t xLen, ProtoFrame_t* pxReq)
+{
+	uint8_t ucPacket[PROTO_MAX_PACKET];		// Decoded packet
+	size_t xPacketLen;						// Length of the decoded packet
+	uint32_t ulCrc;							// CRC carried by the packet
+
+	xPacketLen = xCobsDecode( pucEncoded, xLen, ucPacket, sizeof(ucPacket) );
+
+	if( xPacketLen < PROTO_REQ_HEADER + PROTO_CRC_SIZE ||
+		xPacketLen > PROTO_REQ_HEADER + PROTO_MAX_PAYLOAD + PROTO_CRC_SIZE )
+	{
+		return(pdFAIL);
+	}
+
+	xPacketLen -= PROTO_CRC_SIZE;
+	ulCrc = (uint32_t)ucPacket[xPacketLen] | ( (uint32_t)ucPacket[xPacketLen + 1] << 8 ) |
+			( (uint32_t)ucPacket[xPacketLen + 2] << 16 ) | ( (uint32_t)ucPacket[xPacketLen + 3] << 24 );
+
+	if( ulCrc != ulProtoCrc( ucPacket, xPacketLen ) )
+	{
+		return(pdFAIL);
+	}
+
+	pxReq->ucType = ucPacket[0];
+	pxReq->ucSeq = ucPacket[1];
+	pxReq->ucLen = (uint8_t)( xPacketLen - PROTO_REQ_HEADER );
+	memcpy( pxReq->ucPayload, &ucPacket[PROTO_REQ_HEADER], pxReq->ucLen );
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: ulProtoCrc
+*
+*   Description: This function computes the CRC-32 of a packet with the CRC
+*   			 unit. The unit takes 32-bit words, so the bytes are fed as
+*   			 little-endian words and the last word is padded with zeros.
+*
+*   Notes: The CRC unit is not shared, only the protocol mode uses it.
+*
+*   Parameters: pucData - A pointer to the packet
+*   			xLen - The length of the packet
+*
+*   Return: uint32_t - The CRC
+*
+*******************************************************************************/
+static uint32_t ulProtoCrc(const uint8_t* pucData, size_t xLen)
+{
+	uint32_t ulWord;	// Next word fed to the CRC unit
+
+	CRC_ResetDR();
+
+	while( xLen > 0 )
+	{
+		ulWord = 0;
+		memcpy( &ulWord, pucData, ( xLen < 4 ) ? xLen : 4 );
+		CRC_CalcCRC( ulWord );
+
+		pucData += ( xLen < 4 ) ? xLen : 4;
+		xLen -= ( xLen < 4 ) ? xLen : 4;
+	}
+
+	return( CRC_GetCRC() );
+}
+/*******************************************************************************
+*   Procedure: xCobsEncode
+*
+*   Description: This function COBS encodes a packet. Each run of non-zero
+*   			 bytes is preceded by a code byte giving its length plus one,
+*   			 and the zero ending the run is dropped. Runs are at most 254
+*   			 bytes long.
+*
+*   Notes: The output buffer must hold xLen + xLen / 254 + 1 bytes.
+*
+*   Parameters: pucIn - A pointer to the packet
+*   			xLen - The length of the packet
+*   			pucOut - A pointer to the output buffer
+*
+*   Return: size_t - The length of the encoded packet
+*
+*******************************************************************************/
+static size_t xCobsEncode(const uint8_t* pucIn, size_t xLen, uint8_t* pucOut)
+{
+	size_t xOut = 1;		// Next free byte of the output
+	size_t xCode = 0;		// Position of the code byte of the current run
+	uint8_t ucRun = 1;		// Length of the current run plus one
+
+	for( size_t i = 0; i < xLen; i++ )
+	{
+		if( pucIn[i] != 0x00 )
+		{
+			pucOut[xOut++] = pucIn[i];
+			ucRun++;
+		}
+
+		if( pucIn[i] == 0x00 || ucRun == 0xFF )
+		{
+			// Close the run and start a new one
+			pucOut[xCode] = ucRun;
+			xCode = xOut++;
+			ucRun = 1;
+		}
+	}
+
+	pucOut[xCode] = ucRun;
+
+	return(xOut);
+}
+/*******************************************************************************
+*   Procedure: xCobsDecode
+*
+*   Description: This function decodes a COBS encoded packet.
+*
+*   Notes: None
+*
+*   Parameters: pucIn - A pointer to the encoded packet, without delimiters
+*   			xLen - The length of the encoded packet
+*   			pucOut - A pointer to the output buffer
+*   			xOutSize - The size of the output buffer
+*
+*   Return: size_t - The length of the decoded packet, 0 if the encoding is
+*   		invalid or the packet does not fit
+*
+*******************************************************************************/
+static size_t xCobsDecode(const uint8_t* pucIn, size_t xLen, uint8_t* pucOut, size_t xOutSize)
+{
+	size_t xIn = 0;			// Next byte of the input
+	size_t xOut = 0;		// Next free byte of the output
+	uint8_t ucCode;			// Code byte of the current run
+
+	while( xIn < xLen )
+	{
+		ucCode = pucIn[xIn++];
+
+		if( ucCode == 0x00 || xIn + ucCode - 1 > xLen || xOut + ucCode - 1 > xOutSize )
+		{
+			return(0);
+		}
+
+		for( uint8_t i = 1; i < ucCode; i++ )
+		{
+			pucOut[xOut++] = pucIn[xIn++];
+		}
+
+		// A run shorter than 254 bytes was ended by a zero, unless it is the last one
+		if( ucCode != 0xFF && xIn < xLen )
+		{
+			if( xOut >= xOutSize )
+			{
+				return(0);
+			}
+
+			pucOut[xOut++] = 0x00;
+		}
+	}
+
+	return(xOut);
+}
@@ -0,0 +1,419 @@
+/**
+  ******************************************************************************
+  * @file    timebase.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Monotonic time base built on the DWT cycle counter. The 32-bit
+  * 		 count is extended to 64 bits by counting its wraparounds, which
+  * 		 only needs it to be read once per wraparound (268 seconds at
+  * 		 16 MHz), and the RTC wakeup interrupt reads it every second.
+  *
+  * 		 A timestamp is the time of an anchor plus the cycles since the
+  * 		 anchor times the length of a cycle. At each synchronization the
+  * 		 anchor moves to the current cycle count, and the length of a cycle
+  * 		 is set to the average measured against the RTC over up to a
+  * 		 minute, plus a correction removing a part of the difference from
+  * 		 the RTC over the next second. The timestamps never go back, while
+  * 		 the wall clock offset follows the RTC when its time is set. If the
+  * 		 core clock was stopped, e.g. in STOP mode, the time base is moved
+  * 		 forward by the time the RTC counted meanwhile.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timebase.h"
+
+// CONSTANTS
+
+// Fraction bits of the length of a cycle
+#define TIMEBASE_SCALE_BITS			16
+
+// Shortest and longest time the length of a cycle is measured over
+#define TIMEBASE_RATE_MIN_NS		( 2 * TIMEBASE_NS_PER_SECOND )
+#define TIMEBASE_RATE_MAX_NS		( 64 * TIMEBASE_NS_PER_SECOND )
+
+// Part of the difference from the RTC removed over the next second (1 / 4)
+#define TIMEBASE_PHASE_GAIN			4
+
+// Largest correction of the length of a cycle (1 / 64 of it)
+#define TIMEBASE_SLEW_LIMIT			64
+
+// TIMEBASE GLOBALS
+
+// Cycle counter, extended to 64 bits
+static uint32_t ulCyclesLast = 0;
+static uint32_t ulCyclesHigh = 0;
+
+// Anchor: a cycle count and its timestamp
+static uint64_t ullAnchorCycles = 0;
+static uint64_t ullAnchorNs = 0;
+
+// Length of a cycle used from the anchor on, in nanoseconds with TIMEBASE_SCALE_BITS fraction bits
+static uint32_t ulScale = 0;
+
+// Length of a cycle measured against the RTC, and the core clock it is for
+static uint32_t ulRateScale = 0;
+static uint32_t ulRateClock = 0;
+
+// Start of the measurement: a cycle count and the RTC time
+static uint64_t ullBaseCycles = 0;
+static uint64_t ullBaseRtcNs = 0;
+
+// Wall clock time minus the timestamp, in nanoseconds
+static int64_t llWallOffset = 0;
+
+// Latest timestamp taken, so none goes back
+static uint64_t ullLastNs = 0;
+
+// Set when the RTC date or time was set
+static volatile BaseType_t xResyncPending = pdTRUE;
+
+// pdTRUE while a task sets the RTC date or time
+static volatile BaseType_t xRtcSetting = pdFALSE;
+
+// Set while synchronizing after the core clock was stopped
+static BaseType_t xClockStopped = pdFALSE;
+
+// FUNCTION PROTOTYPES
+
+// To read the cycle counter extended to 64 bits
+static uint64_t ullTimebaseCycles(void);
+
+// To get the timestamp of a cycle count
+static uint64_t ullTimebaseStamp(uint64_t ullCycles);
+
+// To synchronize the time base with the RTC
+static void vTimebaseSync(uint64_t ullRtcNs);
+/*******************************************************************************
+*   Procedure: vTimebaseInit
+*
+*   Description: This function starts the DWT cycle counter, sets the length of
+*   			 a cycle from the core clock and synchronizes the time base
+*   			 with the RTC, so wall clock times are valid at once
+*
+*   Notes: Must be called before the scheduler is started, once the RTC is set
+*   	   up.
+*
+*   Parameters: ullRtcNs - The RTC time, in nanoseconds of Unix time
+*
+*   Return: None
+*
+*******************************************************************************/
+void vTimebaseInit(uint64_t ullRtcNs)
+{
+	// The DWT is only counting if trace is enabled
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	ulCyclesLast = DWT->CYCCNT;
+	ulCyclesHigh = 0;
+	ullAnchorCycles = ullTimebaseCycles();
+	ullAnchorNs = 0;
+	ullLastNs = 0;
+	ulRateClock = 0;
+
+	vTimebaseSync( ullRtcNs );
+}
+/*******************************************************************************
+*   Procedure: ullTimebaseNow
+*
+*   Description: This function takes a timestamp, the nanoseconds since the time
+*   			 base was started. It reads the DWT cycle counter only.
+*
+*   Notes: Can be called from tasks and from interrupts up to
+*   	   configMAX_SYSCALL_INTERRUPT_PRIORITY. Two timestamps taken one after
+*   	   the other are never in the wrong order.
+*
+*   Parameters: None
+*
+*   Return: uint64_t - The timestamp
+*
+*******************************************************************************/
+uint64_t ullTimebaseNow(void)
+{
+	UBaseType_t uxSavedMask;	// Interrupt mask to restore
+	uint64_t ullNs;				// Timestamp
+
+	uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+	ullNs = ullTimebaseStamp( ullTimebaseCycles() );
+	if( ullNs < ullLastNs )
+	{
+		ullNs = ullLastNs;
+	}
+	ullLastNs = ullNs;
+
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+
+	return(ullNs);
+}
+/*******************************************************************************
+*   Procedure: ullTimebaseToWall
+*
+*   Description: This function converts a timestamp to the wall clock time, in
+*   			 nanoseconds of Unix time on the RTC
+*
+*   Notes: Uses the offset of the latest synchronization, so a timestamp taken
+*   	   before the RTC was set is converted with the new time.
+*
+*   Parameters: ullStamp - The timestamp
+*
+*   Return: uint64_t - The wall clock time
+*
+*******************************************************************************/
+uint64_t ullTimebaseToWall(uint64_t ullStamp)
+{
+	UBaseType_t uxSavedMask;	// Interrupt mask to restore
+	int64_t llOffset;			// Wall clock offset
+
+	uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+	llOffset = llWallOffset;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+
+	return( ullStamp + (uint64_t)llOffset );
+}
+/*******************************************************************************
+*   Procedure: vTimebaseSyncFromISR
+*
+*   Description: This function synchronizes the time base with the RTC
+*
+*   Notes: Called from the RTC wakeup interrupt, once a second, with the RTC
+*   	   time read at the start of the second. The RTC time is then exact,
+*   	   instead of rounded down to a step of the sub-second counter, and
+*   	   the cycle counter is read well within each of its wraparounds.
+*
+*   Parameters: ullRtcNs - The RTC time, in nanoseconds of Unix time
+*
+*   Return: None
+*
+*******************************************************************************/
+void vTimebaseSyncFromISR(uint64_t ullRtcNs)
+{
+	UBaseType_t uxSavedMask;	// Interrupt mask to restore
+
+	uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+	vTimebaseSync( ullRtcNs );
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+}
+/*******************************************************************************
+*   Procedure: vTimebaseResume
+*
+*   Description: This function synchronizes the time base with the RTC once the
+*   			 core clock runs again, moving it forward by the time the RTC
+*   			 counted meanwhile, however short
+*
+*   Notes: Called on leaving STOP mode, before the interrupts are enabled again.
+*   	   The RTC time is read at any point of the second, so it should be
+*   	   given in the middle of the sub-second step read.
+*
+*   Parameters: ullRtcNs - The RTC time, in nanoseconds of Unix time
+*
+*   Return: None
+*
+*******************************************************************************/
+void vTimebaseResume(uint64_t ullRtcNs)
+{
+	UBaseType_t uxSavedMask;	// Interrupt mask to restore
+
+	uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+	xClockStopped = pdTRUE;
+	vTimebaseSync( ullRtcNs );
+	xClockStopped = pdFALSE;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+}
+/*******************************************************************************
+*   Procedure: vTimebaseResyncBegin
+*
+*   Description: This function makes the synchronizations take the RTC time as
+*   			 it is, instead of slewing towards it or counting the
+*   			 difference as time the core clock was stopped, till
+*   			 vTimebaseResyncEnd() is called and one more synchronization
+*   			 has run
+*
+*   Notes: Called before the RTC date or time is set, so that a
+*   	   synchronization run between the writes of the RTC does not take a
+*   	   clock set forward for a stopped core clock.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vTimebaseResyncBegin(void)
+{
+	xRtcSetting = pdTRUE;
+	xResyncPending = pdTRUE;
+}
+/*******************************************************************************
+*   Procedure: vTimebaseResyncEnd
+*
+*   Description: This function makes the next synchronization take the RTC time
+*   			 as it is for the last time
+*
+*   Notes: Called once the RTC date or time is set.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vTimebaseResyncEnd(void)
+{
+	xResyncPending = pdTRUE;
+	xRtcSetting = pdFALSE;
+}
+/*******************************************************************************
+*   Procedure: ullTimebaseCycles
+*
+*   Description: This function reads the DWT cycle counter and extends it to 64
+*   			 bits, counting a wraparound each time it reads less than the
+*   			 last time
+*
+*   Notes: Called with interrupts masked.
+*
+*   Parameters: None
+*
+*   Return: uint64_t - The cycles counted
+*
+*******************************************************************************/
+static uint64_t ullTimebaseCycles(void)
+{
+	uint32_t ulCycles = DWT->CYCCNT;	// Cycle counter
+
+	if( ulCycles < ulCyclesLast )
+	{
+		ulCyclesHigh++;
+	}
+	ulCyclesLast = ulCycles;
+
+	return( ( (uint64_t)ulCyclesHigh << 32 ) | ulCycles );
+}
+/*******************************************************************************
+*   Procedure: ullTimebaseStamp
+*
+*   Description: This function returns the timestamp of a cycle count: the time
+*   			 of the anchor plus the cycles since the anchor times the
+*   			 length of a cycle
+*
+*   Notes: Called with interrupts masked. The product is split in two, so it
+*   	   does not overflow for any count of cycles since the anchor below
+*   	   2^40.
+*
+*   Parameters: ullCycles - The cycle count, not before the anchor
+*
+*   Return: uint64_t - The timestamp
+*
+*******************************************************************************/
+static uint64_t ullTimebaseStamp(uint64_t ullCycles)
+{
+	uint64_t ullDelta = ullCycles - ullAnchorCycles;	// Cycles since the anchor
+	uint64_t ullNs;										// Nanoseconds since the anchor
+
+	ullNs = ( ullDelta >> TIMEBASE_SCALE_BITS ) * ulScale;
+	ullNs += ( ( ullDelta & ( ( 1UL << TIMEBASE_SCALE_BITS ) - 1 ) ) * ulScale ) >> TIMEBASE_SCALE_BITS;
+
+	return( ullAnchorNs + ullNs );
+}
+/*******************************************************************************
+*   Procedure: vTimebaseSync
+*
+*   Description: This function compares the time base with the RTC:
+*   			 - After vTimebaseInit(), and from vTimebaseResyncBegin() to
+*   			   vTimebaseResyncEnd(), the wall clock offset is set from the
+*   			   RTC.
+*   			 - From vTimebaseResume(), the time base is moved forward by
+*   			   any time it is behind the RTC.
+*   			 - If the time base is behind the RTC by more than
+*   			   TIMEBASE_STEP_NS, the core clock was stopped and the time base
+*   			   is moved forward. If it is ahead by as much, the RTC was set
+*   			   back and the wall clock offset is set again.
+*   			 - Otherwise the length of a cycle is measured over the last
+*   			   minute, and corrected to remove a quarter of the difference
+*   			   over the next second.
+*
+*   Notes: Called with interrupts masked. The interrupt may be served late by
+*   	   up to the longest critical section, so the rate is only measured
+*   	   over 2 seconds or more, and more precisely as the measurement goes
+*   	   on.
+*
+*   Parameters: ullRtcNs - The RTC time, in nanoseconds of Unix time
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTimebaseSync(uint64_t ullRtcNs)
+{
+	uint64_t ullCycles = ullTimebaseCycles();			// Cycles counted
+	uint64_t ullNs;										// Timestamp now
+	int64_t llError;									// RTC time minus the wall clock time of the time base
+	int64_t llCorrection;								// Correction of the length of a cycle
+	int64_t llLimit;									// Largest correction allowed
+
+	// Move the anchor to now, so a new length of a cycle only applies from now on
+	ullNs = ullTimebaseStamp( ullCycles );
+	ullAnchorCycles = ullCycles;
+	ullAnchorNs = ullNs;
+
+	// Start from the nominal length of a cycle if the core clock changed
+	if( ulRateClock != SystemCoreClock )
+	{
+		ulRateClock = SystemCoreClock;
+		ulRateScale = (uint32_t)( ( TIMEBASE_NS_PER_SECOND << TIMEBASE_SCALE_BITS ) / ulRateClock );
+		ulScale = ulRateScale;
+		ullBaseCycles = ullCycles;
+		ullBaseRtcNs = ullRtcNs;
+	}
+
+	llError = (int64_t)( ullRtcNs - ullNs ) - llWallOffset;
+
+	if( xResyncPending == pdTRUE || xClockStopped == pdTRUE || llError > TIMEBASE_STEP_NS || llError < -TIMEBASE_STEP_NS )
+	{
+		if( xResyncPending == pdFALSE && llError > 0 )
+		{
+			// The core clock was stopped while the RTC counted
+			ullAnchorNs += llError;
+		}
+		else if( xResyncPending == pdTRUE || xClockStopped == pdFALSE )
+		{
+			llWallOffset = (int64_t)( ullRtcNs - ullNs );
+		}
+
+		// The RTC may be written again till vTimebaseResyncEnd()
+		xResyncPending = xRtcSetting;
+		ulScale = ulRateScale;
+		ullBaseCycles = ullCycles;
+		ullBaseRtcNs = ullRtcNs;
+		return;
+	}
+
+	// Average length of a cycle since the start of the measurement
+	if( ullRtcNs - ullBaseRtcNs >= TIMEBASE_RATE_MIN_NS && ullCycles > ullBaseCycles )
+	{
+		ulRateScale = (uint32_t)( ( ( ullRtcNs - ullBaseRtcNs ) << TIMEBASE_SCALE_BITS ) / ( ullCycles - ullBaseCycles ) );
+
+		if( ullRtcNs - ullBaseRtcNs >= TIMEBASE_RATE_MAX_NS )
+		{
+			ullBaseCycles = ullCycles;
+			ullBaseRtcNs = ullRtcNs;
+		}
+	}
+
+	// Remove a part of the difference over the next second, as the rate allows
+	llCorrection = ( llError << TIMEBASE_SCALE_BITS ) / ( (int64_t)TIMEBASE_PHASE_GAIN * ulRateClock );
+	llLimit = ulRateScale / TIMEBASE_SLEW_LIMIT;
+	if( llCorrection > llLimit )
+	{
+		llCorrection = llLimit;
+	}
+	else if( llCorrection < -llLimit )
+	{
+		llCorrection = -llLimit;
+	}
+
+	ulScale = (uint32_t)( ulRateScale + llCorrection );
+}
@@ -0,0 +1,334 @@
+/**
+  ******************************************************************************
+  * @file    tok.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Tokenizer for the lines typed by the user. Each character of the
+  * 		 line is looked at once. Digits are gathered into an unsigned 64-bit
+  * 		 magnitude with an overflow check before each step, so a value
+  * 		 too large is flagged rather than wrapped. A '+' or '-' is the sign
+  * 		 of a number when it starts the line or follows a symbol, so
+  * 		 "5 - -3" gives 5, '-' and -3, and "2026-10-16" gives 2026, '-', 10,
+  * 		 '-' and 16.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include "tok.h"
+
+// CONSTANTS
+
+// Largest number of digits after the point of a fixed-point decimal
+#define TOK_MAX_DECIMALS			18
+
+// Largest magnitude which can take one more decimal digit, and the largest digit
+// it can take. Constants, so the Cortex-M4 needs no 64-bit division per digit
+#define TOK_DEC_LIMIT				( UINT64_MAX / 10 )
+#define TOK_DEC_LIMIT_DIGIT			( UINT64_MAX % 10 )
+
+// FUNCTION PROTOTYPES
+
+// To get the value of a digit in any base up to 36
+static uint32_t ulTokDigit(char c);
+
+// To check if a character can be part of a word
+static int lTokIsWordChar(char c);
+/*******************************************************************************
+*   Procedure: xTokScan
+*
+*   Description: This function splits a line into tokens in one scan. Spaces
+*   			 and tabs separate tokens and are dropped. A number starts with
+*   			 a digit, or with a sign in front of a digit when no number or
+*   			 word comes before it. "0x" starts a hexadecimal number and "0b"
+*   			 a binary number. A decimal number with a point followed by
+*   			 digits is a fixed-point decimal. A number followed directly by
+*   			 a letter is malformed.
+*
+*   Notes: The tokens point into the line, which must remain valid.
+*
+*   Parameters: pcLine - A pointer to the NUL terminated line
+*   			pxTokens - A pointer to an array that will hold the tokens
+*   			xMaxTokens - The size of the array. Tokens beyond it are counted
+*   			but not stored
+*
+*   Return: size_t - The number of tokens in the line
+*
+*******************************************************************************/
+size_t xTokScan(const char* pcLine, Token_t* pxTokens, size_t xMaxTokens)
+{
+	Token_t xToken;						// Token being scanned
+	const char* pcNext = pcLine;		// Next character to scan
+	size_t xNumTokens = 0;				// Number of tokens found
+	uint8_t ucLastType = eTokSymbol;	// Type of the previous token
+	uint64_t ullMag;					// Magnitude of a number
+	uint32_t ulBase;					// Base of a number
+	uint32_t ulDigit;					// Value of a digit
+	uint32_t ulNumDigits;				// Number of digits of a number
+	uint64_t ullLimit;					// Largest magnitude which can take one more digit
+	uint32_t ulLimitDigit;				// Largest digit ullLimit can take
+	int lNegative;						// Set if a number has a '-' sign
+
+	while( *pcNext != '\0' )
+	{
+		if( *pcNext == ' ' || *pcNext == '\t' )
+		{
+			pcNext++;
+			continue;
+		}
+
+		xToken.pcText = pcNext;
+		xToken.llValue = 0;
+		xToken.ucError = eTokOk;
+		xToken.ucDecimals = 0;
+
+		lNegative = 0;
+		if( ( *pcNext == '-' || *pcNext == '+' ) && ucLastType == eTokSymbol &&
+			pcNext[1] >= '0' && pcNext[1] <= '9' )
+		{
+			lNegative = ( *pcNext == '-' );
+			pcNext++;
+		}
+
+		if( *pcNext >= '0' && *pcNext <= '9' )
+		{
+			xToken.ucType = eTokNumber;
+			ullMag = 0;
+			ulBase = 10;
+			ulNumDigits = 0;
+
+			if( pcNext[0] == '0' && ( pcNext[1] == 'x' || pcNext[1] == 'X' ) )
+			{
+				ulBase = 16;
+				pcNext += 2;
+			}
+			else if( pcNext[0] == '0' && ( pcNext[1] == 'b' || pcNext[1] == 'B' ) )
+			{
+				ulBase = 2;
+				pcNext += 2;
+			}
+
+			// Hexadecimal and binary digits shift the magnitude, so any digit fits below the limit
+			ullLimit = ( ulBase == 10 ) ? TOK_DEC_LIMIT : ( UINT64_MAX >> ( ( ulBase == 16 ) ? 4 : 1 ) );
+			ulLimitDigit = ( ulBase == 10 ) ? TOK_DEC_LIMIT_DIGIT : ( ulBase - 1 );
+
+			while( ( ulDigit = ulTokDigit( *pcNext ) ) < ulBase )
+			{
+				if( ullMag > ullLimit || ( ullMag == ullLimit && ulDigit > ulLimitDigit ) )
+				{
+					xToken.ucError = eTokOverflow;
+				}
+
+				ullMag = ( ullMag * ulBase ) + ulDigit;
+				ulNumDigits++;
+				pcNext++;
+			}
+
+			// Fraction of a fixed-point decimal, scaled into the magnitude
+			if( ulBase == 10 && pcNext[0] == '.' && pcNext[1] >= '0' && pcNext[1] <= '9' )
+			{
+				xToken.ucType = eTokFixed;
+				pcNext++;
+
+				while( *pcNext >= '0' && *pcNext <= '9' )
+				{
+					ulDigit = *pcNext++ - '0';
+					if( ullMag > TOK_DEC_LIMIT || ( ullMag == TOK_DEC_LIMIT && ulDigit > TOK_DEC_LIMIT_DIGIT ) ||
+						xToken.ucDecimals == TOK_MAX_DECIMALS )
+					{
+						xToken.ucError = eTokOverflow;
+					}
+
+					ullMag = ( ullMag * 10 ) + ulDigit;
+					xToken.ucDecimals++;
+				}
+			}
+
+			if( ulNumDigits == 0 || lTokIsWordChar( *pcNext ) || *pcNext == '.' )
+			{
+				xToken.ucError = eTokMalformed;
+				while( lTokIsWordChar( *pcNext ) || *pcNext == '.' )
+				{
+					pcNext++;
+				}
+			}
+
+			// A negative value can be one larger than a positive one
+			if( xToken.ucError == eTokOk && ullMag > (uint64_t)INT64_MAX + (uint64_t)lNegative )
+			{
+				xToken.ucError = eTokOverflow;
+			}
+
+			if( xToken.ucError == eTokOk )
+			{
+				xToken.llValue = ( lNegative != 0 ) ? (int64_t)( 0 - ullMag ) : (int64_t)ullMag;
+			}
+		}
+		else if( lTokIsWordChar( *pcNext ) )
+		{
+			xToken.ucType = eTokWord;
+			while( lTokIsWordChar( *pcNext ) )
+			{
+				pcNext++;
+			}
+		}
+		else
+		{
+			xToken.ucType = eTokSymbol;
+			xToken.llValue = (uint8_t)*pcNext++;
+		}
+
+		xToken.ucLen = ( pcNext - xToken.pcText > UINT8_MAX ) ? UINT8_MAX : (uint8_t)( pcNext - xToken.pcText );
+		ucLastType = xToken.ucType;
+
+		if( xNumTokens < xMaxTokens )
+		{
+			pxTokens[xNumTokens] = xToken;
+		}
+
+		xNumTokens++;
+	}
+
+	return(xNumTokens);
+}
+/*******************************************************************************
+*   Procedure: xTokGetInt32
+*
+*   Description: This function reads the value of an integer token as an int32
+*
+*   Notes: None
+*
+*   Parameters: pxToken - A pointer to the token
+*   			plValue - A pointer to a location that will hold the value. It is
+*   			only written if no error is returned
+*
+*   Return: TokError_t - eTokOk, the error found in the number, eTokNotInteger
+*   		if the token is not an integer or eTokRange if it does not fit
+*
+*******************************************************************************/
+TokError_t xTokGetInt32(const Token_t* pxToken, int32_t* plValue)
+{
+	if( pxToken->ucType != eTokNumber && pxToken->ucType != eTokFixed )
+	{
+		return(eTokNotInteger);
+	}
+
+	if( pxToken->ucError != eTokOk )
+	{
+		return( (TokError_t)pxToken->ucError );
+	}
+
+	if( pxToken->ucType == eTokFixed )
+	{
+		return(eTokNotInteger);
+	}
+
+	if( pxToken->llValue < INT32_MIN || pxToken->llValue > INT32_MAX )
+	{
+		return(eTokRange);
+	}
+
+	*plValue = (int32_t)pxToken->llValue;
+
+	return(eTokOk);
+}
+/*******************************************************************************
+*   Procedure: xTokLineToInt32
+*
+*   Description: This function reads a line which must hold a single integer,
+*   			 e.g. a reply to a prompt, as an int32
+*
+*   Notes: None
+*
+*   Parameters: pcLine - A pointer to the NUL terminated line
+*   			plValue - A pointer to a location that will hold the value. It is
+*   			only written if no error is returned
+*
+*   Return: TokError_t - eTokOk, or the reason the line is not an int32
+*
+*******************************************************************************/
+TokError_t xTokLineToInt32(const char* pcLine, int32_t* plValue)
+{
+	Token_t xToken;		// Only token expected
+
+	if( xTokScan( pcLine, &xToken, 1 ) != 1 )
+	{
+		return(eTokNotInteger);
+	}
+
+	return( xTokGetInt32( &xToken, plValue ) );
+}
+/*******************************************************************************
+*   Procedure: pcTokErrorText
+*
+*   Description: This function returns the description of an error for the
+*   			 user
+*
+*   Notes: None
+*
+*   Parameters: xError - The error
+*
+*   Return: const char* - A pointer to the description
+*
+*******************************************************************************/
+const char* pcTokErrorText(TokError_t xError)
+{
+	switch( xError )
+	{
+		case eTokOk:			return("No error");
+		case eTokOverflow:		return("Number too large");
+		case eTokMalformed:		return("Malformed number");
+		case eTokNotInteger:	return("An integer is expected");
+		case eTokRange:			return("Number out of range");
+		default:				return("Unknown error");
+	}
+}
+/*******************************************************************************
+*   Procedure: ulTokDigit
+*
+*   Description: This function returns the value of a digit: 0 to 9 for '0' to
+*   			 '9' and 10 to 35 for the letters, in either case.
+*
+*   Notes: None
+*
+*   Parameters: c - The character
+*
+*   Return: uint32_t - The value of the digit, or 36 if the character is not one
+*
+*******************************************************************************/
+static uint32_t ulTokDigit(char c)
+{
+	if( c >= '0' && c <= '9' )
+	{
+		return( c - '0' );
+	}
+
+	if( c >= 'a' && c <= 'z' )
+	{
+		return( c - 'a' + 10 );
+	}
+
+	if( c >= 'A' && c <= 'Z' )
+	{
+		return( c - 'A' + 10 );
+	}
+
+	return(36);
+}
+/*******************************************************************************
+*   Procedure: lTokIsWordChar
+*
+*   Description: This function checks if a character can be part of a word
+*
+*   Notes: None
+*
+*   Parameters: c - The character
+*
+*   Return: int - Non-zero for a letter, a digit or '_'
+*
+*******************************************************************************/
+static int lTokIsWordChar(char c)
+{
+	return( ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || ( c >= '0' && c <= '9' ) || c == '_' );
+}
@@ -0,0 +1,989 @@
+/**
+  ******************************************************************************
+  * @file    uart_driver.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   USART2 console driver. USART2 TX is served by one of two backends
+  * 		 selected at build time with UART_TX_BACKEND:
+  * 		 - DMA: a task calling vUartWrite() hands the message to DMA1
+  * 		   Stream6 (Channel 4) and then sleeps on a task notification which
+  * 		   is given by the DMA transfer complete interrupt.
+  * 		 - IRQ: vUartWrite() copies the message into a software ring and
+  * 		   enables the TXE interrupt. The interrupt feeds UART2 one byte at
+  * 		   a time and notifies the task once the ring has room again or is
+  * 		   empty. No DMA stream is used.
+  * 		 Either way the CPU is free to run other tasks while the message is
+  * 		 shifted out, instead of spinning on the TXE flag for every byte.
+  * 		 USART2 RX always uses DMA1 Stream5 (Channel 4) in circular mode.
+  * 		 A reader sleeps on a binary semaphore which is given by the USART2
+  * 		 idle line interrupt at the end of each burst of input, and by the
+  * 		 DMA half and full transfer interrupts during long bursts.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <string.h>
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "uart_driver.h"
+#include "ram_budget.h"
+
+// CONSTANTS
+
+// Default console baud rate
+#define UART_BAUD_RATE				115200
+
+// Lowest console baud rate accepted
+#define UART_MIN_BAUD_RATE			1200
+
+// Largest baud rate error accepted, in tenths of a percent
+#define UART_MAX_BAUD_ERROR			25
+
+// RTC backup registers holding the saved baud rate and its complement
+#define UART_BAUD_BKP_REG			RTC_BKP_DR0
+#define UART_BAUD_CHECK_BKP_REG		RTC_BKP_DR1
+
+// DMA stream and channel wired to USART2 RX
+#define UART_RX_DMA_STREAM			DMA1_Stream5
+#define UART_RX_DMA_CHANNEL			DMA_Channel_4
+#define UART_RX_DMA_IRQ				DMA1_Stream5_IRQn
+
+#if UART_TX_BACKEND == UART_TX_BACKEND_DMA
+
+// Largest number of bytes a single DMA transfer can move (NDTR is 16 bits)
+#define UART_DMA_MAX_XFER			0xFFFF
+
+// DMA stream and channel wired to USART2 TX
+#define UART_TX_DMA_STREAM			DMA1_Stream6
+#define UART_TX_DMA_CHANNEL			DMA_Channel_4
+#define UART_TX_DMA_IRQ				DMA1_Stream6_IRQn
+#define UART_TX_DMA_FLAGS			( DMA_FLAG_TCIF6 | DMA_FLAG_HTIF6 | DMA_FLAG_TEIF6 | \
+									  DMA_FLAG_DMEIF6 | DMA_FLAG_FEIF6 )
+
+#elif UART_TX_BACKEND == UART_TX_BACKEND_IRQ
+
+#if ( UART_TX_RING_SIZE & ( UART_TX_RING_SIZE - 1 ) ) != 0
+#error UART_TX_RING_SIZE must be a power of 2
+#endif
+
+#else
+#error Unknown UART_TX_BACKEND
+#endif
+
+// DRIVER GLOBALS
+
+// Task waiting for the current transfer to complete
+static TaskHandle_t xUartTxWaitingTask = NULL;
+
+#if UART_TX_BACKEND == UART_TX_BACKEND_IRQ
+// Transmit ring. The head is only moved by vUartWrite() and the tail only by the TXE interrupt
+static char cUartTxRing[UART_TX_RING_SIZE];
+static volatile uint32_t ulUartTxHead = 0;
+static volatile uint32_t ulUartTxTail = 0;
+
+// The waiting task is notified once no more than this number of bytes are left in the ring
+static volatile uint32_t ulUartTxWakeLevel = 0;
+#endif
+
+// Circular buffer written by DMA1 Stream5. The tail is the index of the next byte to read
+static uint8_t ucUartRxBuf[UART_RX_BUF_SIZE];
+static uint32_t ulUartRxTail = 0;
+
+// Given from the interrupts whenever new bytes have been received, and its storage
+static SemaphoreHandle_t xUartRxSemaphore = NULL;
+static StaticSemaphore_t xUartRxSemaphoreBuffer;
+
+// Set by vUartReadAbortFromISR() to make the reader return without a byte
+static volatile BaseType_t xUartRxAbort = pdFALSE;
+
+// Current console baud rate
+static uint32_t ulUartBaudRate = UART_BAUD_RATE;
+
+// Transmit statistics
+volatile uint32_t ulUartTxCpuCycles = 0;
+volatile uint32_t ulUartTxBytes = 0;
+
+#if UART_TX_BACKEND == UART_TX_BACKEND_IRQ
+RAM_BUDGET_CHECK( sizeof(ucUartRxBuf) + sizeof(xUartRxSemaphoreBuffer) + sizeof(cUartTxRing), RAM_BUDGET_UART );
+#else
+RAM_BUDGET_CHECK( sizeof(ucUartRxBuf) + sizeof(xUartRxSemaphoreBuffer), RAM_BUDGET_UART );
+#endif
+
+// FUNCTION PROTOTYPES
+
+#if UART_TX_BACKEND == UART_TX_BACKEND_DMA
+// To setup the DMA stream used to transmit via UART2
+static void vUartDmaSetup(void);
+#else
+// To feed UART2 from the transmit ring
+static void vUartTxFromISR(BaseType_t* pxHigherPriorityTaskWoken);
+#endif
+
+// To setup the DMA stream used to receive via UART2
+static void vUartRxDmaSetup(void);
+
+// To get the index of the next byte the DMA will write
+static uint32_t ulUartRxHead(void);
+
+// To wake up a reader and the application once new bytes have been received
+static void vUartRxNotifyFromISR(BaseType_t* pxHigherPriorityTaskWoken);
+
+// To program the UART2 frame format and baud rate
+static void vUartConfigure(uint32_t ulBaudRate);
+
+// To get the USART2 kernel clock divider for a baud rate
+static uint32_t ulUartGetDivider(uint32_t ulBaudRate);
+/*******************************************************************************
+*   Procedure: vUartSetup
+*
+*   Description: This function configures and enables UART2 to allow message
+*   			 transmission and reception. With the DMA backend it also
+*   			 configures DMA1 Stream6 to serve UART2 transmit requests.
+*   			 DMA1 Stream5 is always configured to receive. The USART2
+*   			 interrupt is enabled at the NVIC with the idle line source,
+*   			 while the transmit interrupt is only turned on when needed.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vUartSetup(void)
+{
+	GPIO_InitTypeDef xGpioUartPins;	// To hold the configurations for the GPIO UART pins to be initialized
+
+	// Enable UART2 peripheral clock and GPIOA peripheral clock
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART2, ENABLE);
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOA, ENABLE);
+
+	// Zeroing each struct member
+	memset(&xGpioUartPins, 0, sizeof(xGpioUartPins));
+
+	// Alternate function configuration of MCU pins to behave as UART2 TX and RX
+	// PA2 is UART2_TX and PA3 is UART2_RX
+	xGpioUartPins.GPIO_Pin = GPIO_Pin_2 | GPIO_Pin_3;
+	xGpioUartPins.GPIO_Mode = GPIO_Mode_AF;
+	xGpioUartPins.GPIO_PuPd = GPIO_PuPd_UP;  // UART frame is high (logic 1) when idle
+	GPIO_Init(GPIOA, &xGpioUartPins);
+
+	// AF mode settings for the pins
+	GPIO_PinAFConfig(GPIOA, GPIO_PinSource2, GPIO_AF_USART2); 	// Configure AF mode for PA2 as UART2_TX
+	GPIO_PinAFConfig(GPIOA, GPIO_PinSource3, GPIO_AF_USART2); 	// Configure AF mode for PA3 as UART2_RX
+
+	// UART frame format and baud rate
+	vUartConfigure(UART_BAUD_RATE);
+
+#if UART_TX_BACKEND == UART_TX_BACKEND_DMA
+	// Setup the DMA stream serving UART2 TX
+	vUartDmaSetup();
+#endif
+
+	// Setup the DMA stream receiving from UART2
+	vUartRxDmaSetup();
+
+	// The idle line interrupt tells a reader that a burst of input has ended
+	USART_ITConfig(USART2, USART_IT_IDLE, ENABLE);
+
+	// The priority cannot be less than 5 as per configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+	NVIC_SetPriority(USART2_IRQn, 5);
+	NVIC_EnableIRQ(USART2_IRQn);
+
+	// Enable UART2 peripheral
+	USART_Cmd(USART2, ENABLE);
+}
+/*******************************************************************************
+*   Procedure: vUartConfigure
+*
+*   Description: This function programs UART2 for 8N1 frames at the given baud
+*   			 rate. 16x oversampling is used whenever the rate allows it since
+*   			 it tolerates more clock deviation and noise. 8x oversampling
+*   			 (OVER8) is only used for rates above APB1 clock / 16, and raises
+*   			 the maximum baud rate to APB1 clock / 8.
+*
+*   Notes: UART2 must be disabled when this function is called.
+*
+*   Parameters: ulBaudRate - The baud rate to program
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vUartConfigure(uint32_t ulBaudRate)
+{
+	USART_InitTypeDef xUart2Init;       // To hold the configurations for the UART peripheral to be initialized
+
+	// USART_Init() computes the divider according to the oversampling mode, so select it first
+	USART_OverSampling8Cmd(USART2, ( ulUartGetDivider(ulBaudRate) < 16 ) ? ENABLE : DISABLE);
+
+	// Zeroing each struct member
+	memset(&xUart2Init, 0, sizeof(xUart2Init));
+
+	// UART parameter initializations
+	xUart2Init.USART_BaudRate = ulBaudRate;
+	xUart2Init.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	xUart2Init.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
+	xUart2Init.USART_Parity = USART_Parity_No;
+	xUart2Init.USART_StopBits = USART_StopBits_1;
+	xUart2Init.USART_WordLength = USART_WordLength_8b;
+	USART_Init(USART2, &xUart2Init);
+
+	ulUartBaudRate = ulBaudRate;
+}
+/*******************************************************************************
+*   Procedure: ulUartGetDivider
+*
+*   Description: This function returns the number of USART2 kernel clock cycles
+*   			 per bit for a baud rate, rounded to the nearest integer. The
+*   			 baud rate register holds this value in both oversampling modes
+*   			 (mantissa and fraction), so the rate actually produced is the
+*   			 APB1 clock divided by it.
+*
+*   Notes: None
+*
+*   Parameters: ulBaudRate - The baud rate, must not be 0
+*
+*   Return: uint32_t - The clock divider
+*
+*******************************************************************************/
+static uint32_t ulUartGetDivider(uint32_t ulBaudRate)
+{
+	RCC_ClocksTypeDef xClocks;	// To hold the current bus clock frequencies
+
+	RCC_GetClocksFreq(&xClocks);
+
+	return( ( xClocks.PCLK1_Frequency + ( ulBaudRate / 2 ) ) / ulBaudRate );
+}
+/*******************************************************************************
+*   Procedure: ulUartGetMaxBaudRate
+*
+*   Description: This function returns the highest baud rate UART2 can produce
+*   			 with the current APB1 clock, which is APB1 clock / 8 using 8x
+*   			 oversampling (2 Mbaud with the 16 MHz HSI).
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: uint32_t - The highest baud rate
+*
+*******************************************************************************/
+uint32_t ulUartGetMaxBaudRate(void)
+{
+	RCC_ClocksTypeDef xClocks;	// To hold the current bus clock frequencies
+
+	RCC_GetClocksFreq(&xClocks);
+
+	return( xClocks.PCLK1_Frequency / 8 );
+}
+/*******************************************************************************
+*   Procedure: ulUartGetBaudRate
+*
+*   Description: This function returns the current console baud rate.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: uint32_t - The current baud rate
+*
+*******************************************************************************/
+uint32_t ulUartGetBaudRate(void)
+{
+	return( ulUartBaudRate );
+}
+/*******************************************************************************
+*   Procedure: xUartBaudRateSupported
+*
+*   Description: This function checks whether UART2 can produce a baud rate
+*   			 with the current clock. The rate is rejected if it is outside
+*   			 UART_MIN_BAUD_RATE to ulUartGetMaxBaudRate(), or if the nearest
+*   			 divider the clock allows misses it by more than
+*   			 UART_MAX_BAUD_ERROR.
+*
+*   Notes: Lets a rate be checked before the user is told to switch to it.
+*
+*   Parameters: ulBaudRate - The baud rate
+*
+*   Return: BaseType_t - pdTRUE if the rate is supported, otherwise pdFALSE
+*
+*******************************************************************************/
+BaseType_t xUartBaudRateSupported(uint32_t ulBaudRate)
+{
+	RCC_ClocksTypeDef xClocks;	// To hold the current bus clock frequencies
+	uint32_t ulActual;			// Baud rate produced by the nearest divider
+	uint32_t ulError;			// Difference between the requested and the produced rate
+
+	if( ulBaudRate < UART_MIN_BAUD_RATE || ulBaudRate > ulUartGetMaxBaudRate() )
+	{
+		return(pdFALSE);
+	}
+
+	// Check the rate which will actually be produced
+	RCC_GetClocksFreq(&xClocks);
+	ulActual = xClocks.PCLK1_Frequency / ulUartGetDivider(ulBaudRate);
+	ulError = ( ulActual > ulBaudRate ) ? ( ulActual - ulBaudRate ) : ( ulBaudRate - ulActual );
+
+	if( ( ulError * 1000 ) / ulBaudRate > UART_MAX_BAUD_ERROR )
+	{
+		return(pdFALSE);
+	}
+
+	return(pdTRUE);
+}
+/*******************************************************************************
+*   Procedure: xUartSetBaudRate
+*
+*   Description: This function switches UART2 to a new baud rate, if
+*   			 xUartBaudRateSupported() accepts it. The function waits for
+*   			 the last byte to leave the shift register before UART2 is
+*   			 reprogrammed, and discards any byte received at the old rate.
+*
+*   Notes: Nothing may be transmitted meanwhile, so once the scheduler is
+*   	   started the rate is only changed by the UART Write task, see
+*   	   xConsoleSetBaudRate(). The rate is not saved, see
+*   	   vUartSaveBaudRate().
+*
+*   Parameters: ulBaudRate - The new baud rate
+*
+*   Return: BaseType_t - pdPASS if the rate is applied, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xUartSetBaudRate(uint32_t ulBaudRate)
+{
+	if( xUartBaudRateSupported(ulBaudRate) == pdFALSE )
+	{
+		return(pdFAIL);
+	}
+
+	// Wait till the last byte has been shifted out at the old rate
+	while( USART_GetFlagStatus(USART2, USART_FLAG_TC) != SET );
+
+	USART_Cmd(USART2, DISABLE);
+	vUartConfigure(ulBaudRate);
+	USART_Cmd(USART2, ENABLE);
+
+	// Discard anything received at the old rate
+	vUartFlushRx();
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: vUartSaveBaudRate
+*
+*   Description: This function stores the current baud rate in the RTC backup
+*   			 registers, together with its complement to detect registers
+*   			 which were never written. The backup domain is not reset by a
+*   			 system reset, so vUartRestoreBaudRate() can apply the rate on
+*   			 the next start.
+*
+*   Notes: The RTC clock must be enabled (see vRtcSetup()).
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vUartSaveBaudRate(void)
+{
+	// Write access to the backup domain is denied after reset
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_PWR, ENABLE);
+	PWR_BackupAccessCmd(ENABLE);
+
+	RTC_WriteBackupRegister(UART_BAUD_BKP_REG, ulUartBaudRate);
+	RTC_WriteBackupRegister(UART_BAUD_CHECK_BKP_REG, ~ulUartBaudRate);
+}
+/*******************************************************************************
+*   Procedure: vUartRestoreBaudRate
+*
+*   Description: This function switches UART2 to the baud rate saved by
+*   			 vUartSaveBaudRate(). The default rate is kept if nothing valid
+*   			 was saved or if the saved rate cannot be produced by the
+*   			 current clock.
+*
+*   Notes: The RTC clock must be enabled (see vRtcSetup()). Must be called
+*   	   before anything is transmitted.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vUartRestoreBaudRate(void)
+{
+	uint32_t ulSaved = RTC_ReadBackupRegister(UART_BAUD_BKP_REG);	// Saved baud rate
+
+	if( RTC_ReadBackupRegister(UART_BAUD_CHECK_BKP_REG) == ~ulSaved && ulSaved != ulUartBaudRate )
+	{
+		(void)xUartSetBaudRate(ulSaved);
+	}
+}
+/*******************************************************************************
+*   Procedure: vUartRxDmaSetup
+*
+*   Description: This function configures DMA1 Stream5 Channel4 to move every
+*   			 byte received by UART2 into the receive buffer, in circular
+*   			 mode so it never has to be restarted. The half and full
+*   			 transfer interrupts are enabled. It also creates the semaphore
+*   			 readers wait on.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vUartRxDmaSetup(void)
+{
+	DMA_InitTypeDef xDmaInit;	// To hold the configurations for the DMA stream to be initialized
+
+	xUartRxSemaphore = xSemaphoreCreateBinaryStatic( &xUartRxSemaphoreBuffer );
+
+	// DMA1 is hanging on AHB1 bus
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1, ENABLE);
+
+	// Reset the stream to its default state
+	DMA_DeInit(UART_RX_DMA_STREAM);
+
+	// Fills each xDmaInit member with its default value
+	DMA_StructInit(&xDmaInit);
+
+	xDmaInit.DMA_Channel = UART_RX_DMA_CHANNEL;
+	xDmaInit.DMA_PeripheralBaseAddr = (uint32_t)&USART2->DR;
+	xDmaInit.DMA_Memory0BaseAddr = (uint32_t)ucUartRxBuf;
+	xDmaInit.DMA_DIR = DMA_DIR_PeripheralToMemory;
+	xDmaInit.DMA_BufferSize = UART_RX_BUF_SIZE;
+	xDmaInit.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	xDmaInit.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	xDmaInit.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	xDmaInit.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	xDmaInit.DMA_Mode = DMA_Mode_Circular;
+	xDmaInit.DMA_Priority = DMA_Priority_Medium;	// Higher than TX, a missed RX byte is lost
+	xDmaInit.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_Init(UART_RX_DMA_STREAM, &xDmaInit);
+
+	// Turn on the half and full transfer interrupts
+	DMA_ITConfig(UART_RX_DMA_STREAM, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+	// Let UART2 issue DMA requests whenever its receive data register is not empty
+	USART_DMACmd(USART2, USART_DMAReq_Rx, ENABLE);
+
+	// The priority cannot be less than 5 as per configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+	NVIC_SetPriority(UART_RX_DMA_IRQ, 5);
+	NVIC_EnableIRQ(UART_RX_DMA_IRQ);
+
+	// The stream runs from now on
+	DMA_Cmd(UART_RX_DMA_STREAM, ENABLE);
+}
+#if UART_TX_BACKEND == UART_TX_BACKEND_DMA
+/*******************************************************************************
+*   Procedure: vUartDmaSetup
+*
+*   Description: This function configures DMA1 Stream6 Channel4 to move bytes
+*   			 from memory to the UART2 data register. The memory address and
+*   			 the number of bytes are set per transfer by vUartWrite(). The
+*   			 transfer complete interrupt is enabled so the writing task can
+*   			 be notified once the whole message has been handed to UART2.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vUartDmaSetup(void)
+{
+	DMA_InitTypeDef xDmaInit;	// To hold the configurations for the DMA stream to be initialized
+
+	// DMA1 is hanging on AHB1 bus
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1, ENABLE);
+
+	// Reset the stream to its default state
+	DMA_DeInit(UART_TX_DMA_STREAM);
+
+	// Fills each xDmaInit member with its default value
+	DMA_StructInit(&xDmaInit);
+
+	xDmaInit.DMA_Channel = UART_TX_DMA_CHANNEL;
+	xDmaInit.DMA_PeripheralBaseAddr = (uint32_t)&USART2->DR;
+	xDmaInit.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+	xDmaInit.DMA_BufferSize = 1;  							// Set per transfer
+	xDmaInit.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	xDmaInit.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	xDmaInit.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	xDmaInit.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	xDmaInit.DMA_Mode = DMA_Mode_Normal;
+	xDmaInit.DMA_Priority = DMA_Priority_Low;
+	xDmaInit.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_Init(UART_TX_DMA_STREAM, &xDmaInit);
+
+	// Turn on the transfer complete interrupt
+	DMA_ITConfig(UART_TX_DMA_STREAM, DMA_IT_TC, ENABLE);
+
+	// Let UART2 issue DMA requests whenever its transmit data register is empty
+	USART_DMACmd(USART2, USART_DMAReq_Tx, ENABLE);
+
+	// The priority cannot be less than 5 as per configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+	NVIC_SetPriority(UART_TX_DMA_IRQ, 5);
+	NVIC_EnableIRQ(UART_TX_DMA_IRQ);
+}
+/*******************************************************************************
+*   Procedure: vUartWrite
+*
+*   Description: This function transmits a message via UART2 using DMA. The
+*   			 message is split into chunks of up to 65535 bytes. For each
+*   			 chunk the DMA stream is started and the calling task waits in
+*   			 blocked state till the transfer complete interrupt notifies it.
+*
+*   Notes: Must only be called from task context by a single task (the UART
+*   	   Write task) since the DMA stream is not shared.
+*
+*   Parameters: pcMsg - A pointer to the message buffer to send
+*   			xLen - The number of bytes to send
+*
+*   Return: None
+*
+*******************************************************************************/
+void vUartWrite(const char* pcMsg, size_t xLen)
+{
+	uint32_t ulChunk;					  // Number of bytes in the current DMA transfer
+	uint32_t ulStartCycles = DWT->CYCCNT; // To account for the CPU cycles spent in this function
+	uint32_t ulBlockedCycles = 0;		  // CPU cycles spent blocked waiting for the DMA
+	uint32_t ulBlockStart;				  // Cycle count at the time we blocked
+
+	ulUartTxBytes += xLen;
+
+	while( xLen > 0 )
+	{
+		ulChunk = ( xLen > UART_DMA_MAX_XFER ) ? UART_DMA_MAX_XFER : xLen;
+
+		// Clear any flag left over from the previous transfer. The stream cannot be
+		// enabled while a flag is pending
+		DMA_ClearFlag(UART_TX_DMA_STREAM, UART_TX_DMA_FLAGS);
+
+		// UART2 sets the transmission complete flag again once the last byte has left
+		USART_ClearFlag(USART2, USART_FLAG_TC);
+
+		// Point the stream at the message and set the number of bytes to move
+		UART_TX_DMA_STREAM->M0AR = (uint32_t)pcMsg;
+		DMA_SetCurrDataCounter(UART_TX_DMA_STREAM, (uint16_t)ulChunk);
+
+		// Remember which task to notify once the transfer is complete
+		xUartTxWaitingTask = xTaskGetCurrentTaskHandle();
+
+		// Start the transfer
+		DMA_Cmd(UART_TX_DMA_STREAM, ENABLE);
+
+		// Wait in blocked state till the transfer complete interrupt notifies us
+		ulBlockStart = DWT->CYCCNT;
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		ulBlockedCycles += DWT->CYCCNT - ulBlockStart;
+
+		pcMsg += ulChunk;
+		xLen -= ulChunk;
+	}
+
+	ulUartTxCpuCycles += ( DWT->CYCCNT - ulStartCycles ) - ulBlockedCycles;
+}
+/*******************************************************************************
+*   Procedure: DMA1_Stream6_IRQHandler
+*
+*   Description: Non-weak implementation of the interrupt handler for DMA1
+*   			 Stream6. It is executed once the DMA stream has handed the
+*   			 last byte of a message to UART2. It notifies the task waiting
+*   			 in vUartWrite() so it can continue.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void DMA1_Stream6_IRQHandler(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;  // Set if a higher priority task is woken due to task notification
+
+	if( DMA_GetITStatus(UART_TX_DMA_STREAM, DMA_IT_TCIF6) == SET )
+	{
+		// Clear the interrupt bit to prevent the interrupt handler from continuously running
+		DMA_ClearITPendingBit(UART_TX_DMA_STREAM, DMA_IT_TCIF6);
+
+		if( xUartTxWaitingTask != NULL )
+		{
+			vTaskNotifyGiveFromISR(xUartTxWaitingTask, &xHigherPriorityTaskWoken);
+			xUartTxWaitingTask = NULL;
+		}
+	}
+
+	// If the notified task has a higher priority than the interrupted task then yield
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+#else
+/*******************************************************************************
+*   Procedure: vUartWrite
+*
+*   Description: This function transmits a message via UART2 using the TXE
+*   			 interrupt. The message is copied into the transmit ring as far
+*   			 as it fits and the TXE interrupt is enabled. The calling task
+*   			 then waits in blocked state till the interrupt has freed half
+*   			 of the ring, so the rest of the message can be copied, or till
+*   			 the ring is empty once the whole message has been copied.
+*
+*   Notes: Must only be called from task context by a single task (the UART
+*   	   Write task) since the ring has a single producer. The ring is
+*   	   updated inside a critical section, which masks the USART2 interrupt.
+*
+*   Parameters: pcMsg - A pointer to the message buffer to send
+*   			xLen - The number of bytes to send
+*
+*   Return: None
+*
+*******************************************************************************/
+void vUartWrite(const char* pcMsg, size_t xLen)
+{
+	uint32_t ulChunk;					  // Number of bytes copied into the ring
+	uint32_t ulHead;					  // Index of the head within the ring
+	uint32_t ulFirst;					  // Number of bytes copied before the end of the ring
+	uint32_t ulStartCycles = DWT->CYCCNT; // To account for the CPU cycles spent in this function
+	uint32_t ulBlockedCycles = 0;		  // CPU cycles spent blocked waiting for the interrupt
+	uint32_t ulBlockStart;				  // Cycle count at the time we blocked
+
+	ulUartTxBytes += xLen;
+
+	while( xLen > 0 )
+	{
+		taskENTER_CRITICAL();
+
+		// Copy as much as fits, in two parts if the free space wraps around the end of the ring
+		ulChunk = UART_TX_RING_SIZE - ( ulUartTxHead - ulUartTxTail );
+		if( ulChunk > xLen )
+		{
+			ulChunk = xLen;
+		}
+
+		ulHead = ulUartTxHead & ( UART_TX_RING_SIZE - 1 );
+		ulFirst = UART_TX_RING_SIZE - ulHead;
+		if( ulFirst > ulChunk )
+		{
+			ulFirst = ulChunk;
+		}
+
+		memcpy(&cUartTxRing[ulHead], pcMsg, ulFirst);
+		memcpy(&cUartTxRing[0], pcMsg + ulFirst, ulChunk - ulFirst);
+		ulUartTxHead += ulChunk;
+
+		pcMsg += ulChunk;
+		xLen -= ulChunk;
+
+		// Wake up once there is room for more, or once everything has been handed to UART2
+		ulUartTxWakeLevel = ( xLen > 0 ) ? ( UART_TX_RING_SIZE / 2 ) : 0;
+		xUartTxWaitingTask = xTaskGetCurrentTaskHandle();
+
+		// The interrupt fires right away if the data register is empty. It runs once
+		// the critical section is left and notifies us as soon as the level is reached
+		USART_ITConfig(USART2, USART_IT_TXE, ENABLE);
+
+		taskEXIT_CRITICAL();
+
+		// Wait in blocked state till the TXE interrupt notifies us
+		ulBlockStart = DWT->CYCCNT;
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		ulBlockedCycles += DWT->CYCCNT - ulBlockStart;
+	}
+
+	ulUartTxCpuCycles += ( DWT->CYCCNT - ulStartCycles ) - ulBlockedCycles;
+}
+/*******************************************************************************
+*   Procedure: vUartTxFromISR
+*
+*   Description: This function is executed by USART2_IRQHandler on every TXE
+*   			 interrupt. It moves the next byte of the ring into the UART2
+*   			 data register, and notifies the task waiting in vUartWrite()
+*   			 once no more than ulUartTxWakeLevel bytes are left. The TXE
+*   			 interrupt is turned off when the ring is empty.
+*
+*   Notes: None
+*
+*   Parameters: pxHigherPriorityTaskWoken - Set to pdTRUE if the notified task
+*   			has a higher priority than the interrupted one
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vUartTxFromISR(BaseType_t* pxHigherPriorityTaskWoken)
+{
+	uint32_t ulTail = ulUartTxTail;		// Local copy of the ring tail
+
+	if( ulTail != ulUartTxHead )
+	{
+		// Writing the data register clears the TXE flag
+		USART_SendData(USART2, cUartTxRing[ulTail & ( UART_TX_RING_SIZE - 1 )]);
+		ulUartTxTail = ++ulTail;
+	}
+
+	if( ulTail == ulUartTxHead )
+	{
+		// Nothing left to send. Stop the interrupt, the TXE flag stays set
+		USART_ITConfig(USART2, USART_IT_TXE, DISABLE);
+	}
+
+	if( xUartTxWaitingTask != NULL && ( ulUartTxHead - ulTail ) <= ulUartTxWakeLevel )
+	{
+		vTaskNotifyGiveFromISR(xUartTxWaitingTask, pxHigherPriorityTaskWoken);
+		xUartTxWaitingTask = NULL;
+	}
+}
+#endif
+/*******************************************************************************
+*   Procedure: USART2_IRQHandler
+*
+*   Description: Non-weak implementation of USART2 interrupt handler. With the
+*   			 interrupt backend it feeds UART2 from the transmit ring. When
+*   			 the RX line has been idle for one frame after receiving bytes,
+*   			 a reader waiting in xUartReadByte() is woken up.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void USART2_IRQHandler(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;  // Set if a higher priority task is woken by the handler
+
+#if UART_TX_BACKEND == UART_TX_BACKEND_IRQ
+	uint32_t ulStartCycles = DWT->CYCCNT;			// To account for the CPU cycles spent feeding UART2
+
+	if( USART_GetITStatus(USART2, USART_IT_TXE) == SET )
+	{
+		vUartTxFromISR(&xHigherPriorityTaskWoken);
+		ulUartTxCpuCycles += DWT->CYCCNT - ulStartCycles;
+	}
+#endif
+
+	if( USART_GetITStatus(USART2, USART_IT_IDLE) == SET )
+	{
+		// The IDLE flag is cleared by reading SR (done above) then DR. The DMA has
+		// already taken the last byte, so the DR read returns nothing new
+		(void)USART_ReceiveData(USART2);
+
+		vUartRxNotifyFromISR(&xHigherPriorityTaskWoken);
+	}
+
+	// If a task was woken and has a higher priority than the interrupted task then yield
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+/*******************************************************************************
+*   Procedure: xUartReadByte
+*
+*   Description: This function receives one byte from UART2. If no byte is
+*   			 waiting in the receive buffer, the calling task waits in
+*   			 blocked state till the interrupts signal new bytes or till
+*   			 xTimeout ticks have passed, so it uses no CPU time meanwhile.
+*
+*   Notes: Only one task may read at a time, the Console Input task. Must not be
+*   	   called from an ISR. vUartReadAbortFromISR() ends the wait early.
+*
+*   Parameters: pucByte - A pointer to a location that will hold the byte
+*   			xTimeout - The number of ticks to wait, portMAX_DELAY waits forever
+*
+*   Return: BaseType_t - pdPASS if a byte was received, otherwise pdFAIL
+*
+*******************************************************************************/
+BaseType_t xUartReadByte(uint8_t* pucByte, TickType_t xTimeout)
+{
+	TimeOut_t xTimeOut;		// Time at the start of the call, to account for the time already waited
+
+	vTaskSetTimeOutState(&xTimeOut);
+
+	while( ulUartRxTail == ulUartRxHead() )
+	{
+		// A give for bytes that were already read only causes another pass of the loop
+		if( xTaskCheckForTimeOut(&xTimeOut, &xTimeout) == pdTRUE ||
+			xSemaphoreTake(xUartRxSemaphore, xTimeout) != pdPASS || xUartRxAbort == pdTRUE )
+		{
+			xUartRxAbort = pdFALSE;
+
+			if( ulUartRxTail == ulUartRxHead() )
+			{
+				return(pdFAIL);
+			}
+		}
+	}
+
+	*pucByte = ucUartRxBuf[ulUartRxTail];
+	ulUartRxTail = ( ulUartRxTail + 1 ) % UART_RX_BUF_SIZE;
+
+	return(pdPASS);
+}
+/*******************************************************************************
+*   Procedure: vUartFlushRx
+*
+*   Description: This function discards every received byte which has not been
+*   			 read yet, e.g. the key pressed to wake the application up.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vUartFlushRx(void)
+{
+	ulUartRxTail = ulUartRxHead();
+}
+/*******************************************************************************
+*   Procedure: xUartTxBusy
+*
+*   Description: This function checks whether a message is still being
+*   			 transmitted, i.e. a task waits in vUartWrite() or the last
+*   			 byte has not left UART2 yet
+*
+*   Notes: UART2 stops in STOP mode, so the low power service does not enter
+*   	   it while this returns pdTRUE.
+*
+*   Parameters: None
+*
+*   Return: BaseType_t - pdTRUE if busy, pdFALSE otherwise
+*
+*******************************************************************************/
+BaseType_t xUartTxBusy(void)
+{
+	if( xUartTxWaitingTask != NULL || USART_GetFlagStatus(USART2, USART_FLAG_TC) != SET )
+	{
+		return(pdTRUE);
+	}
+
+	return(pdFALSE);
+}
+/*******************************************************************************
+*   Procedure: ulUartRxHead
+*
+*   Description: This function returns the index in the receive buffer of the
+*   			 next byte DMA1 Stream5 will write. It is derived from the
+*   			 number of transfers left in the current cycle (NDTR).
+*
+*   Notes: NDTR is reloaded from UART_RX_BUF_SIZE once it reaches 0, so it can
+*   	   momentarily read 0, which is the same position as UART_RX_BUF_SIZE.
+*
+*   Parameters: None
+*
+*   Return: uint32_t - The index of the next byte to be written
+*
+*******************************************************************************/
+static uint32_t ulUartRxHead(void)
+{
+	return( ( UART_RX_BUF_SIZE - DMA_GetCurrDataCounter(UART_RX_DMA_STREAM) ) % UART_RX_BUF_SIZE );
+}
+/*******************************************************************************
+*   Procedure: vUartReadAbortFromISR
+*
+*   Description: This function makes the task waiting in xUartReadByte(), if
+*   			 any, return pdFAIL at once as if its timeout had expired
+*
+*   Notes: If no task is waiting, the next call of xUartReadByte() returns at
+*   	   once unless a byte is waiting.
+*
+*   Parameters: pxHigherPriorityTaskWoken - Set to pdTRUE if the woken task has
+*   			a higher priority than the interrupted one
+*
+*   Return: None
+*
+*******************************************************************************/
+void vUartReadAbortFromISR(BaseType_t* pxHigherPriorityTaskWoken)
+{
+	xUartRxAbort = pdTRUE;
+	xSemaphoreGiveFromISR(xUartRxSemaphore, pxHigherPriorityTaskWoken);
+}
+/*******************************************************************************
+*   Procedure: vUartRxNotifyFromISR
+*
+*   Description: This function is executed by the USART2 and DMA1 Stream5
+*   			 interrupt handlers whenever new bytes have been received. It
+*   			 wakes up the task waiting in xUartReadByte(), if any, and
+*   			 passes the event on to the application.
+*
+*   Notes: None
+*
+*   Parameters: pxHigherPriorityTaskWoken - Set to pdTRUE if a woken task has
+*   			a higher priority than the interrupted one
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vUartRxNotifyFromISR(BaseType_t* pxHigherPriorityTaskWoken)
+{
+	xSemaphoreGiveFromISR(xUartRxSemaphore, pxHigherPriorityTaskWoken);
+
+	vUartRxCallbackFromISR(pxHigherPriorityTaskWoken);
+}
+/*******************************************************************************
+*   Procedure: DMA1_Stream5_IRQHandler
+*
+*   Description: Non-weak implementation of the interrupt handler for DMA1
+*   			 Stream5. It is executed when the DMA has filled half of the
+*   			 receive buffer or all of it, so a reader can keep up with a
+*   			 long burst of input before the idle line interrupt fires.
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void DMA1_Stream5_IRQHandler(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;  // Set if a higher priority task is woken by the handler
+
+	if( DMA_GetITStatus(UART_RX_DMA_STREAM, DMA_IT_HTIF5) == SET ||
+		DMA_GetITStatus(UART_RX_DMA_STREAM, DMA_IT_TCIF5) == SET )
+	{
+		// Clear the interrupt bits to prevent the interrupt handler from continuously running
+		DMA_ClearITPendingBit(UART_RX_DMA_STREAM, DMA_IT_HTIF5 | DMA_IT_TCIF5);
+
+		vUartRxNotifyFromISR(&xHigherPriorityTaskWoken);
+	}
+
+	// If a task was woken and has a higher priority than the interrupted task then yield
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+/*******************************************************************************
+*   Procedure: vSendUartMsg
+*
+*   Description: This function transmits data byte by byte via UART2 peripheral
+*   			 by polling the TXE flag.
+*
+*   Notes: The user should avoid using this function to transmit UART messages.
+*   	   Rather the user should post messages to the UART write queue in order
+*   	   to serialize message transmission and avoid race condition for UART2
+*   	   peripheral. It is only kept for contexts where the UART Write task
+*   	   cannot be used (e.g. before the scheduler is started).
+*
+*   Parameters: pcMsg - A pointer to a message buffer of type char
+*
+*   Return: None
+*
+*******************************************************************************/
+void vSendUartMsg(const char* pcMsg)
+{
+	// Continue to loop while there are still bytes in the buffer to send
+	for(int i = 0; pcMsg[i] != '\0'; i++)
+	{
+		// Loop until the transmit data register for UART2 is empty
+		while(USART_GetFlagStatus(USART2, USART_FLAG_TXE) != SET);
+
+		// Send one byte at a time
+		USART_SendData(USART2, pcMsg[i]);
+	}
+}
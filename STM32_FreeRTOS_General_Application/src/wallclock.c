@@ -0,0 +1,170 @@
+/**
+  ******************************************************************************
+  * @file    wallclock.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Cached wall clock. The snapshot is written by the RTC wakeup
+  * 		 interrupt only, or by a task with interrupts masked, so there is
+  * 		 a single writer at a time. The sequence counter is odd while the
+  * 		 snapshot is written. A reader copies the snapshot between two
+  * 		 reads of the counter and keeps the copy if both reads give the
+  * 		 same even value.
+  *
+  * 		 A reader spins while the snapshot is written, so it must never
+  * 		 preempt the writer: readers run in tasks or in interrupts of a
+  * 		 priority not above the one of the RTC wakeup interrupt.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timebase.h"
+#include "calendar.h"
+#include "wallclock.h"
+
+// WALLCLOCK GLOBALS
+
+// Sequence counter, odd while the snapshot is written
+static volatile uint32_t ulWallClockSeq = 0;
+
+// Date and time last published
+static WallClock_t xWallClockSnapshot;
+
+// FUNCTION PROTOTYPES
+
+// To write the snapshot
+static void vWallClockPublish(const WallClock_t* pxClock);
+/*******************************************************************************
+*   Procedure: vWallClockReadRtc
+*
+*   Description: This function reads the RTC date, time and sub-second counter
+*   			 directly from the registers
+*
+*   Notes: Reading RTC_SSR locks RTC_TR and RTC_DR till RTC_DR is read, so the
+*   	   three are consistent and RTC_GetDate() does not need to be called
+*   	   twice. Only used where the cached value is not recent enough, e.g.
+*   	   to program the RTC alarm.
+*
+*   Parameters: pxClock - A pointer to the location receiving the date and time
+*
+*   Return: None
+*
+*******************************************************************************/
+void vWallClockReadRtc(WallClock_t* pxClock)
+{
+	uint32_t ulPrediv = RTC->PRER & RTC_PRER_PREDIV_S;		// Steps of the sub-second counter, minus one
+	uint32_t ulSsr = RTC->SSR;								// Sub-second counter, counting down
+	uint32_t ulTr = RTC->TR;								// Time register
+	uint32_t ulDr = RTC->DR;								// Date register
+
+	pxClock->xTime.RTC_Hours = CALENDAR_BCD_TO_BIN( ( ulTr & ( RTC_TR_HT | RTC_TR_HU ) ) >> 16 );
+	pxClock->xTime.RTC_Minutes = CALENDAR_BCD_TO_BIN( ( ulTr & ( RTC_TR_MNT | RTC_TR_MNU ) ) >> 8 );
+	pxClock->xTime.RTC_Seconds = CALENDAR_BCD_TO_BIN( ulTr & ( RTC_TR_ST | RTC_TR_SU ) );
+	pxClock->xTime.RTC_H12 = RTC_H12_AM;
+	pxClock->xDate.RTC_Year = CALENDAR_BCD_TO_BIN( ( ulDr & ( RTC_DR_YT | RTC_DR_YU ) ) >> 16 );
+	pxClock->xDate.RTC_Month = CALENDAR_BCD_TO_BIN( ( ulDr & ( RTC_DR_MT | RTC_DR_MU ) ) >> 8 );
+	pxClock->xDate.RTC_Date = CALENDAR_BCD_TO_BIN( ulDr & ( RTC_DR_DT | RTC_DR_DU ) );
+	pxClock->xDate.RTC_WeekDay = ( ulDr & RTC_DR_WDU ) >> 13;
+
+	// The counter may be above the prescaler after a shift of the RTC
+	if( ulSsr > ulPrediv )
+	{
+		ulSsr = ulPrediv;
+	}
+
+	pxClock->ulSeconds = ulCalendarFromRtc( &pxClock->xDate, &pxClock->xTime );
+	pxClock->ulNanoseconds = (uint32_t)( ( ( ulPrediv - ulSsr ) * TIMEBASE_NS_PER_SECOND ) / ( ulPrediv + 1 ) );
+}
+/*******************************************************************************
+*   Procedure: vWallClockUpdateFromISR
+*
+*   Description: This function reads the RTC and publishes its date and time
+*
+*   Notes: Called from the RTC wakeup interrupt, once a second.
+*
+*   Parameters: pxClock - A pointer to the location receiving the date and time
+*   			published, e.g. to synchronize the time base with it
+*
+*   Return: None
+*
+*******************************************************************************/
+void vWallClockUpdateFromISR(WallClock_t* pxClock)
+{
+	vWallClockReadRtc( pxClock );
+	vWallClockPublish( pxClock );
+}
+/*******************************************************************************
+*   Procedure: vWallClockRefresh
+*
+*   Description: This function reads the RTC and publishes its date and time at
+*   			 once, instead of at the next wakeup interrupt
+*
+*   Notes: Called from tasks after the RTC date or time is set. The interrupts
+*   	   are masked, so the RTC wakeup interrupt does not write meanwhile.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vWallClockRefresh(void)
+{
+	WallClock_t xClock;		// Date and time read
+
+	taskENTER_CRITICAL();
+	vWallClockReadRtc( &xClock );
+	vWallClockPublish( &xClock );
+	taskEXIT_CRITICAL();
+}
+/*******************************************************************************
+*   Procedure: vWallClockGet
+*
+*   Description: This function copies the date and time last published. The
+*   			 copy is taken again if the snapshot was written meanwhile.
+*
+*   Notes: No RTC register is read and no lock is taken. Must not be called
+*   	   from an interrupt above the priority of the RTC wakeup interrupt.
+*
+*   Parameters: pxClock - A pointer to the location receiving the date and time
+*
+*   Return: None
+*
+*******************************************************************************/
+void vWallClockGet(WallClock_t* pxClock)
+{
+	uint32_t ulSeq;		// Sequence counter before the copy
+
+	do
+	{
+		ulSeq = ulWallClockSeq;
+		__DMB();
+		*pxClock = xWallClockSnapshot;
+		__DMB();
+	} while( ( ulSeq & 1 ) != 0 || ulSeq != ulWallClockSeq );
+}
+/*******************************************************************************
+*   Procedure: vWallClockPublish
+*
+*   Description: This function writes the snapshot, with the sequence counter
+*   			 odd meanwhile
+*
+*   Notes: Called by the single writer, the RTC wakeup interrupt or a task with
+*   	   interrupts masked.
+*
+*   Parameters: pxClock - A pointer to the date and time to publish
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vWallClockPublish(const WallClock_t* pxClock)
+{
+	ulWallClockSeq++;
+	__DMB();
+	xWallClockSnapshot = *pxClock;
+	__DMB();
+	ulWallClockSeq++;
+}
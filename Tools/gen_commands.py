@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""
+Generates STM32_FreeRTOS_General_Application/inc/commands_gen.h from
+inc/commands.def: the perfect hash table mapping the keys, names and aliases
+of the menu commands to the command table, and the text of each menu.
+
+The Debug and Release builds of the project run it before compiling, so the
+table follows commands.def. The header is only written when it changes, so
+cmd.c is not rebuilt otherwise. It can also be run by hand:
+    python3 Tools/gen_commands.py
+    python3 Tools/gen_commands.py --check    fails if commands_gen.h is stale
+
+The hash is 32-bit FNV-1a over the menu ID and the lower case token, starting
+from a seed. The top CMD_HASH_BITS bits select the slot. Seeds are tried in
+turn till no two tokens share a slot. It must match pxCmdFind() in cmd.c.
+"""
+
+import ast
+import os
+import re
+import sys
+
+PROJECT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "STM32_FreeRTOS_General_Application"))
+DEF_FILE = os.path.join(PROJECT, "inc", "commands.def")
+OUT_FILE = os.path.join(PROJECT, "inc", "commands_gen.h")
+
+FNV_PRIME = 16777619
+MENU_TEXT_WIDTH = 44
+
+
+def split_args(text):
+    """Split macro arguments on the commas outside string literals."""
+    args, current, in_string, escaped = [], "", False, False
+    for ch in text:
+        if in_string:
+            current += ch
+            if escaped:
+                escaped = False
+            elif ch == "\\":
+                escaped = True
+            elif ch == '"':
+                in_string = False
+        elif ch == '"':
+            in_string = True
+            current += ch
+        elif ch == ",":
+            args.append(current.strip())
+            current = ""
+        else:
+            current += ch
+    args.append(current.strip())
+    return args
+
+
+def parse(path):
+    source = open(path).read()
+    source = re.sub(r"/\*.*?\*/", "", source, flags=re.S)
+    source = re.sub(r"^\s*//.*$", "", source, flags=re.M)
+
+    menus, commands = [], []
+    for match in re.finditer(r"\b(MENU|CMD)\s*\(", source):
+        # Find the closing parenthesis outside string literals
+        depth, pos, in_string = 1, match.end(), False
+        while depth:
+            ch = source[pos]
+            if in_string:
+                if ch == "\\":
+                    pos += 1
+                elif ch == '"':
+                    in_string = False
+            elif ch == '"':
+                in_string = True
+            elif ch == "(":
+                depth += 1
+            elif ch == ")":
+                depth -= 1
+            pos += 1
+        args = split_args(source[match.end():pos - 1])
+        if match.group(1) == "MENU":
+            menu_id, title, prompt = args
+            menus.append({"id": menu_id, "title": literal(title), "prompt": literal(prompt)})
+        else:
+            menu, key, name, aliases, arg, handler, text = args
+            commands.append({"menu": menu, "key": literal(key), "name": literal(name),
+                             "aliases": literal(aliases).split(), "arg": arg, "handler": handler,
+                             "text": literal(text)})
+    return menus, commands
+
+
+def fnv(seed, menu_index, token):
+    h = seed
+    for b in bytes([menu_index]) + token.encode():
+        h = ((h ^ b) * FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def literal(text):
+    """Evaluate C string literals, adjacent ones being concatenated."""
+    return ast.literal_eval("(" + text + ")")
+
+
+def c_string(text):
+    out = ""
+    for ch in text:
+        out += {"\r": "\\r", "\n": "\\n", "\t": "\\t", '"': '\\"', "\\": "\\\\"}.get(ch, ch)
+    return '"' + out + '"'
+
+
+def main():
+    menus, commands = parse(DEF_FILE)
+    menu_index = {m["id"]: i for i, m in enumerate(menus)}
+
+    keys = []
+    for index, cmd in enumerate(commands):
+        if cmd["menu"] not in menu_index:
+            sys.exit("Unknown menu %s for command %s" % (cmd["menu"], cmd["name"]))
+        for token in [cmd["key"], cmd["name"]] + cmd["aliases"]:
+            token = token.lower()
+            # A key may be the name itself
+            if any(k[1] == index and k[2] == token for k in keys):
+                continue
+            if any(k[0] == cmd["menu"] and k[2] == token for k in keys):
+                sys.exit("Token '%s' used twice in menu %s" % (token, cmd["menu"]))
+            keys.append((cmd["menu"], index, token))
+
+    if len(keys) > 255:
+        sys.exit("Too many tokens")
+
+    # Smallest table giving a quick search, at least four slots per token
+    bits = 1
+    while (1 << bits) < 4 * len(keys):
+        bits += 1
+
+    for seed in range(1, 1 << 24):
+        slots = {}
+        for i, (menu, _, token) in enumerate(keys):
+            slot = fnv(seed, menu_index[menu], token) >> (32 - bits)
+            if slot in slots:
+                break
+            slots[slot] = i
+        else:
+            break
+    else:
+        sys.exit("No seed found")
+
+    lines = []
+    lines.append("/**")
+    lines.append("  ******************************************************************************")
+    lines.append("  * @file    commands_gen.h")
+    lines.append("  * @author  Moe2Code")
+    lines.append("  * @version V1.0")
+    lines.append("  * @date    16-Oct-2026")
+    lines.append("  * @brief   Generated by Tools/gen_commands.py from commands.def. Do not edit.")
+    lines.append("  * 		 Holds the perfect hash table of the command tokens and the text of")
+    lines.append("  * 		 each menu. Included by cmd.c only.")
+    lines.append("  ******************************************************************************")
+    lines.append("*/")
+    lines.append("")
+    lines.append("#ifndef COMMANDS_GEN_H")
+    lines.append("#define COMMANDS_GEN_H")
+    lines.append("")
+    lines.append("// CONSTANTS")
+    lines.append("")
+    lines.append("#define CMD_NUM_COMMANDS			%d" % len(commands))
+    lines.append("#define CMD_HASH_SEED				0x%08XUL" % seed)
+    lines.append("#define CMD_HASH_BITS				%d" % bits)
+    lines.append("")
+    lines.append("// GLOBALS")
+    lines.append("")
+    lines.append("// Command tokens")
+    lines.append("static const CmdKey_t xCmdKeys[%d] =" % len(keys))
+    lines.append("{")
+    for menu, index, token in keys:
+        lines.append("	{ eCmdMenu%s, %d, %d, %s }," % (menu, index, len(token), c_string(token)))
+    lines.append("};")
+    lines.append("")
+    lines.append("// Index of the token in xCmdKeys plus one, by slot. 0 if the slot is empty")
+    lines.append("static const uint8_t ucCmdHashSlots[1 << CMD_HASH_BITS] =")
+    lines.append("{")
+    for slot in sorted(slots):
+        lines.append("	[%d] = %d," % (slot, slots[slot] + 1))
+    lines.append("};")
+    lines.append("")
+    lines.append("// Menu text")
+    lines.append("static const char* const pcCmdMenuText[eCmdNumMenus] =")
+    lines.append("{")
+    for menu in menus:
+        text = menu["title"]
+        for cmd in commands:
+            if cmd["menu"] == menu["id"]:
+                if cmd["key"].lower() == cmd["name"].lower():
+                    label = cmd["text"]
+                else:
+                    label = "%s [%s]" % (cmd["text"], cmd["name"])
+                text += "\r\n" + label.ljust(MENU_TEXT_WIDTH) + "----> " + cmd["key"]
+        text += menu["prompt"]
+        parts = text.split("\r\n")
+        lines.append("	[eCmdMenu%s] =" % menu["id"])
+        for i, part in enumerate(parts):
+            piece = ("\r\n" if i > 0 else "") + part
+            if piece:
+                lines.append("		" + c_string(piece))
+        lines[-1] += ","
+    lines.append("};")
+    lines.append("")
+    lines.append("#endif /* COMMANDS_GEN_H */")
+
+    text = "\n".join(lines) + "\n"
+    try:
+        with open(OUT_FILE, newline="") as f:
+            current = f.read()
+    except FileNotFoundError:
+        current = None
+
+    if "--check" in sys.argv[1:]:
+        if current != text:
+            sys.exit("%s is out of date, run Tools/gen_commands.py" % OUT_FILE)
+    elif current != text:
+        with open(OUT_FILE, "w", newline="\n") as f:
+            f.write(text)
+
+    print("%d commands, %d tokens, %d slots, seed 0x%08X" % (len(commands), len(keys), 1 << bits, seed))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,556 @@
+/**
+  ******************************************************************************
+  * @file    alarm_test.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Host test and benchmark of the alarm scheduler (alarm.c). The RTC
+  * 		 is simulated one second at a time: Alarm A matches the date of
+  * 		 the month and the time programmed, as on the target, and the
+  * 		 RTC Alarm interrupt is raised on a match or when the port makes
+  * 		 it pending for an alarm already due.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "alarm.h"
+#include "calendar.h"
+#include "test_util.h"
+
+// CONSTANTS
+
+// Start time of the simulated RTC, 2020-12-03 17:00:00 (RTC_START_TIME of main.c)
+#define SIM_START_TIME				1607014800UL
+
+// Fires recorded at most
+#define SIM_MAX_FIRES				4096
+
+// Rounds of the benchmarks
+#define BENCH_ROUNDS				20000
+
+// TYPES
+
+// An alarm fired
+typedef struct
+{
+	AlarmId_t xId;
+	uint32_t ulArg;
+	uint32_t ulTime;				// Time of the simulated RTC when it fired
+} SimFire_t;
+
+// SIMULATED RTC GLOBALS
+
+static uint32_t ulSimNow = SIM_START_TIME;
+static BaseType_t xSimEnabled = pdFALSE;
+static uint32_t ulSimAlarmTime = 0;
+static BaseType_t xSimPending = pdFALSE;
+static uint32_t ulSimPrograms = 0;
+
+static SimFire_t xSimFires[SIM_MAX_FIRES];
+static uint32_t ulSimNumFires = 0;
+
+// FUNCTION PROTOTYPES
+
+// To check whether the simulated Alarm A matches the simulated RTC
+static BaseType_t xSimMatch(void);
+
+// To start a test with an empty scheduler and the RTC at a time
+static void vSimReset(uint32_t ulNow);
+
+// To run the simulated RTC till a time, raising the RTC Alarm interrupt
+static void vSimRun(uint32_t ulUntil);
+
+// To record a fire
+static void vSimCallback(AlarmId_t xId, void* pvArg, BaseType_t* pxHigherPriorityTaskWoken);
+/*******************************************************************************
+*   Procedure: vAlarmPortProgram
+*
+*   Description: This function programs the simulated Alarm A
+*
+*   Notes: As on the target, the interrupt is made pending for an alarm
+*   	   already due.
+*
+*   Parameters: ulTime - The fire time, in Unix time
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAlarmPortProgram(uint32_t ulTime)
+{
+	ulSimAlarmTime = ulTime;
+	xSimEnabled = pdTRUE;
+	ulSimPrograms++;
+
+	if( ulTime <= ulSimNow )
+	{
+		xSimPending = pdTRUE;
+	}
+}
+/*******************************************************************************
+*   Procedure: vAlarmPortDisable
+*
+*   Description: This function turns the simulated Alarm A off
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+void vAlarmPortDisable(void)
+{
+	xSimEnabled = pdFALSE;
+}
+/*******************************************************************************
+*   Procedure: xSimMatch
+*
+*   Description: This function checks whether the simulated Alarm A matches
+*   			 the simulated RTC
+*
+*   Notes: Only the date of the month and the time are compared, as
+*   	   vAlarmPortProgram() of main.c programs them.
+*
+*   Parameters: None
+*
+*   Return: BaseType_t - pdTRUE on a match, otherwise pdFALSE
+*
+*******************************************************************************/
+static BaseType_t xSimMatch(void)
+{
+	RTC_DateTypeDef xNowDate, xAlarmDate;
+	RTC_TimeTypeDef xNowTime, xAlarmTime;
+
+	if( xSimEnabled == pdFALSE )
+	{
+		return(pdFALSE);
+	}
+
+	vCalendarToRtc( ulSimNow, &xNowDate, &xNowTime );
+	vCalendarToRtc( ulSimAlarmTime, &xAlarmDate, &xAlarmTime );
+
+	return( (BaseType_t)( xNowDate.RTC_Date == xAlarmDate.RTC_Date &&
+						  xNowTime.RTC_Hours == xAlarmTime.RTC_Hours &&
+						  xNowTime.RTC_Minutes == xAlarmTime.RTC_Minutes &&
+						  xNowTime.RTC_Seconds == xAlarmTime.RTC_Seconds ) );
+}
+/*******************************************************************************
+*   Procedure: vSimReset
+*
+*   Description: This function empties the scheduler and sets the simulated RTC
+*
+*   Notes: None
+*
+*   Parameters: ulNow - The time of the simulated RTC, in Unix time
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vSimReset(uint32_t ulNow)
+{
+	vAlarmInit();
+	ulSimNow = ulNow;
+	xSimEnabled = pdFALSE;
+	xSimPending = pdFALSE;
+	ulSimPrograms = 0;
+	ulSimNumFires = 0;
+}
+/*******************************************************************************
+*   Procedure: vSimRun
+*
+*   Description: This function runs the simulated RTC one second at a time till
+*   			 a time, and runs the RTC Alarm interrupt when it is pending
+*
+*   Notes: A pending interrupt is run before the RTC moves on, as on the target.
+*
+*   Parameters: ulUntil - The time to stop at, in Unix time
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vSimRun(uint32_t ulUntil)
+{
+	BaseType_t xWoken = pdFALSE;
+
+	for( ;; )
+	{
+		if( xSimPending == pdTRUE )
+		{
+			xSimPending = pdFALSE;
+			vAlarmFireFromISR( ulSimNow, &xWoken );
+		}
+
+		if( ulSimNow >= ulUntil )
+		{
+			break;
+		}
+
+		ulSimNow++;
+
+		if( xSimMatch() == pdTRUE )
+		{
+			xSimPending = pdTRUE;
+		}
+	}
+}
+/*******************************************************************************
+*   Procedure: vSimCallback
+*
+*   Description: This function records an alarm fired, with the time of the
+*   			 simulated RTC
+*
+*   Notes: None
+*
+*   Parameters: xId - The ID of the alarm
+*   			pvArg - The argument given when the alarm was added
+*   			pxHigherPriorityTaskWoken - Not used
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vSimCallback(AlarmId_t xId, void* pvArg, BaseType_t* pxHigherPriorityTaskWoken)
+{
+	(void)pxHigherPriorityTaskWoken;
+
+	if( ulSimNumFires < SIM_MAX_FIRES )
+	{
+		xSimFires[ulSimNumFires].xId = xId;
+		xSimFires[ulSimNumFires].ulArg = (uint32_t)(uintptr_t)pvArg;
+		xSimFires[ulSimNumFires].ulTime = ulSimNow;
+	}
+	ulSimNumFires++;
+}
+/*******************************************************************************
+*   Procedure: vTestOrder
+*
+*   Description: This function checks that one-shot alarms fire once each, at
+*   			 their time and earliest first
+*
+*   Notes: The alarms are spread over 60 days, so the RTC also fires early
+*   	   for those more than a month away.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestOrder(void)
+{
+	uint32_t ulTimes[ALARM_MAX_ALARMS];
+	uint32_t ulFired[ALARM_MAX_ALARMS];
+	uint32_t ulEnd = SIM_START_TIME;
+	uint32_t i;
+
+	vSimReset( SIM_START_TIME );
+	srand( 1 );
+
+	for( i = 0; i < ALARM_MAX_ALARMS; i++ )
+	{
+		ulTimes[i] = SIM_START_TIME + 1 + (uint32_t)rand() % ( 60 * CALENDAR_SECONDS_PER_DAY );
+		ulEnd = ( ulTimes[i] > ulEnd ) ? ulTimes[i] : ulEnd;
+		ulFired[i] = 0;
+		TEST_CHECK( xAlarmAdd( ulTimes[i], 0, vSimCallback, (void*)(uintptr_t)i ) != ALARM_NONE );
+	}
+
+	// The scheduler is full
+	TEST_CHECK( xAlarmAdd( ulEnd, 0, vSimCallback, NULL ) == ALARM_NONE );
+
+	vSimRun( ulEnd + 1 );
+
+	TEST_CHECK( ulSimNumFires == ALARM_MAX_ALARMS );
+	TEST_CHECK( ulAlarmCount() == 0 );
+	TEST_CHECK( xSimEnabled == pdFALSE );
+
+	for( i = 0; i < ulSimNumFires && i < SIM_MAX_FIRES; i++ )
+	{
+		TEST_CHECK( xSimFires[i].ulTime == ulTimes[xSimFires[i].ulArg] );
+		TEST_CHECK( i == 0 || xSimFires[i].ulTime >= xSimFires[i - 1].ulTime );
+		ulFired[xSimFires[i].ulArg]++;
+	}
+
+	for( i = 0; i < ALARM_MAX_ALARMS; i++ )
+	{
+		TEST_CHECK( ulFired[i] == 1 );
+	}
+}
+/*******************************************************************************
+*   Procedure: vTestCancel
+*
+*   Description: This function checks that removed alarms do not fire and the
+*   			 others still fire in order
+*
+*   Notes: The earliest alarm is removed too, which programs the RTC with
+*   	   the next one.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestCancel(void)
+{
+	AlarmId_t xIds[ALARM_MAX_ALARMS];
+	uint32_t ulTime, ulPeriod;
+	uint32_t i;
+
+	vSimReset( SIM_START_TIME );
+
+	// Added latest first, so every alarm becomes the earliest in turn
+	for( i = 0; i < ALARM_MAX_ALARMS; i++ )
+	{
+		xIds[i] = xAlarmAdd( SIM_START_TIME + 1000 - i * 10, 0, vSimCallback, (void*)(uintptr_t)i );
+		TEST_CHECK( xIds[i] != ALARM_NONE );
+		TEST_CHECK( ulSimAlarmTime == SIM_START_TIME + 1000 - i * 10 );
+	}
+
+	// Remove the odd ones, the earliest included
+	for( i = 1; i < ALARM_MAX_ALARMS; i += 2 )
+	{
+		TEST_CHECK( xAlarmRemove( xIds[i] ) == pdPASS );
+		TEST_CHECK( xAlarmGet( xIds[i], &ulTime, &ulPeriod ) == pdFAIL );
+		TEST_CHECK( xAlarmRemove( xIds[i] ) == pdFAIL );
+	}
+
+	TEST_CHECK( ulAlarmCount() == ALARM_MAX_ALARMS / 2 );
+	TEST_CHECK( ulSimAlarmTime == SIM_START_TIME + 1000 - ( ALARM_MAX_ALARMS - 2 ) * 10 );
+	TEST_CHECK( xAlarmGet( xIds[0], &ulTime, &ulPeriod ) == pdPASS && ulTime == SIM_START_TIME + 1000 && ulPeriod == 0 );
+
+	vSimRun( SIM_START_TIME + 1000 );
+
+	TEST_CHECK( ulSimNumFires == ALARM_MAX_ALARMS / 2 );
+
+	for( i = 0; i < ulSimNumFires && i < SIM_MAX_FIRES; i++ )
+	{
+		TEST_CHECK( ( xSimFires[i].ulArg & 1 ) == 0 );
+		TEST_CHECK( xSimFires[i].ulTime == SIM_START_TIME + 1000 - xSimFires[i].ulArg * 10 );
+		TEST_CHECK( i == 0 || xSimFires[i].ulTime > xSimFires[i - 1].ulTime );
+	}
+
+	TEST_CHECK( xAlarmRemove( ALARM_NONE ) == pdFAIL );
+	TEST_CHECK( xAlarmRemove( ALARM_MAX_ALARMS ) == pdFAIL );
+}
+/*******************************************************************************
+*   Procedure: vTestPeriodic
+*
+*   Description: This function checks that recurring alarms are put back in
+*   			 the heap at their next fire time each time they fire
+*
+*   Notes: A daily alarm, an alarm every 90 minutes and a one-shot alarm at
+*   	   the same time as one of them.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestPeriodic(void)
+{
+	uint32_t ulCounts[3] = { 0, 0, 0 };
+	uint32_t ulLast[3] = { 0, 0, 0 };
+	uint32_t ulStarts[3] = { SIM_START_TIME + 60, SIM_START_TIME + 30, SIM_START_TIME + 60 + ALARM_PERIOD_DAILY };
+	uint32_t ulPeriods[3] = { ALARM_PERIOD_DAILY, 90 * 60, 0 };
+	uint32_t ulArg;
+	uint32_t i;
+
+	vSimReset( SIM_START_TIME );
+
+	for( i = 0; i < 3; i++ )
+	{
+		TEST_CHECK( xAlarmAdd( ulStarts[i], ulPeriods[i], vSimCallback, (void*)(uintptr_t)i ) != ALARM_NONE );
+	}
+
+	vSimRun( SIM_START_TIME + 3 * ALARM_PERIOD_DAILY );
+
+	for( i = 0; i < ulSimNumFires && i < SIM_MAX_FIRES; i++ )
+	{
+		ulArg = xSimFires[i].ulArg;
+		TEST_CHECK( xSimFires[i].ulTime == ulStarts[ulArg] + ulCounts[ulArg] * ulPeriods[ulArg] );
+		TEST_CHECK( i == 0 || xSimFires[i].ulTime >= xSimFires[i - 1].ulTime );
+		ulLast[ulArg] = xSimFires[i].ulTime;
+		ulCounts[ulArg]++;
+	}
+
+	TEST_CHECK( ulCounts[0] == 3 );
+	TEST_CHECK( ulCounts[1] == 48 );
+	TEST_CHECK( ulCounts[2] == 1 );
+	TEST_CHECK( ulLast[0] == SIM_START_TIME + 60 + 2 * ALARM_PERIOD_DAILY );
+	TEST_CHECK( ulAlarmCount() == 2 );
+	TEST_CHECK( xSimEnabled == pdTRUE );
+}
+/*******************************************************************************
+*   Procedure: vTestRtcSetForward
+*
+*   Description: This function sets the clock past a pending alarm and checks
+*   			 that vAlarmRtcChanged() makes it fire at once
+*
+*   Notes: The RTC matches the date of the month, so without programming it
+*   	   again the alarm would not fire till the next month. A recurring
+*   	   alarm fires once only for the periods missed.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestRtcSetForward(void)
+{
+	uint32_t ulSetTime = SIM_START_TIME + 2 * 3600 + 17;
+	uint32_t ulTime, ulPeriod;
+	AlarmId_t xPeriodic;
+
+	vSimReset( SIM_START_TIME );
+
+	TEST_CHECK( xAlarmAdd( SIM_START_TIME + 100, 0, vSimCallback, (void*)0 ) != ALARM_NONE );
+	xPeriodic = xAlarmAdd( SIM_START_TIME + 30, 600, vSimCallback, (void*)1 );
+	TEST_CHECK( xPeriodic != ALARM_NONE );
+
+	vSimRun( SIM_START_TIME + 10 );
+	TEST_CHECK( ulSimNumFires == 0 );
+
+	// Set the clock forward past both alarms, as the clock menu does
+	ulSimNow = ulSetTime;
+	vAlarmRtcChanged();
+	vSimRun( ulSetTime );
+
+	TEST_CHECK( ulSimNumFires == 2 );
+	TEST_CHECK( xSimFires[0].ulArg == 1 && xSimFires[0].ulTime == ulSetTime );
+	TEST_CHECK( xSimFires[1].ulArg == 0 && xSimFires[1].ulTime == ulSetTime );
+	TEST_CHECK( xAlarmGet( xPeriodic, &ulTime, &ulPeriod ) == pdPASS );
+	TEST_CHECK( ulTime > ulSetTime && ulTime <= ulSetTime + 600 && ( ulTime - ( SIM_START_TIME + 30 ) ) % 600 == 0 );
+	TEST_CHECK( ulSimAlarmTime == ulTime );
+
+	// And on at its period again
+	vSimRun( ulTime );
+	TEST_CHECK( ulSimNumFires == 3 && xSimFires[2].ulTime == ulTime );
+}
+/*******************************************************************************
+*   Procedure: vTestRtcSetBack
+*
+*   Description: This function sets the clock back and checks that the alarm
+*   			 still fires at its time, not earlier
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestRtcSetBack(void)
+{
+	uint32_t ulPrograms;
+
+	vSimReset( SIM_START_TIME + ALARM_PERIOD_DAILY );
+
+	TEST_CHECK( xAlarmAdd( SIM_START_TIME + ALARM_PERIOD_DAILY + 100, 0, vSimCallback, (void*)0 ) != ALARM_NONE );
+
+	ulSimNow = SIM_START_TIME;
+	ulPrograms = ulSimPrograms;
+	vAlarmRtcChanged();
+	TEST_CHECK( ulSimPrograms == ulPrograms + 1 );
+	TEST_CHECK( xSimPending == pdFALSE );
+
+	vSimRun( SIM_START_TIME + ALARM_PERIOD_DAILY + 99 );
+	TEST_CHECK( ulSimNumFires == 0 );
+	vSimRun( SIM_START_TIME + ALARM_PERIOD_DAILY + 100 );
+	TEST_CHECK( ulSimNumFires == 1 );
+}
+/*******************************************************************************
+*   Procedure: vBenchmark
+*
+*   Description: This function times adding, removing and firing alarms with
+*   			 a full scheduler
+*
+*   Notes: The RTC is not simulated here, the port only records the time
+*   	   programmed. The times are of the PC, they only compare the
+*   	   operations with one another.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vBenchmark(void)
+{
+	AlarmId_t xIds[ALARM_MAX_ALARMS];
+	BaseType_t xWoken = pdFALSE;
+	uint64_t ullAdd = 0, ullRemove = 0, ullFire = 0, ullStart;
+	uint32_t ulRound, i, j;
+	uint32_t ulTemp;
+
+	srand( 2 );
+
+	for( ulRound = 0; ulRound < BENCH_ROUNDS; ulRound++ )
+	{
+		vSimReset( SIM_START_TIME );
+
+		ullStart = ullBenchNow();
+		for( i = 0; i < ALARM_MAX_ALARMS; i++ )
+		{
+			xIds[i] = xAlarmAdd( SIM_START_TIME + 1 + (uint32_t)rand() % 100000, 0, vSimCallback, NULL );
+		}
+		ullAdd += ullBenchNow() - ullStart;
+
+		// Shuffle, to remove from anywhere in the heap
+		for( i = ALARM_MAX_ALARMS - 1; i > 0; i-- )
+		{
+			j = (uint32_t)rand() % ( i + 1 );
+			ulTemp = (uint32_t)xIds[i];
+			xIds[i] = xIds[j];
+			xIds[j] = (AlarmId_t)ulTemp;
+		}
+
+		ullStart = ullBenchNow();
+		for( i = 0; i < ALARM_MAX_ALARMS; i++ )
+		{
+			xAlarmRemove( xIds[i] );
+		}
+		ullRemove += ullBenchNow() - ullStart;
+	}
+
+	// Recurring alarms with different periods, each fire puts one back in the heap
+	vSimReset( SIM_START_TIME );
+	for( i = 0; i < ALARM_MAX_ALARMS; i++ )
+	{
+		xAlarmAdd( SIM_START_TIME + 1 + i, 7 + i * 3, vSimCallback, NULL );
+	}
+
+	ulSimNumFires = 0;
+	ullStart = ullBenchNow();
+	while( ulSimNumFires < BENCH_ROUNDS * ALARM_MAX_ALARMS )
+	{
+		vAlarmFireFromISR( ulSimAlarmTime, &xWoken );
+	}
+	ullFire = ullBenchNow() - ullStart;
+
+	printf("alarm: %u alarms, add %.1f ns, remove %.1f ns, fire and put back %.1f ns\n",
+		   (unsigned)ALARM_MAX_ALARMS,
+		   (double)ullAdd / ( (double)BENCH_ROUNDS * ALARM_MAX_ALARMS ),
+		   (double)ullRemove / ( (double)BENCH_ROUNDS * ALARM_MAX_ALARMS ),
+		   (double)ullFire / (double)ulSimNumFires);
+}
+
+int main(void)
+{
+	vTestOrder();
+	vTestCancel();
+	vTestPeriodic();
+	vTestRtcSetForward();
+	vTestRtcSetBack();
+
+	if( ulTestFailures != 0 )
+	{
+		printf("alarm: %lu checks failed\n", (unsigned long)ulTestFailures);
+		return(1);
+	}
+
+	printf("alarm: all tests passed\n");
+	vBenchmark();
+
+	return(0);
+}
@@ -0,0 +1,442 @@
+/**
+  ******************************************************************************
+  * @file    fmt_test.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Host property test and benchmark of the formatter (fmt.c). Random
+  * 		 conversions, with random flags, widths, precisions and length
+  * 		 modifiers, must give the text and the length snprintf() of the C
+  * 		 library gives, into buffers of any size. The benchmark times the
+  * 		 lines the application prints against snprintf(). On the PC this
+  * 		 is glibc, not the newlib of the target, so the times only compare
+  * 		 the two on the same machine.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "fmt.h"
+#include "test_util.h"
+
+// CONSTANTS
+
+// Random cases of each property
+#define TEST_ROUNDS					1000000
+
+// Rounds of the benchmarks
+#define BENCH_ROUNDS				1000000
+
+// Size of the output buffers, and of the format strings built
+#define TEST_OUT_SIZE				128
+#define TEST_FMT_SIZE				32
+
+// FUNCTION PROTOTYPES
+
+// To build a random conversion specification
+static void vTestRandomSpec(char* pcFmt, const char* pcLength, char cConv, uint64_t ullBits);
+
+// To compare the output of both formatters for one format
+static void vTestCompare(const char* pcFmt, const char* pcOut, size_t xLen, const char* pcExpected, size_t xExpectedLen);
+
+// To check the conversions against snprintf()
+static void vTestIntegers(void);
+static void vTestText(void);
+static void vTestFixed(void);
+static void vTestTruncation(void);
+
+// To time the formatter against snprintf()
+static void vBenchmark(void);
+/*******************************************************************************
+*   Procedure: vTestRandomSpec
+*
+*   Description: This function builds a conversion specification with random
+*   			 flags, width and precision, e.g. "%-+08.3lld"
+*
+*   Notes: The '0' flag is left out of %c and %s, and the precision of %c,
+*   	   where the C standard leaves them undefined.
+*
+*   Parameters: pcFmt - A pointer to the buffer of TEST_FMT_SIZE characters
+*   			pcLength - The length modifier, e.g. "ll" or ""
+*   			cConv - The conversion character
+*   			ullBits - Random bits choosing the specification
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestRandomSpec(char* pcFmt, const char* pcLength, char cConv, uint64_t ullBits)
+{
+	char* pcNext = pcFmt;
+
+	*pcNext++ = '%';
+	if( ullBits & 0x01 )
+	{
+		*pcNext++ = '-';
+	}
+	if( ( ullBits & 0x02 ) && cConv != 'c' && cConv != 's' )
+	{
+		*pcNext++ = '0';
+	}
+	if( ullBits & 0x04 )
+	{
+		*pcNext++ = '+';
+	}
+	if( ullBits & 0x08 )
+	{
+		*pcNext++ = ' ';
+	}
+	if( ullBits & 0x10 )
+	{
+		pcNext += sprintf( pcNext, "%u", (unsigned)( ( ullBits >> 8 ) % 25 ) );
+	}
+	if( ( ullBits & 0x20 ) && cConv != 'c' )
+	{
+		pcNext += sprintf( pcNext, ".%u", (unsigned)( ( ullBits >> 16 ) % ( ( cConv == 'f' ) ? 10 : 25 ) ) );
+	}
+
+	sprintf( pcNext, "%s%c", pcLength, cConv );
+}
+/*******************************************************************************
+*   Procedure: vTestCompare
+*
+*   Description: This function checks that the formatter gave the text and the
+*   			 length snprintf() gave, and prints the format if it did not
+*
+*   Notes: None
+*
+*   Parameters: pcFmt - The format, for the failure message
+*   			pcOut - The text of the formatter
+*   			xLen - The length returned by the formatter
+*   			pcExpected - The text of snprintf()
+*   			xExpectedLen - The length returned by snprintf()
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestCompare(const char* pcFmt, const char* pcOut, size_t xLen, const char* pcExpected, size_t xExpectedLen)
+{
+	if( xLen != xExpectedLen || strcmp( pcOut, pcExpected ) != 0 )
+	{
+		if( ulTestFailures < 20 )
+		{
+			printf("FAIL \"%s\": \"%s\" (%zu), expected \"%s\" (%zu)\n", pcFmt, pcOut, xLen, pcExpected, xExpectedLen);
+		}
+		ulTestFailures++;
+	}
+}
+/*******************************************************************************
+*   Procedure: vTestIntegers
+*
+*   Description: This function checks %d, %i, %u, %x and %X with every length
+*   			 modifier against snprintf()
+*
+*   Notes: The values are cast to the type of the length modifier, as the
+*   	   caller of a printf function does.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestIntegers(void)
+{
+	static const char* const pcLengths[6] = { "", "h", "hh", "l", "ll", "z" };
+	static const char cConvs[5] = { 'd', 'i', 'u', 'x', 'X' };
+	char cFmt[TEST_FMT_SIZE];
+	char cOut[TEST_OUT_SIZE];
+	char cExpected[TEST_OUT_SIZE];
+	uint64_t ullValue;
+	uint32_t ulLength;
+	char cConv;
+	size_t xLen = 0;
+	int iExpectedLen = 0;
+
+	for( uint32_t i = 0; i < TEST_ROUNDS; i++ )
+	{
+		ullValue = ullTestRandom();
+		if( i & 1 )
+		{
+			ullValue = 0 - ullValue;
+		}
+		ulLength = i % 6;
+		cConv = cConvs[( i / 6 ) % 5];
+		vTestRandomSpec( cFmt, pcLengths[ulLength], cConv, ullTestRandom() );
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat"
+		switch( ulLength )
+		{
+			case 0:
+				xLen = xFmtSnprintf( cOut, sizeof(cOut), cFmt, (int)ullValue );
+				iExpectedLen = snprintf( cExpected, sizeof(cExpected), cFmt, (int)ullValue );
+				break;
+			case 1:
+			case 2:
+				// short and char are promoted to int
+				xLen = xFmtSnprintf( cOut, sizeof(cOut), cFmt, (int)ullValue );
+				iExpectedLen = snprintf( cExpected, sizeof(cExpected), cFmt, (int)ullValue );
+				break;
+			case 3:
+				xLen = xFmtSnprintf( cOut, sizeof(cOut), cFmt, (long)ullValue );
+				iExpectedLen = snprintf( cExpected, sizeof(cExpected), cFmt, (long)ullValue );
+				break;
+			case 4:
+				xLen = xFmtSnprintf( cOut, sizeof(cOut), cFmt, (long long)ullValue );
+				iExpectedLen = snprintf( cExpected, sizeof(cExpected), cFmt, (long long)ullValue );
+				break;
+			default:
+				xLen = xFmtSnprintf( cOut, sizeof(cOut), cFmt, (size_t)ullValue );
+				iExpectedLen = snprintf( cExpected, sizeof(cExpected), cFmt, (size_t)ullValue );
+				break;
+		}
+#pragma GCC diagnostic pop
+
+		vTestCompare( cFmt, cOut, xLen, cExpected, (size_t)iExpectedLen );
+	}
+
+	// The limits
+	xLen = xFmtSnprintf( cOut, sizeof(cOut), "%lld %llu %d", (long long)INT64_MIN, (unsigned long long)UINT64_MAX, (int)INT32_MIN );
+	TEST_CHECK( strcmp( cOut, "-9223372036854775808 18446744073709551615 -2147483648" ) == 0 && xLen == strlen( cOut ) );
+}
+/*******************************************************************************
+*   Procedure: vTestText
+*
+*   Description: This function checks %c, %s and %% against snprintf(), and
+*   			 the text between the conversions
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestText(void)
+{
+	static const char* const pcWords[4] = { "", "a", "Alarm", "Tick drift from the RTC" };
+	char cFmt[TEST_FMT_SIZE * 2];
+	char cOut[TEST_OUT_SIZE];
+	char cExpected[TEST_OUT_SIZE];
+	const char* pcWord;
+	char cChar;
+	size_t xLen;
+	int iExpectedLen;
+
+	for( uint32_t i = 0; i < TEST_ROUNDS; i++ )
+	{
+		pcWord = pcWords[i % 4];
+		cChar = (char)( ' ' + ( ullTestRandom() % 95 ) );
+
+		strcpy( cFmt, "<" );
+		vTestRandomSpec( &cFmt[1], "", 's', ullTestRandom() );
+		strcat( cFmt, "|" );
+		vTestRandomSpec( &cFmt[strlen(cFmt)], "", 'c', ullTestRandom() );
+		strcat( cFmt, "|100%%>" );
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+		xLen = xFmtSnprintf( cOut, sizeof(cOut), cFmt, pcWord, cChar );
+		iExpectedLen = snprintf( cExpected, sizeof(cExpected), cFmt, pcWord, cChar );
+#pragma GCC diagnostic pop
+
+		vTestCompare( cFmt, cOut, xLen, cExpected, (size_t)iExpectedLen );
+	}
+}
+/*******************************************************************************
+*   Procedure: vTestFixed
+*
+*   Description: This function checks %f against snprintf(), and xFmtFixed()
+*   			 against the scaled value written with integers
+*
+*   Notes: The doubles are decimals with as many digits as the precision, up
+*   	   to 15 significant digits, which a double holds exactly enough that
+*   	   both formatters round them the same way. Values exactly halfway
+*   	   between two outputs in binary are rounded half up by fmt.c and to
+*   	   even by the C library, they are not drawn.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestFixed(void)
+{
+	static const double dPow10[10] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+	char cFmt[TEST_FMT_SIZE];
+	char cOut[TEST_OUT_SIZE];
+	char cExpected[TEST_OUT_SIZE];
+	uint32_t ulDecimals;
+	int64_t llScaled;
+	int32_t lScaled;
+	uint32_t ulMag;
+	double dValue;
+	size_t xLen;
+	int iExpectedLen;
+
+	for( uint32_t i = 0; i < TEST_ROUNDS; i++ )
+	{
+		ulDecimals = i % 10;
+		llScaled = (int64_t)( ullTestRandom() % 1000000000000000ULL ) * ( ( i & 1 ) ? -1 : 1 );
+		dValue = (double)llScaled / dPow10[ulDecimals];
+
+		sprintf( cFmt, "%%%s%u.%uf", ( i & 2 ) ? "+" : "", (unsigned)( i % 30 ), (unsigned)ulDecimals );
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+		xLen = xFmtSnprintf( cOut, sizeof(cOut), cFmt, dValue );
+		iExpectedLen = snprintf( cExpected, sizeof(cExpected), cFmt, dValue );
+#pragma GCC diagnostic pop
+
+		vTestCompare( cFmt, cOut, xLen, cExpected, (size_t)iExpectedLen );
+
+		// xFmtFixed() takes an int32 scaled value
+		lScaled = (int32_t)( llScaled % 2147483647 );
+		ulMag = ( lScaled < 0 ) ? 0 - (uint32_t)lScaled : (uint32_t)lScaled;
+		if( ulDecimals == 0 )
+		{
+			iExpectedLen = sprintf( cExpected, "%s%" PRIu32, ( lScaled < 0 ) ? "-" : "", ulMag );
+		}
+		else
+		{
+			iExpectedLen = sprintf( cExpected, "%s%" PRIu32 ".%0*" PRIu32, ( lScaled < 0 ) ? "-" : "",
+									ulMag / (uint32_t)dPow10[ulDecimals], (int)ulDecimals, ulMag % (uint32_t)dPow10[ulDecimals] );
+		}
+		xLen = xFmtFixed( cOut, sizeof(cOut), lScaled, (uint8_t)ulDecimals );
+		vTestCompare( "xFmtFixed", cOut, xLen, cExpected, (size_t)iExpectedLen );
+	}
+}
+/*******************************************************************************
+*   Procedure: vTestTruncation
+*
+*   Description: This function checks that output cut by a small buffer is the
+*   			 start of the text snprintf() cuts, and that the full length
+*   			 is still returned
+*
+*   Notes: A size of 0 must leave the buffer untouched.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestTruncation(void)
+{
+	char cOut[TEST_OUT_SIZE];
+	char cExpected[TEST_OUT_SIZE];
+	size_t xSize;
+	size_t xLen;
+	int iExpectedLen;
+
+	for( xSize = 0; xSize < 48; xSize++ )
+	{
+		memset( cOut, '#', sizeof(cOut) );
+		memset( cExpected, '#', sizeof(cExpected) );
+
+		xLen = xFmtSnprintf( cOut, xSize, "\r\nAlarm %ld: %02d-%02d-%02d %02d:%02d:%02d %5.2f", -3L, 26, 10, 16, 8, 5, 0, -12.5 );
+		iExpectedLen = snprintf( cExpected, xSize, "\r\nAlarm %ld: %02d-%02d-%02d %02d:%02d:%02d %5.2f", -3L, 26, 10, 16, 8, 5, 0, -12.5 );
+
+		TEST_CHECK( xLen == (size_t)iExpectedLen && memcmp( cOut, cExpected, sizeof(cOut) ) == 0 );
+	}
+}
+/*******************************************************************************
+*   Procedure: vBenchmark
+*
+*   Description: This function times three lines the application prints with
+*   			 xFmtSnprintf() and with snprintf(): an alarm with its date and
+*   			 time, a row of the task statistics, and a temperature
+*
+*   Notes: The arguments change every round so that neither formatter prints
+*   	   the same digits over and over.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vBenchmark(void)
+{
+	static const char* const pcNames[4] = { "Menu", "Log", "UART Write", "Temp Monitor" };
+	char cOut[TEST_OUT_SIZE];
+	volatile size_t xSink = 0;
+	uint64_t ullFmt[3];
+	uint64_t ullLibc[3];
+	uint64_t ullStart;
+	uint32_t i;
+
+	ullStart = ullBenchNow();
+	for( i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		xSink += xFmtSnprintf( cOut, sizeof(cOut), "\r\nAlarm %ld: %02d-%02d-%02d %02d:%02d:%02d",
+							   (long)( i & 31 ), (int)( i % 100 ), (int)( i % 12 ) + 1, (int)( i % 28 ) + 1,
+							   (int)( i % 24 ), (int)( i % 60 ), (int)( ( i >> 6 ) % 60 ) );
+	}
+	ullFmt[0] = ullBenchNow() - ullStart;
+
+	ullStart = ullBenchNow();
+	for( i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		xSink += (size_t)snprintf( cOut, sizeof(cOut), "\r\nAlarm %ld: %02d-%02d-%02d %02d:%02d:%02d",
+								   (long)( i & 31 ), (int)( i % 100 ), (int)( i % 12 ) + 1, (int)( i % 28 ) + 1,
+								   (int)( i % 24 ), (int)( i % 60 ), (int)( ( i >> 6 ) % 60 ) );
+	}
+	ullLibc[0] = ullBenchNow() - ullStart;
+
+	ullStart = ullBenchNow();
+	for( i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		xSink += xFmtSnprintf( cOut, sizeof(cOut), "\r\n%-20s %12lu  %3lu.%lu%%",
+							   pcNames[i & 3], (unsigned long)i * 7919UL, (unsigned long)( i % 100 ), (unsigned long)( i % 10 ) );
+	}
+	ullFmt[1] = ullBenchNow() - ullStart;
+
+	ullStart = ullBenchNow();
+	for( i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		xSink += (size_t)snprintf( cOut, sizeof(cOut), "\r\n%-20s %12lu  %3lu.%lu%%",
+								   pcNames[i & 3], (unsigned long)i * 7919UL, (unsigned long)( i % 100 ), (unsigned long)( i % 10 ) );
+	}
+	ullLibc[1] = ullBenchNow() - ullStart;
+
+	ullStart = ullBenchNow();
+	for( i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		xSink += xFmtSnprintf( cOut, sizeof(cOut), "Temp %.2f C", (double)( (int32_t)( i % 12000 ) - 4000 ) / 100.0 );
+	}
+	ullFmt[2] = ullBenchNow() - ullStart;
+
+	ullStart = ullBenchNow();
+	for( i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		xSink += (size_t)snprintf( cOut, sizeof(cOut), "Temp %.2f C", (double)( (int32_t)( i % 12000 ) - 4000 ) / 100.0 );
+	}
+	ullLibc[2] = ullBenchNow() - ullStart;
+
+	printf("fmt: xFmtSnprintf against snprintf, alarm line %.1f / %.1f ns, stats row %.1f / %.1f ns, temperature %.1f / %.1f ns\n",
+		   (double)ullFmt[0] / BENCH_ROUNDS, (double)ullLibc[0] / BENCH_ROUNDS,
+		   (double)ullFmt[1] / BENCH_ROUNDS, (double)ullLibc[1] / BENCH_ROUNDS,
+		   (double)ullFmt[2] / BENCH_ROUNDS, (double)ullLibc[2] / BENCH_ROUNDS);
+}
+
+int main(void)
+{
+	vTestIntegers();
+	vTestText();
+	vTestFixed();
+	vTestTruncation();
+
+	if( ulTestFailures != 0 )
+	{
+		printf("fmt: %lu checks failed\n", (unsigned long)ulTestFailures);
+		return(1);
+	}
+
+	printf("fmt: all tests passed\n");
+	vBenchmark();
+
+	return(0);
+}
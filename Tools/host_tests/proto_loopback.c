@@ -0,0 +1,241 @@
+/**
+  ******************************************************************************
+  * @file    proto_loopback.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Stand-in for the board in protocol mode (main menu option 9).
+  * 		 The bytes read from stdin are fed to xProtoFeed() of proto.c, so
+  * 		 the COBS framing and the CRC checks are the ones of the firmware,
+  * 		 and the responses are written to stdout. The requests are
+  * 		 answered like vProtoHandleRequest() of main.c does, with the same
+  * 		 length and range checks and the calculator of calc.c, against a
+  * 		 simulated clock instead of the RTC. Once PROTO_EXIT is answered, the number of frames dropped is
+  * 		 written to stderr. proto_loopback_test.py drives it with
+  * 		 Host_Client/proto_client.py.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "console.h"
+#include "console_in.h"
+#include "calendar.h"
+#include "calc.h"
+#include "proto.h"
+
+// CONSTANTS
+
+// Time of the simulated clock at start, 2020-12-03 17:00:00 (RTC_START_TIME of main.c)
+#define LOOPBACK_START_TIME			1607014800UL
+
+// LOOPBACK GLOBALS
+
+// Simulated clock, in Unix time
+static uint32_t ulLoopbackTime = LOOPBACK_START_TIME;
+
+// FUNCTION PROTOTYPES
+
+// To answer a request
+static void vLoopbackHandleRequest(const ProtoFrame_t* pxReq);
+/*******************************************************************************
+*   Procedure: vConsoleWrite
+*
+*   Description: This function writes the responses of proto.c to stdout
+*
+*   Notes: Flushed at once, the host waits for each response.
+*
+*   Parameters: pcData - A pointer to the bytes
+*   			xLen - The number of bytes
+*   			ePolicy - Not used
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleWrite(const char* pcData, size_t xLen, ConsolePolicy_t ePolicy)
+{
+	(void)ePolicy;
+
+	fwrite( pcData, 1, xLen, stdout );
+	fflush( stdout );
+}
+/*******************************************************************************
+*   Procedure: vConsoleInSetRaw
+*
+*   Description: This function does nothing, stdin is always read raw
+*
+*   Notes: None
+*
+*   Parameters: xRaw - Not used
+*
+*   Return: None
+*
+*******************************************************************************/
+void vConsoleInSetRaw(BaseType_t xRaw)
+{
+	(void)xRaw;
+}
+/*******************************************************************************
+*   Procedure: vLoopbackHandleRequest
+*
+*   Description: This function answers a request like vProtoHandleRequest()
+*   			 of main.c
+*
+*   Notes: The temperature monitor, the LED and sleeping are not simulated,
+*   	   their requests are only checked and acknowledged.
+*
+*   Parameters: pxReq - A pointer to the decoded request
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vLoopbackHandleRequest(const ProtoFrame_t* pxReq)
+{
+	const uint8_t* pucIn = pxReq->ucPayload;	// Request payload
+	uint8_t ucOut[PROTO_MAX_PAYLOAD];			// Response payload
+	uint8_t* pucOut = ucOut;					// Next free byte of the response payload
+	uint8_t ucStatus = PROTO_OK;				// Status of the response
+	uint8_t ucExpectedLen = 0;					// Payload length of the request
+	RTC_DateTypeDef xDate;						// Date read or written
+	RTC_TimeTypeDef xTime;						// Time read or written
+	int32_t lFirstNum;							// Operands and result of a calculation
+	int32_t lSecondNum;
+
+	switch( pxReq->ucType )
+	{
+		case PROTO_SET_DATETIME:	ucExpectedLen = 7;	break;
+		case PROTO_SET_ALARM:		ucExpectedLen = 3;	break;
+		case PROTO_CALC:			ucExpectedLen = 9;	break;
+		case PROTO_LED:				ucExpectedLen = 1;	break;
+		default:					ucExpectedLen = 0;	break;
+	}
+
+	if( pxReq->ucLen != ucExpectedLen )
+	{
+		vProtoReply( pxReq, PROTO_ERR_LENGTH, NULL, 0 );
+		return;
+	}
+
+	switch( pxReq->ucType )
+	{
+		case PROTO_PING:
+
+			*pucOut++ = PROTO_VERSION;
+			break;
+
+		case PROTO_GET_DATETIME:
+
+			vCalendarToRtc( ulLoopbackTime, &xDate, &xTime );
+
+			*pucOut++ = xDate.RTC_Year;
+			*pucOut++ = xDate.RTC_Month;
+			*pucOut++ = xDate.RTC_Date;
+			*pucOut++ = xDate.RTC_WeekDay;
+			*pucOut++ = xTime.RTC_Hours;
+			*pucOut++ = xTime.RTC_Minutes;
+			*pucOut++ = xTime.RTC_Seconds;
+			break;
+
+		case PROTO_SET_DATETIME:
+
+			// The day of the week sent is not used, it is worked out from the date
+			memset( &xDate, 0, sizeof(xDate) );
+			memset( &xTime, 0, sizeof(xTime) );
+			xDate.RTC_Year = pucIn[0];
+			xDate.RTC_Month = pucIn[1];
+			xDate.RTC_Date = pucIn[2];
+			xTime.RTC_Hours = pucIn[4];
+			xTime.RTC_Minutes = pucIn[5];
+			xTime.RTC_Seconds = pucIn[6];
+
+			if( xCalendarIsValidDate( CALENDAR_RTC_FIRST_YEAR + xDate.RTC_Year, xDate.RTC_Month, xDate.RTC_Date ) == pdFALSE ||
+				xTime.RTC_Hours > 23 || xTime.RTC_Minutes > 59 || xTime.RTC_Seconds > 59 )
+			{
+				ucStatus = PROTO_ERR_VALUE;
+				break;
+			}
+
+			ulLoopbackTime = ulCalendarFromRtc( &xDate, &xTime );
+			break;
+
+		case PROTO_SET_ALARM:
+
+			if( pucIn[0] > 23 || pucIn[1] > 59 || pucIn[2] > 59 )
+			{
+				ucStatus = PROTO_ERR_VALUE;
+			}
+			break;
+
+		case PROTO_CALC:
+
+			memcpy( &lFirstNum, &pucIn[0], sizeof(lFirstNum) );
+			memcpy( &lSecondNum, &pucIn[4], sizeof(lSecondNum) );
+
+			// The arithmetic of the firmware
+			if( xCalcApply( lFirstNum, (char)pucIn[8], lSecondNum, &lFirstNum ) == eCalcOk )
+			{
+				memcpy( pucOut, &lFirstNum, sizeof(lFirstNum) );
+				pucOut += sizeof(lFirstNum);
+			}
+			else
+			{
+				ucStatus = PROTO_ERR_VALUE;
+			}
+			break;
+
+		case PROTO_TEMP_START:
+		case PROTO_TEMP_STOP:
+		case PROTO_SLEEP:
+
+			break;
+
+		case PROTO_TEMP_STATS:
+
+			// Stopped, with the statistics reset
+			memset( ucOut, 0, 25 );
+			pucOut += 25;
+			break;
+
+		case PROTO_LED:
+
+			if( pucIn[0] > 1 )
+			{
+				ucStatus = PROTO_ERR_VALUE;
+			}
+			break;
+
+		default:
+
+			ucStatus = PROTO_ERR_UNKNOWN;
+			break;
+	}
+
+	vProtoReply( pxReq, ucStatus, ucOut, ( ucStatus == PROTO_OK ) ? (size_t)( pucOut - ucOut ) : 0 );
+}
+
+int main(void)
+{
+	char cChunk[64];	// Bytes read at once
+	ssize_t xLen;		// Number of bytes read
+
+	vProtoBegin();
+
+	// Packets arrive over as many reads as the pipe splits them into
+	while( ( xLen = read( STDIN_FILENO, cChunk, sizeof(cChunk) ) ) > 0 )
+	{
+		if( xProtoFeed( cChunk, (size_t)xLen, vLoopbackHandleRequest ) == pdTRUE )
+		{
+			break;
+		}
+	}
+
+	vProtoEnd();
+
+	fprintf( stderr, "dropped %lu\n", (unsigned long)ulProtoFramesDropped );
+
+	return(0);
+}
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+Tests the binary protocol end to end without the board. Host_Client/proto_client.py
+talks to proto_loopback, which runs proto.c of the firmware (COBS framing, CRC
+checks, packet lengths) and answers the requests like main.c does.
+
+Besides the requests of proto_client.py, frames with a bad CRC, truncated
+frames, frames with a bad COBS encoding and oversized frames are sent. Each
+must be dropped without a response and counted in ulProtoFramesDropped, and
+the next request must still be answered.
+
+Run it from Tools/host_tests once proto_loopback is built, or with "make":
+    python3 proto_loopback_test.py ./proto_loopback
+"""
+
+import os
+import select
+import struct
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "Host_Client"))
+
+import proto_client  # noqa: E402
+from proto_client import cobs_encode, crc32_stm32  # noqa: E402
+
+# proto.h and proto.c: largest payload, and largest encoded packet the firmware buffers
+PROTO_MAX_PAYLOAD = 64
+PROTO_MAX_ENCODED = (3 + PROTO_MAX_PAYLOAD + 4) + 1
+
+
+class PipeSerial:
+    """The part of serial.Serial used by ProtoClient, over the pipes of the loopback."""
+
+    def __init__(self, process, timeout):
+        self.process = process
+        self.timeout = timeout
+        self.pending = b""
+
+    def write(self, data):
+        self.process.stdin.write(data)
+        self.process.stdin.flush()
+
+    def read_until(self, terminator):
+        fd = self.process.stdout.fileno()
+        while terminator not in self.pending:
+            ready, _, _ = select.select([fd], [], [], self.timeout)
+            if not ready:
+                break
+            chunk = os.read(fd, 256)
+            if not chunk:
+                break
+            self.pending += chunk
+        end = self.pending.find(terminator)
+        end = len(self.pending) if end < 0 else end + len(terminator)
+        data, self.pending = self.pending[:end], self.pending[end:]
+        return data
+
+
+class Test:
+    def __init__(self, loopback):
+        self.process = subprocess.Popen([loopback], stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                        stderr=subprocess.PIPE)
+        # ProtoClient opens the serial port in its constructor, so give it the pipes instead
+        self.client = proto_client.ProtoClient.__new__(proto_client.ProtoClient)
+        self.client.serial = PipeSerial(self.process, 0.5)
+        self.client.seq = 0
+        self.failures = 0
+        self.dropped = 0
+
+    def check(self, ok, text):
+        if not ok:
+            print("FAIL: " + text)
+            self.failures += 1
+
+    def status(self, req_type, payload=b""):
+        try:
+            self.client.request(req_type, payload)
+        except RuntimeError as error:
+            return str(error)
+        return "OK"
+
+    def frame(self, packet):
+        return b"\x00" + cobs_encode(packet) + b"\x00"
+
+    def request_packet(self, req_type, seq, payload=b""):
+        packet = bytes([req_type, seq]) + payload
+        return packet + struct.pack("<I", crc32_stm32(packet))
+
+    def send_bad(self, data, text):
+        # Nothing may come back, and the next request is still answered
+        self.client.serial.write(data)
+        self.dropped += 1
+        self.check(self.client.serial.read_until(b"\x00") == b"", text + ": no response")
+        self.check(self.client.request(proto_client.PING) == bytes([1]), text + ": answered after")
+
+    def run(self):
+        PING, CALC = proto_client.PING, proto_client.CALC
+
+        # Requests
+        self.check(self.client.request(PING) == bytes([1]), "ping")
+        self.check(self.client.request(proto_client.GET_DATETIME) == bytes([20, 12, 3, 4, 17, 0, 0]), "get-datetime")
+        self.check(self.status(proto_client.SET_DATETIME, bytes([26, 10, 16, 1, 13, 45, 0])) == "OK", "set-datetime")
+        self.check(self.client.request(proto_client.GET_DATETIME) == bytes([26, 10, 16, 5, 13, 45, 0]),
+                   "weekday worked out from the date")
+        self.check(self.status(proto_client.SET_DATETIME, bytes([26, 2, 29, 1, 0, 0, 0])) == "value out of range",
+                   "no 29th of February in 2026")
+        self.check(self.status(proto_client.SET_ALARM, bytes([24, 0, 0])) == "value out of range", "alarm hours")
+        self.check(self.status(proto_client.SET_ALARM, bytes([7, 30, 0])) == "OK", "set-alarm")
+
+        # Zero bytes in the payload exercise the COBS runs
+        result = self.client.request(CALC, struct.pack("<ii", 1234, -56) + b"*")
+        self.check(struct.unpack("<i", result)[0] == -69104, "calc")
+        result = self.client.request(CALC, struct.pack("<ii", 0, 256) + b"+")
+        self.check(struct.unpack("<i", result)[0] == 256, "calc with zero bytes")
+        self.check(self.status(CALC, struct.pack("<ii", 1, 0) + b"/") == "value out of range", "divide by zero")
+        self.check(self.status(CALC, struct.pack("<ii", 0x7FFFFFFF, 1) + b"+") == "value out of range", "overflow")
+        self.check(self.status(CALC, struct.pack("<ii", -0x80000000, -1) + b"/") == "value out of range",
+                   "INT32_MIN / -1")
+        result = self.client.request(CALC, struct.pack("<ii", -7, 2) + b"/")
+        self.check(struct.unpack("<i", result)[0] == -3, "quotient rounded toward zero")
+        self.check(self.status(CALC, struct.pack("<ii", 1, 2) + b"%") == "value out of range", "unknown operator")
+        self.check(self.status(CALC, struct.pack("<ii", 1, 2)) == "wrong length", "calc without operator")
+        self.check(self.status(0x66) == "unknown request", "unknown request")
+
+        data = self.client.request(proto_client.TEMP_STATS)
+        self.check(len(data) == 25 and data[0] == 0, "temp-stats")
+
+        # Requests split over several writes
+        packet = self.frame(self.request_packet(PING, 0x42))
+        for i in range(len(packet)):
+            self.client.serial.write(packet[i:i + 1])
+        self.client.serial.read_until(b"\x00")
+        response = proto_client.cobs_decode(self.client.serial.read_until(b"\x00")[:-1])
+        self.check(response[:4] == bytes([PING | 0x80, 0x42, 0, 1]), "request split over writes")
+
+        # Bad frames
+        packet = bytearray(self.request_packet(PING, 7))
+        packet[-1] ^= 0x01
+        self.send_bad(self.frame(packet), "bad CRC")
+
+        packet = self.request_packet(CALC, 8, struct.pack("<ii", 3, 4) + b"+")
+        self.send_bad(self.frame(packet[:-2]), "truncated CRC")
+        self.send_bad(self.frame(packet[:5]), "shorter than a header and a CRC")
+        self.send_bad(b"\x00" + cobs_encode(packet)[:-3] + b"\x00", "truncated encoding")
+
+        self.send_bad(b"\x00\x09\x01\x02\x00", "bad COBS code")
+
+        packet = self.request_packet(PING, 9, bytes(range(1, PROTO_MAX_PAYLOAD + 2)))
+        self.send_bad(self.frame(packet), "payload over PROTO_MAX_PAYLOAD")
+
+        packet = self.request_packet(PING, 10, bytes([0x55]) * 200)
+        self.check(len(cobs_encode(packet)) > PROTO_MAX_ENCODED, "oversized frame is longer than the buffer")
+        self.send_bad(self.frame(packet), "frame over the receive buffer")
+
+        # Back to back delimiters are not frames
+        self.client.serial.write(b"\x00\x00\x00")
+        self.check(self.client.request(PING) == bytes([1]), "empty frames")
+
+        self.client.request(proto_client.EXIT)
+        _, errors = self.process.communicate(timeout=5)
+        self.check(self.process.returncode == 0, "loopback exit code")
+        self.check(errors.decode().strip() == "dropped %d" % self.dropped,
+                   "frames dropped: %s, expected %d" % (errors.decode().strip(), self.dropped))
+
+
+def main():
+    test = Test(sys.argv[1] if len(sys.argv) > 1 else "./proto_loopback")
+    try:
+        test.run()
+    except (TimeoutError, RuntimeError) as error:
+        print("FAIL: %s" % error)
+        test.failures += 1
+        test.process.kill()
+
+    if test.failures:
+        print("proto: %d checks failed" % test.failures)
+        return 1
+    print("proto: all tests passed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
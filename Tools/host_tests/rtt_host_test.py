@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""
+Tests Tools/rtt_host.py on memory images holding an RTT control block.
+
+rtt_image runs SEGGER_RTT.c of the firmware on the PC with the console buffers
+of console.h and dumps them, so the image read with --ptr-size 8 is laid out by
+SEGGER_RTT.c itself. After rtt_host.py has consumed the output and sent a line,
+rtt_image loads the image back and reads the line with SEGGER_RTT_Read() as the
+firmware does.
+
+The 32-bit image of the target is built here: an up buffer which has wrapped,
+a down buffer with less room than the line sent, and channels without buffers.
+
+Run it from Tools/host_tests once rtt_image is built, or with "make":
+    python3 rtt_host_test.py ./rtt_image
+"""
+
+import os
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+
+RTT_HOST = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "rtt_host.py")
+
+# console.h: RTT channel and buffer sizes of the console
+CONSOLE_RTT_CHANNEL = 1
+CONSOLE_RTT_UP_SIZE = 1024
+CONSOLE_RTT_DOWN_SIZE = 64
+
+# SEGGER_RTT_Conf.h: buffers of the control block
+MAX_NUM_UP = 3
+MAX_NUM_DOWN = 3
+
+# rtt_image.c: text written to the up buffer
+IMAGE_TEXT = "\r\nRTT console, type \"help\" for the commands\r\n> "
+
+ROW = re.compile(r"(up|down)\s+(\d+)\s+(\S+)\s+buffer 0x([0-9a-f]+) size\s+(\d+)\s+WrOff\s+(\d+)\s+RdOff\s+(\d+)")
+
+
+class Test:
+    def __init__(self, directory):
+        self.directory = directory
+        self.failures = 0
+
+    def check(self, ok, text):
+        if not ok:
+            print("FAIL: " + text)
+            self.failures += 1
+
+    def host(self, path, base, ptr_size, *args):
+        result = subprocess.run([sys.executable, RTT_HOST, path, "--base", hex(base), "--ptr-size", str(ptr_size)] +
+                                list(args), stdout=subprocess.PIPE, stderr=subprocess.PIPE, timeout=10)
+        return result.returncode, result.stdout.decode("latin-1"), result.stderr.decode("latin-1")
+
+    def rows(self, path, base, ptr_size):
+        """The control block address and the rows of --list, by (kind, index)."""
+        _, out, _ = self.host(path, base, ptr_size, "--list")
+        match = re.search(r"Control block at 0x([0-9a-f]+)", out)
+        rows = {}
+        for row in ROW.finditer(out):
+            rows[(row.group(1), int(row.group(2)))] = {
+                "name": row.group(3), "buffer": int(row.group(4), 16), "size": int(row.group(5)),
+                "wr": int(row.group(6)), "rd": int(row.group(7))}
+        return (int(match.group(1), 16) if match else None), rows
+
+    def run_host64(self, image):
+        """The image of SEGGER_RTT.c built for the PC, read with --ptr-size 8."""
+        path = os.path.join(self.directory, "ram64.bin")
+        process = subprocess.Popen([image, path], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        try:
+            base, control_block = (int(v, 16) for v in process.stdout.readline().split())
+
+            address, rows = self.rows(path, base, 8)
+            self.check(address == control_block, "64-bit: control block found at its address")
+            self.check(len(rows) == MAX_NUM_UP + MAX_NUM_DOWN, "64-bit: every buffer listed")
+            up = rows.get(("up", CONSOLE_RTT_CHANNEL), {})
+            down = rows.get(("down", CONSOLE_RTT_CHANNEL), {})
+            self.check(up.get("size") == CONSOLE_RTT_UP_SIZE and up.get("wr") == len(IMAGE_TEXT) and
+                       up.get("rd") == 0, "64-bit: up buffer of the console")
+            self.check(down.get("size") == CONSOLE_RTT_DOWN_SIZE and down.get("wr") == 0,
+                       "64-bit: down buffer of the console")
+
+            # Reading without --consume leaves the image as it is
+            with open(path, "rb") as f:
+                before = f.read()
+            code, out, _ = self.host(path, base, 8)
+            with open(path, "rb") as f:
+                self.check(code == 0 and out == IMAGE_TEXT and f.read() == before, "64-bit: output read")
+
+            code, out, _ = self.host(path, base, 8, "--consume", "--send", "temp show; stats\\r")
+            self.check(code == 0 and out == IMAGE_TEXT, "64-bit: output consumed")
+            code, out, _ = self.host(path, base, 8)
+            self.check(code == 0 and out == "", "64-bit: nothing left once consumed")
+
+            _, rows = self.rows(path, base, 8)
+            self.check(rows[("up", CONSOLE_RTT_CHANNEL)]["rd"] == len(IMAGE_TEXT), "64-bit: RdOff moved")
+            self.check(rows[("down", CONSOLE_RTT_CHANNEL)]["wr"] == len("temp show; stats\r"), "64-bit: WrOff moved")
+
+            # SEGGER_RTT.c sees what the host did once the image is loaded back
+            out, _ = process.communicate(b"load\n", timeout=10)
+            self.check(process.returncode == 0 and out == b"up 0\ndown temp show; stats\r\n",
+                       "64-bit: read back by SEGGER_RTT.c: %r" % out)
+        finally:
+            if process.poll() is None:
+                process.kill()
+
+    def run_host32(self):
+        """An image of the target, laid out as SEGGER_RTT.c of the board does with 32-bit pointers."""
+        base = 0x20000000
+        control_block = base + 0x100
+        name = base + 0x80
+        up_buffer, up_size = base + 0x400, 16
+        down_buffer, down_size = base + 0x500, 8
+
+        ram = bytearray(0x800)
+        ram[name - base:name - base + 8] = b"Console\0"
+        struct.pack_into("<16sii", ram, control_block - base, b"SEGGER RTT", MAX_NUM_UP, MAX_NUM_DOWN)
+        rings = [(0, 0, 0, 0, 0)] * (MAX_NUM_UP + MAX_NUM_DOWN)
+        # Up 1 has wrapped: "abcd" at the end of the buffer, then "efgh" at its start
+        rings[1] = (name, up_buffer, up_size, 4, 12)
+        ram[up_buffer - base + 12:up_buffer - base + 16] = b"abcd"
+        ram[up_buffer - base:up_buffer - base + 4] = b"efgh"
+        # Down 1 has room for 3 bytes, from offset 6 round to offset 0
+        rings[MAX_NUM_UP + 1] = (name, down_buffer, down_size, 6, 2)
+        # Up 0 has a buffer but down 0 has none
+        rings[0] = (0, base + 0x600, 16, 0, 0)
+        for i, (ring_name, buffer, size, wr, rd) in enumerate(rings):
+            struct.pack_into("<IIIIII", ram, control_block - base + 24 + 24 * i, ring_name, buffer, size, wr, rd, 0)
+
+        path = os.path.join(self.directory, "ram32.bin")
+        with open(path, "wb") as f:
+            f.write(ram)
+
+        address, rows = self.rows(path, base, 4)
+        self.check(address == control_block, "32-bit: control block found")
+        self.check(rows.get(("up", 1), {}).get("name") == "Console" and rows.get(("up", 2), {}).get("name") == "-",
+                   "32-bit: names in the image")
+        self.check(rows.get(("down", 1), {}).get("buffer") == down_buffer, "32-bit: down buffers after the up ones")
+
+        code, out, _ = self.host(path, base, 4, "--channel", "1")
+        self.check(code == 0 and out == "abcdefgh", "32-bit: wrapped output read: %r" % out)
+
+        code, out, errors = self.host(path, base, 4, "--channel", "1", "--consume", "--send", "hello")
+        self.check(code == 0 and out == "abcdefgh", "32-bit: wrapped output consumed")
+        self.check("3 of 5 bytes sent" in errors, "32-bit: full down buffer reported")
+        with open(path, "rb") as f:
+            ram = f.read()
+        self.check(ram[down_buffer - base + 6:down_buffer - base + 8] + ram[down_buffer - base:down_buffer - base + 1]
+                   == b"hel", "32-bit: line written round the end of the down buffer")
+        _, rows = self.rows(path, base, 4)
+        self.check(rows[("up", 1)]["rd"] == 4 and rows[("down", 1)]["wr"] == 1, "32-bit: offsets moved")
+
+        code, _, errors = self.host(path, base, 4, "--channel", "2")
+        self.check(code != 0 and "channel 2 has no up buffer" in errors, "32-bit: channel without an up buffer")
+        code, _, errors = self.host(path, base, 4, "--channel", "0", "--send", "x")
+        self.check(code != 0 and "channel 0 has no down buffer" in errors, "32-bit: channel without a down buffer")
+
+        code, _, errors = self.host(path, base + 0x1000, 4, "--channel", "1")
+        self.check(code != 0 and "outside the image" in errors, "32-bit: wrong base")
+
+
+def main():
+    with tempfile.TemporaryDirectory() as directory:
+        test = Test(directory)
+        try:
+            test.run_host64(sys.argv[1] if len(sys.argv) > 1 else "./rtt_image")
+            test.run_host32()
+        except (subprocess.TimeoutExpired, ValueError, KeyError) as error:
+            print("FAIL: %r" % error)
+            test.failures += 1
+
+    if test.failures:
+        print("rtt_host: %d checks failed" % test.failures)
+        return 1
+    print("rtt_host: all tests passed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
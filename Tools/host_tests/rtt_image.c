@@ -0,0 +1,236 @@
+/**
+  ******************************************************************************
+  * @file    rtt_image.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Stand-in for the RAM of the board as seen by Tools/rtt_host.py.
+  * 		 SEGGER_RTT.c of the firmware sets up the RTT buffers of the console
+  * 		 as vConsoleInit() of console.c does, a line is written to the up
+  * 		 buffer, and the control block and the buffers are dumped to the
+  * 		 image given on the command line. The first line written to stdout
+  * 		 is the address of the image and of the control block. Once a line
+  * 		 is read from stdin the image is loaded back, and the bytes pending
+  * 		 in the up buffer and the line read from the down buffer are written
+  * 		 to stdout. rtt_host_test.py drives it.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "console.h"
+#include "SEGGER_RTT.h"
+
+// CONSTANTS
+
+// Line written to the up buffer before the dump
+#define RTT_IMAGE_TEXT				"\r\nRTT console, type \"help\" for the commands\r\n> "
+
+// TYPES
+
+// An object of the image
+typedef struct
+{
+	void* pvData;
+	size_t xSize;
+} RttImageObject_t;
+
+// RTT IMAGE GLOBALS
+
+// Buffers of the console, as in console.c
+static char cRttUpBuffer[CONSOLE_RTT_UP_SIZE];
+static char cRttDownBuffer[CONSOLE_RTT_DOWN_SIZE];
+
+// Objects of the image, the control block and its buffers
+static const RttImageObject_t xRttImageObjects[] =
+{
+	{ &_SEGGER_RTT, sizeof(_SEGGER_RTT) },
+	{ cRttUpBuffer, sizeof(cRttUpBuffer) },
+	{ cRttDownBuffer, sizeof(cRttDownBuffer) }
+};
+
+#define RTT_IMAGE_NUM_OBJECTS		( sizeof(xRttImageObjects) / sizeof(xRttImageObjects[0]) )
+
+// FUNCTION PROTOTYPES
+
+// To get the range of addresses holding every object of the image
+static void vRttImageRange(uintptr_t* pxStart, uintptr_t* pxEnd);
+
+// To write the image to a file, or to load the objects back from it
+static BaseType_t xRttImageSave(const char* pcPath);
+static BaseType_t xRttImageLoad(const char* pcPath);
+/*******************************************************************************
+*   Procedure: vRttImageRange
+*
+*   Description: This function gets the range of addresses holding every
+*   			 object of the image
+*
+*   Notes: Other variables may lie between the objects. They are dumped too
+*   	   but never loaded back.
+*
+*   Parameters: pxStart - A pointer to the first address
+*   			pxEnd - A pointer to the address after the last
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vRttImageRange(uintptr_t* pxStart, uintptr_t* pxEnd)
+{
+	uintptr_t xAddress;
+	size_t i;
+
+	*pxStart = UINTPTR_MAX;
+	*pxEnd = 0;
+
+	for( i = 0; i < RTT_IMAGE_NUM_OBJECTS; i++ )
+	{
+		xAddress = (uintptr_t)xRttImageObjects[i].pvData;
+
+		if( xAddress < *pxStart )
+		{
+			*pxStart = xAddress;
+		}
+		if( xAddress + xRttImageObjects[i].xSize > *pxEnd )
+		{
+			*pxEnd = xAddress + xRttImageObjects[i].xSize;
+		}
+	}
+}
+/*******************************************************************************
+*   Procedure: xRttImageSave
+*
+*   Description: This function writes the memory from the first object of the
+*   			 image to the end of the last to a file
+*
+*   Notes: None
+*
+*   Parameters: pcPath - The path of the file
+*
+*   Return: BaseType_t - pdPASS if the image was written, otherwise pdFAIL
+*
+*******************************************************************************/
+static BaseType_t xRttImageSave(const char* pcPath)
+{
+	uintptr_t xStart, xEnd;
+	FILE* pxFile;
+	size_t xWritten;
+
+	vRttImageRange( &xStart, &xEnd );
+
+	pxFile = fopen( pcPath, "wb" );
+	if( pxFile == NULL )
+	{
+		return(pdFAIL);
+	}
+
+	xWritten = fwrite( (const void*)xStart, 1, xEnd - xStart, pxFile );
+
+	return( ( fclose( pxFile ) == 0 && xWritten == xEnd - xStart ) ? pdPASS : pdFAIL );
+}
+/*******************************************************************************
+*   Procedure: xRttImageLoad
+*
+*   Description: This function copies the objects of the image back from a file
+*   			 written by xRttImageSave()
+*
+*   Notes: Only the objects are copied, not what lies between them.
+*
+*   Parameters: pcPath - The path of the file
+*
+*   Return: BaseType_t - pdPASS if every object was loaded, otherwise pdFAIL
+*
+*******************************************************************************/
+static BaseType_t xRttImageLoad(const char* pcPath)
+{
+	uintptr_t xStart, xEnd;
+	FILE* pxFile;
+	BaseType_t xStatus = pdPASS;
+	size_t i;
+
+	vRttImageRange( &xStart, &xEnd );
+
+	pxFile = fopen( pcPath, "rb" );
+	if( pxFile == NULL )
+	{
+		return(pdFAIL);
+	}
+
+	for( i = 0; i < RTT_IMAGE_NUM_OBJECTS && xStatus == pdPASS; i++ )
+	{
+		if( fseek( pxFile, (long)( (uintptr_t)xRttImageObjects[i].pvData - xStart ), SEEK_SET ) != 0 ||
+			fread( xRttImageObjects[i].pvData, 1, xRttImageObjects[i].xSize, pxFile ) != xRttImageObjects[i].xSize )
+		{
+			xStatus = pdFAIL;
+		}
+	}
+
+	fclose( pxFile );
+
+	return(xStatus);
+}
+/*******************************************************************************
+*   Procedure: main
+*
+*   Description: This function dumps the RTT buffers of the console to an
+*   			 image, waits for a line on stdin, loads the image back and
+*   			 writes what the host did to stdout
+*
+*   Notes: None
+*
+*   Parameters: argc - The number of arguments
+*   			argv - The arguments, the path of the image
+*
+*   Return: int - 0 on success, otherwise 1
+*
+*******************************************************************************/
+int main(int argc, char* argv[])
+{
+	char cLine[CONSOLE_RTT_DOWN_SIZE + 1];	// Line read from the down buffer
+	uintptr_t xStart, xEnd;
+	unsigned uLen;
+
+	if( argc != 2 )
+	{
+		fprintf( stderr, "usage: rtt_image <image>\n" );
+		return(1);
+	}
+
+	if( SEGGER_RTT_ConfigUpBuffer( CONSOLE_RTT_CHANNEL, "Console", cRttUpBuffer, sizeof(cRttUpBuffer),
+								   SEGGER_RTT_MODE_NO_BLOCK_TRIM ) < 0 ||
+		SEGGER_RTT_ConfigDownBuffer( CONSOLE_RTT_CHANNEL, "Console", cRttDownBuffer, sizeof(cRttDownBuffer),
+									 SEGGER_RTT_MODE_NO_BLOCK_TRIM ) < 0 )
+	{
+		fprintf( stderr, "rtt_image: no RTT channel %d\n", CONSOLE_RTT_CHANNEL );
+		return(1);
+	}
+
+	SEGGER_RTT_WriteString( CONSOLE_RTT_CHANNEL, RTT_IMAGE_TEXT );
+
+	if( xRttImageSave( argv[1] ) == pdFAIL )
+	{
+		fprintf( stderr, "rtt_image: cannot write %s\n", argv[1] );
+		return(1);
+	}
+
+	vRttImageRange( &xStart, &xEnd );
+	printf( "0x%" PRIxPTR " 0x%" PRIxPTR "\n", xStart, (uintptr_t)&_SEGGER_RTT );
+	fflush( stdout );
+
+	// The host works on the image meanwhile
+	if( fgets( cLine, sizeof(cLine), stdin ) == NULL || xRttImageLoad( argv[1] ) == pdFAIL )
+	{
+		fprintf( stderr, "rtt_image: cannot load %s\n", argv[1] );
+		return(1);
+	}
+
+	uLen = SEGGER_RTT_Read( CONSOLE_RTT_CHANNEL, cLine, sizeof(cLine) - 1 );
+	printf( "up %u\n", SEGGER_RTT_HasDataUp( CONSOLE_RTT_CHANNEL ) );
+	printf( "down " );
+	fwrite( cLine, 1, uLen, stdout );
+	printf( "\n" );
+
+	return(0);
+}
@@ -0,0 +1,28 @@
+/*
+ * Host stand-in for FreeRTOS.h, enough to build the hardware independent
+ * modules of the application (alarm.c, calendar.c, tok.c, cmd.c, fmt.c) on
+ * a PC. Single threaded, so the critical sections do nothing.
+ */
+
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void* TaskHandle_t;
+
+#define pdFALSE				( ( BaseType_t ) 0 )
+#define pdTRUE				( ( BaseType_t ) 1 )
+#define pdFAIL				( pdFALSE )
+#define pdPASS				( pdTRUE )
+#define portMAX_DELAY		( ( TickType_t ) 0xffffffffUL )
+
+#define configASSERT( x )	do { if( ( x ) == 0 ) { abort(); } } while( 0 )
+
+void abort(void);
+
+#endif /* FREERTOS_H */
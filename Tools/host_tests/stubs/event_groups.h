@@ -0,0 +1,14 @@
+/*
+ * Host stand-in for event_groups.h. Only the types are used by the headers
+ * the tests include.
+ */
+
+#ifndef EVENT_GROUPS_H
+#define EVENT_GROUPS_H
+
+#include "FreeRTOS.h"
+
+typedef void* EventGroupHandle_t;
+typedef TickType_t EventBits_t;
+
+#endif /* EVENT_GROUPS_H */
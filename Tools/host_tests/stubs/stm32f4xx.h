@@ -0,0 +1,40 @@
+/*
+ * Host stand-in for stm32f4xx.h, with the RTC types of the standard
+ * peripheral library used by calendar.c and the CRC unit used by proto.c,
+ * computed in software by stm32f4xx_crc.c.
+ */
+
+#ifndef STM32F4XX_H
+#define STM32F4XX_H
+
+#include <stdint.h>
+
+typedef struct
+{
+	uint8_t RTC_Hours;
+	uint8_t RTC_Minutes;
+	uint8_t RTC_Seconds;
+	uint8_t RTC_H12;
+} RTC_TimeTypeDef;
+
+typedef struct
+{
+	uint8_t RTC_WeekDay;
+	uint8_t RTC_Month;
+	uint8_t RTC_Date;
+	uint8_t RTC_Year;
+} RTC_DateTypeDef;
+
+#define RTC_H12_AM			( (uint8_t)0x00 )
+#define RTC_Weekday_Monday	( (uint8_t)0x01 )
+
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+
+#define RCC_AHB1Periph_CRC	( (uint32_t)0x00001000 )
+
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState);
+void CRC_ResetDR(void);
+uint32_t CRC_CalcCRC(uint32_t Data);
+uint32_t CRC_GetCRC(void);
+
+#endif /* STM32F4XX_H */
@@ -0,0 +1,11 @@
+/*
+ * Host stand-in for task.h. The tests run on a single thread.
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#endif /* TASK_H */
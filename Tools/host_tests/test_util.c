@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @file    test_util.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Checks, random numbers and clock shared by the host tests
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <stdio.h>
+#include <time.h>
+#include "test_util.h"
+
+// CONSTANTS
+
+// Failed checks printed, the rest are only counted
+#define TEST_MAX_PRINTED			20
+
+// TEST UTIL GLOBALS
+
+uint32_t ulTestFailures = 0;
+/*******************************************************************************
+*   Procedure: vTestCheck
+*
+*   Description: This function prints and counts a failed check
+*
+*   Notes: Only the first failures are printed.
+*
+*   Parameters: xOk - pdTRUE if the check passed
+*   			pcText - The condition checked
+*   			iLine - The line of the check
+*
+*   Return: None
+*
+*******************************************************************************/
+void vTestCheck(BaseType_t xOk, const char* pcText, int iLine)
+{
+	if( xOk == pdFALSE )
+	{
+		if( ulTestFailures < TEST_MAX_PRINTED )
+		{
+			printf("FAIL line %d: %s\n", iLine, pcText);
+		}
+		ulTestFailures++;
+	}
+}
+/*******************************************************************************
+*   Procedure: ullTestRandom
+*
+*   Description: This function gets 64 random bits, with small and large
+*   			 magnitudes equally likely
+*
+*   Notes: xorshift64, seeded with a constant so a failure can be replayed.
+*
+*   Parameters: None
+*
+*   Return: uint64_t - The random bits
+*
+*******************************************************************************/
+uint64_t ullTestRandom(void)
+{
+	static uint64_t ullState = 0x9E3779B97F4A7C15ULL;
+	uint64_t ullBits;
+
+	ullState ^= ullState << 13;
+	ullState ^= ullState >> 7;
+	ullState ^= ullState << 17;
+	ullBits = ullState;
+
+	// Keep a random number of bits
+	return( ullBits >> ( ( ullBits >> 58 ) & 63 ) );
+}
+/*******************************************************************************
+*   Procedure: ullBenchNow
+*
+*   Description: This function gets the time of the monotonic clock of the PC
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: uint64_t - The time in nanoseconds
+*
+*******************************************************************************/
+uint64_t ullBenchNow(void)
+{
+	struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return( (uint64_t)xNow.tv_sec * 1000000000ULL + (uint64_t)xNow.tv_nsec );
+}
@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file    test_util.h
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Checks, random numbers and clock shared by the host tests
+  ******************************************************************************
+*/
+
+#ifndef TEST_UTIL_H_
+#define TEST_UTIL_H_
+
+// INCLUDES
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+// TEST UTIL GLOBALS
+
+// Checks failed so far
+extern uint32_t ulTestFailures;
+
+// FUNCTION PROTOTYPES
+
+// To check a condition and count a failure
+#define TEST_CHECK( x )		vTestCheck( (x) ? pdTRUE : pdFALSE, #x, __LINE__ )
+void vTestCheck(BaseType_t xOk, const char* pcText, int iLine);
+
+// To get 64 random bits
+uint64_t ullTestRandom(void);
+
+// To get the time of a monotonic clock in nanoseconds
+uint64_t ullBenchNow(void);
+
+#endif /* TEST_UTIL_H_ */
@@ -0,0 +1,648 @@
+/**
+  ******************************************************************************
+  * @file    tok_cmd_test.c
+  * @author  Moe2Code
+  * @version V1.0
+  * @date    16-Oct-2026
+  * @brief   Host property test and benchmark of the tokenizer (tok.c) and of
+  * 		 the command dispatch (cmd.c). Random numbers written in decimal,
+  * 		 hexadecimal and binary must scan back to their value, random
+  * 		 decimal strings must agree with strtoll() on the value and on the
+  * 		 overflow, and random lines must give tokens within the line. Every
+  * 		 key, name and alias of commands.def must find its command through
+  * 		 the perfect hash, in any case, and random words none.
+  ******************************************************************************
+*/
+
+// INCLUDES
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "console.h"
+#include "tok.h"
+#include "cmd.h"
+#include "test_util.h"
+
+// CONSTANTS
+
+// Random cases of each property
+#define TEST_ROUNDS					1000000
+
+// Rounds of the benchmarks
+#define BENCH_ROUNDS				2000000
+
+// Tokens stored by the random line property, and the guard after them
+#define TEST_MAX_TOKENS				8
+#define TEST_GUARD					0x5A
+
+// Size of the random lines
+#define TEST_LINE_SIZE				64
+
+// Status lines of a script kept for the checks
+#define TEST_OUTPUT_SIZE			512
+
+// TYPES
+
+// A token selecting a command, as declared in commands.def
+typedef struct
+{
+	CmdMenu_t eMenu;
+	const char* pcKey;
+	const char* pcName;
+	const char* pcAliases;
+} TestCmd_t;
+
+// TEST GLOBALS
+
+static const TestCmd_t xTestCmds[] =
+{
+#define MENU( id, title, prompt )
+#define CMD( menu, key, name, aliases, arg, handler, text )	{ eCmdMenu##menu, key, name, aliases },
+#include "commands.def"
+#undef MENU
+#undef CMD
+};
+
+// Output posted by cmd.c
+static char cTestOutput[TEST_OUTPUT_SIZE];
+
+// Last handler called and the argument it was given
+static const char* pcTestHandler = "";
+static CmdArg_t xTestArg;
+
+// FUNCTION PROTOTYPES
+
+// To write the magnitude of a number in a base
+static void vTestWriteMag(char* pcOut, uint64_t ullMag, uint32_t ulBase);
+
+// To record the handler called
+static BaseType_t xTestHandler(const char* pcName, const CmdArg_t* pxArg, BaseType_t* pxQuit);
+
+// To check the properties of the tokenizer
+static void vTestRoundTrip(void);
+static void vTestStrtoll(void);
+static void vTestFixed(void);
+static void vTestRandomLines(void);
+
+// To check the command lookup and dispatch
+static void vTestCmdFind(void);
+static void vTestCmdExecute(void);
+
+// To time the tokenizer and the command lookup
+static void vBenchmark(void);
+/*******************************************************************************
+*   Procedure: vPostMsgToUartQueue
+*
+*   Description: This function keeps the output of cmd.c for the checks
+*
+*   Notes: The output is cut once the buffer is full.
+*
+*   Parameters: pcUartMsg - A pointer to the message
+*
+*   Return: None
+*
+*******************************************************************************/
+void vPostMsgToUartQueue(const char* pcUartMsg)
+{
+	strncat( cTestOutput, pcUartMsg, sizeof(cTestOutput) - strlen(cTestOutput) - 1 );
+}
+
+// Handlers of commands.def, each recording its name
+#define TEST_HANDLER( handler ) \
+	BaseType_t handler(const CmdArg_t* pxArg, BaseType_t* pxQuit) { return( xTestHandler( #handler, pxArg, pxQuit ) ); }
+
+TEST_HANDLER( xCmdRunClock )
+TEST_HANDLER( xCmdRunGame )
+TEST_HANDLER( xCmdRunCalculator )
+TEST_HANDLER( xCmdManageTemp )
+TEST_HANDLER( xCmdManageLed )
+TEST_HANDLER( xCmdSleep )
+TEST_HANDLER( xCmdBaudRate )
+TEST_HANDLER( xCmdStats )
+TEST_HANDLER( xCmdProto )
+TEST_HANDLER( xCmdScript )
+TEST_HANDLER( xCmdShowDateTime )
+TEST_HANDLER( xCmdSetDateTime )
+TEST_HANDLER( xCmdSetAlarm )
+TEST_HANDLER( xCmdQuit )
+TEST_HANDLER( xCmdTempStart )
+TEST_HANDLER( xCmdTempShow )
+TEST_HANDLER( xCmdTempStop )
+TEST_HANDLER( xCmdLedOn )
+TEST_HANDLER( xCmdLedOff )
+TEST_HANDLER( xCmdScriptDate )
+TEST_HANDLER( xCmdScriptTime )
+TEST_HANDLER( xCmdScriptAlarm )
+TEST_HANDLER( xCmdScriptAlarms )
+TEST_HANDLER( xCmdScriptTemp )
+TEST_HANDLER( xCmdScriptLed )
+TEST_HANDLER( xCmdScriptHelp )
+/*******************************************************************************
+*   Procedure: xTestHandler
+*
+*   Description: This function records the handler called and its argument
+*
+*   Notes: "end" quits, and an argument "fail" makes the handler fail.
+*
+*   Parameters: pcName - The name of the handler
+*   			pxArg - A pointer to the argument
+*   			pxQuit - A pointer to the quit flag
+*
+*   Return: BaseType_t - pdFAIL for the argument "fail", otherwise pdPASS
+*
+*******************************************************************************/
+static BaseType_t xTestHandler(const char* pcName, const CmdArg_t* pxArg, BaseType_t* pxQuit)
+{
+	pcTestHandler = pcName;
+	xTestArg = *pxArg;
+
+	if( strcmp( pcName, "xCmdQuit" ) == 0 )
+	{
+		*pxQuit = pdTRUE;
+	}
+
+	return( ( pxArg->eType == eCmdArgWord && strcmp( pxArg->pcWord, "fail" ) == 0 ) ? pdFAIL : pdPASS );
+}
+/*******************************************************************************
+*   Procedure: vTestWriteMag
+*
+*   Description: This function writes the magnitude of a number in a base,
+*   			 without a prefix
+*
+*   Notes: None
+*
+*   Parameters: pcOut - A pointer to the buffer, 65 characters hold any value
+*   			ullMag - The magnitude
+*   			ulBase - 2, 10 or 16
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestWriteMag(char* pcOut, uint64_t ullMag, uint32_t ulBase)
+{
+	char cDigits[65];
+	size_t xLen = 0;
+
+	do
+	{
+		cDigits[xLen++] = "0123456789abcdef"[ullMag % ulBase];
+		ullMag /= ulBase;
+	} while( ullMag != 0 );
+
+	while( xLen > 0 )
+	{
+		*pcOut++ = cDigits[--xLen];
+	}
+	*pcOut = '\0';
+}
+/*******************************************************************************
+*   Procedure: vTestRoundTrip
+*
+*   Description: This function checks that random int64 values written in
+*   			 decimal, hexadecimal and binary, with a sign, scan back to
+*   			 their value, and that xTokLineToInt32() takes the ones in range
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestRoundTrip(void)
+{
+	static const uint32_t ulBases[3] = { 10, 16, 2 };
+	static const char* const pcPrefixes[3] = { "", "0x", "0b" };
+	char cLine[80];
+	Token_t xToken;
+	int64_t llValue;
+	uint64_t ullMag;
+	int32_t lValue;
+	uint32_t ulBase;
+
+	for( uint32_t i = 0; i < TEST_ROUNDS; i++ )
+	{
+		llValue = (int64_t)ullTestRandom();
+		if( i & 1 )
+		{
+			llValue = ( llValue == INT64_MIN ) ? llValue : -llValue;
+		}
+		ulBase = i % 3;
+
+		ullMag = ( llValue < 0 ) ? ( 0 - (uint64_t)llValue ) : (uint64_t)llValue;
+		strcpy( cLine, ( llValue < 0 ) ? " -" : ( ( i & 2 ) ? "+" : "" ) );
+		strcat( cLine, pcPrefixes[ulBase] );
+		vTestWriteMag( &cLine[strlen(cLine)], ullMag, ulBases[ulBase] );
+
+		TEST_CHECK( xTokScan( cLine, &xToken, 1 ) == 1 );
+		TEST_CHECK( xToken.ucType == eTokNumber && xToken.ucError == eTokOk && xToken.llValue == llValue );
+
+		if( llValue >= INT32_MIN && llValue <= INT32_MAX )
+		{
+			TEST_CHECK( xTokLineToInt32( cLine, &lValue ) == eTokOk && lValue == llValue );
+		}
+		else
+		{
+			TEST_CHECK( xTokLineToInt32( cLine, &lValue ) == eTokRange );
+		}
+	}
+
+	// The limits
+	TEST_CHECK( xTokScan( "-9223372036854775808", &xToken, 1 ) == 1 && xToken.ucError == eTokOk && xToken.llValue == INT64_MIN );
+	TEST_CHECK( xTokScan( "9223372036854775808", &xToken, 1 ) == 1 && xToken.ucError == eTokOverflow );
+	TEST_CHECK( xTokScan( "0x10000000000000000", &xToken, 1 ) == 1 && xToken.ucError == eTokOverflow );
+	TEST_CHECK( xTokLineToInt32( "-2147483648", &lValue ) == eTokOk && lValue == INT32_MIN );
+	TEST_CHECK( xTokLineToInt32( "2147483648", &lValue ) == eTokRange );
+	TEST_CHECK( xTokLineToInt32( "-1", &lValue ) == eTokOk && lValue == -1 );
+}
+/*******************************************************************************
+*   Procedure: vTestStrtoll
+*
+*   Description: This function checks that random decimal strings scan to the
+*   			 value strtoll() reads, and overflow where it sets ERANGE
+*
+*   Notes: Up to 24 digits, with leading zeros at times, around the limits of
+*   	   int64.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestStrtoll(void)
+{
+	char cLine[32];
+	Token_t xToken;
+	long long llExpected;
+	size_t xLen;
+	size_t xDigits;
+
+	for( uint32_t i = 0; i < TEST_ROUNDS; i++ )
+	{
+		xLen = 0;
+		if( ullTestRandom() & 1 )
+		{
+			cLine[xLen++] = ( ullTestRandom() & 1 ) ? '-' : '+';
+		}
+
+		xDigits = 1 + ullTestRandom() % 24;
+		for( size_t j = 0; j < xDigits; j++ )
+		{
+			cLine[xLen++] = (char)( '0' + ullTestRandom() % 10 );
+		}
+		cLine[xLen] = '\0';
+
+		errno = 0;
+		llExpected = strtoll( cLine, NULL, 10 );
+
+		TEST_CHECK( xTokScan( cLine, &xToken, 1 ) == 1 && xToken.ucType == eTokNumber );
+
+		if( errno == ERANGE )
+		{
+			TEST_CHECK( xToken.ucError == eTokOverflow );
+		}
+		else
+		{
+			TEST_CHECK( xToken.ucError == eTokOk && xToken.llValue == llExpected );
+		}
+	}
+}
+/*******************************************************************************
+*   Procedure: vTestFixed
+*
+*   Description: This function checks fixed-point decimals and malformed
+*   			 numbers
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestFixed(void)
+{
+	char cLine[48];
+	Token_t xToken;
+	int64_t llValue;
+	uint32_t ulDecimals;
+	uint64_t ullMag;
+	uint64_t ullScale;
+
+	for( uint32_t i = 0; i < TEST_ROUNDS; i++ )
+	{
+		ulDecimals = 1 + i % 8;
+		llValue = (int64_t)( ullTestRandom() % 100000000000ULL ) * ( ( i & 1 ) ? -1 : 1 );
+		ullMag = ( llValue < 0 ) ? (uint64_t)-llValue : (uint64_t)llValue;
+		ullScale = 1;
+		for( uint32_t j = 0; j < ulDecimals; j++ )
+		{
+			ullScale *= 10;
+		}
+
+		// The value with ulDecimals digits after the point, e.g. -1234 and 2 is "-12.34"
+		snprintf( cLine, sizeof(cLine), "%s%" PRIu64 ".%0*" PRIu64, ( llValue < 0 ) ? "-" : "",
+				  ullMag / ullScale, (int)ulDecimals, ullMag % ullScale );
+
+		TEST_CHECK( xTokScan( cLine, &xToken, 1 ) == 1 );
+		TEST_CHECK( xToken.ucType == eTokFixed && xToken.ucError == eTokOk &&
+					xToken.llValue == llValue && xToken.ucDecimals == ulDecimals );
+	}
+
+	TEST_CHECK( xTokScan( "0x", &xToken, 1 ) == 1 && xToken.ucError == eTokMalformed );
+	TEST_CHECK( xTokScan( "12ab", &xToken, 1 ) == 1 && xToken.ucError == eTokMalformed && xToken.ucLen == 4 );
+	TEST_CHECK( xTokScan( "1.2.3", &xToken, 1 ) == 1 && xToken.ucError == eTokMalformed && xToken.ucLen == 5 );
+	TEST_CHECK( xTokScan( "0b102", &xToken, 1 ) == 1 && xToken.ucError == eTokMalformed );
+	TEST_CHECK( xTokScan( "5 - -3", NULL, 0 ) == 3 );
+	TEST_CHECK( xTokScan( "2026-10-16", NULL, 0 ) == 5 );
+}
+/*******************************************************************************
+*   Procedure: vTestRandomLines
+*
+*   Description: This function checks that the tokens of random lines lie
+*   			 within the line, in order and without overlapping, and that
+*   			 no more tokens are stored than asked for
+*
+*   Notes: The lines mix spaces, digits, prefixes, signs, points and
+*   	   symbols, so that every path of the scan is taken.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestRandomLines(void)
+{
+	static const char cChars[] = " \t0123456789abxXbB_.+-*/;:Z";
+	char cLine[TEST_LINE_SIZE];
+	Token_t xTokens[TEST_MAX_TOKENS + 1];
+	Token_t xAll[TEST_LINE_SIZE];	// A line has fewer tokens than characters
+	size_t xLen;
+	size_t xNum;
+	const char* pcEnd;
+
+	for( uint32_t i = 0; i < TEST_ROUNDS; i++ )
+	{
+		xLen = ullTestRandom() % ( sizeof(cLine) - 1 );
+		for( size_t j = 0; j < xLen; j++ )
+		{
+			cLine[j] = cChars[ullTestRandom() % ( sizeof(cChars) - 1 )];
+		}
+		cLine[xLen] = '\0';
+
+		memset( xTokens, TEST_GUARD, sizeof(xTokens) );
+		xNum = xTokScan( cLine, xTokens, TEST_MAX_TOKENS );
+
+		TEST_CHECK( xNum <= xLen );
+		TEST_CHECK( xTokScan( cLine, xAll, sizeof(xAll) / sizeof(xAll[0]) ) == xNum );
+		for( size_t j = 0; j < sizeof(Token_t); j++ )
+		{
+			TEST_CHECK( ((const uint8_t*)&xTokens[TEST_MAX_TOKENS])[j] == TEST_GUARD );
+		}
+
+		pcEnd = cLine;
+		for( size_t j = 0; j < xNum; j++ )
+		{
+			TEST_CHECK( xAll[j].pcText >= pcEnd && xAll[j].ucLen > 0 &&
+						xAll[j].pcText + xAll[j].ucLen <= cLine + xLen );
+			TEST_CHECK( *xAll[j].pcText != ' ' && *xAll[j].pcText != '\t' );
+			TEST_CHECK( j >= TEST_MAX_TOKENS || ( xTokens[j].pcText == xAll[j].pcText && xTokens[j].ucLen == xAll[j].ucLen &&
+						xTokens[j].ucType == xAll[j].ucType && xTokens[j].llValue == xAll[j].llValue ) );
+			pcEnd = xAll[j].pcText + xAll[j].ucLen;
+		}
+	}
+}
+/*******************************************************************************
+*   Procedure: vTestCmdFind
+*
+*   Description: This function checks that every key, name and alias of
+*   			 commands.def finds its command, in any case, and that random
+*   			 words which are not tokens of a menu find none
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestCmdFind(void)
+{
+	const size_t xNumCmds = sizeof(xTestCmds) / sizeof(xTestCmds[0]);
+	const TestCmd_t* pxTest;
+	const Cmd_t* pxCmd;
+	const char* pcTokens[3];
+	const char* pcToken;
+	char cWord[16];
+	size_t xLen;
+	BaseType_t xIsToken;
+
+	for( size_t i = 0; i < xNumCmds; i++ )
+	{
+		pxTest = &xTestCmds[i];
+		pcTokens[0] = pxTest->pcKey;
+		pcTokens[1] = pxTest->pcName;
+		pcTokens[2] = pxTest->pcAliases;
+
+		for( size_t j = 0; j < 3; j++ )
+		{
+			// The aliases are space separated
+			for( pcToken = pcTokens[j]; *pcToken != '\0'; pcToken += xLen )
+			{
+				while( *pcToken == ' ' )
+				{
+					pcToken++;
+				}
+				xLen = strcspn( pcToken, " " );
+
+				pxCmd = pxCmdFind( pxTest->eMenu, pcToken, xLen );
+				TEST_CHECK( pxCmd != NULL && strcmp( pxCmd->pcKey, pxTest->pcKey ) == 0 &&
+							strcmp( pxCmd->pcName, pxTest->pcName ) == 0 );
+
+				for( size_t k = 0; k < xLen && k < sizeof(cWord) - 1; k++ )
+				{
+					cWord[k] = ( pcToken[k] >= 'a' && pcToken[k] <= 'z' ) ? (char)( pcToken[k] - 'a' + 'A' ) : pcToken[k];
+				}
+				TEST_CHECK( pxCmdFind( pxTest->eMenu, cWord, xLen ) == pxCmd );
+
+				// A prefix is not the token
+				TEST_CHECK( xLen < 2 || pxCmdFind( pxTest->eMenu, pcToken, xLen - 1 ) == NULL ||
+							strncmp( pxCmdFind( pxTest->eMenu, pcToken, xLen - 1 )->pcName, pcToken, xLen - 1 ) == 0 ||
+							strncmp( pxCmdFind( pxTest->eMenu, pcToken, xLen - 1 )->pcKey, pcToken, xLen - 1 ) == 0 );
+			}
+		}
+	}
+
+	for( uint32_t i = 0; i < TEST_ROUNDS; i++ )
+	{
+		xLen = 1 + ullTestRandom() % 6;
+		for( size_t j = 0; j < xLen; j++ )
+		{
+			cWord[j] = "abcdefghilmnopqrstuyz0123456789?"[ullTestRandom() % 32];
+		}
+		cWord[xLen] = '\0';
+
+		for( uint32_t eMenu = 0; eMenu < eCmdNumMenus; eMenu++ )
+		{
+			// Is the word a key, a name or an alias of the menu?
+			xIsToken = pdFALSE;
+			for( size_t j = 0; j < xNumCmds && xIsToken == pdFALSE; j++ )
+			{
+				pxTest = &xTestCmds[j];
+				if( pxTest->eMenu != (CmdMenu_t)eMenu )
+				{
+					continue;
+				}
+
+				xIsToken = ( strcmp( pxTest->pcKey, cWord ) == 0 || strcmp( pxTest->pcName, cWord ) == 0 );
+				for( pcToken = pxTest->pcAliases; *pcToken != '\0' && xIsToken == pdFALSE; pcToken += strcspn( pcToken, " " ) )
+				{
+					while( *pcToken == ' ' )
+					{
+						pcToken++;
+					}
+					xIsToken = ( strcspn( pcToken, " " ) == xLen && strncmp( pcToken, cWord, xLen ) == 0 );
+				}
+			}
+
+			TEST_CHECK( ( pxCmdFind( (CmdMenu_t)eMenu, cWord, xLen ) != NULL ) == ( xIsToken == pdTRUE ) );
+		}
+	}
+}
+/*******************************************************************************
+*   Procedure: vTestCmdExecute
+*
+*   Description: This function checks the arguments passed to the handlers,
+*   			 the statuses of xCmdExecute() and the status lines of a
+*   			 script
+*
+*   Notes: None
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vTestCmdExecute(void)
+{
+	char cLine[96];
+	const Cmd_t* pxCmd;
+	BaseType_t xQuit = pdFALSE;
+
+	strcpy( cLine, "  BAUD   -115200  " );
+	TEST_CHECK( xCmdExecute( eCmdMenuMain, cLine, &pxCmd, &xQuit ) == eCmdOk );
+	TEST_CHECK( strcmp( pcTestHandler, "xCmdBaudRate" ) == 0 && xTestArg.eType == eCmdArgInt && xTestArg.lInt == -115200 );
+
+	strcpy( cLine, "7 0x2580" );
+	TEST_CHECK( xCmdExecute( eCmdMenuMain, cLine, &pxCmd, &xQuit ) == eCmdOk && xTestArg.lInt == 9600 );
+
+	strcpy( cLine, "baud 12ab" );
+	TEST_CHECK( xCmdExecute( eCmdMenuMain, cLine, &pxCmd, &xQuit ) == eCmdBadNumber );
+	strcpy( cLine, "baud 4294967296" );
+	TEST_CHECK( xCmdExecute( eCmdMenuMain, cLine, &pxCmd, &xQuit ) == eCmdBadNumber );
+
+	strcpy( cLine, "led on" );
+	TEST_CHECK( xCmdExecute( eCmdMenuMain, cLine, &pxCmd, &xQuit ) == eCmdOk );
+	TEST_CHECK( strcmp( pcTestHandler, "xCmdManageLed" ) == 0 && xTestArg.eType == eCmdArgWord &&
+				strcmp( xTestArg.pcWord, "on" ) == 0 );
+
+	strcpy( cLine, "clock now" );
+	TEST_CHECK( xCmdExecute( eCmdMenuMain, cLine, &pxCmd, &xQuit ) == eCmdNoArgument && pxCmd != NULL );
+	strcpy( cLine, "nosuch" );
+	TEST_CHECK( xCmdExecute( eCmdMenuMain, cLine, &pxCmd, &xQuit ) == eCmdUnknown && pxCmd == NULL );
+	strcpy( cLine, "1" );
+	TEST_CHECK( xCmdExecute( eCmdMenuMain, cLine, &pxCmd, &xQuit ) == eCmdOk && strcmp( pcTestHandler, "xCmdRunClock" ) == 0 );
+	TEST_CHECK( xQuit == pdFALSE );
+
+	// A script stops after the command quitting
+	cTestOutput[0] = '\0';
+	strcpy( cLine, "date 2026-10-16;; nosuch 1 ; led fail; alarms x; ALARMS; end; show" );
+	TEST_CHECK( xCmdRunScript( eCmdMenuScript, cLine, &xQuit ) == pdFAIL && xQuit == pdTRUE );
+	TEST_CHECK( strcmp( cTestOutput, "\r\nOK 1 date\r\nERR 2 nosuch: unknown command\r\nERR 3 led: rejected"
+									 "\r\nERR 4 alarms: no argument accepted\r\nOK 5 alarms\r\nOK 6 end" ) == 0 );
+}
+/*******************************************************************************
+*   Procedure: vBenchmark
+*
+*   Description: This function times reading a number with xTokLineToInt32()
+*   			 against strtol(), scanning a script line, and looking up a
+*   			 command with pxCmdFind()
+*
+*   Notes: The times are of the PC, they only compare the functions with
+*   	   one another.
+*
+*   Parameters: None
+*
+*   Return: None
+*
+*******************************************************************************/
+static void vBenchmark(void)
+{
+	static const char* const pcNumbers[] = { "7", "-42", "115200", "2147483647", "0x2A", "-2026" };
+	static const char* const pcWords[] = { "clock", "GAME", "7", "temperature", "baud", "nosuch" };
+	Token_t xTokens[TEST_MAX_TOKENS];
+	volatile int32_t lSink = 0;
+	volatile size_t xSink = 0;
+	uint64_t ullStart, ullTok, ullStrtol, ullScan, ullFind;
+	int32_t lValue;
+
+	ullStart = ullBenchNow();
+	for( uint32_t i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		if( xTokLineToInt32( pcNumbers[i % 6], &lValue ) == eTokOk )
+		{
+			lSink += lValue;
+		}
+	}
+	ullTok = ullBenchNow() - ullStart;
+
+	ullStart = ullBenchNow();
+	for( uint32_t i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		lSink += (int32_t)strtol( pcNumbers[i % 6], NULL, 0 );
+	}
+	ullStrtol = ullBenchNow() - ullStart;
+
+	ullStart = ullBenchNow();
+	for( uint32_t i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		xSink += xTokScan( "date 2026-10-16; time 08:00:00; alarm 07:30:00", xTokens, TEST_MAX_TOKENS );
+	}
+	ullScan = ullBenchNow() - ullStart;
+
+	ullStart = ullBenchNow();
+	for( uint32_t i = 0; i < BENCH_ROUNDS; i++ )
+	{
+		xSink += ( pxCmdFind( eCmdMenuMain, pcWords[i % 6], strlen( pcWords[i % 6] ) ) != NULL );
+	}
+	ullFind = ullBenchNow() - ullStart;
+
+	printf("tok: xTokLineToInt32 %.1f ns, strtol %.1f ns, xTokScan of a 20 token script %.1f ns\n",
+		   (double)ullTok / BENCH_ROUNDS, (double)ullStrtol / BENCH_ROUNDS, (double)ullScan / BENCH_ROUNDS);
+	printf("cmd: pxCmdFind %.1f ns\n", (double)ullFind / BENCH_ROUNDS);
+}
+
+int main(void)
+{
+	vTestRoundTrip();
+	vTestStrtoll();
+	vTestFixed();
+	vTestRandomLines();
+	vTestCmdFind();
+	vTestCmdExecute();
+
+	if( ulTestFailures != 0 )
+	{
+		printf("tok, cmd: %lu checks failed\n", (unsigned long)ulTestFailures);
+		return(1);
+	}
+
+	printf("tok, cmd: all tests passed\n");
+	vBenchmark();
+
+	return(0);
+}
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+Lists the RAM used by each object of the linked application, grouped by the
+source file that defines it, and compares the total of each file with the
+budgets of STM32_FreeRTOS_General_Application/inc/ram_budget.h.
+
+Run it after a build, with the ELF and the map file written by the linker:
+    python3 Tools/ram_map.py Debug/STM32_FreeRTOS_General_Application.elf Debug/output.map
+
+The map file gives the .data and .bss input sections of each object file. The
+symbols are read from the ELF with nm (--nm to choose the tool) and given to
+the file whose section holds them. The exit code is 1 if a file exceeds the
+sum of the budgets naming it, e.g. "(console.c)".
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+PROJECT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "STM32_FreeRTOS_General_Application")
+BUDGET_FILE = os.path.join(PROJECT, "inc", "ram_budget.h")
+
+# Input section of the map file, on one line or with the address on the next one
+SECTION = re.compile(r"^ (\.data\S*|\.bss\S*|COMMON)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+))?\s*$")
+ADDRESS = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+)\s*$")
+
+
+def read_budgets(path):
+    """Return {source file: budget in bytes} from the RAM_BUDGET_ defines."""
+    budgets = {}
+    for match in re.finditer(r"^#define\s+RAM_BUDGET_\w+\s+(\d+)\s*//.*\(([\w.]+)\)\s*$", open(path).read(), re.M):
+        budgets[match.group(2)] = budgets.get(match.group(2), 0) + int(match.group(1))
+    return budgets
+
+
+def read_sections(path):
+    """Return the (address, size, object file) of each RAM input section."""
+    sections, pending = [], None
+    for line in open(path):
+        if pending is not None:
+            match = ADDRESS.match(line)
+            if match:
+                sections.append((int(match.group(1), 16), int(match.group(2), 16), match.group(3)))
+            pending = None
+            continue
+        match = SECTION.match(line)
+        if not match:
+            continue
+        if match.group(2) is None:
+            pending = match.group(1)
+        elif int(match.group(3), 16) > 0:
+            sections.append((int(match.group(2), 16), int(match.group(3), 16), match.group(4)))
+    return [s for s in sections if s[1] > 0]
+
+
+def read_symbols(nm, elf):
+    """Return the (address, size, name) of each data symbol of the ELF."""
+    output = subprocess.run([nm, "--print-size", "--defined-only", elf],
+                            check=True, capture_output=True, text=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in "bBdDC":
+            symbols.append((int(fields[0], 16), int(fields[1], 16), fields[3]))
+    return symbols
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RAM used by each object")
+    parser.add_argument("elf")
+    parser.add_argument("map")
+    parser.add_argument("--nm", default="arm-none-eabi-nm")
+    args = parser.parse_args()
+
+    budgets = read_budgets(BUDGET_FILE)
+    sections = read_sections(args.map)
+    symbols = read_symbols(args.nm, args.elf)
+
+    # Objects of each file, and the bytes of its sections (padding included)
+    files = {}
+    for start, size, obj in sections:
+        # The objects of the project are named after their source file
+        name = os.path.basename(obj)
+        if obj.endswith(".o") and "src" in obj.replace("\\", "/").split("/"):
+            name = os.path.splitext(name)[0] + ".c"
+        entry = files.setdefault(name, {"bytes": 0, "objects": []})
+        entry["bytes"] += size
+        entry["objects"] += [s for s in symbols if start <= s[0] < start + size]
+
+    over = False
+    total = 0
+    for name in sorted(files, key=lambda n: -files[n]["bytes"]):
+        entry = files[name]
+        budget = budgets.get(name)
+        total += entry["bytes"]
+        status = ""
+        if budget is not None:
+            status = "  budget %d%s" % (budget, "  OVER" if entry["bytes"] > budget else "")
+            over = over or entry["bytes"] > budget
+        print("%-28s %8d%s" % (name, entry["bytes"], status))
+        for address, size, symbol in sorted(entry["objects"], key=lambda s: -s[1]):
+            print("    0x%08x %8d  %s" % (address, size, symbol))
+
+    print("%-28s %8d" % ("Total", total))
+    sys.exit(1 if over else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Host side of the RTT console link of STM32_FreeRTOS_General_Application (see
+CONSOLE_RTT_CHANNEL in console.h), working on a memory image instead of a
+debug probe. It finds the SEGGER RTT control block in the image, reads what the
+target has written to an up buffer and writes text into a down buffer, the way
+a J-Link does through the debug port.
+
+The image is a raw copy of the target RAM starting at --base, e.g. written by
+"savebin <file> 0x20000000 0x20000" in J-Link Commander or by "dump_image" in
+OpenOCD. After --send or --consume the image is written back, to be loaded into
+the target again or read by a simulation.
+
+Usage examples:
+    rtt_host.py ram.bin --list
+    rtt_host.py ram.bin --channel 1 --consume
+    rtt_host.py ram.bin --channel 1 --send 'stats\\r'
+
+--ptr-size 8 reads a control block built for a 64-bit host, e.g. SEGGER_RTT.c
+compiled into a Linux test program whose memory was dumped.
+"""
+
+import argparse
+import struct
+import sys
+
+RTT_ID = b"SEGGER RTT\0"
+
+
+class Image:
+    """RAM of the target, addressed as on the target."""
+
+    def __init__(self, data, base, ptr_size):
+        self.data = bytearray(data)
+        self.base = base
+        self.word = "<I" if ptr_size == 4 else "<Q"
+        self.ptr_size = ptr_size
+
+    def offset(self, address, size=1):
+        offset = address - self.base
+        if offset < 0 or offset + size > len(self.data):
+            raise ValueError("address 0x%x is outside the image" % address)
+        return offset
+
+    def read(self, address, size):
+        offset = self.offset(address, size)
+        return bytes(self.data[offset:offset + size])
+
+    def write(self, address, data):
+        offset = self.offset(address, len(data))
+        self.data[offset:offset + len(data)] = data
+
+    def u32(self, address):
+        return struct.unpack("<I", self.read(address, 4))[0]
+
+    def set_u32(self, address, value):
+        self.write(address, struct.pack("<I", value))
+
+    def ptr(self, address):
+        return struct.unpack(self.word, self.read(address, self.ptr_size))[0]
+
+    def string(self, address):
+        # Names are usually constants in flash, outside a RAM image
+        if address == 0 or not 0 <= address - self.base < len(self.data):
+            return ""
+        offset = address - self.base
+        end = self.data.find(b"\0", offset)
+        return self.data[offset:end].decode("ascii", "replace")
+
+
+class Ring:
+    """SEGGER_RTT_BUFFER_UP or SEGGER_RTT_BUFFER_DOWN: name, buffer, size, WrOff, RdOff, flags."""
+
+    def __init__(self, image, address):
+        self.image = image
+        self.address = address
+        p = image.ptr_size
+        # Unsigned members are 32-bit, pointers are padded to the pointer size
+        self.name = image.string(image.ptr(address))
+        self.buffer = image.ptr(address + p)
+        self.size = image.u32(address + 2 * p)
+        self.wr_off_at = address + 2 * p + 4
+        self.rd_off_at = self.wr_off_at + 4
+
+    @staticmethod
+    def struct_size(ptr_size):
+        size = 2 * ptr_size + 4 * 4
+        return (size + ptr_size - 1) // ptr_size * ptr_size
+
+    @property
+    def wr_off(self):
+        return self.image.u32(self.wr_off_at)
+
+    @property
+    def rd_off(self):
+        return self.image.u32(self.rd_off_at)
+
+    def pending(self):
+        """Bytes written by the writer and not read yet."""
+        wr, rd = self.wr_off, self.rd_off
+        if wr >= rd:
+            return self.image.read(self.buffer + rd, wr - rd)
+        return self.image.read(self.buffer + rd, self.size - rd) + self.image.read(self.buffer, wr)
+
+    def consume(self):
+        """Read the pending bytes of an up buffer as the host does."""
+        data = self.pending()
+        self.image.set_u32(self.rd_off_at, self.wr_off)
+        return data
+
+    def send(self, data):
+        """Write into a down buffer as the host does. Returns the bytes that fit."""
+        wr, rd = self.wr_off, self.rd_off
+        free = (rd - wr - 1) % self.size
+        data = data[:free]
+        for byte in data:
+            self.image.write(self.buffer + wr, bytes([byte]))
+            wr = (wr + 1) % self.size
+        self.image.set_u32(self.wr_off_at, wr)
+        return len(data)
+
+
+def find_control_block(image):
+    """Return (address, up buffers, down buffers) of the control block."""
+    offset = image.data.find(RTT_ID)
+    if offset < 0:
+        raise ValueError("no SEGGER RTT control block in the image")
+    address = image.base + offset
+    num_up, num_down = struct.unpack("<ii", image.read(address + 16, 8))
+    ring_size = Ring.struct_size(image.ptr_size)
+    first = address + 24
+    # The rings start on a pointer boundary
+    first = (first + image.ptr_size - 1) // image.ptr_size * image.ptr_size
+    up = [Ring(image, first + i * ring_size) for i in range(num_up)]
+    down = [Ring(image, first + (num_up + i) * ring_size) for i in range(num_down)]
+    return address, up, down
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RTT console link on a memory image")
+    parser.add_argument("image")
+    parser.add_argument("--base", type=lambda v: int(v, 0), default=0x20000000)
+    parser.add_argument("--ptr-size", type=int, choices=(4, 8), default=4)
+    parser.add_argument("--channel", type=int, default=1)
+    parser.add_argument("--list", action="store_true", help="list the buffers of the control block")
+    parser.add_argument("--consume", action="store_true", help="mark the output printed as read")
+    parser.add_argument("--send", help="text to write into the down buffer (\\r, \\n escapes allowed)")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = Image(f.read(), args.base, args.ptr_size)
+    address, up, down = find_control_block(image)
+
+    if args.list:
+        print("Control block at 0x%08x" % address)
+        for kind, rings in (("up", up), ("down", down)):
+            for i, ring in enumerate(rings):
+                print("%-4s %d  %-10s buffer 0x%08x size %5d  WrOff %5d  RdOff %5d" %
+                      (kind, i, ring.name or "-", ring.buffer, ring.size, ring.wr_off, ring.rd_off))
+        return
+
+    if args.channel >= len(up) or up[args.channel].size == 0:
+        sys.exit("channel %d has no up buffer" % args.channel)
+    data = up[args.channel].consume() if args.consume else up[args.channel].pending()
+    changed = args.consume and len(data) > 0
+    sys.stdout.write(data.decode("latin-1"))
+
+    if args.send is not None:
+        if args.channel >= len(down) or down[args.channel].size == 0:
+            sys.exit("channel %d has no down buffer" % args.channel)
+        text = args.send.encode("latin-1").decode("unicode_escape").encode("latin-1")
+        sent = down[args.channel].send(text)
+        if sent < len(text):
+            print("\n%d of %d bytes sent, the down buffer is full" % (sent, len(text)), file=sys.stderr)
+        changed = True
+
+    if changed:
+        with open(args.image, "wb") as f:
+            f.write(image.data)
+
+
+if __name__ == "__main__":
+    main()